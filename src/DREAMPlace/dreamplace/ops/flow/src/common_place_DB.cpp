@@ -116,7 +116,7 @@ CommonDB::__init()
       init_y_[idx] = getBoxLLY(box);
       node_size_x_[idx] = getBoxWidth(box);
       node_size_y_[idx] = getBoxHeight(box);
-      idx_to_instId_.push_back(instId);
+      idx_to_instId_[idx] = instId;
       // collect moveable inst pins
       if (getInstNumPins(inst) > 0) { 
         flat_node2pin_start_map_[idx] = pinIdx;
@@ -144,7 +144,7 @@ CommonDB::__init()
       init_y_[idx] = getBoxLLY(box);
       node_size_x_[idx] = getBoxWidth(box);
       node_size_y_[idx] = getBoxHeight(box);
-      idx_to_instId_.push_back(instId);
+      idx_to_instId_[idx] = instId;
       // collect fixed inst pins
       if (getInstNumPins(inst) > 0) { 
         flat_node2pin_start_map_[idx] = pinIdx;
@@ -286,15 +286,26 @@ CommonDB::__free()
 void
 CommonPlaceDB::updateDB2EDI()
 {
-  // update all moveable instances
-  for (int i = 0; i < getNumMoveableNodes(); ++i) 
-  { 
-    PlObjId id = getInstId(i);
-    PlInst* inst = getInstance(id);
+  // write back all moveable instances through the placement view of edi db
+  PlPlacementView* view = getPlacementView();
+  bool use_view = view != nullptr &&
+      view_index_.size() == static_cast<PlUInt>(getNumMoveableNodes());
+  if (use_view) {
+    view->setLocations(view_index_.data(), view_index_.size(),
+                       getCurX(), getCurY());
+    view->setStatus(view_index_.data(), view_index_.size(),
+                    kPlStatus::kPlaced);
+  }
+  // instances without a slot, or all of them when the view was disabled
+  // since the DB was built, are written one by one
+  for (int i = 0; i < getNumMoveableNodes(); ++i)
+  {
+    if (use_view && view_index_[i] != PlPlacementView::kInvalidIndex) continue;
+    PlInst* inst = getInstance(getInstId(i));
     PlPoint loc(getCurXV().at(i), getCurYV().at(i));
     setInstLoc(inst, loc);
     setInstPStatus(inst, kPlStatus::kPlaced);
-  } 
+  }
 }
 
 void
@@ -368,6 +379,13 @@ CommonPlaceDB::__buildInternalDB()
   // copy currnt locations
   cur_x_ = getInitXV();
   cur_y_ = getInitYV();
+  // map moveable nodes to slots of placement view for write back
+  PlPlacementView* view = enablePlacementView();
+  view_index_.resize(getNumMoveableNodes());
+  for (int i = 0; i < getNumMoveableNodes(); ++i)
+  {
+    view_index_[i] = view->getIndex(getInstId(i));
+  }
   // copy site  
   PlSite* site = getCoreSite();
   if (site) {
@@ -247,7 +247,7 @@ class CommonPlaceDB
     // common DB interface : get
     bool                 isCommonDBReady()          const { return db_.isCommonDBReady();          }
     const LocV&          getInitXV()                const { return db_.getInitX();                 }
-    const LocV&          getInitYV()                const { return db_.getInitX();                 }
+    const LocV&          getInitYV()                const { return db_.getInitY();                 }
     const LocV&          getNodeSizeXV()            const { return db_.getNodeSizeX();             }
     const LocV&          getNodeSizeYV()            const { return db_.getNodeSizeY();             }
     const LocV&          getFlatRegionBoxesV()      const { return db_.getFlatRegionBoxes();       }
@@ -359,6 +359,7 @@ __attribute__ ((visibility("default")))
     PlBox               box_;                              // box of die area xl, yl, xh, yh
     LocV                cur_x_;                            // init loc X of nodes
     LocV                cur_y_;                            // init loc Y of nodes
+    std::vector<PlUInt> view_index_;                       // placement view slot of moveable nodes
     // build i,j grid in the future
     Coord               site_width_         = 0;           // site width
     Coord               row_height_         = 0;           // row height  
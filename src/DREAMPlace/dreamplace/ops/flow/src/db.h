@@ -23,6 +23,7 @@
 #include "db/core/inst.h"
 #include "db/core/net.h"
 #include "db/core/pin.h"
+#include "db/core/placement_view.h"
 #include "db/core/special_net.h"
 #include "db/core/term.h"
 #include "db/tech/tech.h"
@@ -42,6 +43,7 @@ typedef std::string String;
 typedef dbi::Object PlObj;
 typedef dbi::ObjectId PlObjId;
 typedef dbi::ArrayObject<PlObjId> PlArrayObj;
+template <class T> using PlRange = dbi::ObjectRange<T>;
 typedef dbi::Net PlNet;
 typedef dbi::Pin PlPin;
 typedef dbi::Term PlTerm;
@@ -66,6 +68,7 @@ typedef dbi::LayerGeometry PlLGeometry;
 typedef dbi::Geometry PlGeometry;
 typedef dbi::Row PlRow;
 typedef dbi::Root PlRoot;
+typedef dbi::PlacementView PlPlacementView;
 
 typedef uti::PlaceStatus kPlStatus;
 typedef uti::Polygon PlPolygon;
@@ -85,6 +88,7 @@ inline PlCell*        getPlTopCell()                     { return dbi::getTopCel
 inline PlUInt         getNumOfNets()                     { return getPlTopCell()->getNumOfNets(); }
 inline PlObjId        getNetsId()                        { return getPlTopCell()->getNets(); }
 inline PlArrayObj*    getNetArray()                      { return getPlTopCell()->getNetArray(); }
+inline PlRange<PlNet> getNets()                          { return getPlTopCell()->nets(); }
 inline PlUInt         getNumOfSpecialNets()              { return getPlTopCell()->getNumOfSpecialNets(); }
 inline PlArrayObj*    getSpecialNetArray()               { return getPlTopCell()->getSpecialNetArray(); }
 inline PlNet*         getNet(PlObjId idx)                { return PlObj::addr<PlNet>(idx); } // need API
@@ -113,6 +117,7 @@ inline PlBox          getGeometryBox(PlGeometry* geo)             { return geo->
 // pin
 inline PlUInt         getNumOfIOPins()                   { return getPlTopCell()->getNumOfIOPins(); }
 inline PlArrayObj*    getNetPinArray(PlNet* net)         { return net->getPinArray(); }
+inline PlRange<PlPin> getNetPins(PlNet* net)             { return net->pins(); }
 inline PlPin*         getPin(PlObjId idx)                { return PlObj::addr<PlPin>(idx); } // need API
 inline PlPin*         getIOPin(PlObjId idx)              { return getPlTopCell()->getIOPin(idx); } // need API
 inline PlNet*         getPinNet(PlPin* pin)              { return pin->getNet(); }
@@ -128,7 +133,10 @@ inline PlInt          getPinLocY(PlPin* pin)             { return getPinLoc(pin)
 // instance
 inline PlUInt         getNumOfInsts()                    { return getPlTopCell()->getNumOfInsts(); }
 inline PlArrayObj*    getInstanceArray()                 { return getPlTopCell()->getInstanceArray(); }
+inline PlRange<PlInst> getInstances()                    { return getPlTopCell()->insts(); }
 inline PlInst*        getInstance(PlObjId idx)           { return PlObj::addr<PlInst>(idx); }
+inline PlPlacementView* getPlacementView()              { return getPlTopCell()->getPlacementView(); }
+inline PlPlacementView* enablePlacementView()           { return getPlTopCell()->enablePlacementView(); }
 inline PlCell*        getInstCell(PlInst* inst)          { return inst->getParent(); } 
 inline String         getInstName(PlInst* inst)          { return inst->getName(); }
 inline PlBox          getInstBox(PlInst* inst)           { return inst->getBox(); }
@@ -141,6 +149,7 @@ inline PlInt          getInstWeigth(PlInst* inst)        { return inst->getWeigh
 inline PlConstraint*  getInstRegion(PlInst* inst)        { return inst->getRegion(); }
 inline PlInt          getInstNumPins(PlInst* inst)       { return inst->numPins(); }
 inline PlArrayObj*    getInstPinArray(PlInst* inst)      { return inst->getPinArray(); }
+inline PlRange<PlPin> getInstPins(PlInst* inst)          { return inst->pins(); }
 inline bool           isInstUnplaced(PlInst* inst)       { return getInstStatus(inst) == kPlStatus::kUnplaced; }
 inline bool           isInstPlaced(PlInst* inst)         { return getInstStatus(inst) == kPlStatus::kPlaced; }
 inline bool           isInstSuggested(PlInst* inst)      { return getInstStatus(inst) == kPlStatus::kSuggested;}
@@ -151,6 +160,7 @@ inline bool           isInstMoveable(PlInst* inst)       { return (isInstUnplace
 // cell
 inline PlUInt         getNumOfCells()                    { return getRoot()->getTechLib()->getNumOfCells(); }
 inline PlArrayObj*    getCellArray()                     { return getRoot()->getTechLib()->getCellArray(); }
+inline PlRange<PlCell> getCells()                        { return PlRange<PlCell>(getCellArray()); }
 inline PlCell*        getCell(PlInt idx)                 { return PlObj::addr<PlCell>(idx); }
 inline PlUInt         getCellNumOfTerms(PlCell* cell)    { return cell->getNumOfTerms(); }
 inline PlArrayObj*    getCellTerms(PlCell* cell)         { return cell->getTermArray(); }
@@ -222,36 +232,36 @@ getPin1Box(PlPin* pin, PlBox& box)
 #define setMax2(a, b) if (a > b) b = a;
 // iterations
 #define forEachNet()                                                                     \
-        for (auto iter = getNetArray()->begin(); iter != getNetArray()->end(); ++iter) { \
-          PlObjId netId = *iter;                                                         \
+        for (auto iter = getNets().begin(), iter_end = getNets().end(); iter != iter_end; ++iter) { \
+          PlObjId netId = iter.getId();                                                  \
           PlNet* net = getNet(netId);                                                    \
           if (nullptr == net) continue;
 #define endForEachNet }
 
 #define forEachNetPin(net) \
-        for (auto iter = getNetPinArray(net)->begin(); iter != getNetPinArray(net)->end(); ++iter) { \
-          PlObjId pinId = *iter;                                                                     \
+        for (auto iter = getNetPins(net).begin(), iter_end = getNetPins(net).end(); iter != iter_end; ++iter) { \
+          PlObjId pinId = iter.getId();                                                              \
           PlPin* pin = getPin(pinId);                                                                \
           if (nullptr == pin) continue;
 #define endForEachNetPin }
 
 #define forEachInst()                                                                              \
-        for (auto iter = getInstanceArray()->begin(); iter != getInstanceArray()->end(); ++iter) { \
-          PlObjId instId = *iter;                                                                  \
+        for (auto iter = getInstances().begin(), iter_end = getInstances().end(); iter != iter_end; ++iter) { \
+          PlObjId instId = iter.getId();                                                           \
           PlInst* inst = getInstance(instId);                                                      \
           if (nullptr == inst) continue;
 #define endForEachInst }
 
 #define forEachInstPin(inst)                                                                             \
-        for (auto iter = getInstPinArray(inst)->begin(); iter != getInstPinArray(inst)->end(); ++iter) { \
-          PlObjId pinId = *iter;                                                                         \
+        for (auto iter = getInstPins(inst).begin(), iter_end = getInstPins(inst).end(); iter != iter_end; ++iter) { \
+          PlObjId pinId = iter.getId();                                                                  \
           PlPin* pin = getPin(pinId);                                                                    \
           if (nullptr == pin) continue;
 #define endForEachInstPin }
 
 #define forEachCell()                                                                      \
-        for (auto iter = getCellArray()->begin(); iter != getCellArray()->end(); ++iter) { \
-          PlObjId cellId = *iter;                                                          \
+        for (auto iter = getCells().begin(), iter_end = getCells().end(); iter != iter_end; ++iter) { \
+          PlObjId cellId = iter.getId();                                                   \
           PlCell* cell = getCell(cellId);                                                  \
           if (nullptr == cell) continue;
 #define endForEachCell }
@@ -119,6 +119,7 @@ void HierData::__init() {
     fills_ = 0;
     scan_chains_ = 0;
     regions_ = 0;
+    inst_sparse_attrs_ = 0;
 }
 
 StorageUtil* HierData::getStorageUtil() const { return storage_util_; }
@@ -174,6 +175,8 @@ ObjectId HierData::getScanChains() const { return scan_chains_; }
 
 ObjectId HierData::getRegions() const { return regions_; }
 
+ObjectId HierData::getInstSparseAttrs() const { return inst_sparse_attrs_; }
+
 // Set object vector:
 void HierData::setCells(ObjectId v) { cells_ = v; }
 
@@ -194,6 +197,8 @@ void HierData::setFills(ObjectId v) { fills_ = v; }
 void HierData::setScanChains(ObjectId v) { scan_chains_ = v; }
 
 void HierData::setRegions(ObjectId v) { regions_ = v; }
+
+void HierData::setInstSparseAttrs(ObjectId v) { inst_sparse_attrs_ = v; }
 // End of HierData
 
 void Cell::__init() {
@@ -305,6 +310,37 @@ StorageUtil *Cell::getStorageUtil() {
     return __getHierData()->getStorageUtil();
 }
 
+/// @brief enablePlacementView build the placement view of the instances
+/// of a hierarchical cell, see PlacementView
+///
+/// @return the view, nullptr for leaf cells
+PlacementView *Cell::enablePlacementView() {
+    PlacementView *view = getPlacementView();
+    if (view != nullptr) return view;
+    if (__getConstHierData() == nullptr) return nullptr;
+    StorageUtil *storage_util = getStorageUtil();
+    if (storage_util == nullptr) return nullptr;
+    view = new PlacementView(this);
+    storage_util->setPlacementView(view);
+    return view;
+}
+
+/// @brief disablePlacementView release the placement view
+void Cell::disablePlacementView() {
+    if (getPlacementView() == nullptr) return;
+    getStorageUtil()->setPlacementView(nullptr);
+}
+
+/// @brief getPlacementView
+///
+/// @return the view if enabled, otherwise nullptr
+PlacementView *Cell::getPlacementView() {
+    if (__getConstHierData() == nullptr) return nullptr;
+    StorageUtil *storage_util = getStorageUtil();
+    if (storage_util == nullptr) return nullptr;
+    return storage_util->getPlacementView();
+}
+
 /// @brief set storage_util to a cell
 void Cell::setStorageUtil(StorageUtil *v) {
     HierData * hier_data = __getHierData();
@@ -427,6 +463,16 @@ SymbolIndex Cell::getOrCreateSymbol(std::string &name) {
     return getOrCreateSymbol(name.c_str());
 }
 
+/// @brief look up the symbol of name without inserting it
+/// @return kInvalidSymbolIndex if there is no such symbol
+SymbolIndex Cell::__findSymbol(const std::string &name) {
+    SymbolTable *sym_table = getSymbolTable();
+    if (sym_table == nullptr) {
+        return kInvalidSymbolIndex;
+    }
+    return sym_table->isSymbolInTable(name);
+}
+
 /// @brief addSymbolReference
 ///
 /// @param index
@@ -689,7 +735,10 @@ void Cell::addNet(ObjectId id) {
         vct = addr<ArrayObject<ObjectId>>(getNets());
     }
 
-    if (vct) vct->pushBack(id);
+    if (vct) {
+        vct->pushBack(id);
+        __addToNameIndex(kObjectTypeNet, id);
+    }
 }
 
 Net *Cell::createNet(std::string &name) {
@@ -726,7 +775,10 @@ void Cell::addSpecialNet(ObjectId id) {
         vct = addr<ArrayObject<ObjectId>>(getSpecialNets());
     }
 
-    if (vct) vct->pushBack(id);
+    if (vct) {
+        vct->pushBack(id);
+        __addToNameIndex(kObjectTypeSpecialNet, id);
+    }
 }
 
 SpecialNet *Cell::createSpecialNet(std::string &name) {
@@ -757,7 +809,57 @@ void Cell::addInstance(ObjectId id) {
         vct = addr<ArrayObject<ObjectId>>(getInstances());
     }
 
-    if (vct) vct->pushBack(id);
+    if (vct) {
+        vct->pushBack(id);
+        __addToNameIndex(kObjectTypeInst, id);
+        PlacementView *view = getPlacementView();
+        if (view != nullptr) view->addInst(addr<Inst>(id));
+    }
+}
+
+/// @brief addInstSparseAttr add a slot with default values to the side
+/// table of optional instance attributes
+///
+/// @return index of the slot
+UInt32 Cell::addInstSparseAttr() {
+    ediAssert(__getConstHierData() != nullptr);
+    ArrayObject<InstSparseAttr> *vct = nullptr;
+
+    if (__getHierData()->getInstSparseAttrs() == 0) {
+        vct = createObject<ArrayObject<InstSparseAttr>>(kObjectTypeArray);
+        ediAssert(vct != nullptr);
+        vct->setPool(getPool());
+        vct->reserve(32);
+        __getHierData()->setInstSparseAttrs(vct->getId());
+    } else {
+        vct = addr<ArrayObject<InstSparseAttr>>(
+            __getHierData()->getInstSparseAttrs());
+    }
+
+    InstSparseAttr attr;
+    attr.eeq_master = 0;
+    attr.region = 0;
+    attr.halo = Box(0, 0, 0, 0);
+    attr.route_halo_dist = 0;
+    attr.min_layer_id = -1;
+    attr.max_layer_id = -1;
+    attr.weight = 0;
+    for (int i = 0; i < max_layer_num; i++) {
+        attr.mask_shift[i] = 0;
+    }
+    UInt32 index = vct->getSize();
+    vct->pushBack(attr);
+    return index;
+}
+
+/// @brief getInstSparseAttr
+///
+/// @param index slot returned by addInstSparseAttr
+InstSparseAttr *Cell::getInstSparseAttr(UInt32 index) const {
+    if (__getConstHierData() == nullptr) return nullptr;
+    ObjectId id = __getConstHierData()->getInstSparseAttrs();
+    if (id == 0) return nullptr;
+    return &(*addr<ArrayObject<InstSparseAttr>>(id))[index];
 }
 
 Inst *Cell::createInstance(std::string &name) {
@@ -793,7 +895,10 @@ void Cell::addIOPin(ObjectId id) {
         vct = addr<ArrayObject<ObjectId>>(getIOPins());
     }
 
-    if (vct) vct->pushBack(id);
+    if (vct) {
+        vct->pushBack(id);
+        __addToNameIndex(kObjectTypePin, id);
+    }
 }
 
 Pin *Cell::createIOPin(std::string &name) {
@@ -1018,11 +1123,15 @@ ObjectId Cell::getScanChains() const {
 }
 
 Cell *Cell::getCellFromTechLib(std::string name) {
-    SymbolIndex symbol_index = getTechLib()->getOrCreateSymbol(name.c_str());
+    Tech *tech_lib = getTechLib();
+    if (tech_lib == nullptr) return nullptr;
+    SymbolTable *symbol_table = tech_lib->getSymbolTable();
+    if (symbol_table == nullptr) return nullptr;
+    SymbolIndex symbol_index = symbol_table->isSymbolInTable(name);
     if (symbol_index == kInvalidSymbolIndex) return nullptr;
 
-    std::vector<ObjectId> object_vector =
-          getTechLib()->getSymbolTable()->getReferences(symbol_index);
+    const std::vector<ObjectId> &object_vector =
+        symbol_table->getReferences(symbol_index);
     for (auto iter = object_vector.begin(); iter != object_vector.end();
         iter++) {
         Cell *target = addr<Cell>(*iter);
@@ -1034,16 +1143,16 @@ Cell *Cell::getCellFromTechLib(std::string name) {
 
 Cell *Cell::getCell(std::string name) {
     if (getCells() != 0) {
-        SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
-        if (symbol_index == kInvalidSymbolIndex) return nullptr;
-
-        std::vector<ObjectId> object_vector =
-              this->getSymbolTable()->getReferences(symbol_index);
-        for (auto iter = object_vector.begin(); iter != object_vector.end();
-            iter++) {
-            Cell *target = addr<Cell>(*iter);
-            if (target && (target->getObjectType() == kObjectTypeCell))
-                return target;
+        SymbolIndex symbol_index = __findSymbol(name);
+        if (symbol_index != kInvalidSymbolIndex) {
+            const std::vector<ObjectId> &object_vector =
+                getSymbolTable()->getReferences(symbol_index);
+            for (auto iter = object_vector.begin();
+                 iter != object_vector.end(); iter++) {
+                Cell *target = addr<Cell>(*iter);
+                if (target && (target->getObjectType() == kObjectTypeCell))
+                    return target;
+            }
         }
     }
 
@@ -1122,10 +1231,10 @@ ArrayObject<ObjectId> *Cell::getGroupArray() const {
 
 Term *Cell::getTerm(std::string name) {
     if (getTerms() != 0) {
-        SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
+        SymbolIndex symbol_index = __findSymbol(name);
         if (symbol_index == kInvalidSymbolIndex) return nullptr;
 
-        std::vector<ObjectId> &object_vector =
+        const std::vector<ObjectId> &object_vector =
             this->getSymbolTable()->getReferences(symbol_index);
         for (auto iter = object_vector.begin(); iter != object_vector.end();
              iter++) {
@@ -1142,10 +1251,10 @@ Term *Cell::getTerm(std::string name) {
 
 Bus *Cell::getBus(std::string name) {
     if (getBuses() == 0) return nullptr;
-    SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
+    SymbolIndex symbol_index = __findSymbol(name);
     if (symbol_index == kInvalidSymbolIndex) return nullptr;
 
-    std::vector<ObjectId> &object_vector =
+    const std::vector<ObjectId> &object_vector =
         this->getSymbolTable()->getReferences(symbol_index);
     for (auto iter = object_vector.begin(); iter != object_vector.end();
          iter++) {
@@ -1156,71 +1265,157 @@ Bus *Cell::getBus(std::string name) {
     return nullptr;
 }
 
-Inst *Cell::getInstance(std::string name) {
-    if (getInstances() == 0) return nullptr;
-    SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
-    if (symbol_index == kInvalidSymbolIndex) return nullptr;
+/// @brief symbol index of the name of an object in the name index
+SymbolIndex Cell::__getNameKey(ObjectType type, ObjectId id) {
+    switch (type) {
+        case kObjectTypeInst: {
+            Inst *inst = addr<Inst>(id);
+            return inst ? inst->getNameIndex() : kInvalidSymbolIndex;
+        }
+        case kObjectTypeNet: {
+            Net *net = addr<Net>(id);
+            return net ? net->getNameIndex() : kInvalidSymbolIndex;
+        }
+        case kObjectTypeSpecialNet: {
+            SpecialNet *net = addr<SpecialNet>(id);
+            return net ? net->getNameIndex() : kInvalidSymbolIndex;
+        }
+        case kObjectTypePin: {
+            // IO pins don't keep their symbol index, they are named by
+            // their term.
+            Pin *pin = addr<Pin>(id);
+            if (pin == nullptr || pin->getTerm() == nullptr)
+                return kInvalidSymbolIndex;
+            return getSymbolTable()->isSymbolInTable(pin->getName());
+        }
+        default:
+            return kInvalidSymbolIndex;
+    }
+}
 
-    std::vector<ObjectId> object_vector =
-        this->getSymbolTable()->getReferences(symbol_index);
-    for (auto iter = object_vector.begin(); iter != object_vector.end();
-         iter++) {
-        Inst *target = addr<Inst>(*iter);
-        if (target && (target->getObjectType() == kObjectTypeInst))
-            return target;
+/// @brief get the name index of objects of type, building it on first use
+///
+/// The index isn't saved with the design, so it is built lazily from the
+/// object array after the cell is restored from disk.
+NameIndex *Cell::__getNameIndex(ObjectType type) {
+    StorageUtil *storage_util = getStorageUtil();
+    if (storage_util == nullptr) return nullptr;
+    NameIndex *name_index = storage_util->getNameIndex(type);
+    if (name_index == nullptr || name_index->isBuilt()) return name_index;
+
+    // concurrent lookups may get here together, one of them builds it.
+    std::lock_guard<std::mutex> lock(storage_util->getNameIndexMutex());
+    if (name_index->isBuilt()) return name_index;
+    ArrayObject<ObjectId> *obj_array = nullptr;
+    switch (type) {
+        case kObjectTypeInst:
+            obj_array = getInstanceArray();
+            break;
+        case kObjectTypeNet:
+            obj_array = getNetArray();
+            break;
+        case kObjectTypeSpecialNet:
+            obj_array = getSpecialNetArray();
+            break;
+        case kObjectTypePin:
+            if (getIOPins() != 0) {
+                obj_array = addr<ArrayObject<ObjectId>>(getIOPins());
+            }
+            break;
+        default:
+            break;
+    }
+    if (obj_array != nullptr) {
+        for (auto iter = obj_array->begin(); iter != obj_array->end();
+             ++iter) {
+            SymbolIndex key = __getNameKey(type, *iter);
+            if (key != kInvalidSymbolIndex) name_index->insert(key, *iter);
+        }
     }
+    // mark it last: lookups that see it built see all of the entries.
+    name_index->setBuilt(true);
+    return name_index;
+}
+
+void Cell::buildNameIndexes() {
+    __getNameIndex(kObjectTypeInst);
+    __getNameIndex(kObjectTypeNet);
+    __getNameIndex(kObjectTypeSpecialNet);
+    __getNameIndex(kObjectTypePin);
+    // leaf cells share the indexes of their owner, hierarchical cells
+    // have their own.
+    for (Cell *cell : cells()) {
+        if (cell != nullptr && cell != this && cell->isHierCell()) {
+            cell->buildNameIndexes();
+        }
+    }
+}
 
-    return nullptr;
+/// @brief keep a built name index in sync with a newly added object
+void Cell::__addToNameIndex(ObjectType type, ObjectId id) {
+    StorageUtil *storage_util = getStorageUtil();
+    if (storage_util == nullptr) return;
+    NameIndex *name_index = storage_util->getNameIndex(type);
+    // not built yet: the object will be picked up on first lookup.
+    if (name_index == nullptr || !name_index->isBuilt()) return;
+    SymbolIndex key = __getNameKey(type, id);
+    if (key != kInvalidSymbolIndex) name_index->insert(key, id);
+}
+
+/// @brief keep a built name index in sync with a renamed object
+///
+/// IO pins are named by their terms, they are never renamed.
+///
+/// @param old_key symbol index of the previous name of the object
+void Cell::renameInNameIndex(ObjectType type, SymbolIndex old_key,
+                             ObjectId id) {
+    StorageUtil *storage_util = getStorageUtil();
+    if (storage_util == nullptr) return;
+    NameIndex *name_index = storage_util->getNameIndex(type);
+    // not built yet: the new name will be picked up on first lookup.
+    if (name_index == nullptr || !name_index->isBuilt()) return;
+    if (old_key != kInvalidSymbolIndex && name_index->find(old_key) == id) {
+        name_index->erase(old_key);
+    }
+    SymbolIndex key = __getNameKey(type, id);
+    if (key != kInvalidSymbolIndex) name_index->insert(key, id);
+}
+
+/// @brief find an object of type by name without touching the symbol table
+/// @return object id upon success, otherwise 0.
+ObjectId Cell::__findByName(ObjectType type, const std::string &name) {
+    SymbolTable *symbol_table = getSymbolTable();
+    if (symbol_table == nullptr) return 0;
+    SymbolIndex symbol_index = symbol_table->isSymbolInTable(name);
+    if (symbol_index == kInvalidSymbolIndex) return 0;
+
+    NameIndex *name_index = __getNameIndex(type);
+    if (name_index == nullptr) return 0;
+    ObjectId id = name_index->find(symbol_index);
+    if (id == 0) return 0;
+    Object *target = addr<Object>(id);
+    if (target == nullptr || target->getObjectType() != type) return 0;
+    return id;
+}
+
+Inst *Cell::getInstance(const std::string &name) {
+    if (getInstances() == 0) return nullptr;
+    return addr<Inst>(__findByName(kObjectTypeInst, name));
 }
 
 Pin *Cell::getIOPin(const std::string &name) {
     if (getIOPins() == 0) return nullptr;
-    SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
-    if (symbol_index == kInvalidSymbolIndex) return nullptr;
-
-    std::vector<ObjectId> object_vector =
-        this->getSymbolTable()->getReferences(symbol_index);
-    for (auto iter = object_vector.begin(); iter != object_vector.end();
-         iter++) {
-        Pin *target = addr<Pin>(*iter);
-        if (target && (target->getObjectType() == kObjectTypePin))
-            return target;
-    }
-    return nullptr;
+    return addr<Pin>(__findByName(kObjectTypePin, name));
 }
 
-Net *Cell::getNet(std::string name) {
+Net *Cell::getNet(const std::string &name) {
     if (getNets() == 0) return nullptr;
-
-    SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
-    if (symbol_index == kInvalidSymbolIndex) return nullptr;
-
-    std::vector<ObjectId> object_vector =
-        this->getSymbolTable()->getReferences(symbol_index);
-    for (auto iter = object_vector.begin(); iter != object_vector.end();
-         iter++) {
-        Net *target = addr<Net>(*iter);
-        if (target && (target->getObjectType() == kObjectTypeNet))
-            return target;
-    }
-    return nullptr;
+    return addr<Net>(__findByName(kObjectTypeNet, name));
 }
 
-SpecialNet *Cell::getSpecialNet(std::string name) {
+SpecialNet *Cell::getSpecialNet(const std::string &name) {
     if (getSpecialNets() == 0) return nullptr;
-
-    SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
-    if (symbol_index == kInvalidSymbolIndex) return nullptr;
-
-    std::vector<ObjectId> object_vector =
-        this->getSymbolTable()->getReferences(symbol_index);
-    for (auto iter = object_vector.begin(); iter != object_vector.end();
-         iter++) {
-        SpecialNet *target = addr<SpecialNet>(*iter);
-        if (target && (target->getObjectType() == kObjectTypeSpecialNet))
-            return target;
-    }
-    return nullptr;
+    return addr<SpecialNet>(__findByName(kObjectTypeSpecialNet, name));
 }
 
 Inst *Cell::getInstance(ObjectId obj_id) const { return addr<Inst>(obj_id); }
@@ -1309,10 +1504,10 @@ Group *Cell::getGroup(size_t idx) const {
 
 Group *Cell::getGroup(std::string &name) {
     if (getGroups() == 0) return nullptr;
-    SymbolIndex symbol_index = this->getOrCreateSymbol(name.c_str());
+    SymbolIndex symbol_index = __findSymbol(name);
     if (symbol_index == kInvalidSymbolIndex) return nullptr;
 
-    std::vector<ObjectId> object_vector =
+    const std::vector<ObjectId> &object_vector =
         this->getSymbolTable()->getReferences(symbol_index);
     for (auto iter = object_vector.begin(); iter != object_vector.end();
          iter++) {
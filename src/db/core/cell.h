@@ -29,6 +29,8 @@
 #include "db/tech/tech.h"
 #include "db/util/box.h"
 #include "db/util/geometrys.h"
+#include "db/util/name_index.h"
+#include "db/util/object_range.h"
 #include "db/util/symbol_table.h"
 #include "util/polygon_table.h"
 #include "util/util.h"
@@ -38,6 +40,7 @@ namespace db {
 
 class SpecialNet;
 class StorageUtil;
+class PlacementView;
 
 enum CellClassType {
     kNoClass = 0,
@@ -215,6 +218,7 @@ class HierData : public Object {
     ObjectId getFills() const;
     ObjectId getScanChains() const;
     ObjectId getRegions() const;
+    ObjectId getInstSparseAttrs() const;
 
     // Set object vector:
     void setCells(ObjectId v);
@@ -227,6 +231,7 @@ class HierData : public Object {
     void setFills(ObjectId v);
     void setScanChains(ObjectId v);
     void setRegions(ObjectId v);
+    void setInstSparseAttrs(ObjectId v);
 
   private:
     void __init();
@@ -245,6 +250,7 @@ class HierData : public Object {
     ObjectId fills_;        /// FILLS defined in DEF
     ObjectId scan_chains_;  /// SCANCHAINS defined in DEF
     ObjectId regions_;      /// REGIONS defined in DEF
+    ObjectId inst_sparse_attrs_;  /// optional attributes of instances
 };
 
 /// @brief cell class for cells/stencils in the library
@@ -286,6 +292,9 @@ class Cell : public Object {
     MemPagePool *getPool();
     StorageUtil *getStorageUtil();
     void setStorageUtil(StorageUtil *v);
+    PlacementView *enablePlacementView();
+    void disablePlacementView();
+    PlacementView *getPlacementView();
     void initHierData(StorageUtil *v);
     // void initHierData();
 
@@ -310,13 +319,19 @@ class Cell : public Object {
     Term *getTerm(std::string name);
 
     Bus *getBus(std::string name);
-    Net *getNet(std::string name);
-    Inst *getInstance(std::string name);
-    SpecialNet *getSpecialNet(std::string name);
+    Net *getNet(const std::string &name);
+    Inst *getInstance(const std::string &name);
+    SpecialNet *getSpecialNet(const std::string &name);
     Pin *getPin(std::string name);
     Pin *getIOPin(const std::string &name);
     Pin *getVPin(const std::string &name);
     Group *getGroup(std::string &name);
+    /// @brief build the lazy name indexes of this cell and of its
+    /// hierarchical cells now, so that the name lookups above only read
+    /// afterwards, e.g. before a frozen traversal.
+    void buildNameIndexes();
+    /// @brief called by setName of objects in the name indexes
+    void renameInNameIndex(ObjectType type, SymbolIndex old_key, ObjectId id);
 
     // Get object vector:
     ObjectId getInstances() const;
@@ -339,6 +354,21 @@ class Cell : public Object {
     ArrayObject<ObjectId> *getSpecialNetArray() const;
     ArrayObject<ObjectId> *getGroupArray() const;
 
+    // Typed ranges, e.g. for (Inst *inst : cell->insts()):
+    ObjectRange<Cell> cells() const {
+        return ObjectRange<Cell>(getCellArray());
+    }
+    ObjectRange<Inst> insts() const {
+        return ObjectRange<Inst>(getInstanceArray());
+    }
+    ObjectRange<Term> terms() const {
+        return ObjectRange<Term>(getTermArray());
+    }
+    ObjectRange<Net> nets() const { return ObjectRange<Net>(getNetArray()); }
+    ObjectRange<SpecialNet> specialNets() const {
+        return ObjectRange<SpecialNet>(getSpecialNetArray());
+    }
+
     // Get object by index/ID:
     Pin *getIOPinById(ObjectId obj_id);        // TODO: to be removed.
     Inst *getInstance(ObjectId obj_id) const;  // TODO: to be removed.
@@ -359,6 +389,8 @@ class Cell : public Object {
     void addNet(ObjectId id);
     void addSpecialNet(ObjectId id);
     void addInstance(ObjectId id);
+    UInt32 addInstSparseAttr();
+    InstSparseAttr *getInstSparseAttr(UInt32 index) const;
     void addIOPin(ObjectId id);
     void addVPin(ObjectId id);
     void addGroup(ObjectId sp);
@@ -480,6 +512,11 @@ class Cell : public Object {
     void __init();
     const HierData *__getConstHierData() const;
     HierData *__getHierData();
+    NameIndex *__getNameIndex(ObjectType type);
+    SymbolIndex __getNameKey(ObjectType type, ObjectId id);
+    void __addToNameIndex(ObjectType type, ObjectId id);
+    ObjectId __findByName(ObjectType type, const std::string &name);
+    SymbolIndex __findSymbol(const std::string &name);
     //void __initHierData();
 
     SymbolIndex name_index_;  ///< cell name
@@ -524,6 +561,13 @@ template <class T>
 T *Cell::createObject(ObjectType type) {
     assert(type > kObjectTypeNone && type < kObjectTypeMax);
 
+    if (isDBFrozen()) {
+        message->issueMsg(kError,
+                          "Cannot create object for type %d because the "
+                          "database is frozen.\n",
+                          type);
+        return nullptr;
+    }
     T *obj = nullptr;
     ObjectId id;
     MemPagePool *pool = getPool();
@@ -555,6 +599,13 @@ void Cell::deleteObject(T *obj) {
 
     if (obj->getId()) {
         ObjectType type = obj->getObjectType();
+        if (isDBFrozen()) {
+            message->issueMsg(kError,
+                              "Cannot delete object for type %d because the "
+                              "database is frozen.\n",
+                              type);
+            return;
+        }
         MemPagePool *pool = getPool();
 
         if (!pool) {
@@ -10,6 +10,9 @@
  */
 
 #include "db/core/db.h"
+
+#include <atomic>
+
 #include "db/core/root.h"
 #include "db/util/symbol_table.h"
 #include "util/polygon_table.h"
@@ -26,6 +29,7 @@ static Cell *kTopCell = nullptr;
 static bool kIsTopCellInitialized = false;
 static Version kCurrentVersion;
 static Root &kRoot = Root::getInstance();
+static std::atomic<int> kFrozenCount(0);
 
 /// @brief resetTopCell: 
 //    Note currently the root is also reset. might be changed someday.
@@ -129,7 +133,7 @@ Cell *getCell() {
 ///
 /// @return
 Box *creatBox() {
-    Box *box = getCell()->createObject<Box>(kObjectTypeBox);
+    BoxObject *box = getCell()->createObject<BoxObject>(kObjectTypeBox);
     return box;
 }
 
@@ -137,7 +141,7 @@ Box *creatBox() {
 ///
 /// @return
 Box *creatBox(int llx, int lly, int urx, int ury) {
-    Box *box = getCell()->createObject<Box>(kObjectTypeBox);
+    BoxObject *box = getCell()->createObject<BoxObject>(kObjectTypeBox);
     box->setLLX(llx);
     box->setLLY(lly);
     box->setURX(urx);
@@ -146,5 +150,30 @@ Box *creatBox(int llx, int lly, int urx, int ury) {
     return box;
 }
 
+/// @brief  freezeDB
+void freezeDB() {
+    // build the lazy indexes now, readers must not build them.
+    if (kFrozenCount.load(std::memory_order_acquire) == 0 && kTopCell) {
+        kTopCell->buildNameIndexes();
+    }
+    kFrozenCount.fetch_add(1, std::memory_order_acq_rel);
+}
+
+/// @brief  unfreezeDB
+void unfreezeDB() {
+    int count = kFrozenCount.fetch_sub(1, std::memory_order_acq_rel);
+    if (count <= 0) {
+        kFrozenCount.fetch_add(1, std::memory_order_acq_rel);
+        message->issueMsg(kError, "unfreezeDB without freezeDB.\n");
+    }
+}
+
+/// @brief  isDBFrozen
+///
+/// @return true if the database is frozen
+bool isDBFrozen() {
+    return kFrozenCount.load(std::memory_order_acquire) > 0;
+}
+
 }  // namespace db
 }  // namespace open_edi
@@ -46,6 +46,33 @@ Cell* getCell();
 Box* creatBox();
 Box* creatBox(int llx, int lly, int urx, int ury);
 
+/// @brief freeze the database for read only traversals
+///
+/// While the database is frozen, objects can't be created or deleted and
+/// the name indexes of the top cell and of its hierarchical cells are
+/// built, so that the const getters, the name lookups (getInstance,
+/// getNet, getTerm, getCell ...), typed ranges, ArrayObject reads and
+/// Object::addr only read shared data. They
+/// may then be called from any number of threads at the same time, e.g.
+/// inside util::parallelFor. Setters are not checked: callers must not
+/// modify objects while the database is frozen.
+///
+/// freezeDB and unfreezeDB are called by the thread owning the database,
+/// outside of parallel regions. Calls nest.
+void freezeDB();
+void unfreezeDB();
+bool isDBFrozen();
+
+/// @brief keep the database frozen for the lifetime of the scope
+class FrozenDBScope {
+  public:
+    FrozenDBScope() { freezeDB(); }
+    ~FrozenDBScope() { unfreezeDB(); }
+
+    FrozenDBScope(const FrozenDBScope &) = delete;
+    FrozenDBScope &operator=(const FrozenDBScope &) = delete;
+};
+
 using Version = open_edi::util::Version;
 Version& getCurrentVersion();
 void setCurrentVersion(Version& v);
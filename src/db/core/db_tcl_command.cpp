@@ -13,6 +13,7 @@
 #include "db/core/db_tcl_command.h"
 
 #include <gperftools/profiler.h>
+#include <cstring>
 
 #include "db/core/db.h"
 #include "db/io/read_def.h"
@@ -23,6 +24,7 @@
 #include "db/io/write_lef.h"
 #include "db/io/write_verilog.h"
 #include "db/timing/timinglib/timinglib_tcl_command.h"
+#include "db/util/design_stats.h"
 #include "db/timing/spef/spef_tcl_command.h"
 #include "util/util.h"
 #include "infra/command_manager.h"
@@ -71,15 +73,74 @@ static int writeVerilogCommand(ClientData cld, Tcl_Interp *itp, int argc, const
     return util::runCommandWithProcessBar(writeVerilog, argc, argv);
 }
 
+// size of the thread pool shared by parallel commands
+static int setNumThreadsCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]) {
+    util::ThreadPool &pool = util::ThreadPool::getInstance();
+    if (argc > 2) {
+        message->issueMsg(kError, "Usage: set_num_threads [<num>]\n");
+        return TCL_ERROR;
+    }
+    if (argc == 2) {
+        int num_threads = atoi(argv[1]);
+        if (num_threads < 0) {
+            message->issueMsg(kError, "Invalid thread number %s.\n", argv[1]);
+            return TCL_ERROR;
+        }
+        // 0 for one thread per core.
+        pool.setNumThreads(num_threads);
+    }
+    message->info("Parallel commands run on %d threads.\n", pool.getNumThreads());
+    return TCL_OK;
+}
+
+// statistics of the top cell, gathered on the thread pool
+static int reportDesignStatsCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]) {
+    if (argc != 1) {
+        message->issueMsg(kError, "Usage: report_design_stats\n");
+        return TCL_ERROR;
+    }
+    DesignStats stats;
+    if (!getDesignStats(getTopCell(), &stats)) {
+        message->issueMsg(kError, "Failed to get top cell.\n");
+        return TCL_ERROR;
+    }
+    message->info("Instances:         %ld\n", stats.num_insts);
+    message->info("Placed instances:  %ld\n", stats.num_placed_insts);
+    message->info("Instance area:     %ld\n", stats.inst_area);
+    message->info("Nets:              %ld\n", stats.num_nets);
+    message->info("Net pins:          %ld\n", stats.num_net_pins);
+    message->info("Max fanout:        %ld\n", stats.max_fanout);
+    message->info("HPWL:              %ld\n", stats.hpwl);
+    message->info("Special nets:      %ld\n", stats.num_special_nets);
+    return TCL_OK;
+}
+
 // read db from disk
 enum readWriteDBArgument { kRWDBDBFile = 1, kRWDBDebug = 2, kRWDBUnknown };
 
 static int readDBCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]) {
     std::string cell_name;
     bool debug = false;
+    bool use_mmap = false;
+    bool verify = false;
+    int num_threads = 1;
 
+    // flags can appear anywhere, the rest are positional.
+    int pos = 0;
     for (int i = 1; i < argc; ++i) {
-        switch (i) {
+        if (strcmp(argv[i], "-mmap") == 0) {
+            use_mmap = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-verify") == 0) {
+            verify = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+            continue;
+        }
+        switch (++pos) {
             case kRWDBDBFile:
                 cell_name = argv[i];
                 break;
@@ -95,6 +156,9 @@ static int readDBCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *
     ReadDesign read_design(cell_name);
     read_design.setTop();
     read_design.setDebug(debug);
+    read_design.setMmap(use_mmap);
+    read_design.setVerify(verify);
+    read_design.setNumThreads(num_threads);
     return read_design.run();
 }
 // end of read_design
@@ -103,9 +167,21 @@ static int readDBCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *
 static int writeDBCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]) {
     std::string cell_name;
     bool debug = false;
+    bool compress = false;
+    int num_threads = 1;
 
+    // flags can appear anywhere, the rest are positional.
+    int pos = 0;
     for (int i = 1; i < argc; ++i) {
-        switch (i) {
+        if (strcmp(argv[i], "-compress") == 0) {
+            compress = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+            continue;
+        }
+        switch (++pos) {
             case kRWDBDBFile:
                 cell_name = argv[i];
                 break;
@@ -130,6 +206,8 @@ static int writeDBCommand(ClientData cld, Tcl_Interp *itp, int argc, const char
     }
     WriteDesign write_design(cell_name);
     write_design.setDebug(debug);
+    write_design.setCompress(compress);
+    write_design.setNumThreads(num_threads);
     return write_design.run();
 }
 // end of write_design
@@ -449,8 +527,12 @@ void registerDatabaseTclCommands(Tcl_Interp *itp) {
     Tcl_CreateCommand(itp, "set_analysis_view_status", setAnalysisViewStatusCommand, NULL, NULL);
     Tcl_CreateCommand(itp, "read_spef", readSpefCommand, NULL, NULL);
     Tcl_CreateCommand(itp, "write_spef", writeSpefCommand, NULL, NULL);
+    Tcl_CreateCommand(itp, "read_parasitics_cache", readParasiticsCacheCommand, NULL, NULL);
+    Tcl_CreateCommand(itp, "write_parasitics_cache", writeParasiticsCacheCommand, NULL, NULL);
     Tcl_CreateCommand(itp, "read_design", readDBCommand, NULL, NULL);
     Tcl_CreateCommand(itp, "write_design", writeDBCommand, NULL, NULL);
+    Tcl_CreateCommand(itp, "set_num_threads", setNumThreadsCommand, NULL, NULL);
+    Tcl_CreateCommand(itp, "report_design_stats", reportDesignStatsCommand, NULL, NULL);
     // testing commands. TODO: remove them.
     Tcl_CreateCommand(itp, "__create_cell", createCellCommand, NULL, NULL);
     Tcl_CreateCommand(itp, "__report_cell", reportCellCommand, NULL, NULL);
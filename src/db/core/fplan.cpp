@@ -1065,7 +1065,7 @@ std::string Constraint::componentName() const { return component_name_; }
 
 Box *Constraint::createBox(int64_t xl, int64_t yl, int64_t xh, int64_t yh) {
     Cell *top_cell = getOwnerCell();
-    Box *box = top_cell->createObject<Box>(kObjectTypeBox);
+    BoxObject *box = top_cell->createObject<BoxObject>(kObjectTypeBox);
     if (!box) {
         message->issueMsg(kError, "create box failed.\n");
         return nullptr;
@@ -1155,7 +1155,7 @@ void Constraint::printBlockage() const {
         IdArray *box_vector = addr<IdArray>(boxes_id_);
         uint32_t num_boxes = box_vector->getSize();
         for (int i = 0; i < num_boxes; ++i) {
-            Box *box = addr<Box>((*box_vector)[i]);
+            Box *box = addr<BoxObject>((*box_vector)[i]);
             if (!box) {
                 continue;
             }
@@ -1239,7 +1239,7 @@ void Constraint::printBlockage(FILE *fp) const {
         IdArray *box_vector = addr<IdArray>(boxes_id_);
         uint32_t num_boxes = box_vector->getSize();
         for (int i = 0; i < num_boxes; ++i) {
-            Box *box = addr<Box>((*box_vector)[i]);
+            Box *box = addr<BoxObject>((*box_vector)[i]);
             if (!box) {
                 continue;
             }
@@ -1311,7 +1311,7 @@ void Constraint::printRegion(FILE *fp) {
         IdArray *box_vector = addr<IdArray>(boxes_id_);
         uint32_t num_boxes = box_vector->getSize();
         for (int i = 0; i < num_boxes; ++i) {
-            Box *box = addr<Box>((*box_vector)[i]);
+            Box *box = addr<BoxObject>((*box_vector)[i]);
             if (!box) {
                 continue;
             }
@@ -18,6 +18,7 @@
 #include "db/core/cell.h"
 #include "db/core/db.h"
 #include "db/core/pin.h"
+#include "db/core/placement_view.h"
 #include "db/util/array.h"
 #include "db/util/vector_object_var.h"
 
@@ -41,17 +42,9 @@ Inst::Inst() {
     status_ = PlaceStatus::kUnknown;
     location_ = Point(0, 0);
     orient_ = Orient::kUnknown;
-    eeq_master_ = 0;
     source_ = kNetlist;
-    for (int i = 0; i < max_layer_num; i++) {
-        mask_shift_[i] = 0;
-    }
-    halo_ = Box(0, 0, 0, 0);
-    route_halo_dist_ = 0;
-    min_layer_id_ = -1;
-    max_layer_id_ = -1;
-    weight_ = 0;
-    region_ = 0;
+    sparse_attr_index_ = 0;
+    properties_id_ = 0;
 }
 
 Inst::Inst(Inst const &rhs) { copy(rhs); }
@@ -138,8 +131,13 @@ Box Inst::getBox() {
 }
 
 void Inst::setName(std::string name) {
+    SymbolIndex old_index = name_index_;
     name_index_ = getOwnerCell()->getOrCreateSymbol(name);
     getOwnerCell()->addSymbolReference(name_index_, this->getId());
+    if (old_index != kInvalidSymbolIndex && old_index != name_index_) {
+        getOwnerCell()->renameInNameIndex(kObjectTypeInst, old_index,
+                                          getId());
+    }
 }
 
 std::string Inst::getName() const {
@@ -148,11 +146,14 @@ std::string Inst::getName() const {
 
 Cell *Inst::getMaster() const { return addr<Cell>(master_); }
 
-void Inst::setMaster(ObjectId master) { master_ = master; }
+void Inst::setMaster(ObjectId master) {
+    master_ = master;
+    __updatePlacementView();
+}
 void Inst::setMaster(const std::string name) {
     Cell *master = getOwnerCell()->getCell(name);
     if (master) {
-        master_ = master->getId();
+        setMaster(master->getId());
     } else {
         message->issueMsg(kError, "cannot find cell %s for instance %s\n",
                           name.c_str(), getName().c_str());
@@ -319,15 +320,33 @@ Pin *Inst::createInstancePinWithoutMaster(std::string &pin_name) {
 
 PlaceStatus Inst::getStatus() const { return status_; }
 
-void Inst::setStatus(const PlaceStatus &s) { status_ = s; }
+void Inst::setStatus(const PlaceStatus &s) {
+    status_ = s;
+    __updatePlacementView();
+}
 
 Point Inst::getLocation() const { return location_; }
 
-void Inst::setLocation(const Point &l) { location_ = l; }
+void Inst::setLocation(const Point &l) {
+    location_ = l;
+    __updatePlacementView();
+}
 
 Orient Inst::getOrient() const { return orient_; }
 
-void Inst::setOrient(const Orient &o) { orient_ = o; }
+void Inst::setOrient(const Orient &o) {
+    orient_ = o;
+    __updatePlacementView();
+}
+
+/// @brief __updatePlacementView keep the placement view of the owner cell
+/// in sync, if it is enabled
+void Inst::__updatePlacementView() const {
+    Cell *owner_cell = getOwnerCell();
+    if (owner_cell == nullptr) return;
+    PlacementView *view = owner_cell->getPlacementView();
+    if (view != nullptr) view->updateInst(this);
+}
 
 SourceType Inst::getSource() const { return source_; }
 
@@ -354,53 +373,114 @@ std::string Inst::getSourceString() const {
 
 void Inst::setSource(const SourceType &s) { source_ = s; }
 
-Cell *Inst::getEeqMaster() const { return addr<Cell>(eeq_master_); }
+/// @brief __getSparseAttr optional attributes in the side table of the
+/// owner cell
+///
+/// @return nullptr if none of them was set
+const InstSparseAttr *Inst::__getSparseAttr() const {
+    if (sparse_attr_index_ == 0) return nullptr;
+    return getOwnerCell()->getInstSparseAttr(sparse_attr_index_ - 1);
+}
+
+/// @brief __getOrCreateSparseAttr get the slot of the instance in the side
+/// table of the owner cell, adding one with default values if needed
+InstSparseAttr *Inst::__getOrCreateSparseAttr() {
+    Cell *owner_cell = getOwnerCell();
+    if (sparse_attr_index_ == 0) {
+        sparse_attr_index_ = owner_cell->addInstSparseAttr() + 1;
+    }
+    return owner_cell->getInstSparseAttr(sparse_attr_index_ - 1);
+}
+
+Cell *Inst::getEeqMaster() const {
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? addr<Cell>(attr->eeq_master) : nullptr;
+}
 
 void Inst::setEeqMaster(const std::string &name) {
     Cell *cell = getOwnerCell()->getCell(name);
     if (cell) {
-        eeq_master_ = cell->getId();
+        __getOrCreateSparseAttr()->eeq_master = cell->getId();
     }
 }
 
 UInt32 Inst::getMaskShift(Int32 layer_id) const {
-    return mask_shift_[layer_id];
+    if (layer_id < 0 || layer_id >= max_layer_num) return 0;
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? attr->mask_shift[layer_id] : 0;
+}
+
+/// @brief setMaskShift of a mask shift layer, see Cell::addMaskShiftLayer
+///
+/// The side table keeps one byte per layer: larger values are rejected.
+void Inst::setMaskShift(UInt32 m, Int32 layer_id) {
+    if (layer_id < 0 || layer_id >= max_layer_num) {
+        message->issueMsg(kError,
+                          "invalid mask shift layer %d for instance %s.\n",
+                          layer_id, getName().c_str());
+        return;
+    }
+    if (m > UINT8_MAX) {
+        message->issueMsg(kError,
+                          "mask shift %u of instance %s is out of range.\n",
+                          m, getName().c_str());
+        return;
+    }
+    __getOrCreateSparseAttr()->mask_shift[layer_id] = m;
 }
 
-void Inst::setMaskShift(UInt32 m, Int32 layer_id) { mask_shift_[layer_id] = m; }
-
-Box Inst::getHalo() const { return halo_; }
+Box Inst::getHalo() const {
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? attr->halo : Box(0, 0, 0, 0);
+}
 
-void Inst::setHalo(const Box &halo) { halo_ = halo; }
+void Inst::setHalo(const Box &halo) { __getOrCreateSparseAttr()->halo = halo; }
 
-UInt32 Inst::getRouteHaloDist() const { return route_halo_dist_; }
+UInt32 Inst::getRouteHaloDist() const {
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? attr->route_halo_dist : 0;
+}
 
-void Inst::setRouteHaloDist(const UInt32 &d) { route_halo_dist_ = d; }
+void Inst::setRouteHaloDist(const UInt32 &d) {
+    __getOrCreateSparseAttr()->route_halo_dist = d;
+}
 
-Int32 Inst::getMinLayerId() const { return min_layer_id_; }
+Int32 Inst::getMinLayerId() const {
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? attr->min_layer_id : -1;
+}
 
 void Inst::setMinLayer(std::string name) {
-    min_layer_id_ =
+    __getOrCreateSparseAttr()->min_layer_id =
         getOwnerCell()->getTechLib()->getLayerLEFIndexByName(name.c_str());
 }
 
-Int32 Inst::getMaxLayerId() const { return max_layer_id_; }
+Int32 Inst::getMaxLayerId() const {
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? attr->max_layer_id : -1;
+}
 
 void Inst::setMaxLayer(std::string name) {
-    max_layer_id_ =
+    __getOrCreateSparseAttr()->max_layer_id =
         getOwnerCell()->getTechLib()->getLayerLEFIndexByName(name.c_str());
 }
 
-Int32 Inst::getWeight() const { return weight_; }
+Int32 Inst::getWeight() const {
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? attr->weight : 0;
+}
 
-void Inst::setWeight(const Int32 &w) { weight_ = w; }
+void Inst::setWeight(const Int32 &w) { __getOrCreateSparseAttr()->weight = w; }
 
-Constraint *Inst::getRegion() const { return addr<Constraint>(region_); }
+Constraint *Inst::getRegion() const {
+    const InstSparseAttr *attr = __getSparseAttr();
+    return attr ? addr<Constraint>(attr->region) : nullptr;
+}
 
 void Inst::setRegion(std::string &name) {
     Constraint *region = getOwnerCell()->getFloorplan()->getRegion(name);
     if (region) {
-        region_ = region->getId();
+        __getOrCreateSparseAttr()->region = region->getId();
     }
 }
 
@@ -449,17 +529,14 @@ void Inst::copy(Inst const &rhs) {
     }
     location_ = rhs.location_;
     orient_ = rhs.orient_;
-    eeq_master_ = rhs.eeq_master_;
     source_ = rhs.source_;
-    for (int i = 0; i < max_layer_num; i++) {
-        mask_shift_[i] = rhs.getMaskShift(i);
-    }
-    halo_ = rhs.halo_;
-    route_halo_dist_ = rhs.route_halo_dist_;
-    min_layer_id_ = rhs.min_layer_id_;
-    max_layer_id_ = rhs.max_layer_id_;
-    weight_ = rhs.weight_;
-    region_ = rhs.region_;
+    // the copy gets a slot of its own in the side table.
+    sparse_attr_index_ = 0;
+    const InstSparseAttr *rhs_attr = rhs.__getSparseAttr();
+    if (rhs_attr != nullptr) {
+        InstSparseAttr attr = *rhs_attr;
+        *__getOrCreateSparseAttr() = attr;
+    }
 }
 
 void Inst::move(Inst &&rhs) {
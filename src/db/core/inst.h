@@ -17,6 +17,7 @@
 #include "db/tech/type_def.h"
 #include "db/util/array.h"
 #include "db/util/box.h"
+#include "db/util/object_range.h"
 #include "util/enums.h"
 #include "util/point.h"
 
@@ -45,6 +46,22 @@ class Constraint;
 
 enum SourceType { kNetlist, kDist, kUser, kTiming };
 
+/// @brief Optional DEF attributes of an instance.
+///
+/// Few instances have any of them, so they are kept out of Inst, in a side
+/// table of the owner cell (see Cell::addInstSparseAttr). An instance gets
+/// a slot the first time one of them is set.
+struct InstSparseAttr {
+    ObjectId eeq_master;                // EEQMASTER macroName
+    ObjectId region;                    // REGION
+    Box halo;                           // HALO
+    UInt32 route_halo_dist;             // haloDist
+    Int32 min_layer_id;                 // minLayer
+    Int32 max_layer_id;                 // maxLayer
+    Int32 weight;                       // WEIGHT
+    uint8_t mask_shift[max_layer_num];  // MASKSHIFT, one digit per layer
+};
+
 class Inst : public Object {
   public:
     Inst();
@@ -71,6 +88,7 @@ class Inst : public Object {
     void setHasProperty(bool flag);
 
     std::string getName() const;
+    SymbolIndex getNameIndex() const { return name_index_; }
     void setName(std::string name);
     Cell *getParent() const;
     void setParent(const std::string name);
@@ -129,6 +147,10 @@ class Inst : public Object {
 
     ArrayObject<ObjectId>* getPinArray() const;
     ArrayObject<ObjectId>* getPGPinArray() const;
+    ObjectRange<Pin> pins() const { return ObjectRange<Pin>(getPinArray()); }
+    ObjectRange<Pin> pgPins() const {
+        return ObjectRange<Pin>(getPGPinArray());
+    }
 
     void clear();
 
@@ -139,9 +161,13 @@ class Inst : public Object {
     void move(Inst &&rhs);
     friend OStreamBase &operator<<(OStreamBase &os, Inst const &rhs);
     friend IStreamBase &operator>>(IStreamBase &is, Inst &rhs);
+    friend class PlacementView;
 
   private:
     ObjectId __createPinArray();
+    void __updatePlacementView() const;
+    const InstSparseAttr *__getSparseAttr() const;
+    InstSparseAttr *__getOrCreateSparseAttr();
     ObjectId __createPropertyArray();
 
     Bits has_eeq_master_ : 1;
@@ -163,15 +189,8 @@ class Inst : public Object {
     PlaceStatus status_;                // instance status
     Point location_;                    // instance location
     Orient orient_;                     // instance orientation
-    ObjectId eeq_master_;               // EEQMASTER macroName
     SourceType source_;                 // SOURCE
-    UInt32 mask_shift_[max_layer_num];  // MASKSHIFT
-    Box halo_;                          // HALO
-    UInt32 route_halo_dist_;            // haloDist
-    Int32 min_layer_id_;                // minLayer
-    Int32 max_layer_id_;                // maxLayer
-    Int32 weight_;                      // WEIGHT
-    ObjectId region_;                   // REGION
+    UInt32 sparse_attr_index_;          // slot + 1 in cell side table, or 0
     ObjectId properties_id_;
 };  // class Inst
 
@@ -465,8 +465,13 @@ bool Net::setName(std::string const& name) {
     SymbolIndex index = getOwnerCell()->getOrCreateSymbol(name.c_str());
     if (index == kInvalidSymbolIndex) return false;
 
+    SymbolIndex old_index = name_index_;
     name_index_ = index;
     getOwnerCell()->addSymbolReference(name_index_, this->getId());
+    if (old_index != kInvalidSymbolIndex && old_index != name_index_) {
+        getOwnerCell()->renameInNameIndex(kObjectTypeNet, old_index,
+                                          getId());
+    }
     return true;
 }
 
@@ -919,6 +924,12 @@ void Net::printDEF(FILE* fp) {
             Pin* pin = nullptr;
             ObjectId id = (*iter);
             if (id) pin = addr<Pin>(id);
+            if (pin && pin->getTerm() == nullptr) {
+                message->issueMsg(kError,
+                                  "the term of a pin of net %s is null.\n",
+                                  getName().c_str());
+                continue;
+            }
             if (pin) {
                 Inst* inst = pin->getInst();
                 if (inst) {
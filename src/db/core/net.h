@@ -17,6 +17,7 @@
 #include "db/core/via.h"
 #include "db/core/wire.h"
 #include "db/tech/layer.h"
+#include "db/util/object_range.h"
 #include "util/enums.h"
 #include "util/point.h"
 
@@ -149,6 +150,7 @@ class Net : public Object {
     void setPropertySize(uint64_t v);
 
     ArrayObject<ObjectId>* getPinArray() const;
+    ObjectRange<Pin> pins() const { return ObjectRange<Pin>(getPinArray()); }
     
     Net* createSubNet(std::string& name);
     VPin* createVpin(std::string& name);
@@ -162,10 +162,17 @@ typedef enum ObjectType {
     kObjectTypeArraySegment,
     kObjectTypeMaxViaStack,
     kObjectTypeAntennaModelTerm,
-    kObjectTypeInternalVectorStarts = 4096,
     kObjectTypeMax
 } ObjectType;
 
+// vector objects are kObjectTypeVector, their pool type is a free list of
+// their size, see Object::__getInternalTypeForVectorObject.
+static_assert(kObjectTypeMax <= MEM_VECTOR_FREE_LIST_BASE,
+              "free lists of object types run into those of vector objects");
+static_assert(MEM_VECTOR_FREE_LIST_BASE + MEM_VECTOR_FREE_LIST_NUM <=
+                  MEM_ARRAY_FREE_LIST_BASE,
+              "free lists of vector objects run into those of array blocks");
+
 /// @brief Base class for all objects.
 
 #define NEW_ARRAY_OBJECT
@@ -181,6 +188,9 @@ class ArrayObject : public std::vector<T> {
 class Cell;
 class StorageUtil;
 
+/// @brief whether the database is frozen, see freezeDB() in db.h.
+bool isDBFrozen();
+
 class Object {
   public:
     using CoordinateType = CoordinateTraits<int32_t>::CoordinateType;
@@ -193,6 +203,12 @@ class Object {
 
     template <class T>
     static T* addr(ObjectId obj_id);
+    /// @brief addr for ids known to be valid and non zero, e.g. in hot
+    /// traversal loops: one frame table load per id and no checks.
+    template <class T>
+    static T* addrUnchecked(ObjectId obj_id) {
+        return reinterpret_cast<T*>(MemPagePool::getAddressUnchecked(obj_id));
+    }
 
     template <class T>
     static T *createObject(ObjectType type, ObjectId owner_id);
@@ -299,9 +315,13 @@ class Object {
     ObjectId owner_;  ///< parent object of this object
 };
 
+/// @brief free list of vector objects of type T, one per aligned size
 template <class T>
 int Object::__getInternalTypeForVectorObject() {
-    int type = kObjectTypeInternalVectorStarts + (sizeof(T) >> 3);
+    static_assert(sizeof(T) <= (MEM_VECTOR_FREE_LIST_NUM << MEM_ALIGN_BIT),
+                  "vector object larger than its free lists");
+    int type = MEM_VECTOR_FREE_LIST_BASE +
+               ((sizeof(T) + (1 << MEM_ALIGN_BIT) - 1) >> MEM_ALIGN_BIT) - 1;
     return type;
 }
 
@@ -351,12 +371,8 @@ T* Object::addr(uint64_t obj_id)
 {
     if (obj_id == 0) return nullptr;
 
-    MemPagePool *pool = MemPool::getPagePoolByObjectId(obj_id);
-    if (pool) {
-        return pool->getObjectPtr<T>(obj_id);
-    } else {
-        return nullptr;
-    }
+    // the frame table of the pool replaces the pool -> page -> frame chain.
+    return reinterpret_cast<T*>(MemPagePool::getAddress(obj_id));
 }
 
 /// @brief createObject create object within memory pool
@@ -365,6 +381,13 @@ template <class T>
 T* Object::createObject(ObjectType type, ObjectId owner_id) {
     assert(type > kObjectTypeNone && type < kObjectTypeMax);
     assert(owner_id != 0);
+    if (isDBFrozen()) {
+        message->issueMsg(kError,
+                          "Cannot create object for type %d because the "
+                          "database is frozen.\n",
+                          type);
+        return nullptr;
+    }
     MemPagePool *pool = getPoolById(owner_id);
 
     if (!pool) {
@@ -395,6 +418,13 @@ void Object::deleteObject(T *obj) {
 
     if (obj->getId()) {
         ObjectType type = obj->getObjectType();
+        if (isDBFrozen()) {
+            message->issueMsg(kError,
+                              "Cannot delete object for type %d because the "
+                              "database is frozen.\n",
+                              type);
+            return;
+        }
         MemPagePool *pool = MemPool::getPagePoolByObjectId(obj->getId());
 
         if (!pool) {
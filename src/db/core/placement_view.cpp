@@ -0,0 +1,140 @@
+/* @file  placement_view.cpp
+ * @date  Oct 2020
+ * @brief Structure-of-arrays view of the placement of instances in a cell.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#include "db/core/placement_view.h"
+
+#include "db/core/cell.h"
+#include "db/core/inst.h"
+
+namespace open_edi {
+namespace db {
+
+const uint64_t PlacementView::kInvalidIndex;
+
+PlacementView::PlacementView(Cell *cell) { __build(cell); }
+
+PlacementView::~PlacementView() {}
+
+/// @brief __build one slot per instance, in the order of the instance array
+void PlacementView::__build(Cell *cell) {
+    ArrayObject<ObjectId> *inst_array = cell->getInstanceArray();
+    if (inst_array == nullptr) return;
+    uint64_t num_insts = inst_array->getSize();
+    ids_.reserve(num_insts);
+    insts_.reserve(num_insts);
+    x_.reserve(num_insts);
+    y_.reserve(num_insts);
+    orient_.reserve(num_insts);
+    status_.reserve(num_insts);
+    width_.reserve(num_insts);
+    height_.reserve(num_insts);
+    index_map_.reserve(num_insts);
+    for (auto iter = inst_array->begin(); iter != inst_array->end(); ++iter) {
+        Inst *inst = Object::addr<Inst>(*iter);
+        if (inst != nullptr) addInst(inst);
+    }
+}
+
+void PlacementView::__fillSlot(uint64_t index, const Inst *inst) {
+    Point location = inst->getLocation();
+    x_[index] = location.getX();
+    y_[index] = location.getY();
+    orient_[index] = inst->getOrient();
+    status_[index] = inst->getStatus();
+    Cell *master = inst->getMaster();
+    if (master != nullptr && master->hasSize()) {
+        width_[index] = master->getSizeX();
+        height_[index] = master->getSizeY();
+    } else {
+        width_[index] = 0;
+        height_[index] = 0;
+    }
+}
+
+uint64_t PlacementView::getIndex(ObjectId id) const {
+    auto iter = index_map_.find(id);
+    if (iter == index_map_.end()) return kInvalidIndex;
+    return iter->second;
+}
+
+void PlacementView::addInst(Inst *inst) {
+    uint64_t index = ids_.size();
+    if (!index_map_.emplace(inst->getId(), index).second) return;
+    ids_.push_back(inst->getId());
+    insts_.push_back(inst);
+    x_.push_back(0);
+    y_.push_back(0);
+    orient_.push_back(Orient::kN);
+    status_.push_back(PlaceStatus::kUnplaced);
+    width_.push_back(0);
+    height_.push_back(0);
+    __fillSlot(index, inst);
+}
+
+void PlacementView::updateInst(const Inst *inst) {
+    uint64_t index = getIndex(inst->getId());
+    if (index != kInvalidIndex) __fillSlot(index, inst);
+}
+
+void PlacementView::getLocations(uint64_t begin, uint64_t num, int *x,
+                                 int *y) const {
+    for (uint64_t i = 0; i < num; ++i) {
+        x[i] = x_[begin + i];
+        y[i] = y_[begin + i];
+    }
+}
+
+/// @brief setLocations write the arrays and the Inst objects
+///
+/// Instances are reached through the cached pointers, and the fields are
+/// set directly, so there is no id lookup per instance.
+void PlacementView::setLocations(uint64_t begin, uint64_t num, const int *x,
+                                 const int *y) {
+    for (uint64_t i = 0; i < num; ++i) {
+        uint64_t index = begin + i;
+        x_[index] = x[i];
+        y_[index] = y[i];
+        insts_[index]->location_ = Point(x[i], y[i]);
+    }
+}
+
+void PlacementView::setLocations(const uint64_t *indexes, uint64_t num,
+                                 const int *x, const int *y) {
+    for (uint64_t i = 0; i < num; ++i) {
+        uint64_t index = indexes[i];
+        if (index == kInvalidIndex) continue;
+        x_[index] = x[i];
+        y_[index] = y[i];
+        insts_[index]->location_ = Point(x[i], y[i]);
+    }
+}
+
+void PlacementView::setOrients(const uint64_t *indexes, uint64_t num,
+                               const Orient *orients) {
+    for (uint64_t i = 0; i < num; ++i) {
+        uint64_t index = indexes[i];
+        if (index == kInvalidIndex) continue;
+        orient_[index] = orients[i];
+        insts_[index]->orient_ = orients[i];
+    }
+}
+
+void PlacementView::setStatus(const uint64_t *indexes, uint64_t num,
+                              PlaceStatus status) {
+    for (uint64_t i = 0; i < num; ++i) {
+        uint64_t index = indexes[i];
+        if (index == kInvalidIndex) continue;
+        status_[index] = status;
+        insts_[index]->status_ = status;
+    }
+}
+
+}  // namespace db
+}  // namespace open_edi
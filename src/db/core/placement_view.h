@@ -0,0 +1,93 @@
+/* @file  placement_view.h
+ * @date  Oct 2020
+ * @brief Structure-of-arrays view of the placement of instances in a cell.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#ifndef SRC_DB_CORE_PLACEMENT_VIEW_H_
+#define SRC_DB_CORE_PLACEMENT_VIEW_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "util/enums.h"
+#include "util/point.h"
+#include "util/util.h"
+
+namespace open_edi {
+namespace db {
+
+using namespace open_edi::util;
+
+class Cell;
+class Inst;
+
+/// @brief Placement of the instances of a cell kept in contiguous arrays.
+///
+/// The view is a runtime object owned by the StorageUtil of the cell, see
+/// Cell::enablePlacementView(). Slot i holds the location, orient, status
+/// and master size of the i-th instance of the cell. Inst::setLocation,
+/// setOrient, setStatus and setMaster update the slot of the instance, and
+/// the bulk setters write through to the Inst objects, so both stay in
+/// sync. The bulk setters skip kInvalidIndex, so indexes may come straight
+/// from getIndex().
+class PlacementView {
+  public:
+    static const uint64_t kInvalidIndex = ~0ULL;
+
+    explicit PlacementView(Cell *cell);
+    ~PlacementView();
+
+    uint64_t getNumInsts() const { return ids_.size(); }
+    /// @brief slot of an instance, kInvalidIndex if not in the view
+    uint64_t getIndex(ObjectId id) const;
+    ObjectId getInstId(uint64_t index) const { return ids_[index]; }
+    Inst *getInst(uint64_t index) const { return insts_[index]; }
+
+    const int *getX() const { return x_.data(); }
+    const int *getY() const { return y_.data(); }
+    const Orient *getOrient() const { return orient_.data(); }
+    const PlaceStatus *getStatus() const { return status_.data(); }
+    const int *getWidth() const { return width_.data(); }
+    const int *getHeight() const { return height_.data(); }
+
+    /// @brief copy locations of num slots from begin into x and y
+    void getLocations(uint64_t begin, uint64_t num, int *x, int *y) const;
+    /// @brief set locations of num slots from begin
+    void setLocations(uint64_t begin, uint64_t num, const int *x,
+                      const int *y);
+    /// @brief set locations of the slots in indexes
+    void setLocations(const uint64_t *indexes, uint64_t num, const int *x,
+                      const int *y);
+    void setOrients(const uint64_t *indexes, uint64_t num,
+                    const Orient *orients);
+    void setStatus(const uint64_t *indexes, uint64_t num, PlaceStatus status);
+
+    /// @brief add a new instance of the cell
+    void addInst(Inst *inst);
+    /// @brief refresh the slot of an instance from the object
+    void updateInst(const Inst *inst);
+
+  private:
+    void __build(Cell *cell);
+    void __fillSlot(uint64_t index, const Inst *inst);
+
+    std::vector<ObjectId> ids_;
+    std::vector<Inst *> insts_;
+    std::vector<int> x_;
+    std::vector<int> y_;
+    std::vector<Orient> orient_;
+    std::vector<PlaceStatus> status_;
+    std::vector<int> width_;
+    std::vector<int> height_;
+    std::unordered_map<ObjectId, uint64_t> index_map_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // SRC_DB_CORE_PLACEMENT_VIEW_H_
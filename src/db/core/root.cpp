@@ -13,6 +13,8 @@
 #include "db/core/cell.h"
 #include "db/tech/tech.h"
 #include "db/core/timing.h"
+#include "db/timing/spef/nets_parasitics.h"
+#include "db/timing/timinglib/libset.h"
 
 #include "db/util/symbol_table.h"
 #include "util/polygon_table.h"
@@ -101,6 +103,12 @@ Tech* Root::getTechLib() const {
 
 void Root::setTimingLib(Timing *v) {
     if (timing_ != nullptr) {
+        // lazy SPEF loaders point into the parasitics of the old lib, the
+        // table storages into its tables, split RC networks are keyed by
+        // its ids.
+        NetsParasitics::resetLazyLoaders();
+        DNetParasitics::resetSplitRcNetworks();
+        LibSet::resetTableStorages();
         Object::deleteObject<Timing>(timing_);
     }
     timing_ = v;
@@ -123,15 +131,19 @@ Cell* Root::getTopCell() const {
 
 // Class StorageUtil (runtime object):
 StorageUtil::StorageUtil() : 
-  pool_(nullptr), symtbl_(nullptr), polytbl_(nullptr) {}
+  pool_(nullptr), symtbl_(nullptr), polytbl_(nullptr),
+  placement_view_(nullptr) {}
 
-StorageUtil::StorageUtil(uint64_t cell_id) {
+StorageUtil::StorageUtil(uint64_t cell_id) : placement_view_(nullptr) {
     initPool(cell_id);
     initSymbolTable();
     initPolygonTable();
 }
 
 StorageUtil::~StorageUtil() {
+    if (placement_view_ != nullptr) {
+        delete placement_view_;
+    }
     if (polytbl_ != nullptr) {
         delete polytbl_;
     }
@@ -190,5 +202,37 @@ MemPagePool *StorageUtil::getPool() const {
     return pool_;
 }
 
+/// @brief getNameIndex name lookup of objects owned by the cell
+///
+/// @param type kObjectTypeInst, kObjectTypeNet, kObjectTypeSpecialNet or
+///        kObjectTypePin (IO pins)
+///
+/// @return nullptr for other types
+NameIndex *StorageUtil::getNameIndex(ObjectType type) {
+    switch (type) {
+        case kObjectTypeInst:
+            return &name_indexes_[kNameIndexInst];
+        case kObjectTypeNet:
+            return &name_indexes_[kNameIndexNet];
+        case kObjectTypeSpecialNet:
+            return &name_indexes_[kNameIndexSpecialNet];
+        case kObjectTypePin:
+            return &name_indexes_[kNameIndexIOPin];
+        default:
+            return nullptr;
+    }
+}
+
+void StorageUtil::setPlacementView(PlacementView *v) {
+    if (placement_view_ != nullptr) {
+        delete placement_view_;
+    }
+    placement_view_ = v;
+}
+
+PlacementView *StorageUtil::getPlacementView() const {
+    return placement_view_;
+}
+
 }  // namespace db
 }  // namespace open_edi
@@ -12,12 +12,15 @@
 #ifndef SRC_DB_CORE_ROOT_H_
 #define SRC_DB_CORE_ROOT_H_
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include "db/core/cell.h"
 #include "db/tech/tech.h"
 #include "db/core/timing.h"
 
+#include "db/core/placement_view.h"
+#include "db/util/name_index.h"
 #include "db/util/symbol_table.h"
 #include "util/polygon_table.h"
 #include "util/util.h"
@@ -70,11 +73,27 @@ class StorageUtil {
     PolygonTable *getPolygonTable() const;
     void setPool(MemPagePool *p);
     MemPagePool *getPool() const;
+    NameIndex *getNameIndex(ObjectType type);
+    /// @brief serializes building the name indexes on first lookup
+    std::mutex &getNameIndexMutex() { return name_index_mutex_; }
+    void setPlacementView(PlacementView *v);
+    PlacementView *getPlacementView() const;
 
   private:
+    enum NameIndexType {
+        kNameIndexInst = 0,
+        kNameIndexNet,
+        kNameIndexSpecialNet,
+        kNameIndexIOPin,
+        kNameIndexMax
+    };
+
     MemPagePool *pool_;  ///< use the memory pool to allocate object
     SymbolTable *symtbl_;
     PolygonTable *polytbl_;
+    NameIndex name_indexes_[kNameIndexMax];  ///< runtime, built on demand
+    std::mutex name_index_mutex_;
+    PlacementView *placement_view_;  ///< runtime, nullptr unless enabled
 };
 
 }  // namespace db
@@ -229,8 +229,13 @@ bool SpecialNet::setName(std::string const& name) {
     int64_t index = getTopCell()->getOrCreateSymbol(name.c_str());
     if (index == kInvalidSymbolIndex) return false;
 
+    SymbolIndex old_index = name_index_;
     name_index_ = index;
     getTopCell()->addSymbolReference(name_index_, this->getId());
+    if (old_index != kInvalidSymbolIndex && old_index != name_index_) {
+        getTopCell()->renameInNameIndex(kObjectTypeSpecialNet, old_index,
+                                        getId());
+    }
     return true;
 }
 
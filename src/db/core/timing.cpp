@@ -67,6 +67,17 @@ SymbolIndex Timing::getOrCreateSymbol(std::string &name) {
     return getOrCreateSymbol(name.c_str());
 }
 
+/// @brief isSymbolInTable
+/// @param name
+/// @return
+SymbolIndex Timing::isSymbolInTable(const std::string &name) {
+    SymbolTable *sym_table = getSymbolTable();
+    if (sym_table == nullptr) {
+        return kInvalidSymbolIndex;
+    }
+    return sym_table->isSymbolInTable(SymbolName(name.data(), name.size()));
+}
+
 /// @brief addSymbolReference
 /// @param index
 /// @param owner
@@ -52,6 +52,9 @@ class Timing : public Object {
     std::string &getSymbolByIndex(SymbolIndex index);
     SymbolIndex getOrCreateSymbol(const char *name);
     SymbolIndex getOrCreateSymbol(std::string &name);
+    /// @brief symbol index of name, kInvalidSymbolIndex if there is none.
+    /// Never inserts, for queries.
+    SymbolIndex isSymbolInTable(const std::string &name);
     bool addSymbolReference(SymbolIndex index, ObjectId owner);
 
     // timinglib
@@ -14,6 +14,7 @@
 #include <string.h>
 #include <time.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,8 @@ static int isSessionless = 0;
 static int ignoreRowNames = 0;
 static int ignoreViaNames = 0;
 static std::string current_net_name = "";
+// set while a file is read with parallel COMPONENTS and NETS import
+static DefParallelReader* parallel_reader = nullptr;
 
 static std::vector<char*> kGroupCompNamePatterns;
 static void saveGroupMember(char* name);
@@ -79,6 +82,19 @@ static void readProperties(PropType prop_type, void* from, void* to) {
     }
 }
 
+/// @brief commit staged records ahead of the next serial one
+static void commitStagedComponents() {
+    while (DefStagedComponent* co = parallel_reader->nextComponent()) {
+        readComp(co);
+    }
+}
+
+static void commitStagedNets() {
+    while (DefStagedNet* io_net = parallel_reader->nextNet()) {
+        readNet(io_net);
+    }
+}
+
 void myLogFunction(const char* errMsg) {
     fprintf(fout, "ERROR: found error: %s\n", errMsg);
 }
@@ -109,6 +125,15 @@ int done(defrCallbackType_e c, void*, defiUserData ud) {
 int endfunc(defrCallbackType_e c, void*, defiUserData ud) {
     checkType(c);
     if (ud != userData) dataError();
+    if (parallel_reader) {
+        if (c == defrComponentEndCbkType) {
+            commitStagedComponents();
+            parallel_reader->endSection(DefParallelReader::kComponents);
+        } else if (c == defrNetEndCbkType) {
+            commitStagedNets();
+            parallel_reader->endSection(DefParallelReader::kNets);
+        }
+    }
     return 0;
 }
 
@@ -150,6 +175,10 @@ int compf(defrCallbackType_e c, defiComponent* co, defiUserData ud) {
 
     checkType(c);
     if (ud != userData) dataError();
+    if (parallel_reader) {
+        commitStagedComponents();
+        parallel_reader->skipSerialRecord();
+    }
     readComp(co);
 
     --numObjs;
@@ -192,6 +221,10 @@ int netf(defrCallbackType_e c, defiNet* net, defiUserData ud) {
     checkType(c);
     if (ud != userData) dataError();
 
+    if (parallel_reader) {
+        commitStagedNets();
+        parallel_reader->skipSerialRecord();
+    }
     readNet(net);
     --numObjs;
 
@@ -302,6 +335,13 @@ int cs(defrCallbackType_e c, int num, defiUserData ud) {
 
     if (ud != userData) dataError();
 
+    if (parallel_reader) {
+        if (c == defrComponentStartCbkType) {
+            parallel_reader->beginSection(DefParallelReader::kComponents);
+        } else if (c == defrNetStartCbkType) {
+            parallel_reader->beginSection(DefParallelReader::kNets);
+        }
+    }
     numObjs = num;
     return 0;
 }
@@ -661,6 +701,7 @@ int readDef(int argc, const char** argv) {
     int fileCt = 0;
     int noNetCb = 0;
     int line_num_print_interval = 50;
+    int num_threads = 1;
 
 #if (defined WIN32 && _MSC_VER < 1800)
     // Enable two-digit exponent format
@@ -707,6 +748,10 @@ int readDef(int argc, const char** argv) {
             argv++;
             argc--;
             line_num_print_interval = atoi(*argv);
+        } else if (strcmp(*argv, "-threads") == 0) {
+            argv++;
+            argc--;
+            num_threads = atoi(*argv);
         } else if (argv[0][0] != '-') {
             if (numInFile >= 6) {
                 fprintf(stderr, "ERROR: too many input files, max = 6.\n");
@@ -729,6 +774,9 @@ int readDef(int argc, const char** argv) {
                     "\t-nc            -- no functional callbacks will be "
                     "called.\n");
             fprintf(stderr, "\t-o <out_file>  -- write output to the file.\n");
+            fprintf(stderr,
+                    "\t-threads <num> -- parse COMPONENTS and NETS on <num> "
+                    "threads.\n");
             fprintf(stderr, "\t-ignoreRowNames   -- don't output row names.\n");
             fprintf(stderr, "\t-ignoreViaNames   -- don't output via names.\n");
             return 2;
@@ -928,8 +976,32 @@ int readDef(int argc, const char** argv) {
         // in History & PropertyDefinition
         // reset it to 1.
 
+        // COMPONENTS and NETS are parsed ahead on worker threads, this
+        // needs the callbacks that commit them.
+        std::unique_ptr<DefParallelReader> reader;
+        if (num_threads > 1 && noCalls == 0 && f != stdin) {
+            reader.reset(new DefParallelReader(num_threads));
+            if (reader->open(inFile[fileCt])) {
+                parallel_reader = reader.get();
+                DefParallelReader::setActive(parallel_reader);
+                defrSetReadFunction(DefParallelReader::read);
+            } else {
+                reader.reset();
+            }
+        }
+
         res = defrRead(f, inFile[fileCt], userData, 1);
 
+        if (reader) {
+            defrUnsetReadFunction();
+            DefParallelReader::setActive(nullptr);
+            parallel_reader = nullptr;
+            message->info("Parsed %lu records on %d threads, %lu serially.\n",
+                          reader->getNumStaged(), num_threads,
+                          reader->getNumSerial());
+            reader.reset();
+        }
+
         if (res) fprintf(stderr, "Reader returns bad status.\n");
 
         // Testing the aliases API.
@@ -1880,30 +1952,11 @@ int readSpecialNet(defiNet* io_net) {
     return 0;
 }
 
-int readNet(defiNet* io_net) {
-    int i, j, k, w, x, y, z, count, newLayer;
-    defiPath* p;
-    defiSubnet* s;
-    int path;
-    defiVpin* io_vpin;
-    defiWire* wire;
-    Net* net;
-    VPin* v_pin;
-    Point* loc;
-    Box* bbox;
+/// @brief pins of a net, from a defiNet or a staged record
+template <class T>
+static void readNetConnections(T* io_net, Net* net) {
     Cell* top_cell = getTopCell();
-    Tech* lib = top_cell->getTechLib();
-
-    net = top_cell->createNet(current_net_name);
-    if (net == 0) {
-        return -1;
-    }
-    net->setCell(top_cell->getId());
-
-    if (io_net->pinIsMustJoin(0)) net->setMustJoin(1);
-
-    // set pin
-    for (i = 0; i < io_net->numConnections(); i++) {
+    for (int i = 0; i < io_net->numConnections(); i++) {
         Pin* pin = nullptr;
         std::string inst_name = io_net->instance(i);
 
@@ -1923,6 +1976,59 @@ int readNet(defiNet* io_net) {
             pin->setNet(net);
         }
     }
+}
+
+template <class T>
+static void readNetNonDefaultRule(T* io_net, Net* net) {
+    if (io_net->hasNonDefaultRule()) {
+        Tech* lib = getTopCell()->getTechLib();
+        std::string rule_name = io_net->nonDefaultRule();
+        net->setNonDefaultRule(
+            lib->getNonDefaultRuleIdByName(rule_name.c_str()));
+    }
+}
+
+template <class T>
+static void readNetAttributes(T* io_net, Net* net) {
+    if (io_net->hasUse()) {
+        NetType type = getNetType(io_net->use());
+        net->setType(type);
+    }
+    if (io_net->hasSource()) {
+        int source = getSourceStatus(io_net->source());
+        net->setSource(source);
+    }
+
+    if (io_net->hasXTalk()) net->setXtalk(io_net->XTalk());
+    if (io_net->hasFixedbump()) net->setFixBump(1);
+    if (io_net->hasFrequency()) {
+        net->setFrequency(static_cast<int>(io_net->frequency()));
+    }
+    if (io_net->hasOriginal()) net->setOriginNet(io_net->original());
+    if (io_net->hasPattern()) net->setPattern(getNetPattern(io_net->pattern()));
+    if (io_net->hasCap()) net->setCapacitance(io_net->cap());
+    if (io_net->hasWeight()) net->setWeight(io_net->weight());
+}
+
+int readNet(defiNet* io_net) {
+    int i;
+    defiVpin* io_vpin;
+    defiWire* wire;
+    Net* net;
+    VPin* v_pin;
+    Point* loc;
+    Cell* top_cell = getTopCell();
+
+    net = top_cell->createNet(current_net_name);
+    if (net == 0) {
+        return -1;
+    }
+    net->setCell(top_cell->getId());
+
+    if (io_net->pinIsMustJoin(0)) net->setMustJoin(1);
+
+    // set pin
+    readNetConnections(io_net, net);
 
     // regularWiring
     if (io_net->numWires()) {
@@ -1936,11 +2042,7 @@ int readNet(defiNet* io_net) {
     readSubNet(io_net, net);
 
     // NDR
-    if (io_net->hasNonDefaultRule()) {
-        std::string rule_name = io_net->nonDefaultRule();
-        net->setNonDefaultRule(
-            lib->getNonDefaultRuleIdByName(rule_name.c_str()));
-    }
+    readNetNonDefaultRule(io_net, net);
 
     // VPin
     for (i = 0; i < io_net->numVpins(); i++) {
@@ -1951,9 +2053,8 @@ int readNet(defiNet* io_net) {
             v_pin->setHasLayer(true);
             v_pin->setLayer(const_cast<char*>(io_vpin->layer()));
         }
-        bbox = creatBox(io_vpin->xl(), io_vpin->yl(), io_vpin->xh(),
-                        io_vpin->yh());
-        v_pin->setBox(*bbox);
+        Box bbox(io_vpin->xl(), io_vpin->yl(), io_vpin->xh(), io_vpin->yh());
+        v_pin->setBox(bbox);
 
         if (io_vpin->status() != ' ') {
             int status = getVPinRouteStatus(io_vpin->status());
@@ -1968,24 +2069,7 @@ int readNet(defiNet* io_net) {
         net->addVPin(v_pin);
     }
 
-    if (io_net->hasUse()) {
-        NetType type = getNetType(io_net->use());
-        net->setType(type);
-    }
-    if (io_net->hasSource()) {
-        int source = getSourceStatus(io_net->source());
-        net->setSource(source);
-    }
-
-    if (io_net->hasXTalk()) net->setXtalk(io_net->XTalk());
-    if (io_net->hasFixedbump()) net->setFixBump(1);
-    if (io_net->hasFrequency()) {
-        net->setFrequency(static_cast<int>(io_net->frequency()));
-    }
-    if (io_net->hasOriginal()) net->setOriginNet(io_net->original());
-    if (io_net->hasPattern()) net->setPattern(getNetPattern(io_net->pattern()));
-    if (io_net->hasCap()) net->setCapacitance(io_net->cap());
-    if (io_net->hasWeight()) net->setWeight(io_net->weight());
+    readNetAttributes(io_net, net);
 
     readProperties<defiNet, Net>(PropType::kNet,
                                  reinterpret_cast<void*>(io_net),
@@ -1994,6 +2078,22 @@ int readNet(defiNet* io_net) {
     return 0;
 }
 
+/// @brief net staged by the parallel reader, it has no routing.
+int readNet(DefStagedNet* io_net) {
+    Cell* top_cell = getTopCell();
+    std::string net_name(io_net->name());
+    Net* net = top_cell->createNet(net_name);
+    if (net == 0) {
+        return -1;
+    }
+    net->setCell(top_cell->getId());
+
+    readNetConnections(io_net, net);
+    readNetNonDefaultRule(io_net, net);
+    readNetAttributes(io_net, net);
+    return 0;
+}
+
 int readFill(defiFill* io_fill) {
     Cell* top_cell = getTopCell();
     Tech* lib = top_cell->getTechLib();
@@ -2420,12 +2520,14 @@ int readCompMaskShift(defiComponentMaskShiftLayer* co) {
     return OK;
 }
 
-int readComp(defiComponent* co) {
+/// @brief instance of a defiComponent or of a staged record
+template <class T>
+static Inst* readCompInstance(T* co) {
     Cell* top_cell = getTopCell();
     std::string inst_name(co->id());
     Inst* inst = top_cell->createInstance(inst_name);
     if (!inst) {
-        return -1;
+        return nullptr;
     }
     inst->setMaster(co->name());
     inst->createPins();
@@ -2492,6 +2594,14 @@ int readComp(defiComponent* co) {
         inst->setMinLayer(co->minLayer());
         inst->setMaxLayer(co->maxLayer());
     }
+    return inst;
+}
+
+int readComp(defiComponent* co) {
+    Inst* inst = readCompInstance(co);
+    if (!inst) {
+        return -1;
+    }
     readProperties<defiComponent, Inst>(PropType::kComponent,
                                         reinterpret_cast<void*>(co),
                                         reinterpret_cast<void*>(inst));
@@ -2511,6 +2621,11 @@ int readComp(defiComponent* co) {
     return 0;
 }
 
+/// @brief component staged by the parallel reader, it has no properties.
+int readComp(DefStagedComponent* co) {
+    return readCompInstance(co) ? 0 : -1;
+}
+
 int readGcellGrid(defiGcellGrid* io_gcell_grid) {
     if (!io_gcell_grid) {
         message->issueMsg(kError, "io gcell grid is null pointer.\n");
@@ -2955,8 +3070,8 @@ int readPin(defiPin* def_pin) {
                 top_cell->createObject<Geometry>(kObjectTypeGeometry);
             int xl, yl, xh, yh;
             def_pin->bounds(i, &xl, &yl, &xh, &yh);
-            Box* b = creatBox(xl, yl, xh, yh);
-            geo->setBox(b);
+            Box b(xl, yl, xh, yh);
+            geo->setBox(&b);
             if (def_pin->layerMask(i)) {
                 geo->setNumMask(def_pin->layerMask(i));
             }
@@ -3055,8 +3170,8 @@ int readPin(defiPin* def_pin) {
                     top_cell->createObject<Geometry>(kObjectTypeGeometry);
                 int xl, yl, xh, yh;
                 port->bounds(i, &xl, &yl, &xh, &yh);
-                Box* b = creatBox(xl, yl, xh, yh);
-                geo->setBox(b);
+                Box b(xl, yl, xh, yh);
+                geo->setBox(&b);
                 if (port->layerMask(i)) {
                     geo->setNumMask(port->layerMask(i));
                 }
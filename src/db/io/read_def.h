@@ -21,6 +21,7 @@
 #include "db/core/special_wire.h"
 #include "db/core/via.h"
 #include "db/core/wire.h"
+#include "db/io/read_def_parallel.h"
 #include "db/tech/tech.h"
 #include "db/tech/via_master.h"
 #include "db/util/property_definition.h"
@@ -37,6 +38,7 @@ int readDieArea(defiBox* io_die_area);
 
 // Net
 int readNet(defiNet* io_net);
+int readNet(DefStagedNet* io_net);
 int readSpecialNet(defiNet* io_net);
 // Wire
 int readWire(defiWire* io_wire, Net* net);
@@ -64,6 +66,7 @@ int readCompMaskShift(defiComponentMaskShiftLayer* co);
 
 // Components
 int readComp(defiComponent* co);
+int readComp(DefStagedComponent* co);
 
 // Design
 
@@ -0,0 +1,652 @@
+/* @file  read_def_parallel.cpp
+ * @date  Oct 2020
+ * @brief Parallel import of the COMPONENTS and NETS sections of a DEF file.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "db/io/read_def_parallel.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace open_edi {
+namespace db {
+
+/// @brief bytes of a section body parsed by one worker at a time
+static const uint64_t kChunkSize = 4 << 20;
+
+/// @brief same rounding as the DEF parser
+static inline int __round(double value) {
+    return value >= 0 ? static_cast<int>(value + 0.5)
+                      : static_cast<int>(value - 0.5);
+}
+
+DefStagedComponent::DefStagedComponent()
+    : id_(nullptr), name_(nullptr), source_(nullptr), eeq_(nullptr),
+      region_(nullptr), min_layer_(nullptr), max_layer_(nullptr),
+      status_(kNone), x_(0), y_(0), orient_(0), weight_(0), halo_{0, 0, 0, 0},
+      halo_dist_(0), has_weight_(false), has_halo_(false),
+      has_halo_soft_(false), has_route_halo_(false) {}
+
+DefStagedNet::DefStagedNet()
+    : name_(nullptr), connections_(nullptr), first_connection_(0),
+      num_connections_(0), ndr_(nullptr), use_(nullptr), source_(nullptr),
+      original_(nullptr), pattern_(nullptr), frequency_(0), cap_(0),
+      xtalk_(0), weight_(0), has_xtalk_(false), has_fixedbump_(false),
+      has_frequency_(false), has_cap_(false), has_weight_(false) {}
+
+/// @brief whitespace separated tokens, the way the DEF lexer splits them.
+///
+/// Comments are skipped. Quoted strings, aliases and non-ASCII characters
+/// are not handled here; a token holding one of them marks the range as
+/// not clean.
+class DefParallelReader::Tokenizer {
+  public:
+    Tokenizer(const char *begin, const char *end)
+        : pos_(begin), end_(end), token_(nullptr), length_(0), clean_(true) {}
+
+    bool next() {
+        for (;;) {
+            while (pos_ < end_ && __isSpace(*pos_)) ++pos_;
+            if (pos_ == end_) {
+                token_ = nullptr;
+                length_ = 0;
+                return false;
+            }
+            if (*pos_ != '#') break;
+            // comments run to the end of line
+            while (pos_ < end_ && *pos_ != '\n') ++pos_;
+        }
+        token_ = pos_;
+        while (pos_ < end_ && !__isSpace(*pos_)) {
+            if (*pos_ == '"' || *pos_ < 0) clean_ = false;
+            ++pos_;
+        }
+        length_ = pos_ - token_;
+        if (*token_ == '&') clean_ = false;
+        return true;
+    }
+
+    bool valid() const { return token_ != nullptr; }
+    bool clean() const { return clean_; }
+    const char *token() const { return token_; }
+    size_t length() const { return length_; }
+
+    template <size_t N>
+    bool is(const char (&keyword)[N]) const {
+        return token_ != nullptr && length_ == N - 1 &&
+               memcmp(token_, keyword, N - 1) == 0;
+    }
+
+    /// @brief a number in the integer range, as the DEF lexer reads it
+    bool number(double *value) const {
+        char buffer[64];
+        if (token_ == nullptr || length_ >= sizeof(buffer)) return false;
+        char first = *token_;
+        if (!isdigit(static_cast<unsigned char>(first)) && first != '.' &&
+            !(first == '-' && length_ > 1)) {
+            return false;
+        }
+        memcpy(buffer, token_, length_);
+        buffer[length_] = '\0';
+        char *end = nullptr;
+        *value = strtod(buffer, &end);
+        return *end == '\0' && *value >= INT_MIN && *value <= INT_MAX;
+    }
+
+    /// @brief orient as the DEF parser numbers it, -1 if not an orient
+    int orient() const {
+        static const char *kOrients[] = {"N",  "W",  "S",  "E",
+                                         "FN", "FW", "FS", "FE"};
+        for (int i = 0; i < 8; ++i) {
+            if (token_ != nullptr && length_ == strlen(kOrients[i]) &&
+                memcmp(token_, kOrients[i], length_) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+  private:
+    static bool __isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    const char *pos_;
+    const char *end_;
+    const char *token_;
+    size_t length_;
+    bool clean_;
+};
+
+DefParallelReader *DefParallelReader::active_ = nullptr;
+
+DefParallelReader::DefParallelReader(int num_threads)
+    : data_(nullptr), size_(0), version_(5.8),
+      num_threads_(num_threads > 0 ? num_threads : 1), next_chunk_(0),
+      part_(0), chunk_(0), entry_(0), offset_(0), next_section_(0),
+      section_(nullptr), commit_chunk_(0), commit_entry_(0), num_staged_(0),
+      num_serial_(0) {}
+
+DefParallelReader::~DefParallelReader() {
+    // workers stop at the next chunk if the serial parser gave up early.
+    next_chunk_.store(chunks_.size());
+    workers_.wait();
+    if (active_ == this) active_ = nullptr;
+}
+
+/// @brief map a file, find its sections and start parsing them
+///
+/// @return false if the file should rather be read serially
+bool DefParallelReader::open(const char *filename) {
+    if (!file_.map(filename)) return false;
+    data_ = file_.getAddr();
+    size_ = file_.getSize();
+    if (!__scan() || chunks_.empty()) return false;
+
+    int num_workers = std::min<uint64_t>(num_threads_, chunks_.size());
+    for (int i = 0; i < num_workers; ++i) {
+        workers_.run([this]() { __work(); });
+    }
+    return true;
+}
+
+/// @brief first line at or after pos whose first token is "-"
+uint64_t DefParallelReader::__nextRecordLine(uint64_t pos, uint64_t end) const {
+    while (pos < end) {
+        const char *line = data_ + pos;
+        const char *eol = static_cast<const char *>(
+            memchr(line, '\n', end - pos));
+        uint64_t line_end = eol ? eol - data_ + 1 : end;
+        Tokenizer tokens(line, data_ + line_end);
+        if (tokens.next() && tokens.is("-")) return pos;
+        pos = line_end;
+    }
+    return end;
+}
+
+/// @brief find VERSION and the COMPONENTS and NETS sections
+///
+/// A section is staged if its header is "COMPONENTS <num> ;" on a line of
+/// its own and its END statement is found, otherwise it is left to the
+/// serial parser.
+bool DefParallelReader::__scan() {
+    Section *section = nullptr;
+    uint64_t served = 0;
+    uint64_t pos = 0;
+    while (pos < size_) {
+        const char *line = data_ + pos;
+        const char *eol = static_cast<const char *>(
+            memchr(line, '\n', size_ - pos));
+        uint64_t line_end = eol ? eol - data_ + 1 : size_;
+        Tokenizer tokens(line, data_ + line_end);
+        if (!tokens.next()) {
+            pos = line_end;
+            continue;
+        }
+
+        if (section) {
+            if (tokens.is("END") && tokens.next() &&
+                ((section->type == kComponents && tokens.is("COMPONENTS")) ||
+                 (section->type == kNets && tokens.is("NETS")))) {
+                section->body_end = pos;
+                parts_.push_back(Part{served, section->body_begin, nullptr});
+                parts_.push_back(
+                    Part{section->body_begin, section->body_end, section});
+                served = section->body_end;
+                __cutSection(section);
+                section = nullptr;
+            }
+        } else if (tokens.is("VERSION")) {
+            double version = 0;
+            if (tokens.next() && tokens.number(&version)) version_ = version;
+        } else if (tokens.is("NAMESCASESENSITIVE")) {
+            // names would be changed to upper case by the lexer.
+            if (tokens.next() && tokens.is("OFF")) return false;
+        } else if (tokens.is("COMPONENTS") || tokens.is("NETS")) {
+            SectionType type = tokens.is("NETS") ? kNets : kComponents;
+            double num = 0;
+            bool well_formed = tokens.next() && tokens.number(&num) &&
+                               tokens.next() && tokens.is(";") &&
+                               !tokens.next() && tokens.clean();
+            sections_.emplace_back(
+                new Section{type, line_end, line_end, {}, 0, 0});
+            if (well_formed) section = sections_.back().get();
+        }
+        pos = line_end;
+    }
+    // a section without END is left to the serial parser as is.
+    parts_.push_back(Part{served, size_, nullptr});
+    return true;
+}
+
+/// @brief cut a section body into chunks starting at record lines
+void DefParallelReader::__cutSection(Section *section) {
+    uint64_t begin = section->body_begin;
+    while (begin < section->body_end) {
+        uint64_t end = section->body_end;
+        if (end - begin > kChunkSize) {
+            const char *target = data_ + begin + kChunkSize;
+            const char *eol = static_cast<const char *>(
+                memchr(target, '\n', data_ + section->body_end - target));
+            if (eol) {
+                end = __nextRecordLine(eol - data_ + 1, section->body_end);
+            }
+        }
+        Chunk *chunk = new Chunk;
+        chunk->section = section;
+        chunk->begin = begin;
+        chunk->end = end;
+        section->chunks.emplace_back(chunk);
+        chunks_.push_back(chunk);
+        ++section->num_pending;
+        begin = end;
+    }
+    section->chunks_end = chunks_.size();
+}
+
+void DefParallelReader::__work() {
+    while (__workOne()) {
+    }
+}
+
+/// @brief __workOne parse the next chunk nobody took yet
+///
+/// @return false if there is none left
+bool DefParallelReader::__workOne() {
+    uint64_t i = next_chunk_++;
+    if (i >= chunks_.size()) return false;
+    Chunk *chunk = chunks_[i];
+    __parseChunk(chunk);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--chunk->section->num_pending == 0) {
+        section_done_.notify_all();
+    }
+    return true;
+}
+
+/// @brief split a chunk into records and stage the ones workers handle
+void DefParallelReader::__parseChunk(Chunk *chunk) {
+    // copied tokens with their terminators never exceed the chunk size, so
+    // the strings handed out by staged records do not move.
+    chunk->strings.reserve(chunk->end - chunk->begin + 1);
+
+    uint64_t begin = chunk->begin;
+    while (begin < chunk->end) {
+        const char *eol = static_cast<const char *>(
+            memchr(data_ + begin, '\n', chunk->end - begin));
+        uint64_t end = eol ? __nextRecordLine(eol - data_ + 1, chunk->end)
+                           : chunk->end;
+
+        Entry entry{begin, end,
+                    static_cast<uint64_t>(
+                        std::count(data_ + begin, data_ + end, '\n')),
+                    kEntryVerbatim, 0};
+        Tokenizer tokens(data_ + begin, data_ + end);
+        if (tokens.next() && tokens.is("-")) {
+            bool staged = false;
+            if (chunk->section->type == kComponents) {
+                entry.record = chunk->components.size();
+                staged = __parseComponent(chunk, tokens);
+            } else {
+                entry.record = chunk->nets.size();
+                staged = __parseNet(chunk, tokens);
+            }
+            entry.kind = staged ? kEntryStaged : kEntrySerial;
+        }
+        chunk->entries.push_back(entry);
+        begin = end;
+    }
+
+    for (DefStagedNet &net : chunk->nets) {
+        net.connections_ = chunk->connections.data() + net.first_connection_;
+    }
+}
+
+const char *DefParallelReader::__copyToken(Chunk *chunk, const char *token,
+                                           size_t len) {
+    std::vector<char> &strings = chunk->strings;
+    size_t offset = strings.size();
+    strings.insert(strings.end(), token, token + len);
+    strings.push_back('\0');
+    return strings.data() + offset;
+}
+
+/// @brief "- id master [+ option]* ;"
+///
+/// Handles placement, SOURCE, WEIGHT, EEQMASTER, REGION name, HALO and
+/// ROUTEHALO. PROPERTY, GENERATE, FOREIGN, MASKSHIFT and the obsolete
+/// forms are left to the serial parser.
+bool DefParallelReader::__parseComponent(Chunk *chunk, Tokenizer &tokens) {
+    DefStagedComponent co;
+    if (!tokens.next()) return false;
+    co.id_ = __copyToken(chunk, tokens.token(), tokens.length());
+    if (!tokens.next()) return false;
+    co.name_ = __copyToken(chunk, tokens.token(), tokens.length());
+    // obsolete net list
+    while (tokens.next() && !tokens.is("+") && !tokens.is(";")) {
+    }
+
+    while (tokens.is("+")) {
+        double num[4];
+        if (!tokens.next()) return false;
+        if (tokens.is("PLACED") || tokens.is("FIXED") || tokens.is("COVER")) {
+            co.status_ = tokens.is("PLACED")
+                             ? DefStagedComponent::kPlaced
+                             : (tokens.is("FIXED") ? DefStagedComponent::kFixed
+                                                   : DefStagedComponent::kCover);
+            if (!tokens.next() || !tokens.is("(") || !tokens.next() ||
+                !tokens.number(&num[0]) || !tokens.next() ||
+                !tokens.number(&num[1]) || !tokens.next() || !tokens.is(")") ||
+                !tokens.next() || tokens.orient() < 0) {
+                return false;
+            }
+            co.x_ = __round(num[0]);
+            co.y_ = __round(num[1]);
+            co.orient_ = tokens.orient();
+        } else if (tokens.is("UNPLACED")) {
+            co.status_ = DefStagedComponent::kUnplaced;
+            co.x_ = co.y_ = co.orient_ = -1;
+        } else if (tokens.is("SOURCE")) {
+            if (!tokens.next() ||
+                !(tokens.is("NETLIST") || tokens.is("DIST") ||
+                  tokens.is("USER") || tokens.is("TIMING"))) {
+                return false;
+            }
+            co.source_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("WEIGHT")) {
+            if (!tokens.next() || !tokens.number(&num[0])) return false;
+            co.has_weight_ = true;
+            co.weight_ = __round(num[0]);
+        } else if (tokens.is("EEQMASTER")) {
+            if (!tokens.next()) return false;
+            co.eeq_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("REGION")) {
+            if (!tokens.next() || tokens.is("(")) return false;
+            co.region_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("HALO")) {
+            // older versions get an error from the serial parser
+            if (version_ < 5.6 || !tokens.next()) return false;
+            if (tokens.is("SOFT")) {
+                if (version_ < 5.7 || !tokens.next()) return false;
+                co.has_halo_soft_ = true;
+            }
+            for (int i = 0; i < 4; ++i) {
+                if ((i > 0 && !tokens.next()) || !tokens.number(&num[i])) {
+                    return false;
+                }
+                co.halo_[i] = static_cast<int>(num[i]);
+            }
+            co.has_halo_ = true;
+        } else if (tokens.is("ROUTEHALO")) {
+            if (version_ < 5.7 || !tokens.next() || !tokens.number(&num[0])) {
+                return false;
+            }
+            co.halo_dist_ = static_cast<int>(num[0]);
+            if (!tokens.next()) return false;
+            co.min_layer_ = __copyToken(chunk, tokens.token(), tokens.length());
+            if (!tokens.next()) return false;
+            co.max_layer_ = __copyToken(chunk, tokens.token(), tokens.length());
+            co.has_route_halo_ = true;
+        } else {
+            return false;
+        }
+        tokens.next();
+    }
+    if (!tokens.is(";") || tokens.next() || !tokens.clean()) return false;
+
+    chunk->components.push_back(co);
+    return true;
+}
+
+/// @brief "- name [( inst pin )]* [+ option]* ;"
+///
+/// Handles connections and the net attributes. Routing, SUBNET, VPIN,
+/// SHIELDNET, PROPERTY, MUSTJOIN and SYNTHESIZED are left to the serial
+/// parser.
+bool DefParallelReader::__parseNet(Chunk *chunk, Tokenizer &tokens) {
+    DefStagedNet net;
+    uint64_t first = chunk->connections.size();
+    auto fail = [&]() {
+        chunk->connections.resize(first);
+        return false;
+    };
+
+    if (!tokens.next() || tokens.is("MUSTJOIN")) return false;
+    net.name_ = __copyToken(chunk, tokens.token(), tokens.length());
+    tokens.next();
+    while (tokens.is("(")) {
+        if (!tokens.next()) return fail();
+        chunk->connections.push_back(
+            __copyToken(chunk, tokens.token(), tokens.length()));
+        if (!tokens.next()) return fail();
+        chunk->connections.push_back(
+            __copyToken(chunk, tokens.token(), tokens.length()));
+        if (!tokens.next() || !tokens.is(")")) return fail();
+        tokens.next();
+    }
+    net.first_connection_ = first;
+    net.num_connections_ = (chunk->connections.size() - first) / 2;
+
+    while (tokens.is("+")) {
+        double num = 0;
+        if (!tokens.next()) return fail();
+        if (tokens.is("USE")) {
+            if (!tokens.next() ||
+                !(tokens.is("SIGNAL") || tokens.is("POWER") ||
+                  tokens.is("GROUND") || tokens.is("CLOCK") ||
+                  tokens.is("TIEOFF") || tokens.is("ANALOG") ||
+                  tokens.is("SCAN") || tokens.is("RESET"))) {
+                return fail();
+            }
+            net.use_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("SOURCE")) {
+            if (!tokens.next() ||
+                !(tokens.is("NETLIST") || tokens.is("DIST") ||
+                  tokens.is("USER") || tokens.is("TIMING") ||
+                  tokens.is("TEST"))) {
+                return fail();
+            }
+            net.source_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("PATTERN")) {
+            if (!tokens.next() ||
+                !(tokens.is("BALANCED") || tokens.is("STEINER") ||
+                  tokens.is("TRUNK") || tokens.is("WIREDLOGIC"))) {
+                return fail();
+            }
+            net.pattern_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("ORIGINAL")) {
+            if (!tokens.next()) return fail();
+            net.original_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("NONDEFAULTRULE")) {
+            if (!tokens.next()) return fail();
+            net.ndr_ = __copyToken(chunk, tokens.token(), tokens.length());
+        } else if (tokens.is("FIXEDBUMP")) {
+            if (version_ < 5.5) return fail();
+            net.has_fixedbump_ = true;
+        } else if (tokens.is("FREQUENCY")) {
+            if (version_ < 5.5 || !tokens.next() || !tokens.number(&num)) {
+                return fail();
+            }
+            net.has_frequency_ = true;
+            net.frequency_ = num;
+        } else if (tokens.is("XTALK")) {
+            if (!tokens.next() || !tokens.number(&num)) return fail();
+            net.has_xtalk_ = true;
+            net.xtalk_ = __round(num);
+        } else if (tokens.is("WEIGHT")) {
+            if (!tokens.next() || !tokens.number(&num)) return fail();
+            net.has_weight_ = true;
+            net.weight_ = __round(num);
+        } else if (tokens.is("ESTCAP")) {
+            if (!tokens.next() || !tokens.number(&num)) return fail();
+            net.has_cap_ = true;
+            net.cap_ = num;
+        } else if (tokens.is("STYLE")) {
+            // not kept in the database
+            if (!tokens.next() || !tokens.number(&num)) return fail();
+        } else {
+            return fail();
+        }
+        tokens.next();
+    }
+    if (!tokens.is(";") || tokens.next() || !tokens.clean()) return fail();
+
+    chunk->nets.push_back(net);
+    return true;
+}
+
+void DefParallelReader::__waitSection(Section *section) {
+    // the pool may be busy or small: don't wait for chunks nobody took.
+    while (next_chunk_.load() < section->chunks_end && __workOne()) {
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    section_done_.wait(lock, [section]() { return section->num_pending == 0; });
+}
+
+size_t DefParallelReader::read(FILE *file, char *buffer, size_t size) {
+    if (active_ == nullptr) return 0;
+    return active_->__read(buffer, size);
+}
+
+/// @brief serve the file with staged records replaced by newlines
+size_t DefParallelReader::__read(char *buffer, size_t size) {
+    size_t num = 0;
+    while (num < size && part_ < parts_.size()) {
+        const Part &part = parts_[part_];
+        if (part.section == nullptr) {
+            uint64_t len = std::min<uint64_t>(size - num,
+                                              part.end - part.begin - offset_);
+            memcpy(buffer + num, data_ + part.begin + offset_, len);
+            num += len;
+            offset_ += len;
+            if (offset_ == part.end - part.begin) {
+                ++part_;
+                offset_ = 0;
+            }
+            continue;
+        }
+
+        Section *section = part.section;
+        if (chunk_ == 0 && entry_ == 0 && offset_ == 0) {
+            __waitSection(section);
+        }
+        if (chunk_ >= section->chunks.size()) {
+            ++part_;
+            chunk_ = entry_ = offset_ = 0;
+            continue;
+        }
+        Chunk *chunk = section->chunks[chunk_].get();
+        if (entry_ >= chunk->entries.size()) {
+            ++chunk_;
+            entry_ = offset_ = 0;
+            continue;
+        }
+        const Entry &entry = chunk->entries[entry_];
+        uint64_t total = entry.kind == kEntryStaged ? entry.num_lines
+                                                    : entry.end - entry.begin;
+        uint64_t len = std::min<uint64_t>(size - num, total - offset_);
+        if (entry.kind == kEntryStaged) {
+            memset(buffer + num, '\n', len);
+        } else {
+            memcpy(buffer + num, data_ + entry.begin + offset_, len);
+        }
+        num += len;
+        offset_ += len;
+        if (offset_ == total) {
+            ++entry_;
+            offset_ = 0;
+        }
+    }
+    return num;
+}
+
+/// @brief the serial parser reached the header of a section
+void DefParallelReader::beginSection(SectionType type) {
+    section_ = nullptr;
+    for (; next_section_ < sections_.size(); ++next_section_) {
+        if (sections_[next_section_]->type == type) {
+            section_ = sections_[next_section_++].get();
+            break;
+        }
+    }
+    if (section_) __waitSection(section_);
+    commit_chunk_ = 0;
+    commit_entry_ = 0;
+}
+
+/// @brief the serial parser reached the END of a section, whose staged
+/// records are committed by then.
+void DefParallelReader::endSection(SectionType type) {
+    if (section_ == nullptr || section_->type != type) return;
+    // the stream has moved past the body, release its records.
+    section_->chunks.clear();
+    section_ = nullptr;
+}
+
+DefParallelReader::Entry *DefParallelReader::__currentEntry() {
+    if (section_ == nullptr) return nullptr;
+    while (commit_chunk_ < section_->chunks.size()) {
+        Chunk *chunk = section_->chunks[commit_chunk_].get();
+        if (commit_entry_ < chunk->entries.size()) {
+            return &chunk->entries[commit_entry_];
+        }
+        ++commit_chunk_;
+        commit_entry_ = 0;
+    }
+    return nullptr;
+}
+
+DefStagedComponent *DefParallelReader::nextComponent() {
+    if (section_ == nullptr || section_->type != kComponents) return nullptr;
+    for (Entry *entry = __currentEntry(); entry; entry = __currentEntry()) {
+        if (entry->kind == kEntrySerial) return nullptr;
+        Chunk *chunk = section_->chunks[commit_chunk_].get();
+        ++commit_entry_;
+        if (entry->kind == kEntryStaged) {
+            ++num_staged_;
+            return &chunk->components[entry->record];
+        }
+    }
+    return nullptr;
+}
+
+DefStagedNet *DefParallelReader::nextNet() {
+    if (section_ == nullptr || section_->type != kNets) return nullptr;
+    for (Entry *entry = __currentEntry(); entry; entry = __currentEntry()) {
+        if (entry->kind == kEntrySerial) return nullptr;
+        Chunk *chunk = section_->chunks[commit_chunk_].get();
+        ++commit_entry_;
+        if (entry->kind == kEntryStaged) {
+            ++num_staged_;
+            return &chunk->nets[entry->record];
+        }
+    }
+    return nullptr;
+}
+
+/// @brief move past the serial record the parser has just read
+///
+/// Staged records ahead of it are expected to be committed already.
+void DefParallelReader::skipSerialRecord() {
+    for (Entry *entry = __currentEntry(); entry; entry = __currentEntry()) {
+        if (entry->kind == kEntryStaged) return;
+        ++commit_entry_;
+        if (entry->kind == kEntrySerial) {
+            ++num_serial_;
+            return;
+        }
+    }
+}
+
+}  // namespace db
+}  // namespace open_edi
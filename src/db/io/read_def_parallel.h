@@ -0,0 +1,283 @@
+/* @file  read_def_parallel.h
+ * @date  Oct 2020
+ * @brief Parallel import of the COMPONENTS and NETS sections of a DEF file.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#ifndef SRC_DB_IO_READ_DEF_PARALLEL_H_
+#define SRC_DB_IO_READ_DEF_PARALLEL_H_
+
+#include <stdio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/thread_pool.h"
+#include "util/util_mem.h"
+
+namespace open_edi {
+namespace db {
+
+/// @brief COMPONENTS record parsed by a worker thread.
+///
+/// Offers the accessors of defiComponent used by readComp, so both go
+/// through the same code when they are committed into the cell.
+class DefStagedComponent {
+  public:
+    const char *id() const { return id_; }
+    const char *name() const { return name_; }
+    int isUnplaced() const { return status_ == kUnplaced; }
+    int isPlaced() const { return status_ == kPlaced; }
+    int isFixed() const { return status_ == kFixed; }
+    int isCover() const { return status_ == kCover; }
+    int placementX() const { return x_; }
+    int placementY() const { return y_; }
+    int placementOrient() const { return orient_; }
+    int hasSource() const { return source_ != nullptr; }
+    const char *source() const { return source_; }
+    int hasWeight() const { return has_weight_; }
+    int weight() const { return weight_; }
+    int hasEEQ() const { return eeq_ != nullptr; }
+    const char *EEQ() const { return eeq_; }
+    int hasRegionName() const { return region_ != nullptr; }
+    const char *regionName() const { return region_; }
+    // MASKSHIFT is left to the serial parser.
+    int maskShiftSize() const { return 0; }
+    int maskShift(int index) const { return 0; }
+    int hasHalo() const { return has_halo_; }
+    int hasHaloSoft() const { return has_halo_soft_; }
+    void haloEdges(int *left, int *bottom, int *right, int *top) {
+        *left = halo_[0];
+        *bottom = halo_[1];
+        *right = halo_[2];
+        *top = halo_[3];
+    }
+    int hasRouteHalo() const { return has_route_halo_; }
+    int haloDist() const { return halo_dist_; }
+    const char *minLayer() const { return min_layer_; }
+    const char *maxLayer() const { return max_layer_; }
+
+  private:
+    friend class DefParallelReader;
+
+    enum Status { kNone = 0, kUnplaced, kPlaced, kFixed, kCover };
+
+    DefStagedComponent();
+
+    const char *id_;
+    const char *name_;
+    const char *source_;
+    const char *eeq_;
+    const char *region_;
+    const char *min_layer_;
+    const char *max_layer_;
+    int status_;
+    int x_;
+    int y_;
+    int orient_;
+    int weight_;
+    int halo_[4];
+    int halo_dist_;
+    bool has_weight_;
+    bool has_halo_;
+    bool has_halo_soft_;
+    bool has_route_halo_;
+};
+
+/// @brief NETS record without routing parsed by a worker thread.
+///
+/// Offers the accessors of defiNet used by readNet.
+class DefStagedNet {
+  public:
+    const char *name() const { return name_; }
+    int numConnections() const { return num_connections_; }
+    const char *instance(int index) const { return connections_[2 * index]; }
+    const char *pin(int index) const { return connections_[2 * index + 1]; }
+    int hasNonDefaultRule() const { return ndr_ != nullptr; }
+    const char *nonDefaultRule() const { return ndr_; }
+    int hasUse() const { return use_ != nullptr; }
+    const char *use() const { return use_; }
+    int hasSource() const { return source_ != nullptr; }
+    const char *source() const { return source_; }
+    int hasOriginal() const { return original_ != nullptr; }
+    const char *original() const { return original_; }
+    int hasPattern() const { return pattern_ != nullptr; }
+    const char *pattern() const { return pattern_; }
+    int hasXTalk() const { return has_xtalk_; }
+    int XTalk() const { return xtalk_; }
+    int hasFixedbump() const { return has_fixedbump_; }
+    int hasFrequency() const { return has_frequency_; }
+    double frequency() const { return frequency_; }
+    int hasCap() const { return has_cap_; }
+    double cap() const { return cap_; }
+    int hasWeight() const { return has_weight_; }
+    int weight() const { return weight_; }
+
+  private:
+    friend class DefParallelReader;
+
+    DefStagedNet();
+
+    const char *name_;
+    const char *const *connections_;
+    uint64_t first_connection_;
+    int num_connections_;
+    const char *ndr_;
+    const char *use_;
+    const char *source_;
+    const char *original_;
+    const char *pattern_;
+    double frequency_;
+    double cap_;
+    int xtalk_;
+    int weight_;
+    bool has_xtalk_;
+    bool has_fixedbump_;
+    bool has_frequency_;
+    bool has_cap_;
+    bool has_weight_;
+};
+
+/// @brief Parallel import of the COMPONENTS and NETS sections.
+///
+/// The DEF file is mapped and pre-scanned for section boundaries. The
+/// bodies of COMPONENTS and NETS are cut into byte ranges at record
+/// starts, and tasks of the shared thread pool parse the records of each
+/// range into staging buffers while the serial parser works on the
+/// sections ahead. When it needs a section which isn't parsed yet, the
+/// serial parser parses the remaining ranges of that section itself.
+///
+/// The serial parser reads the file through read(). Staged records are
+/// replaced by as many newlines as they span, so line numbers still match
+/// the file, and records the workers do not handle (routing, properties,
+/// comments...) are passed through unchanged. The callbacks of the serial
+/// parser commit staged records into the cell in file order, so the
+/// database is the same as the one read serially.
+class DefParallelReader {
+  public:
+    enum SectionType { kComponents = 0, kNets = 1 };
+
+    explicit DefParallelReader(int num_threads);
+    ~DefParallelReader();
+
+    /// @brief map and scan a file, and start the workers
+    bool open(const char *filename);
+    /// @brief read function of the serial parser, see defrSetReadFunction
+    static size_t read(FILE *file, char *buffer, size_t size);
+    static void setActive(DefParallelReader *reader) { active_ = reader; }
+
+    /// @brief the serial parser starts or ends a section
+    void beginSection(SectionType type);
+    void endSection(SectionType type);
+    /// @brief next staged record ahead of the next serial one, if any
+    DefStagedComponent *nextComponent();
+    DefStagedNet *nextNet();
+    /// @brief the serial parser has read the next serial record
+    void skipSerialRecord();
+
+    uint64_t getNumStaged() const { return num_staged_; }
+    uint64_t getNumSerial() const { return num_serial_; }
+
+  private:
+    /// @brief records are staged, read serially, or carry no record at all
+    enum EntryKind { kEntryStaged = 0, kEntrySerial, kEntryVerbatim };
+
+    /// @brief a byte range of the body holding at most one record
+    struct Entry {
+        uint64_t begin;
+        uint64_t end;
+        uint64_t num_lines;
+        uint32_t kind;
+        uint32_t record;
+    };
+
+    struct Section;
+
+    /// @brief a byte range of a section body parsed by one worker
+    struct Chunk {
+        Section *section;
+        uint64_t begin;
+        uint64_t end;
+        std::vector<char> strings;
+        std::vector<const char *> connections;
+        std::vector<DefStagedComponent> components;
+        std::vector<DefStagedNet> nets;
+        std::vector<Entry> entries;
+    };
+
+    struct Section {
+        SectionType type;
+        uint64_t body_begin;
+        uint64_t body_end;
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        uint64_t chunks_end;  // index in chunks_ past the last chunk
+        int num_pending;
+    };
+
+    /// @brief a byte range of the file served as is, or a section body
+    struct Part {
+        uint64_t begin;
+        uint64_t end;
+        Section *section;
+    };
+
+    class Tokenizer;
+
+    bool __scan();
+    void __addSection(SectionType type, uint64_t header_end,
+                      uint64_t line_begin, uint64_t line_end);
+    void __cutSection(Section *section);
+    uint64_t __nextRecordLine(uint64_t pos, uint64_t end) const;
+    void __work();
+    bool __workOne();
+    void __parseChunk(Chunk *chunk);
+    bool __parseComponent(Chunk *chunk, Tokenizer &tokens);
+    bool __parseNet(Chunk *chunk, Tokenizer &tokens);
+    const char *__copyToken(Chunk *chunk, const char *token, size_t len);
+    size_t __read(char *buffer, size_t size);
+    void __waitSection(Section *section);
+    Entry *__currentEntry();
+
+    static DefParallelReader *active_;
+
+    util::MemMappedFile file_;
+    const char *data_;
+    uint64_t size_;
+    double version_;
+    int num_threads_;
+
+    std::vector<std::unique_ptr<Section>> sections_;
+    std::vector<Part> parts_;
+    std::vector<Chunk *> chunks_;
+    std::atomic<uint64_t> next_chunk_;
+    util::TaskGroup workers_;
+    std::mutex mutex_;
+    std::condition_variable section_done_;
+
+    // serial parser stream position
+    uint64_t part_;
+    uint64_t chunk_;
+    uint64_t entry_;
+    uint64_t offset_;
+
+    // commit position
+    uint64_t next_section_;
+    Section *section_;
+    uint64_t commit_chunk_;
+    uint64_t commit_entry_;
+
+    uint64_t num_staged_;
+    uint64_t num_serial_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // SRC_DB_IO_READ_DEF_PARALLEL_H_
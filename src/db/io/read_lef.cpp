@@ -201,10 +201,9 @@ int prtGeometry(lefiGeometries *geometry, Port *port = nullptr) {
                 if (rect->colorMask != 0) {
                     base->setNumMask(rect->colorMask);
                 }
-                Box *b = creatBox(
-                    lib->micronsToDBU(rect->xl), lib->micronsToDBU(rect->yl),
-                    lib->micronsToDBU(rect->xh), lib->micronsToDBU(rect->yh));
-                base->setBox(b);
+                Box b(lib->micronsToDBU(rect->xl), lib->micronsToDBU(rect->yl),
+                      lib->micronsToDBU(rect->xh), lib->micronsToDBU(rect->yh));
+                base->setBox(&b);
                 base->setType(GeometryType::kRect);
                 current_lg->addGeometry(base->getId());
                 break;
@@ -223,16 +222,15 @@ int prtGeometry(lefiGeometries *geometry, Port *port = nullptr) {
                         if (rectIter->colorMask != 0)
                             base->setNumMask(rectIter->colorMask);
 
-                        Box *b =
-                            creatBox(lib->micronsToDBU(rectIter->xl +
-                                                       i * rectIter->xStep),
-                                     lib->micronsToDBU(rectIter->yl +
-                                                       j * rectIter->yStep),
-                                     lib->micronsToDBU(rectIter->xh +
-                                                       i * rectIter->xStep),
-                                     lib->micronsToDBU(rectIter->yh +
-                                                       j * rectIter->yStep));
-                        base->setBox(b);
+                        Box b(lib->micronsToDBU(rectIter->xl +
+                                                i * rectIter->xStep),
+                              lib->micronsToDBU(rectIter->yl +
+                                                j * rectIter->yStep),
+                              lib->micronsToDBU(rectIter->xh +
+                                                i * rectIter->xStep),
+                              lib->micronsToDBU(rectIter->yh +
+                                                j * rectIter->yStep));
+                        base->setBox(&b);
                         base->setType(GeometryType::kRect);
                         current_lg->addGeometry(base->getId());
                     }
@@ -957,10 +955,9 @@ int densityCB(lefrCallbackType_e c, lefiDensity *density, lefiUserData) {
             DensityLayer *layer = Object::createObject<DensityLayer>(
                 kObjectTypeDensityLayer, lib->getId());
             rect = density->lefiDensity::getRect(i, j);
-            Box *box = creatBox(
-                lib->micronsToDBU(rect.xl), lib->micronsToDBU(rect.yl),
-                lib->micronsToDBU(rect.xh), lib->micronsToDBU(rect.yh));
-            layer->setRect(*box);
+            Box box(lib->micronsToDBU(rect.xl), lib->micronsToDBU(rect.yl),
+                    lib->micronsToDBU(rect.xh), lib->micronsToDBU(rect.yh));
+            layer->setRect(box);
             layer->setDensity(density->lefiDensity::densityValue(i, j));
             den->addDensityLayer(layer->getId());
         }
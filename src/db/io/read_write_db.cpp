@@ -13,24 +13,43 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <string>
 
 #include "util/checksum.h"
+#include "util/page_image.h"
 #include "util/util.h"
 
 namespace open_edi {
 namespace db {
 
+/// @brief whether each page of a pool read over a mapping lies within the
+/// size bytes of content
+static bool __framesInMapping(MemPagePool *pool, const char *content,
+                              uint64_t size) {
+    for (uint64_t page_no = 0; page_no < pool->getNumPages(); ++page_no) {
+        const char *frame = pool->getPage(page_no)->getFrame();
+        if (frame < content ||
+            static_cast<uint64_t>(frame - content) > size ||
+            pool->getPageSize() > size - (frame - content)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Class ReadDesign
 bool ReadDesign::__preWork() {
     if (is_top_) {
         Cell *top_cell = getTopCell();
         if (top_cell) {
             resetTopCell();
-            MemPool::destroyMemPool();
         }
+        // a read that failed leaves its pools without a top cell, pool
+        // numbers must start over for ids of the file to resolve.
+        MemPool::destroyMemPool();
         MemPool::initMemPool();
     }
     return true;
@@ -89,31 +108,114 @@ bool ReadDesign::__readDBFile(
         return false;
     }
     in_dbfile.seekg(0, in_dbfile.beg);
-    // read version:
+    // read version, objects of other versions are laid out differently:
     v_.readFromFile(in_dbfile, getDebug());
+    Version current;
+    current.init();
+    if (v_.compare(current) != 0) {
+        util::message->issueMsg(kMsgCategoryDB, VersionError, kError,
+            db_file.c_str(), v_.getVersionString().c_str(),
+            current.getVersionString().c_str());
+        return false;
+    }
     // read into mem pool:
     size_t pool_id = 0;
     // TODO(luoying): pool_id is unused in object ID.
     in_dbfile.read(reinterpret_cast<char *>(&(pool_id)), sizeof(size_t));
     in_dbfile.read(reinterpret_cast<char *>(&(current_id_)), sizeof(ObjectId));
 
-    //pool_ = MemPool::newPagePool();
-    MemPool::insertPagePool(current_id_, pool);
-    pool->readFromFile(in_dbfile, getDebug());
-    if (getDebug()) {
-        pool->printUsage();
-    }
-    // read checksum:
-    CheckSum csum;
+    // read checksum first, the header size also tells where content starts:
     uint32_t file_header_size = 0;
     uint32_t ref_value = 0;
+    std::streampos pool_header_pos = in_dbfile.tellg();
+    in_dbfile.seekg(0, in_dbfile.end);
+    uint64_t file_size = in_dbfile.tellg();
+    in_dbfile.seekg(-2 * static_cast<int>(sizeof(uint32_t)), in_dbfile.end);
     in_dbfile.read(reinterpret_cast<char *>(&file_header_size),
             sizeof(uint32_t));
     in_dbfile.read(reinterpret_cast<char *>(&ref_value), sizeof(uint32_t));
+    in_dbfile.seekg(pool_header_pos);
+    // pages end where the header size and checksum start.
+    uint64_t content_end = file_size - 2 * sizeof(uint32_t);
+
+    // files of this version have a page index, the header size of a cut
+    // file is whatever bytes ended up at its end.
+    PageImage image(pool);
+    image.setNumThreads(getNumThreads());
+    if (!in_dbfile || file_size < 2 * sizeof(uint32_t) ||
+        file_header_size < static_cast<uint64_t>(pool_header_pos) ||
+        file_header_size > content_end ||
+        !PageImage::hasIndex(in_dbfile, file_header_size) ||
+        !image.readIndexFromFile(in_dbfile, getDebug())) {
+        util::message->issueMsg(kMsgCategoryDB,
+            PageCorruptError, kError, db_file.c_str());
+        return false;
+    }
+
+    MemMappedFile *mapped = nullptr;
+    if (getMmap() && image.getCompression() != PageImage::kCompressionNone) {
+        util::message->issueMsg(kMsgCategoryDB,
+            MapFileWarning, kWarn, db_file.c_str());
+    } else if (getMmap()) {
+        mapped = new MemMappedFile;
+        // content must keep the alignment objects were allocated with.
+        if (!mapped->map(db_file.c_str()) ||
+            mapped->getSize() != file_size ||
+            file_header_size % (1 << MEM_ALIGN_BIT) != 0) {
+            util::message->issueMsg(kMsgCategoryDB,
+                MapFileWarning, kWarn, db_file.c_str());
+            delete mapped;
+            mapped = nullptr;
+        }
+    }
+
+    //pool_ = MemPool::newPagePool();
+    MemPool::insertPagePool(current_id_, pool);
+    // mapped pages are used in place, check them before anything reads them.
+    if (mapped &&
+        !image.verifyMappedPages(mapped->getAddr() + file_header_size,
+                                 content_end - file_header_size,
+                                 db_file, getVerify(), getDebug())) {
+        util::message->issueMsg(kMsgCategoryDB,
+            PageCorruptError, kError, db_file.c_str());
+        delete mapped;
+        return false;
+    }
+    if (mapped) {
+        pool->setMappedFile(mapped);
+        pool->readHeaderFromFile(in_dbfile,
+            mapped->getAddr() + file_header_size, getDebug());
+        // frames come from the chunk sizes of the pool header, the index
+        // only vouches for the pages it lists.
+        if (!in_dbfile || pool->getNumPages() != image.getNumPages() ||
+            !__framesInMapping(pool, mapped->getAddr() + file_header_size,
+                               content_end - file_header_size)) {
+            util::message->issueMsg(kMsgCategoryDB,
+                PageCorruptError, kError, db_file.c_str());
+            return false;
+        }
+    } else {
+        pool->readHeaderFromFile(in_dbfile, nullptr, getDebug());
+        if (!image.readPagesFromFile(db_file, file_header_size, getDebug())) {
+            util::message->issueMsg(kMsgCategoryDB,
+                PageCorruptError, kError, db_file.c_str());
+            return false;
+        }
+    }
+    if (getDebug()) {
+        pool->printUsage();
+    }
     // close:
     in_dbfile.close();
     // check checksum:
-    uint32_t sum = csum.summary(db_file, file_header_size, getDebug());
+    CheckSum csum;
+    uint32_t sum = 0;
+    if (mapped) {
+        sum = csum.summary(reinterpret_cast<const unsigned char *>(
+            mapped->getAddr()), file_header_size, getDebug());
+    } else {
+        sum = csum.summary(db_file, file_header_size, getDebug());
+    }
     if (csum.check(sum, ref_value, getDebug())) {
         if (getDebug()) {
           util::message->issueMsg(kMsgCategoryDB, 
@@ -307,11 +409,15 @@ bool WriteDesign::__writeDBFile(
     ediAssert(pool != nullptr);
     std::string db_file = filename;
     db_file.append(kDBFilePostFix);
+    // write to a temporary file and rename it at the end, the existing
+    // file may still be mapped by a design read with read_design -mmap.
+    std::string tmp_file = db_file;
+    tmp_file.append(".tmp");
     // open:
-    std::ofstream out_dbfile(db_file.c_str(), std::ofstream::binary);
+    std::ofstream out_dbfile(tmp_file.c_str(), std::ofstream::binary);
     if (out_dbfile.good() == false) {
         util::message->issueMsg(kMsgCategoryDB, 
-            OpenFileError, kError, db_file.c_str());      
+            OpenFileError, kError, tmp_file.c_str());      
         //std::cout << "ERROR: Failed to open output db file "
                   //<< db_file << ".\n";
         return false;
@@ -324,18 +430,42 @@ bool WriteDesign::__writeDBFile(
     size_t pool_id = pool->getPoolNo();
     out_dbfile.write(reinterpret_cast<char *>(&pool_id), sizeof(size_t));
     out_dbfile.write(reinterpret_cast<char *>(&current_id_), sizeof(ObjectId));
+    PageImage image(pool);
+    image.setCompression(getCompress() ? PageImage::kCompressionZlib
+                                       : PageImage::kCompressionNone);
+    image.setNumThreads(getNumThreads());
+    image.writeIndexToFile(out_dbfile, getDebug());
     pool->writeHeaderToFile(out_dbfile, getDebug());
+    // pad the header so that content can be mapped in place:
+    uint32_t header_end = out_dbfile.tellp();
+    uint32_t padding = (kDBContentAlign - header_end % kDBContentAlign) %
+                       kDBContentAlign;
+    std::string zeros(padding, '\0');
+    out_dbfile.write(zeros.data(), padding);
     uint32_t file_header_size = out_dbfile.tellp();
-    pool->writeContentToFile(out_dbfile, getDebug());
+    if (!image.writePagesToFile(out_dbfile, getDebug())) {
+        util::message->issueMsg(kMsgCategoryDB, 
+            OpenFileError, kError, tmp_file.c_str());
+        out_dbfile.close();
+        std::remove(tmp_file.c_str());
+        return false;
+    }
     out_dbfile.flush();
     // write checksum:
     CheckSum csum;
-    uint32_t sum = csum.summary(db_file, file_header_size, getDebug());
+    uint32_t sum = csum.summary(tmp_file, file_header_size, getDebug());
     out_dbfile.write(reinterpret_cast<char *>(&file_header_size),
                                                      sizeof(uint32_t));
     out_dbfile.write(reinterpret_cast<char *>(&sum), sizeof(uint32_t));
     // close:
     out_dbfile.close();
+    if (!out_dbfile.good() ||
+        std::rename(tmp_file.c_str(), db_file.c_str()) != 0) {
+        util::message->issueMsg(kMsgCategoryDB, 
+            OpenFileError, kError, db_file.c_str());
+        std::remove(tmp_file.c_str());
+        return false;
+    }
     if (getDebug()) {
         pool->printUsage();
     }
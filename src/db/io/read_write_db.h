@@ -31,6 +31,9 @@ const char kPropFilePostFix[] = ".prop";
 const char kLibSubDirName[] = "/Libs";
 const char kTechLibName[] =  "lef";
 const char kTimingLibName[] =  "liberty";
+// pool content in the .db file starts on this boundary so that it can be
+// mapped in place, see ReadDesign::setMmap.
+const uint32_t kDBContentAlign = 4096;
 const int OK = 0;     // equals to TCL_OK
 const int ERROR = 1;  // equals to TCL_ERROR
 
@@ -45,20 +48,37 @@ enum readWriteDesignMsgId {
     ReadDesignInitError = 106,
     CreateDirError = 107,
     WriteFileError = 108,
-    RenameCellVerbose = 109
+    RenameCellVerbose = 109,
+    MapFileWarning = 110,
+    PageCorruptError = 111,
+    VersionError = 112
 };
 
 class ReadDesign {
  public:
     explicit ReadDesign(const std::string &name)
         : cell_name_(name), current_id_(0),
-          is_top_(false), debug_(false) {}
+          is_top_(false), debug_(false), mmap_(false), verify_(false),
+          num_threads_(1) {}
 
     int run();
 
     bool getDebug() { return debug_; }
     void setDebug(bool v) { debug_ = v; }
     void setTop(void) { is_top_ = true; }
+    /// @brief map .db files copy-on-write instead of streaming them in,
+    /// pages are loaded lazily and only copied when first written.
+    bool getMmap() { return mmap_; }
+    void setMmap(bool v) { mmap_ = v; }
+    /// @brief compare the checksum of each mapped page at load. Streamed
+    /// pages are always checked, they are read anyway. Mapped ones are
+    /// only checked against the bounds of the file by default: a checksum
+    /// reads every page, so a load that should take milliseconds takes as
+    /// long as reading the whole file.
+    bool getVerify() { return verify_; }
+    void setVerify(bool v) { verify_ = v; }
+    int getNumThreads() { return num_threads_; }
+    void setNumThreads(int v) { num_threads_ = v; }
 
  private:
     ReadDesign() {}
@@ -88,6 +108,9 @@ class ReadDesign {
     Version v_;
     bool is_top_;
     bool debug_;
+    bool mmap_;
+    bool verify_;
+    int num_threads_;
 };
 
 class WriteDesign {
@@ -97,12 +120,17 @@ class WriteDesign {
     explicit WriteDesign(const std::string &name)
         : original_cell_name_(""), saved_name_(name),
           write_cell_(nullptr), current_id_(0),
-          debug_(false) {}
+          debug_(false), compress_(false), num_threads_(1) {}
 
     int run();
 
     bool getDebug() { return debug_; }
     void setDebug(bool v) { debug_ = v; }
+    /// @brief zlib compress each page, such files cannot be mapped.
+    bool getCompress() { return compress_; }
+    void setCompress(bool v) { compress_ = v; }
+    int getNumThreads() { return num_threads_; }
+    void setNumThreads(int v) { num_threads_ = v; }
 
  private:
     /// @brief copy constructor
@@ -132,6 +160,8 @@ class WriteDesign {
     Cell *write_cell_;
     ObjectId current_id_;
     bool debug_;
+    bool compress_;
+    int num_threads_;
 };
 
 }  // namespace db
@@ -13,7 +13,13 @@
 
 #include <gperftools/profiler.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -22,6 +28,7 @@
 #include "db/util/property_definition.h"
 #include "db/util/array.h"
 #include "db/util/vector_object_var.h"
+#include "util/thread_pool.h"
 #include "util/util.h"
 
 namespace open_edi {
@@ -32,8 +39,16 @@ using IdArray = ArrayObject<ObjectId>;
 #define ERROR (1)
 
 static Cell *top_cell;
+static int num_threads = 1;
+
+/// @brief records printed into one memory buffer by one thread
+static const uint64_t kRecordsPerChunk = 1024;
+/// @brief stream buffer, chunks larger than this are written directly
+static const size_t kWriteBufferSize = 1 << 20;
 
-static FILE *getDefFilePointer(const char *file_name);
+static FILE *getDefFilePointer(const char *file_name, bool gzip);
+static bool writeRecords(FILE *fp, uint64_t num,
+                         const std::function<void(FILE *, uint64_t)> &print);
 static bool writeFileHead(FILE *fp);
 static bool writeVersion(FILE *fp);
 static bool writeDividerChar(FILE *fp);
@@ -69,6 +84,8 @@ int writeDef(int argc, const char **argv) {
     int num_out_file = 0;
     char *def_file_name = nullptr;
     bool debug_mode = false;
+    bool gzip = false;
+    num_threads = 1;
 
     argc--;
     argv++;
@@ -82,6 +99,12 @@ int writeDef(int argc, const char **argv) {
             fprintf(stderr, "\tOverwrite the previous DEF file.\n");
             fprintf(stderr, "options:\n");
             fprintf(stderr, "\t--help -- write output to the file.\n");
+            fprintf(stderr,
+                    "\t-threads <num> -- print COMPONENTS, PINS, NETS and "
+                    "SPECIALNETS on <num> threads.\n");
+            fprintf(stderr,
+                    "\t-gzip -- compress the output, default for *.gz "
+                    "files.\n");
             return ERROR;
         } else if (argv[0][0] != '-') {
             if (num_out_file >= 1) {
@@ -92,6 +115,12 @@ int writeDef(int argc, const char **argv) {
             ++num_out_file;
         } else if (strcmp(*argv, "--debug") == 0) {
             debug_mode = true;
+        } else if (strcmp(*argv, "-threads") == 0 && argc > 0) {
+            argv++;
+            argc--;
+            num_threads = std::max(1, atoi(*argv));
+        } else if (strcmp(*argv, "-gzip") == 0) {
+            gzip = true;
         }
 
         argv++;
@@ -109,7 +138,11 @@ int writeDef(int argc, const char **argv) {
                           "Cannot get top cell when writing DEF file.\n");
         return ERROR;
     }
-    FILE *fp = getDefFilePointer(def_file_name);
+    size_t name_len = strlen(def_file_name);
+    if (name_len > 3 && strcmp(def_file_name + name_len - 3, ".gz") == 0) {
+        gzip = true;
+    }
+    FILE *fp = getDefFilePointer(def_file_name, gzip);
     if (!fp) {
         message->issueMsg(kError, "Open DEF file failed %s.\n", def_file_name);
         return ERROR;
@@ -269,21 +302,118 @@ int writeDef(int argc, const char **argv) {
         return ERROR;
     }
 
-    fclose(fp);
+    if (fclose(fp) != 0) {
+        message->issueMsg(kError, "Write DEF file %s failed.\n",
+                          def_file_name);
+        return ERROR;
+    }
     if (debug_mode == true) ProfilerStop();
     message->info("\nWrite DEF successfully.\n");
     return OK;
 }
 
-static FILE *getDefFilePointer(const char *file_name) {
-    FILE *fp = fopen(file_name, "w");
+/// @brief write of a FILE opened on a gzip stream, see fopencookie
+static ssize_t gzipWrite(void *cookie, const char *buffer, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        unsigned len = std::min<size_t>(size - written, 1U << 30);
+        int ret = gzwrite(static_cast<gzFile>(cookie), buffer + written, len);
+        if (ret <= 0) return -1;
+        written += ret;
+    }
+    return written;
+}
+
+static int gzipClose(void *cookie) {
+    return gzclose(static_cast<gzFile>(cookie)) == Z_OK ? 0 : EOF;
+}
+
+static FILE *getDefFilePointer(const char *file_name, bool gzip) {
+    FILE *fp = nullptr;
+    if (gzip) {
+        gzFile gz = gzopen(file_name, "wb1");
+        if (gz) {
+            cookie_io_functions_t functions = {nullptr, gzipWrite, nullptr,
+                                               gzipClose};
+            fp = fopencookie(gz, "w", functions);
+            if (!fp) gzclose(gz);
+        }
+    } else {
+        fp = fopen(file_name, "w");
+    }
     if (!fp) {
         message->issueMsg(kError, "Cannot open file %s\n", file_name);
         return nullptr;
     }
+    setvbuf(fp, nullptr, _IOFBF, kWriteBufferSize);
     return fp;
 }
 
+/// @brief print records [0, num) in order
+///
+/// With several threads, chunks of records are printed by tasks of the
+/// shared thread pool into memory streams of their own, so threads neither
+/// share a stream lock nor the formatting, and the chunks are then written
+/// in order with one large write each. Batches of chunks keep the memory
+/// bounded, and no more than -threads tasks print at the same time.
+static bool writeRecords(FILE *fp, uint64_t num,
+                         const std::function<void(FILE *, uint64_t)> &print) {
+    if (num_threads <= 1 || num <= kRecordsPerChunk) {
+        for (uint64_t i = 0; i < num; ++i) print(fp, i);
+        return !ferror(fp);
+    }
+
+    struct Chunk {
+        char *buffer;
+        size_t size;
+    };
+    uint64_t num_chunks = (num + kRecordsPerChunk - 1) / kRecordsPerChunk;
+    uint64_t batch_size = 4 * num_threads;
+    std::vector<Chunk> chunks(batch_size);
+    for (uint64_t first = 0; first < num_chunks; first += batch_size) {
+        uint64_t batch = std::min(batch_size, num_chunks - first);
+        // at most num_threads printers, whatever the width of the pool:
+        // each one takes the next chunk nobody printed yet.
+        std::atomic<uint64_t> next_chunk(0);
+        int64_t num_printers = std::min<uint64_t>(num_threads, batch);
+        util::parallelFor(0, num_printers, [&](int64_t begin, int64_t end) {
+            for (int64_t printer = begin; printer < end; ++printer) {
+                uint64_t i = 0;
+                while ((i = next_chunk.fetch_add(1)) < batch) {
+                    Chunk &chunk = chunks[i];
+                    chunk.buffer = nullptr;
+                    chunk.size = 0;
+                    FILE *mem = open_memstream(&chunk.buffer, &chunk.size);
+                    if (!mem) continue;
+                    uint64_t first_record = (first + i) * kRecordsPerChunk;
+                    uint64_t last_record =
+                        std::min(num, first_record + kRecordsPerChunk);
+                    for (uint64_t record = first_record; record < last_record;
+                         ++record) {
+                        print(mem, record);
+                    }
+                    fclose(mem);
+                }
+            }
+        }, 1);
+
+        bool ok = true;
+        for (uint64_t i = 0; i < batch; ++i) {
+            if (chunks[i].buffer == nullptr) {
+                ok = false;
+                continue;
+            }
+            if (ok) fwrite(chunks[i].buffer, 1, chunks[i].size, fp);
+            free(chunks[i].buffer);
+        }
+        if (!ok) {
+            message->issueMsg(kError, "Out of memory when writing DEF file.\n");
+            return false;
+        }
+    }
+    return !ferror(fp);
+}
+
 static bool writeFileHead(FILE *fp) {
     time_t timep;
     time(&timep);
@@ -716,23 +846,20 @@ static bool writeComponents(FILE *fp) {
             "#############\n");
 
     uint64_t num_components = top_cell->getNumOfInsts();
-    ObjectId components = top_cell->getInstances();
-    ArrayObject<ObjectId> *component_vector =
-        Object::addr< ArrayObject<ObjectId> >(components);
+    ObjectRange<Inst> insts = top_cell->insts();
     fprintf(fp, "COMPONENTS %d ;\n", num_components);
-    for (auto iter = component_vector->begin(); iter != component_vector->end();
-         ++iter) {
-        Inst *instance = Object::addr<Inst>(*iter);
+    bool ok = writeRecords(fp, insts.size(), [&insts](FILE *out, uint64_t i) {
+        Inst *instance = insts[i];
         if (!instance) {
             message->issueMsg(
                 kError, "Cannot find instance %d when writting DEF file.\n");
-            continue;
+            return;
         }
-        instance->print(fp);
-    }
+        instance->print(out);
+    });
     fprintf(fp, "END COMPONENTS\n");
 
-    return true;
+    return ok;
 }
 static bool writePins(FILE *fp) {
     uint64_t pin_num = top_cell->getNumOfIOPins();
@@ -740,11 +867,14 @@ static bool writePins(FILE *fp) {
         return true;
     }
     fprintf(fp, "PINS %d ;\n", pin_num);
+    std::vector<Pin *> pins;
+    pins.reserve(pin_num);
     for (int i = 0; i < pin_num; i++) {
         Pin *pin = top_cell->getIOPin(i);
-        if (!pin) {
-            continue;
-        }
+        if (pin) pins.push_back(pin);
+    }
+    bool ok = writeRecords(fp, pins.size(), [&pins](FILE *fp, uint64_t index) {
+        Pin *pin = pins[index];
         fprintf(fp, "    - %s", pin->getName().c_str());
         Net *net = pin->getNet();
         fprintf(fp, " + NET %s\n", (net ? net->getName().c_str() : "ERROR"));
@@ -1032,9 +1162,9 @@ static bool writePins(FILE *fp) {
             }
         }
         fprintf(fp, "    ;\n");
-    }
+    });
     fprintf(fp, "END PINS\n");
-    return true;
+    return ok;
 }
 static bool writePinProperties(FILE *fp) { return true; }
 static bool writeBlockages(FILE *fp) {
@@ -1209,42 +1339,38 @@ static bool writeFills(FILE *fp) {
 static bool writeSpecialNets(FILE *fp) {
     int special_nets_num = top_cell->getNumOfSpecialNets();
     if (special_nets_num == 0) return true;
-    ObjectId special_nets = top_cell->getSpecialNets();
-    ArrayObject<ObjectId> *special_net_vector =
-        Object::addr< ArrayObject<ObjectId> >(special_nets);
+    ObjectRange<SpecialNet> special_nets = top_cell->specialNets();
     fprintf(fp, "\nSPECIALNETS %d ;\n", special_nets_num);
-    for (int i = 0; i < special_net_vector->getSize(); ++i) {
-        SpecialNet *special_net =
-            Object::addr<SpecialNet>((*special_net_vector)[i]);
+    bool ok = writeRecords(fp, special_nets.size(),
+                           [&special_nets](FILE *out, uint64_t i) {
+        SpecialNet *special_net = special_nets[i];
         if (!special_net) {
             message->issueMsg(
                 kError, "Cannot find special net %d when writting DEF file.\n");
-            continue;
+            return;
         }
-        special_net->printDEF(fp);
-    }
+        special_net->printDEF(out);
+    });
     fprintf(fp, "END SPECIALNETS\n");
-    return true;
+    return ok;
 }
 static bool writeNets(FILE *fp) {
     int nets_num = top_cell->getNumOfNets();
     if (nets_num == 0) return true;
-    ObjectId nets = top_cell->getNets();
-    ArrayObject<ObjectId> *net_vector =
-                                   Object::addr< ArrayObject<ObjectId> >(nets);
+    ObjectRange<Net> nets = top_cell->nets();
     fprintf(fp, "\nNETS %d ;\n", nets_num);
-    for (auto iter = net_vector->begin(); iter != net_vector->end(); ++iter) {
-        Net *net = Object::addr<Net>(*iter);
+    bool ok = writeRecords(fp, nets.size(), [&nets](FILE *out, uint64_t i) {
+        Net *net = nets[i];
         if (!net) {
             message->issueMsg(kError,
                               "Cannot find net %d when writting DEF file.\n");
-            continue;
+            return;
         }
-        net->printDEF(fp);
-    }
+        net->printDEF(out);
+    });
     fprintf(fp, "END NETS\n");
 
-    return true;
+    return ok;
 }
 static void writeScanChainPoint(FILE *fp, ScanChainPoint *point,
                                 bool is_start) {
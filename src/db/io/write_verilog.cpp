@@ -147,21 +147,19 @@ static bool writeModule(std::ostream *out_stream, Cell *cell) {
     std::vector<Net*> assign_nets;
     ObjectId nets = cell->getNets();
     if ( nets > 0 ) {
-        Net *net = nullptr;
-        ArrayObject<ObjectId> *net_vector
-                                   = cell->addr< ArrayObject<ObjectId> >(nets);
-        if (!net_vector) {
+        if (!cell->getNetArray()) {
             message->issueMsg(kError,
                     "cannot get net vector from id %d of cell %s.\n",
                     nets, cell->getName().c_str());
             return false;
         }
-        for (int i = 0; i < net_vector->getSize(); ++i) {
-            net = cell->addr<Net>((*net_vector)[i]);
+        ObjectRange<Net> net_range = cell->nets();
+        for (auto iter = net_range.begin(); iter != net_range.end(); ++iter) {
+            Net *net = *iter;
             if (!net) {
                 message->issueMsg(kError,
                         "cannot get net from id %d of cell %s.\n",
-                        (*net_vector)[i], cell->getName().c_str());
+                        iter.getId(), cell->getName().c_str());
                 return false;
             }
             if (!(net->getIsBusNet()) && !(net->getIsOfBus())
@@ -230,21 +228,19 @@ static bool writeModule(std::ostream *out_stream, Cell *cell) {
     // instance
     ObjectId insts = cell->getInstances();
     if ( insts > 0 ) {
-        Inst *inst = nullptr;
-        ArrayObject<ObjectId> *inst_vector
-                                  = cell->addr< ArrayObject<ObjectId> >(insts);
-        if (!inst_vector) {
+        if (!cell->getInstanceArray()) {
             message->issueMsg(kError,
                     "cannot get instance vector from id %d of cell %s.\n",
                     insts, cell->getName().c_str());
             return false;
         }
-        for (int i = 0; i < inst_vector->getSize(); ++i) {
-            inst = cell->addr<Inst>((*inst_vector)[i]);
+        ObjectRange<Inst> inst_range = cell->insts();
+        for (auto iter = inst_range.begin(); iter != inst_range.end(); ++iter) {
+            Inst *inst = *iter;
             if (!inst) {
                 message->issueMsg(kError,
                         "cannot get instance from id %d of cell %s.\n",
-                        (*inst_vector)[i], cell->getName().c_str());
+                        iter.getId(), cell->getName().c_str());
                 return false;
             }
             Cell *master = inst->getMaster();
@@ -257,23 +253,21 @@ static bool writeModule(std::ostream *out_stream, Cell *cell) {
 
             *out_stream << "  " << master->getName() << " "
                         << inst->getName() << " (";
-            ObjectId pins = inst->getPins();
-            ArrayObject<ObjectId> *pins_vector =
-                    cell->addr<ArrayObject<ObjectId>>(pins);
-            if (!pins_vector) {
+            if (!inst->getPinArray()) {
                 message->issueMsg(kError,
                         "cannot get pins vector from id %d of instance %s.\n",
-                        pins, inst->getName().c_str());
+                        inst->getPins(), inst->getName().c_str());
                 //return false;
             }
             first = true;
-            for (int j = 0; pins_vector && j < pins_vector->getSize(); j++) {
-                ObjectId pin_id = (*pins_vector)[j];
-                Pin *pin = cell->addr<Pin>(pin_id);
+            ObjectRange<Pin> pin_range = inst->pins();
+            for (auto pin_iter = pin_range.begin();
+                    pin_iter != pin_range.end(); ++pin_iter) {
+                Pin *pin = *pin_iter;
                 if (!pin) {
                     message->issueMsg(kError,
                             "cannot get pin from id %d of instance %s.\n",
-                            pin_id, inst->getName().c_str());
+                            pin_iter.getId(), inst->getName().c_str());
                     return false;
                 }
                 if (first) {
@@ -291,13 +285,8 @@ static bool writeModule(std::ostream *out_stream, Cell *cell) {
                     }
                 } else {
                     *out_stream << "{ ";
-                    ArrayObject<ObjectId> *net_array = pin->getNetArray();
-                    ArrayObject<ObjectId>::iterator iter;
-                    Net *net = nullptr;
                     bool first_net = true;
-                    for (iter = net_array ->begin(); iter != net_array->end();
-                            ++iter) {
-                        net = cell->addr<Net>(*iter);
+                    for (Net *net : ObjectRange<Net>(pin->getNetArray())) {
                         if (net) {
                             if (!first_net) {
                                 *out_stream << ", ";
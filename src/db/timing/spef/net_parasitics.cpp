@@ -13,8 +13,14 @@
  */
 
 #include "db/timing/spef/net_parasitics.h"
+#include <string.h>
+
+#include <algorithm>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "db/core/db.h"
 #include "db/core/timing.h"
@@ -34,164 +40,169 @@ NetParasitics::NetParasitics()
 NetParasitics::~NetParasitics() {
 }
 
+/// Blocks of RC networks are a power of two bytes, so that freeArray
+/// recycles them. Networks larger than kRcBlockSize are split.
+static const uint64_t kRcBlockSize = 1ULL << (MEM_PAGE_SIZE_BIT - 2);
+
+/// @brief __getRcBlockSize bytes allocated for size bytes of a network
+static uint64_t __getRcBlockSize(uint64_t size) {
+    uint64_t block_size = 1ULL << MEM_ALIGN_BIT;
+    while (block_size < size) block_size <<= 1;
+    return block_size;
+}
+
+struct RcNetworkDeleter {
+    void operator()(RcNetwork *network) const { RcNetwork::destroy(network); }
+};
+
+/// Networks split into blocks, in one piece on the heap for readers, by
+/// DNetParasitics id. They are kept out of the pool, the blocks are what
+/// is saved.
+static std::mutex kSplitRcNetworksMutex;
+static std::unordered_map<ObjectId,
+                          std::unique_ptr<RcNetwork, RcNetworkDeleter>>
+    kSplitRcNetworks;
+
 DNetParasitics::DNetParasitics()
     : NetParasitics(),
-      pinNodeVecId_(UNINIT_OBJECT_ID),
-      gCapVecId_(UNINIT_OBJECT_ID),
-      xCapVecId_(UNINIT_OBJECT_ID),
-      resVecId_(UNINIT_OBJECT_ID) {
+      rcNetworkId_(UNINIT_OBJECT_ID),
+      numRcBlocks_(0) {
     setObjectType(ObjectType::kObjectTypeDNetParasitics);
 }
 
-void DNetParasitics::addPinNode(ObjectId pinNodeId) {
-    ArrayObject<ObjectId> *vct = nullptr;
-    Timing *timingdb = getTimingLib();
-    if (timingdb) {
-        if (pinNodeVecId_ == UNINIT_OBJECT_ID) {
-            vct = timingdb->createObject< ArrayObject<ObjectId> >(kObjectTypeArray, timingdb->getId());
-            if (vct != nullptr) {
-                vct->setPool(timingdb->getPool());
-                vct->reserve(5);
-                pinNodeVecId_ = vct->getId();
-            }
-        } else 
-            vct = addr< ArrayObject<ObjectId> >(pinNodeVecId_);
-                
-        if (vct != nullptr)
-            vct->pushBack(pinNodeId);    
-    }
+DNetParasitics::~DNetParasitics() {
+    __setRcNetwork(UNINIT_OBJECT_ID, 0);
 }
 
-ObjectId DNetParasitics::createPinNode(ObjectId pinId) {
-    //Cell *timingdb = getTopCell();
-    //Cell *timingdb = Object::addr<Cell>(cellId);
-    Timing *timingdb = getTimingLib();
-    if (timingdb) {
-        auto pinNode = timingdb->createObject<ParasiticPinNode>(kObjectTypeParasiticPinNode, timingdb->getId());
-        if (pinNode) {
-            pinNode->setOwner(this);
-	    pinNode->setPinId(pinId);
-	    return pinNode->getId();
-        }
-    }
-    return UNINIT_OBJECT_ID;
+const RcNetwork *DNetParasitics::getRcNetwork() const {
+    if (rcNetworkId_ == UNINIT_OBJECT_ID) return nullptr;
+    if (numRcBlocks_ > 1) return __getSplitRcNetwork();
+    return addr<RcNetwork>(rcNetworkId_);
 }
 
-ObjectId DNetParasitics::createIntNode(uint32_t intNodeId) {
-    //Cell *timingdb = getTopCell();
-    //Cell *timingdb = Object::addr<Cell>(cellId);
-    Timing *timingdb = getTimingLib();
-    if (timingdb) {
-        auto intNode = timingdb->createObject<ParasiticIntNode>(kObjectTypeParasiticIntNode, timingdb->getId());
-        if (intNode) {
-            intNode->setOwner(this);
-            intNode->setIntNodeId(intNodeId);
-            return intNode->getId();
-        }
+/// @brief __getSplitRcNetwork the heap copy of a split network, made from
+/// its blocks on first use, e.g. after the pool is restored
+const RcNetwork *DNetParasitics::__getSplitRcNetwork() const {
+    std::lock_guard<std::mutex> lock(kSplitRcNetworksMutex);
+    auto found = kSplitRcNetworks.find(getId());
+    if (found != kSplitRcNetworks.end()) return found->second.get();
+
+    const ObjectId *blocks = addr<ObjectId>(rcNetworkId_);
+    const RcNetwork *first = addr<RcNetwork>(blocks[0]);
+    uint64_t size = first->getMemorySize();
+    char *data = static_cast<char *>(::operator new(size));
+    for (uint32_t i = 0; i < numRcBlocks_; ++i) {
+        uint64_t offset = i * kRcBlockSize;
+        memcpy(data + offset, addr<char>(blocks[i]),
+               std::min(kRcBlockSize, size - offset));
     }
-    return UNINIT_OBJECT_ID;
+    RcNetwork *network = reinterpret_cast<RcNetwork *>(data);
+    kSplitRcNetworks[getId()].reset(network);
+    return network;
 }
 
-ObjectId DNetParasitics::createExtNode(ObjectId netId, uint32_t extNodeId) {
-    //Cell *timingdb = getTopCell();
-    //Cell *timingdb = Object::addr<Cell>(cellId);
-    Timing *timingdb = getTimingLib();
-    if (timingdb) {
-        auto extNode = timingdb->createObject<ParasiticExtNode>(kObjectTypeParasiticExtNode, timingdb->getId());
-        if (extNode) {
-            extNode->setOwner(this);
-	    extNode->setExtNetId(netId);
-            extNode->setExtNodeId(extNodeId);
-            return extNode->getId();
-        }
+/// @brief __setRcNetwork replace the network, the blocks of the old one go
+/// back to the pool
+void DNetParasitics::__setRcNetwork(ObjectId id, uint32_t numBlocks) {
+    ObjectId old_id = rcNetworkId_;
+    uint32_t old_num_blocks = numRcBlocks_;
+    rcNetworkId_ = id;
+    numRcBlocks_ = numBlocks;
+    if (old_id == UNINIT_OBJECT_ID) return;
+    MemPagePool *pool = MemPool::getPagePoolByObjectId(getId());
+    if (pool == nullptr) return;
+    if (old_num_blocks <= 1) {
+        uint64_t size = addr<RcNetwork>(old_id)->getMemorySize();
+        pool->freeArray<char>(old_id, __getRcBlockSize(size));
+        return;
     }
-    return UNINIT_OBJECT_ID;
-}
 
-void DNetParasitics::addGroundCap(ObjectId nodeId, float capValue) {
-    //Cell *timingdb = getTopCell();
-    //Cell *timingdb = Object::addr<Cell>(cellId);
-    Timing *timingdb = getTimingLib();
-    if (timingdb) {
-        auto gCap = timingdb->createObject<ParasiticCap>(kObjectTypeParasiticCap, timingdb->getId());
-        if (gCap) {
-            gCap->setOwner(this);
-	    gCap->setNode1Id(nodeId);
-	    gCap->setCapacitance(capValue);
-
-	    ArrayObject<ObjectId> *vct = nullptr;
-            if (gCapVecId_ == UNINIT_OBJECT_ID) {
-                vct = timingdb->createObject< ArrayObject<ObjectId> >(kObjectTypeArray, timingdb->getId());
-                if (vct == nullptr)
-		    return;
-                vct->setPool(timingdb->getPool());
-                vct->reserve(50);
-                gCapVecId_ = vct->getId();
-            } else {
-                vct = addr< ArrayObject<ObjectId> >(gCapVecId_);
-            }
-            if (vct != nullptr)
-                vct->pushBack(gCap->getId());
+    std::unique_ptr<RcNetwork, RcNetworkDeleter> old;
+    {
+        std::lock_guard<std::mutex> lock(kSplitRcNetworksMutex);
+        auto found = kSplitRcNetworks.find(getId());
+        if (found != kSplitRcNetworks.end()) {
+            old = std::move(found->second);
+            kSplitRcNetworks.erase(found);
         }
     }
+    const ObjectId *blocks = addr<ObjectId>(old_id);
+    uint64_t size = addr<RcNetwork>(blocks[0])->getMemorySize();
+    for (uint32_t i = 0; i < old_num_blocks; ++i) {
+        uint64_t offset = i * kRcBlockSize;
+        pool->freeArray<char>(
+            blocks[i], __getRcBlockSize(std::min(kRcBlockSize, size - offset)));
+    }
+    pool->freeArray<ObjectId>(old_id, __getRcBlockSize(old_num_blocks));
 }
 
-void DNetParasitics::addCouplingCap(ObjectId node1Id, ObjectId node2Id, float capValue) {
-    //Cell *timingdb = getTopCell();
-    //Cell *timingdb = Object::addr<Cell>(cellId);
-    Timing *timingdb = getTimingLib();
-    if (timingdb) {
-        auto xCap = timingdb->createObject<ParasiticXCap>(kObjectTypeParasiticXCap, timingdb->getId());
-        if (xCap) {
-            xCap->setOwner(this);
-            xCap->setNode1Id(node1Id);
-	    xCap->setNode2Id(node2Id);
-            xCap->setCapacitance(capValue);
-
-	    ArrayObject<ObjectId> *vct = nullptr;
-            if (xCapVecId_ == UNINIT_OBJECT_ID) {
-                vct = timingdb->createObject< ArrayObject<ObjectId> >(kObjectTypeArray, timingdb->getId());
-                if (vct == nullptr)
-                    return;
-                vct->setPool(timingdb->getPool());
-                vct->reserve(20);
-                gCapVecId_ = vct->getId();
-            } else {
-                vct = addr< ArrayObject<ObjectId> >(xCapVecId_);
-            }
-            if (vct != nullptr)
-                vct->pushBack(xCap->getId());
-        }
-    }
+/// @brief __copyRcNetwork a writable copy of a block: in the pool if it
+/// fits one block, on the heap for __storeRcNetwork to split otherwise
+RcNetwork *DNetParasitics::__copyRcNetwork(const void *block, uint64_t size) {
+    if (!RcNetwork::isValid(block, size)) return nullptr;
+    if (size > kRcBlockSize) return RcNetwork::copy(block, size);
+    MemPagePool *pool = MemPool::getPagePoolByObjectId(getId());
+    if (pool == nullptr) return nullptr;
+    ObjectId id = UNINIT_OBJECT_ID;
+    char *copy = pool->allocateArray<char>(__getRcBlockSize(size), id);
+    if (copy == nullptr) return nullptr;
+    memcpy(copy, block, size);
+    __setRcNetwork(id, 1);
+    return reinterpret_cast<RcNetwork *>(copy);
 }
 
-void DNetParasitics::addResistor(ObjectId node1Id, ObjectId node2Id, float resValue) {
-    //Cell *timingdb = getTopCell();
-    //Cell *timingdb = Object::addr<Cell>(cellId);
-    Timing *timingdb = getTimingLib();
-    if (timingdb) {
-        auto res = timingdb->createObject<ParasiticResistor>(kObjectTypeParasiticResistor, timingdb->getId());
-        if (res) {
-            res->setOwner(this);
-            res->setNode1Id(node1Id);
-	    res->setNode2Id(node2Id);
-            res->setResistance(resValue);
-
-	    ArrayObject<ObjectId> *vct = nullptr;
-            if (resVecId_ == UNINIT_OBJECT_ID) {
-                vct = timingdb->createObject< ArrayObject<ObjectId> >(kObjectTypeArray, timingdb->getId());
-                if (vct == nullptr)
-                    return;
-                vct->setPool(timingdb->getPool());
-                vct->reserve(50);
-                resVecId_ = vct->getId();
-            } else {
-                vct = addr< ArrayObject<ObjectId> >(resVecId_);
-            }
-            if (vct != nullptr)
-                vct->pushBack(res->getId());
-        }
+/// @brief __storeRcNetwork make a network of __copyRcNetwork the one of
+/// this net, a heap one is split into blocks and kept for readers
+RcNetwork *DNetParasitics::__storeRcNetwork(RcNetwork *network) {
+    if (numRcBlocks_ == 1 && addr<RcNetwork>(rcNetworkId_) == network)
+        return network;
+    std::unique_ptr<RcNetwork, RcNetworkDeleter> owned(network);
+    MemPagePool *pool = MemPool::getPagePoolByObjectId(getId());
+    if (pool == nullptr) return nullptr;
+    uint64_t size = network->getMemorySize();
+    uint32_t num_blocks = (size + kRcBlockSize - 1) / kRcBlockSize;
+    ObjectId id = UNINIT_OBJECT_ID;
+    ObjectId *blocks =
+        pool->allocateArray<ObjectId>(__getRcBlockSize(num_blocks), id);
+    if (blocks == nullptr) return nullptr;
+    const char *data = reinterpret_cast<const char *>(network);
+    for (uint32_t i = 0; i < num_blocks; ++i) {
+        uint64_t offset = i * kRcBlockSize;
+        uint64_t length = std::min(kRcBlockSize, size - offset);
+        char *block =
+            pool->allocateArray<char>(__getRcBlockSize(length), blocks[i]);
+        if (block == nullptr) return nullptr;
+        memcpy(block, data + offset, length);
     }
+    __setRcNetwork(id, num_blocks);
+    std::lock_guard<std::mutex> lock(kSplitRcNetworksMutex);
+    kSplitRcNetworks[getId()] = std::move(owned);
+    return network;
+}
+
+RcNetwork *DNetParasitics::createRcNetwork(const RcNetworkBuilder &builder) {
+    uint64_t size = RcNetwork::getPackedSize(builder);
+    if (size > kRcBlockSize) return __storeRcNetwork(RcNetwork::create(builder));
+    MemPagePool *pool = MemPool::getPagePoolByObjectId(getId());
+    if (pool == nullptr) return nullptr;
+    ObjectId id = UNINIT_OBJECT_ID;
+    char *block = pool->allocateArray<char>(__getRcBlockSize(size), id);
+    if (block == nullptr) return nullptr;
+    __setRcNetwork(id, 1);
+    return RcNetwork::pack(builder, block);
+}
+
+RcNetwork *DNetParasitics::copyRcNetwork(const void *block, uint64_t size) {
+    RcNetwork *network = __copyRcNetwork(block, size);
+    if (network == nullptr) return nullptr;
+    return __storeRcNetwork(network);
+}
+
+void DNetParasitics::resetSplitRcNetworks() {
+    std::unordered_map<ObjectId, std::unique_ptr<RcNetwork, RcNetworkDeleter>>
+        old;
+    std::lock_guard<std::mutex> lock(kSplitRcNetworksMutex);
+    old.swap(kSplitRcNetworks);
 }
 
 RNetParasitics::RNetParasitics()
@@ -202,5 +213,8 @@ RNetParasitics::RNetParasitics()
     setObjectType(ObjectType::kObjectTypeRNetParasitics);
 }
 
+RNetParasitics::~RNetParasitics() {
+}
+
 }  // namespace db
 }  // namespace open_edi
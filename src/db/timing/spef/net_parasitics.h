@@ -24,7 +24,7 @@
 #include "db/core/object.h"
 #include "db/util/array.h"
 #include "util/data_traits.h"
-#include "parasitic_device.h"
+#include "db/timing/spef/rc_network.h"
 
 namespace open_edi {
 namespace db {
@@ -52,36 +52,54 @@ class NetParasitics : public Object {
 class DNetParasitics : public NetParasitics {
   public:
     DNetParasitics();
+    /// @brief destructor, gives the blocks of the RC network back to the
+    /// pool
     ~DNetParasitics();
-    ObjectId getPinNodeVecId() const { return pinNodeVecId_; }
-    ObjectId getGroundCapVecId() const { return gCapVecId_; }
-    ObjectId getCouplingCapVecId() const { return xCapVecId_; }
-    ObjectId getResistorVecId() const { return resVecId_; } 
-
-    ObjectId createPinNode(ObjectId pinId);
-    ObjectId createIntNode(uint32_t intNodeId);
-    ObjectId createExtNode(ObjectId netId, uint32_t extNodeId);
-    void addPinNode(ObjectId pinNodeId);
-    void addGroundCap(ObjectId nodeId, float capValue);
-    void addCouplingCap(ObjectId node1Id, ObjectId node2Id, float capValue);
-    void addResistor(ObjectId node1Id, ObjectId node2Id, float resValue);
-    
+    /// @brief the RC network, nullptr before the end of the D_NET
+    const RcNetwork *getRcNetwork() const;
+    /// @brief pack the network of a builder into the pool of this object
+    RcNetwork *createRcNetwork(const RcNetworkBuilder &builder);
+    /// @brief copy a packed block into the pool of this object
+    ///
+    /// @return the copy, nullptr if the block is not valid
+    RcNetwork *copyRcNetwork(const void *block, uint64_t size);
+    /// @brief copy a packed block into the pool of this object, with each
+    /// pin and external net id replaced by map(id)
+    template <class Map>
+    RcNetwork *copyRcNetwork(const void *block, uint64_t size, Map map);
+    /// @brief drop the heap copies of the networks split into blocks, e.g.
+    /// along with the timing lib
+    static void resetSplitRcNetworks();
 
   protected:
     /// @brief overload output stream
     //friend OStreamBase &operator<<(OStreamBase &os, DNetParasitics const &rhs);
 
   private:
-    /// The vector to store Pin Node pointer belongs to this net
-    ObjectId pinNodeVecId_;
-    /// The vector to store Grounded Cap pointer belongs to this net
-    ObjectId gCapVecId_;
-    /// The vector to store Coupling Cap pointer belongs to this net
-    ObjectId xCapVecId_;
-    /// The vector to store Resistor pointer belongs to this net
-    ObjectId resVecId_;
+    RcNetwork *__copyRcNetwork(const void *block, uint64_t size);
+    RcNetwork *__storeRcNetwork(RcNetwork *network);
+    void __setRcNetwork(ObjectId id, uint32_t numBlocks);
+    const RcNetwork *__getSplitRcNetwork() const;
+
+    /// Nodes, capacitors and resistors of this net in one block of the
+    /// pool, so that the network is saved and restored with the object.
+    /// Networks larger than kRcBlockSize are split into blocks of that
+    /// size, listed by a directory block.
+    ObjectId rcNetworkId_;
+    /// 1 if rcNetworkId_ is the network, the number of blocks listed by
+    /// the directory rcNetworkId_ otherwise
+    uint32_t numRcBlocks_;
 };
 
+template <class Map>
+RcNetwork *DNetParasitics::copyRcNetwork(const void *block, uint64_t size,
+                                         Map map) {
+    RcNetwork *network = __copyRcNetwork(block, size);
+    if (network == nullptr) return nullptr;
+    network->mapObjectIds(map);
+    return __storeRcNetwork(network);
+}
+
 class RNetParasitics : public NetParasitics {
   public:
     RNetParasitics();
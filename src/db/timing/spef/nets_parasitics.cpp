@@ -17,8 +17,15 @@
 #include <stdio.h>
 #include <time.h>
 #include "stdlib.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "db/core/db.h"
 #include "db/core/timing.h"
+#include "db/timing/spef/spef_lazy_loader.h"
 #include "util/stream.h"
 
 namespace open_edi {
@@ -43,6 +50,7 @@ NetsParasitics::NetsParasitics()
 }
 
 NetsParasitics::~NetsParasitics() {
+    setLazyLoader(nullptr);
 }
 
 NetsParasitics::NetsParasitics(Object* owner, NetsParasitics::IndexType id)
@@ -136,7 +144,7 @@ bool NetsParasitics::isDigits(const char *str)
 Net* NetsParasitics::getNetBySymbol(SymbolIndex index) {
     Cell *cell = Object::addr<Cell>(cellId_);
     if (cell) {
-        std::vector<ObjectId> objectVec = cell->getSymbolTable()->getReferences(index);
+        std::vector<ObjectId> &objectVec = cell->getSymbolTable()->getReferences(index);
         for (auto obj : objectVec) {
             Net *net = Object::addr<Net>(obj);
             if (net && net->getObjectType() == kObjectTypeNet) {
@@ -156,8 +164,9 @@ Net* NetsParasitics::findNet(const char *netName) {
     if (cell && netName) {
 	if (netName[0] == '*') {
 	    uint32_t idx = strtoul(netName+1, NULL, 0);
-	    if (nameMap_.find(idx) != nameMap_.end()) {
-		net = getNetBySymbol(nameMap_[idx]);
+	    auto found = nameMap_.find(idx);
+	    if (found != nameMap_.end()) {
+		net = getNetBySymbol(found->second);
             } 
         } else 
 	    net = cell->getNet(netStr); 
@@ -169,24 +178,31 @@ Net* NetsParasitics::findNet(const char *netName) {
     return net;
 }
 
-Pin* NetsParasitics::getPinBySymbol(SymbolIndex index, const std::string& pinName) {
+Inst* NetsParasitics::getInstBySymbol(SymbolIndex index) {
     Cell *cell = Object::addr<Cell>(cellId_);
     if (cell) {
-        std::vector<ObjectId> objectVec = cell->getSymbolTable()->getReferences(index);
+        std::vector<ObjectId> &objectVec = cell->getSymbolTable()->getReferences(index);
 	for (auto obj : objectVec) {
 	    Inst *inst = Object::addr<Inst>(obj);
             if (inst && inst->getObjectType() == kObjectTypeInst) {
-		return inst->getPin(pinName);	
+		return inst;
 	    }
 	}
     }
     return nullptr;
 }
 
+Pin* NetsParasitics::getPinBySymbol(SymbolIndex index, const std::string& pinName) {
+    Inst *inst = getInstBySymbol(index);
+    if (inst)
+        return inst->getPin(pinName);
+    return nullptr;
+}
+
 Pin* NetsParasitics::getPortBySymbol(SymbolIndex index) {
     Cell *cell = Object::addr<Cell>(cellId_);
     if (cell) {
-        std::vector<ObjectId> objectVec = cell->getSymbolTable()->getReferences(index);
+        std::vector<ObjectId> &objectVec = cell->getSymbolTable()->getReferences(index);
         for (auto obj : objectVec) {
             Pin *pin = Object::addr<Pin>(obj);
             if (pin && pin->getObjectType() == kObjectTypePin) {
@@ -197,26 +213,36 @@ Pin* NetsParasitics::getPortBySymbol(SymbolIndex index) {
     return nullptr;
 }
 
+Inst* NetsParasitics::findInst(const std::string &instName) {
+    Cell *cell = Object::addr<Cell>(cellId_);
+    if (cell) {
+        if (instName[0] == '*') {
+            uint32_t idx = strtoul(instName.c_str()+1, NULL, 0);
+            auto found = nameMap_.find(idx);
+            if (found != nameMap_.end())
+                return getInstBySymbol(found->second);
+        } else {  //Name map doesn't exist
+            return cell->getInstance(instName);
+        }
+    }
+    return nullptr;
+}
+
 Pin* NetsParasitics::findPin(const char *pinName) {
     Cell *cell = Object::addr<Cell>(cellId_);
     if (cell && pinName) {
         std::string pinStr = pinName;
 	std::size_t found = pinStr.find_last_of(delimiter_);
 	if (found != std::string::npos) {
-            if (pinName[0] == '*') {
-                uint32_t idx = strtoul(pinStr.substr(1, found).c_str(), NULL, 0);
-                if (nameMap_.find(idx) != nameMap_.end()) 
-		    return getPinBySymbol(nameMap_[idx], pinStr.substr(found+1));
-            } else {  //Name map doesn't exist
-		Inst *inst = cell->getInstance(pinStr.substr(0, found));
-		if (inst)
-		    return inst->getPin(pinStr.substr(found+1));
-	    }
+	    Inst *inst = findInst(pinStr.substr(0, found));
+	    if (inst)
+		return inst->getPin(pinStr.substr(found+1));
         } else {  //Handle IO pin
             if (pinName[0] == '*') {
 		uint32_t idx = strtoul(pinName+1, NULL, 0);
-		if (nameMap_.find(idx) != nameMap_.end()) {
-		    return getPortBySymbol(nameMap_[idx]);
+		auto found = nameMap_.find(idx);
+		if (found != nameMap_.end()) {
+		    return getPortBySymbol(found->second);
                 } 
 	    } else 
                 return cell->getIOPin(pinStr); 
@@ -225,7 +251,8 @@ Pin* NetsParasitics::findPin(const char *pinName) {
     return nullptr;
 }
 
-ObjectId  NetsParasitics::createParaNode(DNetParasitics *netParasitics, const char *nodeName) {
+uint32_t NetsParasitics::createParaNode(DNetParasitics *netParasitics, RcNetworkBuilder *builder,
+                                        const char *nodeName) {
     //Cell *topCell = getTopCell();   //Need to use current cell in future
     Cell *cell = Object::addr<Cell>(cellId_);
     if (cell && nodeName) {
@@ -237,36 +264,26 @@ ObjectId  NetsParasitics::createParaNode(DNetParasitics *netParasitics, const ch
 	    if (isDigits(nodeStr.substr(found+1).c_str())) {  //Never see use all number for term name
                 net = findNet(nodeStr.substr(0, found).c_str());
                 if (net == nullptr)
-                    return UNINIT_OBJECT_ID;
+                    return RcNetwork::kInvalidNode;
 		else if (net->getId() == netParasitics->getNetId()) { //Internal node
 		    uint32_t intNodeId = strtoul(nodeStr.substr(found+1).c_str(), NULL, 0);
-                    return netParasitics->createIntNode(intNodeId);
+                    return builder->addIntNode(intNodeId);
 		} else {  //External node
 		    uint32_t extNodeId = strtoul(nodeStr.substr(found+1).c_str(), NULL, 0);
-		    return netParasitics->createExtNode(net->getId(), extNodeId);
+		    return builder->addExtNode(net->getId(), extNodeId);
 		}
             } else { //Pin node
 		pin = findPin(nodeName);
-		if (pin != nullptr) {
-		    ObjectId pinNodeId = netParasitics->createPinNode(pin->getId());
-                    /*if (pin->getNet()->getId() == netParasitics->getNetId()) { //Add internal pin node
-                        netParasitics->addPinNode(pinNodeId);
-		    }*/
-                    return pinNodeId;
-		}
+		if (pin != nullptr)
+                    return builder->addPinNode(pin->getId());
 	    }
         } else { //To handle IO pin
 	    pin = findPin(nodeName);
-            if (pin != nullptr) {
-		ObjectId pinNodeId = netParasitics->createPinNode(pin->getId());
-                /*if (pin->getNet()->getId() == netParasitics->getNetId()) { //Add internal pin node
-                    netParasitics->addPinNode(pinNodeId);
-                }*/
-		return pinNodeId;
-	    } 
+            if (pin != nullptr)
+		return builder->addPinNode(pin->getId());
 	}
     }
-    return UNINIT_OBJECT_ID;
+    return RcNetwork::kInvalidNode;
 }
 
 DNetParasitics* NetsParasitics::addDNetParasitics(ObjectId netId, float totCap) {
@@ -305,6 +322,81 @@ RNetParasitics* NetsParasitics::addRNetParasitics(ObjectId netId, float totCap)
     return nullptr;
 }
 
+NetParasitics* NetsParasitics::getNetParasitics(ObjectId netId) {
+    SpefReader::SpefLazyLoader *lazyLoader = getLazyLoader();
+    if (lazyLoader)
+        return lazyLoader->load(netId);
+    return findNetParasitics(netId);
+}
+
+NetParasitics* NetsParasitics::findNetParasitics(ObjectId netId) const {
+    auto found = netParasiticsMap_.find(netId);
+    if (found == netParasiticsMap_.end())
+        return nullptr;
+    return Object::addr<NetParasitics>(found->second);
+}
+
+void NetsParasitics::removeNetParasitics(ObjectId netId) {
+    auto found = netParasiticsMap_.find(netId);
+    if (found == netParasiticsMap_.end())
+        return;
+    NetParasitics *netPara = Object::addr<NetParasitics>(found->second);
+    netParasiticsMap_.erase(found);
+    if (netPara == nullptr)
+        return;
+    if (netPara->getObjectType() == ObjectType::kObjectTypeDNetParasitics)
+        Object::deleteObject<DNetParasitics>(static_cast<DNetParasitics*>(netPara));
+    else if (netPara->getObjectType() == ObjectType::kObjectTypeRNetParasitics)
+        Object::deleteObject<RNetParasitics>(static_cast<RNetParasitics*>(netPara));
+}
+
+std::vector<ObjectId> NetsParasitics::getParasiticNetIds() const {
+    SpefReader::SpefLazyLoader *lazyLoader = getLazyLoader();
+    if (lazyLoader)
+        return lazyLoader->getNetIds();
+    std::vector<ObjectId> netIds;
+    netIds.reserve(netParasiticsMap_.size());
+    for (auto obj : netParasiticsMap_)
+        netIds.push_back(obj.first);
+    return netIds;
+}
+
+/// Loaders of lazily read SPEF files, by NetsParasitics id. The count lets
+/// the nets of files read at once skip the lock.
+static std::mutex kLazyLoadersMutex;
+static std::unordered_map<ObjectId, std::unique_ptr<SpefReader::SpefLazyLoader>> kLazyLoaders;
+static std::atomic<uint64_t> kNumLazyLoaders(0);
+
+void NetsParasitics::setLazyLoader(SpefReader::SpefLazyLoader *lazyLoader) {
+    std::unique_ptr<SpefReader::SpefLazyLoader> old;
+    std::lock_guard<std::mutex> lock(kLazyLoadersMutex);
+    auto found = kLazyLoaders.find(getId());
+    if (found != kLazyLoaders.end()) {
+        if (found->second.get() == lazyLoader)
+            return;
+        old = std::move(found->second);
+        kLazyLoaders.erase(found);
+    }
+    if (lazyLoader)
+        kLazyLoaders[getId()].reset(lazyLoader);
+    kNumLazyLoaders.store(kLazyLoaders.size(), std::memory_order_release);
+}
+
+SpefReader::SpefLazyLoader* NetsParasitics::getLazyLoader() const {
+    if (kNumLazyLoaders.load(std::memory_order_acquire) == 0)
+        return nullptr;
+    std::lock_guard<std::mutex> lock(kLazyLoadersMutex);
+    auto found = kLazyLoaders.find(getId());
+    return found == kLazyLoaders.end() ? nullptr : found->second.get();
+}
+
+void NetsParasitics::resetLazyLoaders() {
+    std::unordered_map<ObjectId, std::unique_ptr<SpefReader::SpefLazyLoader>> old;
+    std::lock_guard<std::mutex> lock(kLazyLoadersMutex);
+    old.swap(kLazyLoaders);
+    kNumLazyLoaders.store(0, std::memory_order_release);
+}
+
 ///Functions for SPEF dumpping
 std::string NetsParasitics::getNetDumpName(Net *net) {
     std::string netName = net->getName();
@@ -320,10 +412,10 @@ std::string NetsParasitics::getCellDumpName(Cell *cell) { //for RNet
     return cellName;
 }
 
-std::string NetsParasitics::getIntNodeDumpName(Net *net, ParasiticIntNode *intNode) {
+std::string NetsParasitics::getIntNodeDumpName(Net *net, uint32_t intNodeId) {
     std::string intNodeName = getNetDumpName(net);
     intNodeName += std::string(1,getDelimiter());
-    intNodeName += std::to_string(intNode->getIntNodeId());
+    intNodeName += std::to_string(intNodeId);
     return intNodeName; 
 }
 
@@ -357,27 +449,29 @@ std::string NetsParasitics::getTermDirDumpName(Pin *pin) {
     return termDirStr;
 }
 
-std::string NetsParasitics::getExtNodeDumpName(ParasiticExtNode *extNode) {
-    Net *net = Object::addr<Net>(extNode->getExtNetId());
+std::string NetsParasitics::getExtNodeDumpName(ObjectId extNetId, uint32_t extNodeId) {
+    Net *net = Object::addr<Net>(extNetId);
     std::string extNodeName = getNetDumpName(net);
-    extNodeName += std::to_string(delimiter_); 
-    extNodeName += std::to_string(extNode->getExtNodeId());
+    extNodeName += std::string(1,getDelimiter());
+    extNodeName += std::to_string(extNodeId);
     return extNodeName;
 }
 
-std::string NetsParasitics::getNodeDumpName(Net *net, ObjectId objId) {
-    ParasiticNode *unObj = Object::addr<ParasiticNode>(objId);
+std::string NetsParasitics::getNodeDumpName(Net *net, const RcNetwork *rcNetwork, uint32_t node) {
     std::string dumpName = "";
-    if (unObj->getObjectType() == kObjectTypeParasiticIntNode) {
-        ParasiticIntNode *intNode = Object::addr<ParasiticIntNode>(objId);
-        dumpName = getIntNodeDumpName(net, intNode);
-    } else if (unObj->getObjectType() == kObjectTypeParasiticPinNode) {
-        ParasiticPinNode *pinNode = Object::addr<ParasiticPinNode>(objId);
-        Pin *pin = Object::addr<Pin>(pinNode->getPinId());
+    switch (rcNetwork->getNodeType(node)) {
+      case kRcIntNode:
+        dumpName = getIntNodeDumpName(net, rcNetwork->getNodeNumber(node));
+        break;
+      case kRcPinNode: {
+        Pin *pin = Object::addr<Pin>(rcNetwork->getPinId(node));
         dumpName = getPinDumpName(pin);
-    } else if (unObj->getObjectType() == kObjectTypeParasiticExtNode) {
-        ParasiticExtNode *extNode = Object::addr<ParasiticExtNode>(objId);
-        dumpName = getExtNodeDumpName(extNode);
+        break;
+      }
+      case kRcExtNode:
+        dumpName = getExtNodeDumpName(rcNetwork->getExtNetId(node),
+                                      rcNetwork->getNodeNumber(node));
+        break;
     }
     return dumpName;
 }
@@ -450,24 +544,20 @@ void NetsParasitics::dumpPorts(std::ofstream& os) {
 
 void NetsParasitics::dumpDNetConn(std::ofstream& os, DNetParasitics *dNetPara) {
     os << ("*CONN\n");
-    ObjectId pinNodeVecId = dNetPara->getPinNodeVecId(); 
-    if (pinNodeVecId != UNINIT_OBJECT_ID) {
-	ArrayObject<ObjectId> *objVector = addr< ArrayObject<ObjectId> >(pinNodeVecId);
-        for (auto obj : *objVector) {
-            ParasiticPinNode *pinNode = Object::addr<ParasiticPinNode>(obj);
-            if (pinNode) {
-                Pin *pin = Object::addr<Pin>(pinNode->getPinId());
-                if (pin != nullptr) {
-                    std::string pinName = pin->getName();
-                    if (revertPortsMap_.find(pinName) != revertPortsMap_.end())
-                        os << ("*P ");
-                    else
-                        os << ("*I ");
-
-                    os << (getPinDumpName(pin)) << (" "); // << ("\n");
-                    os << (getTermDirDumpName(pin)) << ("\n");
-	        }
-	    }
+    const RcNetwork *rcNetwork = dNetPara->getRcNetwork();
+    if (rcNetwork != nullptr) {
+        for (uint32_t node : rcNetwork->getConnNodes()) {
+            Pin *pin = Object::addr<Pin>(rcNetwork->getPinId(node));
+            if (pin != nullptr) {
+                std::string pinName = pin->getName();
+                if (revertPortsMap_.find(pinName) != revertPortsMap_.end())
+                    os << ("*P ");
+                else
+                    os << ("*I ");
+
+                os << (getPinDumpName(pin)) << (" "); // << ("\n");
+                os << (getTermDirDumpName(pin)) << ("\n");
+            }
         }
     }
     os << ("\n");
@@ -477,28 +567,20 @@ void NetsParasitics::dumpDNetCap(std::ofstream& os, DNetParasitics *dNetPara) {
     Net *net = Object::addr<Net>(dNetPara->getNetId());
     os << ("*CAP\n\n");
     uint32_t capNo = 0;
-    ObjectId gndCapVecId = dNetPara->getGroundCapVecId();
-    if (gndCapVecId != UNINIT_OBJECT_ID) {
-	ArrayObject<ObjectId> *objVector = addr< ArrayObject<ObjectId> >(gndCapVecId);	
-        for (auto obj : *objVector) {
+    const RcNetwork *rcNetwork = dNetPara->getRcNetwork();
+    if (rcNetwork != nullptr) {
+        for (const RcGroundCap &gCap : rcNetwork->getGroundCaps()) {
             capNo++;
-            ParasiticCap *gCap = Object::addr<ParasiticCap>(obj);
             os << (std::to_string(capNo)) << (" ");
-            os << (getNodeDumpName(net, gCap->getNode1Id()));
-            os << (" ") << (std::to_string(gCap->getCapacitance())) << ("\n");
+            os << (getNodeDumpName(net, rcNetwork, gCap.node));
+            os << (" ") << (std::to_string(gCap.capacitance)) << ("\n");
         }
-    }
-
-    ObjectId xCapVecId = dNetPara->getCouplingCapVecId();
-    if (xCapVecId != UNINIT_OBJECT_ID) {
-	ArrayObject<ObjectId> *objVector = addr< ArrayObject<ObjectId> >(xCapVecId);
-        for (auto obj : *objVector) {
+        for (const RcCouplingCap &xCap : rcNetwork->getCouplingCaps()) {
             capNo++;
-            ParasiticXCap *xCap = Object::addr<ParasiticXCap>(obj);
             os << (std::to_string(capNo)) << (" ");
-            os << (getNodeDumpName(net, xCap->getNode1Id())) << (" ");
-            os << (getNodeDumpName(net, xCap->getNode2Id()));
-            os << (" ") << (std::to_string(xCap->getCapacitance())) << ("\n");
+            os << (getNodeDumpName(net, rcNetwork, xCap.node1)) << (" ");
+            os << (getNodeDumpName(net, rcNetwork, xCap.node2));
+            os << (" ") << (std::to_string(xCap.capacitance)) << ("\n");
         }
     }
     os << ("\n"); 
@@ -508,16 +590,14 @@ void NetsParasitics::dumpDNetRes(std::ofstream& os, DNetParasitics *dNetPara) {
     Net *net = Object::addr<Net>(dNetPara->getNetId());
     os << ("*RES\n\n");
     uint32_t resNo = 0;
-    ObjectId resVecId = dNetPara->getResistorVecId();
-    if (resVecId != UNINIT_OBJECT_ID) {
-	ArrayObject<ObjectId> *objVector = addr< ArrayObject<ObjectId> >(resVecId);
-        for (auto obj : *objVector) {
+    const RcNetwork *rcNetwork = dNetPara->getRcNetwork();
+    if (rcNetwork != nullptr) {
+        for (const RcResistor &res : rcNetwork->getResistors()) {
             resNo++;
-	    ParasiticResistor *res = Object::addr<ParasiticResistor>(obj);
             os << (std::to_string(resNo)) << (" ");
-            os << (getNodeDumpName(net, res->getNode1Id())) << (" ");
-            os << (getNodeDumpName(net, res->getNode2Id()));
-            os << (" ") << (std::to_string(res->getResistance())) << ("\n");
+            os << (getNodeDumpName(net, rcNetwork, res.node1)) << (" ");
+            os << (getNodeDumpName(net, rcNetwork, res.node2));
+            os << (" ") << (std::to_string(res.resistance)) << ("\n");
         }
     }
     os << ("\n");
@@ -553,18 +633,25 @@ void NetsParasitics::dumpRNet(std::ofstream& os, RNetParasitics *rNetPara) {
     os << ("*END\n\n");
 }
 
+void NetsParasitics::dumpNetParasitics(std::ofstream& os, NetParasitics *unObj) {
+    if (unObj == nullptr)
+        return;
+    if (unObj->getObjectType() == ObjectType::kObjectTypeDNetParasitics) {
+        dumpDNet(os, static_cast<DNetParasitics*>(unObj));
+    } else if (unObj->getObjectType() == ObjectType::kObjectTypeRNetParasitics) {
+        dumpRNet(os, static_cast<RNetParasitics*>(unObj));
+    }
+}
+
 void NetsParasitics::dumpNets(std::ofstream& os) {
-    for (auto obj : netParasiticsMap_) {
-        Net *net = Object::addr<Net>(obj.first);
-        NetParasitics *unObj = Object::addr<NetParasitics>(obj.second);  //Need to check further
-        if (unObj->getObjectType() == ObjectType::kObjectTypeDNetParasitics) {
-            DNetParasitics *dNetPara = Object::addr<DNetParasitics>(obj.second);
-            dumpDNet(os, dNetPara);
-        } else if (unObj->getObjectType() == ObjectType::kObjectTypeRNetParasitics) {
-            RNetParasitics *rNetPara = Object::addr<RNetParasitics>(obj.second);
-            dumpRNet(os, rNetPara);
-        }
+    SpefReader::SpefLazyLoader *lazyLoader = getLazyLoader();
+    if (lazyLoader) {  //Load nets one by one, in SPEF file order
+        for (auto netId : lazyLoader->getNetIds())
+            dumpNetParasitics(os, getNetParasitics(netId));
+        return;
     }
+    for (auto obj : netParasiticsMap_)
+        dumpNetParasitics(os, Object::addr<NetParasitics>(obj.second));
 }
 
 std::ofstream& operator<<(std::ofstream& os, NetsParasitics &rhs) {
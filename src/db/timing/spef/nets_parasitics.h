@@ -29,6 +29,9 @@
 #include "db/core/term.h"
 #include "db/util/symbol_page.h"
 
+namespace SpefReader {
+  class SpefLazyLoader;
+}
 
 namespace open_edi {
 namespace db {
@@ -88,23 +91,42 @@ class NetsParasitics : public Object {
     bool isDigits(const char *str);
     Net* getNetBySymbol(SymbolIndex index);
     Net* findNet(const char *netName);
+    Inst* getInstBySymbol(SymbolIndex index);
     Pin* getPinBySymbol(SymbolIndex index, const std::string& pinName);
     Pin* getPortBySymbol(SymbolIndex index);
+    /// @brief instance by name or by name map index, without pin part
+    Inst* findInst(const std::string &instName);
     Pin* findPin(const char *pinName);
-    ObjectId createParaNode(DNetParasitics *netParasitics, const char *nodeName);
+    uint32_t createParaNode(DNetParasitics *netParasitics, RcNetworkBuilder *builder,
+                            const char *nodeName);
     DNetParasitics* addDNetParasitics(ObjectId netId, float totCap);
     void addGroundCap(ObjectId netId, char *nodeName, float capValue);
     void addCouplingCap(ObjectId netId, char *nodeName1, char *nodeName2, float xCapValue);
     void addResistor(ObjectId netId, char *nodeName1, char *nodeName2, float resValue);
     RNetParasitics* addRNetParasitics(ObjectId netId, float totCap);
+    /// @brief parasitics of a net, loaded from the SPEF file if read lazily
+    NetParasitics* getNetParasitics(ObjectId netId);
+    /// @brief parasitics of a net if created, never loads
+    NetParasitics* findNetParasitics(ObjectId netId) const;
+    void removeNetParasitics(ObjectId netId);
+    /// @brief nets with parasitics, with the ones not loaded yet if read lazily
+    std::vector<ObjectId> getParasiticNetIds() const;
+    /// @brief loader of a lazily read SPEF file, owned from now on
+    ///
+    /// Loaders are runtime state kept out of the pool, by the id of their
+    /// NetsParasitics: nets restored by read_design are not lazy.
+    void setLazyLoader(SpefReader::SpefLazyLoader *lazyLoader);
+    SpefReader::SpefLazyLoader* getLazyLoader() const;
+    /// @brief delete the loaders of all NetsParasitics, e.g. on a new timing lib
+    static void resetLazyLoaders();
     ///functions for spef dumpping
     std::string getNetDumpName(Net *net);
     std::string getCellDumpName(Cell *cell);
-    std::string getIntNodeDumpName(Net *net, ParasiticIntNode *intNode);
+    std::string getIntNodeDumpName(Net *net, uint32_t intNodeId);
     std::string getPinDumpName(Pin *pin);
     std::string getTermDirDumpName(Pin *pin);
-    std::string getExtNodeDumpName(ParasiticExtNode *extNode);
-    std::string getNodeDumpName(Net *net, ObjectId objId);
+    std::string getExtNodeDumpName(ObjectId extNetId, uint32_t extNodeId);
+    std::string getNodeDumpName(Net *net, const RcNetwork *rcNetwork, uint32_t node);
     void dumpSpefHeader(std::ofstream& os);
     void dumpNameMap(std::ofstream& os);
     void dumpPorts(std::ofstream& os);
@@ -113,6 +135,7 @@ class NetsParasitics : public Object {
     void dumpDNetRes(std::ofstream& os, DNetParasitics *dNetPara);
     void dumpDNet(std::ofstream& os, DNetParasitics *dNetPara);
     void dumpRNet(std::ofstream& os, RNetParasitics *rNetPara);
+    void dumpNetParasitics(std::ofstream& os, NetParasitics *netPara);
     void dumpNets(std::ofstream& os);
 
   protected:
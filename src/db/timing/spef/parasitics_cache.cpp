@@ -0,0 +1,400 @@
+/**
+ * @file parasitics_cache.cpp
+ * @date 2020-11-02
+ * @brief Binary cache file of the parasitics of a corner.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "db/timing/spef/parasitics_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "db/core/db.h"
+#include "db/core/timing.h"
+#include "db/timing/spef/design_parasitics.h"
+#include "db/timing/spef/nets_parasitics.h"
+#include "util/util_mem.h"
+
+namespace open_edi {
+namespace db {
+
+static const char kCacheMagic[8] = {'E', 'D', 'I', 'P', 'A', 'R', 'A', 'S'};
+static const uint32_t kCacheVersion = 1;
+static const uint32_t kNoIndex = UINT32_MAX;
+
+enum CacheObjectType : uint32_t {
+    kCacheNet,
+    kCacheIOPin,
+    kCacheInstPin
+};
+
+struct CacheFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numSections;
+};
+
+/// @brief offsets are from the start of the section, all 8 bytes aligned
+struct CacheSectionHeader {
+    uint64_t size;
+    uint64_t rcOffset;
+    uint64_t stringOffset;  ///< numStrings + 1 uint64_t offsets, then chars
+    uint64_t objectOffset;  ///< 3 uint32_t per object
+    uint64_t netOffset;
+    uint32_t numStrings;
+    uint32_t numObjects;
+    uint32_t numNets;
+    uint32_t cellName;
+    uint32_t spefFile;
+    char divider;
+    char delimiter;
+    char preBusDel;
+    char sufBusDel;
+    float timeScale;
+    float resScale;
+    float capScale;
+    float inductScale;
+    uint32_t reserved;
+};
+
+struct CacheNet {
+    uint64_t rcOffset;
+    uint64_t rcSize;   ///< 0 for R_NET, or D_NET without network
+    uint32_t net;
+    uint32_t driver;   ///< R_NET driver pin
+    float totalCap;
+    float c2;
+    float r1;
+    float c1;
+    uint32_t reduced;
+    uint32_t reserved;
+};
+
+/// @brief write the cache to a temporary file renamed to fileName once
+/// complete, so a reader never sees a partial cache
+bool ParasiticsCacheWriter::write(DesignParasitics *designParasitics,
+                                  const std::string &fileName) {
+    std::string tmpFile = fileName + "." + std::to_string(getpid()) + ".tmp";
+    fp_ = fopen(tmpFile.c_str(), "wb");
+    if (fp_ == nullptr) return false;
+    pos_ = 0;
+
+    CacheFileHeader header;
+    memcpy(header.magic, kCacheMagic, sizeof(header.magic));
+    header.version = kCacheVersion;
+    header.numSections = designParasitics->getParasiticsMap().size();
+    bool ok = __writeBytes(&header, sizeof(header));
+    Timing *timingdb = getTimingLib();
+    auto &spefMap = designParasitics->getSpefMap();
+    for (auto obj : designParasitics->getParasiticsMap()) {
+        if (!ok) break;
+        NetsParasitics *netsParasitics = Object::addr<NetsParasitics>(obj.second);
+        auto spefIdx = spefMap.find(obj.first);
+        std::string spefFile = "";
+        if (timingdb && spefIdx != spefMap.end())
+            spefFile = timingdb->getSymbolByIndex(spefIdx->second);
+        ok = netsParasitics != nullptr && __writeSection(netsParasitics, spefFile);
+    }
+    if (fclose(fp_) != 0) ok = false;
+    fp_ = nullptr;
+    if (ok) ok = rename(tmpFile.c_str(), fileName.c_str()) == 0;
+    if (!ok) unlink(tmpFile.c_str());
+    return ok;
+}
+
+bool ParasiticsCacheWriter::__writeSection(NetsParasitics *netsParasitics,
+                                           const std::string &spefFile) {
+    strings_.clear();
+    stringIndex_.clear();
+    objects_.clear();
+    objectIndex_.clear();
+
+    uint64_t begin = pos_;
+    CacheSectionHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!__writeBytes(&header, sizeof(header))) return false;
+    header.rcOffset = pos_ - begin;
+
+    Cell *cell = Object::addr<Cell>(netsParasitics->getCellId());
+    if (cell == nullptr) return false;
+    header.cellName = __addString(cell->getName());
+    header.spefFile = spefFile.empty() ? kNoIndex : __addString(spefFile);
+    header.divider = netsParasitics->getDivider();
+    header.delimiter = netsParasitics->getDelimiter();
+    header.preBusDel = netsParasitics->getPreBusDel();
+    header.sufBusDel = netsParasitics->getSufBusDel();
+    header.timeScale = netsParasitics->getTimeScale();
+    header.resScale = netsParasitics->getResScale();
+    header.capScale = netsParasitics->getCapScale();
+    header.inductScale = netsParasitics->getInductScale();
+
+    // networks first, as they fill the name table.
+    std::vector<CacheNet> nets;
+    for (auto netId : netsParasitics->getParasiticNetIds()) {
+        NetParasitics *netPara = netsParasitics->getNetParasitics(netId);
+        if (netPara == nullptr) continue;
+        CacheNet net;
+        memset(&net, 0, sizeof(net));
+        net.net = __addNet(netId);
+        net.driver = kNoIndex;
+        net.totalCap = netPara->getNetTotalCap();
+        if (netPara->getObjectType() == kObjectTypeRNetParasitics) {
+            RNetParasitics *rnet = static_cast<RNetParasitics *>(netPara);
+            net.reduced = 1;
+            if (rnet->getDriverPinId() != UNINIT_OBJECT_ID)
+                net.driver = __addPin(rnet->getDriverPinId());
+            net.c2 = rnet->getC2();
+            net.r1 = rnet->getR1();
+            net.c1 = rnet->getC1();
+        } else {
+            const RcNetwork *rcNetwork =
+                static_cast<DNetParasitics *>(netPara)->getRcNetwork();
+            if (rcNetwork) {
+                net.rcOffset = pos_ - begin;
+                if (!__writeRcNetwork(rcNetwork, &net.rcSize) || !__align())
+                    return false;
+            }
+        }
+        nets.push_back(net);
+    }
+
+    header.stringOffset = pos_ - begin;
+    header.numStrings = strings_.size();
+    std::vector<uint64_t> stringOffsets(strings_.size() + 1, 0);
+    for (uint32_t i = 0; i < strings_.size(); ++i)
+        stringOffsets[i + 1] = stringOffsets[i] + strings_[i].size();
+    if (!__writeBytes(stringOffsets.data(), sizeof(uint64_t) * stringOffsets.size()))
+        return false;
+    for (auto &str : strings_) {
+        if (!__writeBytes(str.data(), str.size())) return false;
+    }
+    if (!__align()) return false;
+
+    header.objectOffset = pos_ - begin;
+    header.numObjects = objects_.size() / 3;
+    if (!__writeBytes(objects_.data(), sizeof(uint32_t) * objects_.size()) ||
+        !__align())
+        return false;
+
+    header.netOffset = pos_ - begin;
+    header.numNets = nets.size();
+    if (!__writeBytes(nets.data(), sizeof(CacheNet) * nets.size())) return false;
+
+    header.size = pos_ - begin;
+    if (fseeko(fp_, begin, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, fp_) != 1 ||
+        fseeko(fp_, pos_, SEEK_SET) != 0)
+        return false;
+    return true;
+}
+
+/// @brief __writeRcNetwork the block, with name table indexes as ids
+bool ParasiticsCacheWriter::__writeRcNetwork(const RcNetwork *rcNetwork,
+                                             uint64_t *size) {
+    *size = rcNetwork->getMemorySize();
+    RcNetwork *copy = RcNetwork::copy(rcNetwork, *size);
+    if (copy == nullptr) return false;
+    uint32_t numPinNodes = rcNetwork->getNumPinNodes();
+    uint32_t node = 0;
+    copy->mapObjectIds([this, &node, numPinNodes](ObjectId id) {
+        bool isPin = node++ < numPinNodes;
+        return static_cast<ObjectId>(isPin ? __addPin(id) : __addNet(id));
+    });
+    bool ok = __writeBytes(copy, *size);
+    RcNetwork::destroy(copy);
+    return ok;
+}
+
+uint32_t ParasiticsCacheWriter::__addString(const std::string &str) {
+    auto found = stringIndex_.find(str);
+    if (found != stringIndex_.end()) return found->second;
+    uint32_t index = strings_.size();
+    strings_.push_back(str);
+    stringIndex_.emplace(str, index);
+    return index;
+}
+
+uint32_t ParasiticsCacheWriter::__addNet(ObjectId netId) {
+    auto found = objectIndex_.find(netId);
+    if (found != objectIndex_.end()) return found->second;
+    Net *net = Object::addr<Net>(netId);
+    uint32_t index = objects_.size() / 3;
+    objects_.push_back(kCacheNet);
+    objects_.push_back(net ? __addString(net->getName()) : kNoIndex);
+    objects_.push_back(kNoIndex);
+    objectIndex_.emplace(netId, index);
+    return index;
+}
+
+uint32_t ParasiticsCacheWriter::__addPin(ObjectId pinId) {
+    auto found = objectIndex_.find(pinId);
+    if (found != objectIndex_.end()) return found->second;
+    Pin *pin = Object::addr<Pin>(pinId);
+    Inst *inst = pin ? pin->getInst() : nullptr;
+    uint32_t index = objects_.size() / 3;
+    objects_.push_back(inst ? kCacheInstPin : kCacheIOPin);
+    objects_.push_back(pin ? __addString(pin->getName()) : kNoIndex);
+    objects_.push_back(inst ? __addString(inst->getName()) : kNoIndex);
+    objectIndex_.emplace(pinId, index);
+    return index;
+}
+
+bool ParasiticsCacheWriter::__writeBytes(const void *data, uint64_t size) {
+    if (size == 0) return true;
+    if (fwrite(data, size, 1, fp_) != 1) return false;
+    pos_ += size;
+    return true;
+}
+
+bool ParasiticsCacheWriter::__align() {
+    static const char kZeros[8] = {0};
+    return __writeBytes(kZeros, (8 - pos_ % 8) % 8);
+}
+
+bool ParasiticsCacheReader::read(DesignParasitics *designParasitics,
+                                 const std::string &fileName) {
+    open_edi::util::MemMappedFile file;
+    if (!file.map(fileName.c_str())) return false;
+    const char *data = file.getAddr();
+    uint64_t size = file.getSize();
+
+    CacheFileHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, kCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != kCacheVersion)
+        return false;
+    uint64_t pos = sizeof(header);
+    for (uint32_t i = 0; i < header.numSections; ++i) {
+        CacheSectionHeader section;
+        if (size - pos < sizeof(section)) return false;
+        memcpy(&section, data + pos, sizeof(section));
+        if (section.size > size - pos ||
+            !__readSection(designParasitics, data + pos, section.size))
+            return false;
+        pos += section.size;
+    }
+    return true;
+}
+
+bool ParasiticsCacheReader::__readSection(DesignParasitics *designParasitics,
+                                          const char *data, uint64_t size) {
+    CacheSectionHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.stringOffset > size ||
+        (size - header.stringOffset) / sizeof(uint64_t) <= header.numStrings ||
+        header.objectOffset > size ||
+        (size - header.objectOffset) / (3 * sizeof(uint32_t)) < header.numObjects ||
+        header.netOffset > size ||
+        (size - header.netOffset) / sizeof(CacheNet) < header.numNets)
+        return false;
+
+    // strings point into the mapped file, copied when looked up.
+    const uint64_t *stringOffsets =
+        reinterpret_cast<const uint64_t *>(data + header.stringOffset);
+    const char *chars = reinterpret_cast<const char *>(
+        stringOffsets + header.numStrings + 1);
+    uint64_t charsSize = size - (chars - data);
+    auto getString = [&](uint32_t index) {
+        if (index >= header.numStrings ||
+            stringOffsets[index + 1] > charsSize ||
+            stringOffsets[index] > stringOffsets[index + 1])
+            return std::string();
+        return std::string(chars + stringOffsets[index],
+                           stringOffsets[index + 1] - stringOffsets[index]);
+    };
+
+    Cell *topCell = getTopCell();
+    Timing *timingdb = getTimingLib();
+    if (topCell == nullptr || timingdb == nullptr) return false;
+    Cell *cell = topCell->getCell(getString(header.cellName));
+    if (cell == nullptr) {
+        open_edi::util::message->issueMsg(open_edi::util::kError,
+            "Failed to find parasitics cache cell in design.\n");
+        return false;
+    }
+    NetsParasitics *netsParasitics =
+        timingdb->createObject<NetsParasitics>(kObjectTypeNetsParasitics,
+                                               timingdb->getId());
+    if (netsParasitics == nullptr) return false;
+    netsParasitics->setCellId(cell->getId());
+    netsParasitics->setDivider(header.divider);
+    netsParasitics->setDelimiter(header.delimiter);
+    netsParasitics->setPreBusDel(header.preBusDel);
+    netsParasitics->setSufBusDel(header.sufBusDel);
+    netsParasitics->setTimeScale(header.timeScale);
+    netsParasitics->setResScale(header.resScale);
+    netsParasitics->setCapScale(header.capScale);
+    netsParasitics->setInductScale(header.inductScale);
+    std::string spefFile = getString(header.spefFile);
+    if (!spefFile.empty())
+        designParasitics->addSpefMap(cell->getId(),
+                                     timingdb->getOrCreateSymbol(spefFile));
+    designParasitics->addParasiticsMap(cell->getId(), netsParasitics->getId());
+
+    // names to the object ids of this design, once per section.
+    const uint32_t *objects =
+        reinterpret_cast<const uint32_t *>(data + header.objectOffset);
+    std::vector<ObjectId> objectIds(header.numObjects, UNINIT_OBJECT_ID);
+    for (uint32_t i = 0; i < header.numObjects; ++i) {
+        const uint32_t *object = objects + 3 * i;
+        std::string name = getString(object[1]);
+        if (object[0] == kCacheNet) {
+            Net *net = cell->getNet(name);
+            if (net) objectIds[i] = net->getId();
+        } else if (object[0] == kCacheIOPin) {
+            Pin *pin = cell->getIOPin(name);
+            if (pin) objectIds[i] = pin->getId();
+        } else if (object[0] == kCacheInstPin) {
+            Inst *inst = cell->getInstance(getString(object[2]));
+            Pin *pin = inst ? inst->getPin(name) : nullptr;
+            if (pin) objectIds[i] = pin->getId();
+        }
+        if (objectIds[i] == UNINIT_OBJECT_ID) ++numUnresolved_;
+    }
+    auto getObjectId = [&objectIds](uint64_t index) {
+        return index < objectIds.size() ? objectIds[index] : UNINIT_OBJECT_ID;
+    };
+
+    const CacheNet *nets = reinterpret_cast<const CacheNet *>(data + header.netOffset);
+    for (uint32_t i = 0; i < header.numNets; ++i) {
+        const CacheNet &net = nets[i];
+        ObjectId netId = getObjectId(net.net);
+        if (netId == UNINIT_OBJECT_ID) continue;
+        if (net.reduced) {
+            RNetParasitics *rnet =
+                netsParasitics->addRNetParasitics(netId, net.totalCap);
+            if (rnet == nullptr) return false;
+            if (net.driver != kNoIndex)
+                rnet->setDriverPinId(getObjectId(net.driver));
+            rnet->setC2(net.c2);
+            rnet->setR1(net.r1);
+            rnet->setC1(net.c1);
+        } else {
+            DNetParasitics *dnet =
+                netsParasitics->addDNetParasitics(netId, net.totalCap);
+            if (dnet == nullptr) return false;
+            if (net.rcSize > 0) {
+                if (net.rcOffset > size || net.rcSize > size - net.rcOffset)
+                    return false;
+                RcNetwork *rcNetwork = dnet->copyRcNetwork(
+                    data + net.rcOffset, net.rcSize, getObjectId);
+                if (rcNetwork == nullptr) return false;
+            }
+        }
+        ++numNets_;
+    }
+    return true;
+}
+
+}  // namespace db
+}  // namespace open_edi
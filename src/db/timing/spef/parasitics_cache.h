@@ -0,0 +1,90 @@
+/**
+ * @file parasitics_cache.h
+ * @date 2020-11-02
+ * @brief Binary cache file of the parasitics of a corner.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef EDI_DB_TIMING_SPEF_PARASITICS_CACHE_H_
+#define EDI_DB_TIMING_SPEF_PARASITICS_CACHE_H_
+
+#include <stdio.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "db/core/object.h"
+
+namespace open_edi {
+namespace db {
+
+class DesignParasitics;
+class NetsParasitics;
+class RcNetwork;
+
+/// @brief Binary cache file of the parasitics of a corner.
+///
+/// The file has one section per NetsParasitics of the DesignParasitics,
+/// i.e. per SPEF file read. A section holds the SPEF header values, a
+/// table of the nets and pins it refers to by name, one fixed size record
+/// per net and the RC networks as their packed RcNetwork blocks, in which
+/// pin and external net ids are replaced by indexes in the name table.
+///
+/// Reading maps the file: names are looked up once per section, then each
+/// block is copied and its indexes replaced by the object ids of this
+/// design. Nothing is parsed again, and the name map of the SPEF file is
+/// no longer needed.
+class ParasiticsCacheWriter {
+  public:
+    ParasiticsCacheWriter() : fp_(nullptr) {}
+
+    bool write(DesignParasitics *designParasitics, const std::string &fileName);
+
+  private:
+    bool __writeSection(NetsParasitics *netsParasitics, const std::string &spefFile);
+    bool __writeRcNetwork(const RcNetwork *rcNetwork, uint64_t *size);
+    uint32_t __addString(const std::string &str);
+    uint32_t __addNet(ObjectId netId);
+    uint32_t __addPin(ObjectId pinId);
+    bool __writeBytes(const void *data, uint64_t size);
+    bool __align();
+
+    FILE *fp_;
+    uint64_t pos_;
+    /// tables of the current section
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, uint32_t> stringIndex_;
+    /// type, name and instance name of each net or pin, flattened
+    std::vector<uint32_t> objects_;
+    std::unordered_map<ObjectId, uint32_t> objectIndex_;
+};
+
+class ParasiticsCacheReader {
+  public:
+    ParasiticsCacheReader() : numNets_(0), numUnresolved_(0) {}
+
+    bool read(DesignParasitics *designParasitics, const std::string &fileName);
+    uint64_t getNumNets() const { return numNets_; }
+    /// @brief nets and pins of the cache not found in the design
+    uint64_t getNumUnresolved() const { return numUnresolved_; }
+
+  private:
+    bool __readSection(DesignParasitics *designParasitics, const char *data,
+                       uint64_t size);
+
+    uint64_t numNets_;
+    uint64_t numUnresolved_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // EDI_DB_TIMING_SPEF_PARASITICS_CACHE_H_
@@ -0,0 +1,304 @@
+/**
+ * @file rc_network.cpp
+ * @date 2020-11-02
+ * @brief Packed RC network of a net, read from the D_NET records of SPEF.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "db/timing/spef/rc_network.h"
+
+#include <string.h>
+
+#include <new>
+
+namespace open_edi {
+namespace db {
+
+uint32_t RcNetworkBuilder::addPinNode(ObjectId pin_id) {
+    nodes_.push_back(Node{kRcPinNode, 0, pin_id});
+    return nodes_.size() - 1;
+}
+
+uint32_t RcNetworkBuilder::addExtNode(ObjectId net_id, uint32_t number) {
+    nodes_.push_back(Node{kRcExtNode, number, net_id});
+    return nodes_.size() - 1;
+}
+
+uint32_t RcNetworkBuilder::addIntNode(uint32_t number) {
+    nodes_.push_back(Node{kRcIntNode, number, UNINIT_OBJECT_ID});
+    return nodes_.size() - 1;
+}
+
+void RcNetworkBuilder::addGroundCap(uint32_t node, float capacitance) {
+    ground_caps_.push_back(RcGroundCap{node, capacitance});
+}
+
+void RcNetworkBuilder::addCouplingCap(uint32_t node1, uint32_t node2,
+                                      float capacitance) {
+    coupling_caps_.push_back(RcCouplingCap{node1, node2, capacitance});
+}
+
+void RcNetworkBuilder::addResistor(uint32_t node1, uint32_t node2,
+                                   float resistance) {
+    resistors_.push_back(RcResistor{node1, node2, resistance});
+}
+
+/// @brief clear keeps the capacity for the next net
+void RcNetworkBuilder::clear() {
+    nodes_.clear();
+    conn_nodes_.clear();
+    ground_caps_.clear();
+    coupling_caps_.clear();
+    resistors_.clear();
+}
+
+uint64_t RcNetwork::getPackedSize(const RcNetworkBuilder &builder) {
+    uint32_t num_nodes[kRcIntNode + 1] = {0, 0, 0};
+    for (auto &node : builder.nodes_) ++num_nodes[node.type];
+    uint64_t num_all_nodes = builder.nodes_.size();
+    return sizeof(RcNetwork) +
+           sizeof(ObjectId) * (num_nodes[kRcPinNode] + num_nodes[kRcExtNode]) +
+           sizeof(uint32_t) * (num_nodes[kRcExtNode] + num_nodes[kRcIntNode]) +
+           sizeof(uint32_t) * builder.conn_nodes_.size() +
+           sizeof(uint32_t) * (num_all_nodes + 1) +
+           sizeof(uint32_t) * 2 * builder.resistors_.size() +
+           sizeof(RcGroundCap) * builder.ground_caps_.size() +
+           sizeof(RcCouplingCap) * builder.coupling_caps_.size() +
+           sizeof(RcResistor) * builder.resistors_.size();
+}
+
+RcNetwork *RcNetwork::create(const RcNetworkBuilder &builder) {
+    return pack(builder, ::operator new(getPackedSize(builder)));
+}
+
+RcNetwork *RcNetwork::pack(const RcNetworkBuilder &builder, void *block) {
+    const std::vector<RcNetworkBuilder::Node> &nodes = builder.nodes_;
+    uint32_t num_nodes[kRcIntNode + 1] = {0, 0, 0};
+    for (auto &node : nodes) ++num_nodes[node.type];
+
+    // new index of the builder nodes: pin, external, then internal ones.
+    uint32_t next_index[kRcIntNode + 1] = {
+        0, num_nodes[kRcPinNode], num_nodes[kRcPinNode] + num_nodes[kRcExtNode]};
+    std::vector<uint32_t> new_index(nodes.size());
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        new_index[i] = next_index[nodes[i].type]++;
+    }
+
+    uint32_t num_all_nodes = nodes.size();
+    uint32_t num_numbered = num_nodes[kRcExtNode] + num_nodes[kRcIntNode];
+    uint32_t num_resistors = builder.resistors_.size();
+    uint64_t size = sizeof(RcNetwork) +
+                    sizeof(ObjectId) * (num_nodes[kRcPinNode] +
+                                        num_nodes[kRcExtNode]);
+    uint64_t number_offset = size;
+    size += sizeof(uint32_t) * num_numbered;
+    uint64_t conn_offset = size;
+    size += sizeof(uint32_t) * builder.conn_nodes_.size();
+    uint64_t adjacency_begin_offset = size;
+    size += sizeof(uint32_t) * (num_all_nodes + 1);
+    uint64_t adjacency_offset = size;
+    size += sizeof(uint32_t) * 2 * num_resistors;
+    uint64_t ground_cap_offset = size;
+    size += sizeof(RcGroundCap) * builder.ground_caps_.size();
+    uint64_t coupling_cap_offset = size;
+    size += sizeof(RcCouplingCap) * builder.coupling_caps_.size();
+    uint64_t resistor_offset = size;
+    size += sizeof(RcResistor) * num_resistors;
+
+    char *data = static_cast<char *>(block);
+    RcNetwork *network = new (data) RcNetwork;
+    network->size_ = size;
+    network->num_pin_nodes_ = num_nodes[kRcPinNode];
+    network->num_ext_nodes_ = num_nodes[kRcExtNode];
+    network->num_int_nodes_ = num_nodes[kRcIntNode];
+    network->num_conn_nodes_ = builder.conn_nodes_.size();
+    network->num_ground_caps_ = builder.ground_caps_.size();
+    network->num_coupling_caps_ = builder.coupling_caps_.size();
+    network->num_resistors_ = num_resistors;
+    network->number_offset_ = number_offset;
+    network->conn_offset_ = conn_offset;
+    network->adjacency_begin_offset_ = adjacency_begin_offset;
+    network->adjacency_offset_ = adjacency_offset;
+    network->ground_cap_offset_ = ground_cap_offset;
+    network->coupling_cap_offset_ = coupling_cap_offset;
+    network->resistor_offset_ = resistor_offset;
+
+    ObjectId *object_ids = reinterpret_cast<ObjectId *>(network + 1);
+    uint32_t *numbers = reinterpret_cast<uint32_t *>(data + number_offset);
+    uint32_t num_pin_nodes = num_nodes[kRcPinNode];
+    for (uint32_t i = 0; i < num_all_nodes; ++i) {
+        uint32_t index = new_index[i];
+        if (nodes[i].type != kRcIntNode) object_ids[index] = nodes[i].object_id;
+        if (nodes[i].type != kRcPinNode) {
+            numbers[index - num_pin_nodes] = nodes[i].number;
+        }
+    }
+
+    uint32_t *conn = reinterpret_cast<uint32_t *>(data + conn_offset);
+    for (uint32_t i = 0; i < builder.conn_nodes_.size(); ++i) {
+        conn[i] = new_index[builder.conn_nodes_[i]];
+    }
+    RcGroundCap *ground_caps =
+        reinterpret_cast<RcGroundCap *>(data + ground_cap_offset);
+    for (uint32_t i = 0; i < builder.ground_caps_.size(); ++i) {
+        ground_caps[i] = builder.ground_caps_[i];
+        ground_caps[i].node = new_index[ground_caps[i].node];
+    }
+    RcCouplingCap *coupling_caps =
+        reinterpret_cast<RcCouplingCap *>(data + coupling_cap_offset);
+    for (uint32_t i = 0; i < builder.coupling_caps_.size(); ++i) {
+        coupling_caps[i] = builder.coupling_caps_[i];
+        coupling_caps[i].node1 = new_index[coupling_caps[i].node1];
+        coupling_caps[i].node2 = new_index[coupling_caps[i].node2];
+    }
+    RcResistor *resistors =
+        reinterpret_cast<RcResistor *>(data + resistor_offset);
+    for (uint32_t i = 0; i < num_resistors; ++i) {
+        resistors[i] = builder.resistors_[i];
+        resistors[i].node1 = new_index[resistors[i].node1];
+        resistors[i].node2 = new_index[resistors[i].node2];
+    }
+
+    // resistors per node: count, prefix sum, fill.
+    uint32_t *adjacency_begin =
+        reinterpret_cast<uint32_t *>(data + adjacency_begin_offset);
+    uint32_t *adjacency = reinterpret_cast<uint32_t *>(data + adjacency_offset);
+    memset(adjacency_begin, 0, sizeof(uint32_t) * (num_all_nodes + 1));
+    for (uint32_t i = 0; i < num_resistors; ++i) {
+        ++adjacency_begin[resistors[i].node1 + 1];
+        ++adjacency_begin[resistors[i].node2 + 1];
+    }
+    for (uint32_t i = 0; i < num_all_nodes; ++i) {
+        adjacency_begin[i + 1] += adjacency_begin[i];
+    }
+    std::vector<uint32_t> fill(adjacency_begin, adjacency_begin + num_all_nodes);
+    for (uint32_t i = 0; i < num_resistors; ++i) {
+        adjacency[fill[resistors[i].node1]++] = i;
+        adjacency[fill[resistors[i].node2]++] = i;
+    }
+    return network;
+}
+
+/// @brief value of type T at an offset of a block, maybe unaligned
+template <class T>
+static T loadValue(const char *data, uint64_t offset) {
+    T value;
+    memcpy(static_cast<void *>(&value), data + offset, sizeof(T));
+    return value;
+}
+
+/// @brief isValid checks the header, the layout pack() gives the arrays and
+/// that each node and resistor index is in range, so a block read from a
+/// file is safe to traverse.
+bool RcNetwork::isValid(const void *block, uint64_t size) {
+    if (block == nullptr || size < sizeof(RcNetwork)) return false;
+    const char *data = static_cast<const char *>(block);
+    RcNetwork header;
+    memcpy(static_cast<void *>(&header), block, sizeof(RcNetwork));
+    if (header.size_ != size) return false;
+
+    // offsets and counts: the arrays follow each other as pack() lays them.
+    uint64_t num_nodes = static_cast<uint64_t>(header.num_pin_nodes_) +
+                         header.num_ext_nodes_ + header.num_int_nodes_;
+    uint64_t num_resistors = header.num_resistors_;
+    uint64_t offset = sizeof(RcNetwork) +
+        sizeof(ObjectId) * (static_cast<uint64_t>(header.num_pin_nodes_) +
+                            header.num_ext_nodes_);
+    if (header.number_offset_ != offset) return false;
+    offset += sizeof(uint32_t) * (static_cast<uint64_t>(header.num_ext_nodes_) +
+                                  header.num_int_nodes_);
+    if (header.conn_offset_ != offset) return false;
+    offset += sizeof(uint32_t) * static_cast<uint64_t>(header.num_conn_nodes_);
+    if (header.adjacency_begin_offset_ != offset) return false;
+    offset += sizeof(uint32_t) * (num_nodes + 1);
+    if (header.adjacency_offset_ != offset) return false;
+    offset += sizeof(uint32_t) * 2 * num_resistors;
+    if (header.ground_cap_offset_ != offset) return false;
+    offset += sizeof(RcGroundCap) * static_cast<uint64_t>(header.num_ground_caps_);
+    if (header.coupling_cap_offset_ != offset) return false;
+    offset += sizeof(RcCouplingCap) *
+              static_cast<uint64_t>(header.num_coupling_caps_);
+    if (header.resistor_offset_ != offset) return false;
+    offset += sizeof(RcResistor) * num_resistors;
+    if (offset != size) return false;
+
+    // node indexes of the elements.
+    for (uint32_t i = 0; i < header.num_conn_nodes_; ++i) {
+        uint32_t node = loadValue<uint32_t>(
+            data, header.conn_offset_ + sizeof(uint32_t) * i);
+        if (node >= num_nodes) return false;
+    }
+    for (uint32_t i = 0; i < header.num_ground_caps_; ++i) {
+        RcGroundCap cap = loadValue<RcGroundCap>(
+            data, header.ground_cap_offset_ + sizeof(RcGroundCap) * i);
+        if (cap.node >= num_nodes) return false;
+    }
+    for (uint32_t i = 0; i < header.num_coupling_caps_; ++i) {
+        RcCouplingCap cap = loadValue<RcCouplingCap>(
+            data, header.coupling_cap_offset_ + sizeof(RcCouplingCap) * i);
+        if (cap.node1 >= num_nodes || cap.node2 >= num_nodes) return false;
+    }
+    for (uint32_t i = 0; i < num_resistors; ++i) {
+        RcResistor res = loadValue<RcResistor>(
+            data, header.resistor_offset_ + sizeof(RcResistor) * i);
+        if (res.node1 >= num_nodes || res.node2 >= num_nodes) return false;
+    }
+
+    // resistors per node: ascending ranges over all of the entries, each
+    // entry a resistor at that node.
+    if (loadValue<uint32_t>(data, header.adjacency_begin_offset_) != 0)
+        return false;
+    uint32_t end = 0;
+    for (uint64_t node = 0; node < num_nodes; ++node) {
+        uint32_t begin = end;
+        end = loadValue<uint32_t>(
+            data, header.adjacency_begin_offset_ + sizeof(uint32_t) * (node + 1));
+        if (end < begin || end > 2 * num_resistors) return false;
+        for (uint32_t i = begin; i < end; ++i) {
+            uint32_t resistor = loadValue<uint32_t>(
+                data, header.adjacency_offset_ + sizeof(uint32_t) * i);
+            if (resistor >= num_resistors) return false;
+            RcResistor res = loadValue<RcResistor>(
+                data, header.resistor_offset_ + sizeof(RcResistor) * resistor);
+            if (res.node1 != node && res.node2 != node) return false;
+        }
+    }
+    return end == 2 * num_resistors;
+}
+
+RcNetwork *RcNetwork::copy(const void *block, uint64_t size) {
+    if (!isValid(block, size)) return nullptr;
+    char *data = static_cast<char *>(::operator new(size));
+    memcpy(data, block, size);
+    return reinterpret_cast<RcNetwork *>(data);
+}
+
+void RcNetwork::destroy(RcNetwork *network) {
+    if (network == nullptr) return;
+    network->~RcNetwork();
+    ::operator delete(network);
+}
+
+RcNodeType RcNetwork::getNodeType(uint32_t node) const {
+    if (node < num_pin_nodes_) return kRcPinNode;
+    if (node < num_pin_nodes_ + num_ext_nodes_) return kRcExtNode;
+    return kRcIntNode;
+}
+
+RcRange<uint32_t> RcNetwork::getNodeResistors(uint32_t node) const {
+    const uint32_t *begin = reinterpret_cast<const uint32_t *>(
+        __getData() + adjacency_begin_offset_);
+    const uint32_t *adjacency = reinterpret_cast<const uint32_t *>(
+        __getData() + adjacency_offset_);
+    return RcRange<uint32_t>(adjacency + begin[node], adjacency + begin[node + 1]);
+}
+
+}  // namespace db
+}  // namespace open_edi
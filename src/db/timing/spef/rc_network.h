@@ -0,0 +1,228 @@
+/**
+ * @file rc_network.h
+ * @date 2020-11-02
+ * @brief Packed RC network of a net, read from the D_NET records of SPEF.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef EDI_DB_TIMING_SPEF_RC_NETWORK_H_
+#define EDI_DB_TIMING_SPEF_RC_NETWORK_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "db/core/object.h"
+
+namespace open_edi {
+namespace db {
+
+/// @brief kind of the nodes of an RC network
+enum RcNodeType : uint8_t {
+    kRcPinNode,  ///< pin of an instance, or IO pin
+    kRcExtNode,  ///< node of another net, i.e. net:number
+    kRcIntNode   ///< internal node of the net, i.e. net:number
+};
+
+/// @brief resistor between two nodes of a net
+struct RcResistor {
+    uint32_t node1;
+    uint32_t node2;
+    float resistance;
+};
+
+/// @brief capacitance to ground
+struct RcGroundCap {
+    uint32_t node;
+    float capacitance;
+};
+
+/// @brief capacitance to a node of another net
+struct RcCouplingCap {
+    uint32_t node1;
+    uint32_t node2;
+    float capacitance;
+};
+
+/// @brief elements of an RC network, as a contiguous range
+template <class T>
+class RcRange {
+  public:
+    RcRange(const T *begin, const T *end) : begin_(begin), end_(end) {}
+
+    const T *begin() const { return begin_; }
+    const T *end() const { return end_; }
+    uint32_t size() const { return end_ - begin_; }
+    bool empty() const { return begin_ == end_; }
+    const T &operator[](uint32_t index) const { return begin_[index]; }
+
+  private:
+    const T *begin_;
+    const T *end_;
+};
+
+class RcNetwork;
+
+/// @brief Collects the nodes and elements of one D_NET.
+///
+/// Nodes get their index in the order they are added; RcNetwork::create()
+/// packs them by type, so the indexes of the builder are not those of the
+/// network. The builder is meant to be reused from net to net.
+class RcNetworkBuilder {
+  public:
+    RcNetworkBuilder() {}
+
+    uint32_t addPinNode(ObjectId pin_id);
+    uint32_t addExtNode(ObjectId net_id, uint32_t number);
+    uint32_t addIntNode(uint32_t number);
+    /// @brief pin node listed in the *CONN section
+    void addConnNode(uint32_t node) { conn_nodes_.push_back(node); }
+    void addGroundCap(uint32_t node, float capacitance);
+    void addCouplingCap(uint32_t node1, uint32_t node2, float capacitance);
+    void addResistor(uint32_t node1, uint32_t node2, float resistance);
+    void clear();
+
+  private:
+    friend class RcNetwork;
+
+    struct Node {
+        RcNodeType type;
+        uint32_t number;
+        ObjectId object_id;  ///< pin, or net of an external node
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> conn_nodes_;
+    std::vector<RcGroundCap> ground_caps_;
+    std::vector<RcCouplingCap> coupling_caps_;
+    std::vector<RcResistor> resistors_;
+};
+
+/// @brief RC network of a net in one block of memory.
+///
+/// Nodes are numbered pin nodes first, then external nodes, then internal
+/// ones, so the type of a node is known from its index. Besides the
+/// element arrays, the resistors are indexed per node in CSR form for
+/// traversals of the network. Nodes and elements are 4 or 8 bytes each,
+/// there are no objects nor object ids per element.
+class RcNetwork {
+  public:
+    static const uint32_t kInvalidNode = UINT32_MAX;
+
+    /// @brief bytes of the block packing the content of a builder
+    static uint64_t getPackedSize(const RcNetworkBuilder &builder);
+    /// @brief pack the content of a builder into getPackedSize() bytes
+    static RcNetwork *pack(const RcNetworkBuilder &builder, void *data);
+    /// @brief whether a block of size bytes is a well formed network
+    static bool isValid(const void *block, uint64_t size);
+    /// @brief pack the content of a builder on the heap
+    static RcNetwork *create(const RcNetworkBuilder &builder);
+    /// @brief copy of a block on the heap, nullptr if it isn't valid
+    static RcNetwork *copy(const void *block, uint64_t size);
+    /// @brief release a block of create() or copy()
+    static void destroy(RcNetwork *network);
+
+    /// @brief replace each pin and external net id by map(id)
+    template <class Map>
+    void mapObjectIds(Map map) {
+        ObjectId *ids = reinterpret_cast<ObjectId *>(this + 1);
+        for (uint32_t i = 0; i < num_pin_nodes_ + num_ext_nodes_; ++i)
+            ids[i] = map(ids[i]);
+    }
+
+    /// @brief bytes of the whole block
+    uint64_t getMemorySize() const { return size_; }
+
+    uint32_t getNumNodes() const {
+        return num_pin_nodes_ + num_ext_nodes_ + num_int_nodes_;
+    }
+    uint32_t getNumPinNodes() const { return num_pin_nodes_; }
+    uint32_t getNumExtNodes() const { return num_ext_nodes_; }
+    uint32_t getNumIntNodes() const { return num_int_nodes_; }
+    RcNodeType getNodeType(uint32_t node) const;
+    /// @brief pin of a pin node
+    ObjectId getPinId(uint32_t node) const { return __getPinIds()[node]; }
+    /// @brief net of an external node
+    ObjectId getExtNetId(uint32_t node) const {
+        return __getExtNetIds()[node - num_pin_nodes_];
+    }
+    /// @brief number of an internal or external node, as in net:number
+    uint32_t getNodeNumber(uint32_t node) const {
+        return __getNodeNumbers()[node - num_pin_nodes_];
+    }
+
+    /// @brief pin nodes of the *CONN section, in file order
+    RcRange<uint32_t> getConnNodes() const {
+        return __getRange<uint32_t>(conn_offset_, num_conn_nodes_);
+    }
+    RcRange<RcGroundCap> getGroundCaps() const {
+        return __getRange<RcGroundCap>(ground_cap_offset_, num_ground_caps_);
+    }
+    RcRange<RcCouplingCap> getCouplingCaps() const {
+        return __getRange<RcCouplingCap>(coupling_cap_offset_,
+                                         num_coupling_caps_);
+    }
+    RcRange<RcResistor> getResistors() const {
+        return __getRange<RcResistor>(resistor_offset_, num_resistors_);
+    }
+    /// @brief indexes of the resistors at a node
+    RcRange<uint32_t> getNodeResistors(uint32_t node) const;
+    /// @brief the node at the other end of a resistor
+    uint32_t getOtherNode(uint32_t resistor, uint32_t node) const {
+        const RcResistor &res = getResistors()[resistor];
+        return res.node1 == node ? res.node2 : res.node1;
+    }
+
+  private:
+    RcNetwork() {}
+    ~RcNetwork() {}
+
+    const char *__getData() const {
+        return reinterpret_cast<const char *>(this);
+    }
+    template <class T>
+    RcRange<T> __getRange(uint32_t offset, uint32_t num) const {
+        const T *begin = reinterpret_cast<const T *>(__getData() + offset);
+        return RcRange<T>(begin, begin + num);
+    }
+    const ObjectId *__getPinIds() const {
+        return reinterpret_cast<const ObjectId *>(this + 1);
+    }
+    const ObjectId *__getExtNetIds() const {
+        return __getPinIds() + num_pin_nodes_;
+    }
+    const uint32_t *__getNodeNumbers() const {
+        return reinterpret_cast<const uint32_t *>(__getData() +
+                                                  number_offset_);
+    }
+
+    uint64_t size_;
+    uint32_t num_pin_nodes_;
+    uint32_t num_ext_nodes_;
+    uint32_t num_int_nodes_;
+    uint32_t num_conn_nodes_;
+    uint32_t num_ground_caps_;
+    uint32_t num_coupling_caps_;
+    uint32_t num_resistors_;
+    /// byte offsets of the arrays from the start of the block, the pin and
+    /// external net ids follow the header.
+    uint32_t number_offset_;
+    uint32_t conn_offset_;
+    uint32_t adjacency_begin_offset_;  ///< num nodes + 1 entries
+    uint32_t adjacency_offset_;        ///< 2 entries per resistor
+    uint32_t ground_cap_offset_;
+    uint32_t coupling_cap_offset_;
+    uint32_t resistor_offset_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // EDI_DB_TIMING_SPEF_RC_NETWORK_H_
@@ -0,0 +1,197 @@
+/**
+ * @file spef_lazy_loader.cpp
+ * @date 2020-11-02
+ * @brief On demand loading of the nets of a SPEF file.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "db/timing/spef/spef_lazy_loader.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "db/core/db.h"
+#include "db/timing/spef/spef_reader.h"
+
+namespace SpefReader {
+
+static const char kIndexMagic[8] = {'S', 'P', 'E', 'F', 'I', 'D', 'X', '1'};
+
+SpefLazyLoader::SpefLazyLoader(const std::string &fileName,
+                               DesignParasitics *designParasitics,
+                               uint64_t cacheSize)
+    : fileName_(fileName),
+      cacheSize_(cacheSize),
+      spefReader_(new SpefReader(fileName, designParasitics)),
+      reader_(),
+      netsParasitics_(nullptr),
+      offsets_(),
+      entries_(),
+      lru_() {
+    reader_.reset(new SpefParallelReader(spefReader_.get(), 1));
+}
+
+SpefLazyLoader::~SpefLazyLoader() {
+}
+
+/// @brief open read the header and index the nets, from indexFile if valid
+bool SpefLazyLoader::open(const std::string &indexFile) {
+    if (!reader_->open()) return false;
+    netsParasitics_ = spefReader_->getNetsParasitics();
+    if (netsParasitics_ == nullptr) return false;
+
+    if (indexFile.empty() || !__readIndex(indexFile)) {
+        offsets_.clear();
+        if (!reader_->indexNets(&offsets_)) {
+            std::string errMsg = "Failed to index SPEF file: " + fileName_;
+            open_edi::util::message->issueMsg(open_edi::util::kError, errMsg.c_str());
+            return false;
+        }
+        if (!indexFile.empty() && !__writeIndex(indexFile)) {
+            std::string errMsg = "Failed to write SPEF index file: " + indexFile;
+            open_edi::util::message->issueMsg(open_edi::util::kWarn, errMsg.c_str());
+        }
+    }
+    entries_.reserve(offsets_.size());
+    for (uint32_t i = 0; i < offsets_.size(); ++i)
+        entries_[offsets_[i].netId] = Entry{i, lru_.end(), false};
+    netsParasitics_->setLazyLoader(this);
+    return true;
+}
+
+bool SpefLazyLoader::isIndexed(ObjectId netId) const {
+    return entries_.find(netId) != entries_.end();
+}
+
+/// @brief getNetIds nets of the index, in file order
+std::vector<ObjectId> SpefLazyLoader::getNetIds() const {
+    std::vector<ObjectId> netIds;
+    netIds.reserve(offsets_.size());
+    for (auto &offset : offsets_) netIds.push_back(offset.netId);
+    return netIds;
+}
+
+/// @brief load parasitics of a net, parsed from the file if not loaded
+NetParasitics* SpefLazyLoader::load(ObjectId netId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = entries_.find(netId);
+    if (found == entries_.end()) return nullptr;
+    Entry &entry = found->second;
+    if (entry.loaded) {
+        lru_.splice(lru_.begin(), lru_, entry.lruPos);
+        return netsParasitics_->findNetParasitics(netId);
+    }
+
+    SpefStagedNet staged;
+    if (!reader_->parseNet(offsets_[entry.offsetIdx], &staged)) {
+        std::string errMsg = "Failed to load net " +
+                             reader_->getNetName(offsets_[entry.offsetIdx].begin) +
+                             " from SPEF file: " + fileName_;
+        open_edi::util::message->issueMsg(open_edi::util::kError, errMsg.c_str());
+        return nullptr;
+    }
+    NetParasitics *netParasitics = reader_->commitNet(&staged);
+    if (netParasitics == nullptr) return nullptr;
+    lru_.push_front(netId);
+    entry.lruPos = lru_.begin();
+    entry.loaded = true;
+    __evict();
+    return netParasitics;
+}
+
+/// @brief __evict least recently used nets over the cache size
+void SpefLazyLoader::__evict() {
+    while (cacheSize_ > 0 && lru_.size() > cacheSize_) {
+        ObjectId netId = lru_.back();
+        lru_.pop_back();
+        Entry &entry = entries_[netId];
+        entry.loaded = false;
+        entry.lruPos = lru_.end();
+        netsParasitics_->removeNetParasitics(netId);
+    }
+}
+
+bool SpefLazyLoader::__getFileStamp(uint64_t *size, int64_t *mtime) const {
+    struct stat st;
+    if (stat(fileName_.c_str(), &st) != 0) return false;
+    *size = st.st_size;
+    *mtime = st.st_mtime;
+    return true;
+}
+
+/// @brief __readIndex nets from a sidecar index file
+///
+/// Layout: magic, SPEF file size and mtime, number of nets, then for each
+/// net its begin and end offsets and its name.
+bool SpefLazyLoader::__readIndex(const std::string &indexFile) {
+    uint64_t fileSize = 0;
+    int64_t fileMtime = 0;
+    if (!__getFileStamp(&fileSize, &fileMtime)) return false;
+    FILE *fp = fopen(indexFile.c_str(), "rb");
+    if (fp == nullptr) return false;
+
+    char magic[sizeof(kIndexMagic)];
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t numNets = 0;
+    bool ok = fread(magic, sizeof(magic), 1, fp) == 1 &&
+              memcmp(magic, kIndexMagic, sizeof(magic)) == 0 &&
+              fread(&size, sizeof(size), 1, fp) == 1 &&
+              fread(&mtime, sizeof(mtime), 1, fp) == 1 &&
+              fread(&numNets, sizeof(numNets), 1, fp) == 1 &&
+              size == fileSize && mtime == fileMtime &&
+              size == reader_->getFileSize();
+    offsets_.clear();
+    if (ok) offsets_.reserve(numNets);
+    std::string name;
+    for (uint64_t i = 0; ok && i < numNets; ++i) {
+        uint64_t range[2];
+        uint32_t length = 0;
+        ok = fread(range, sizeof(range), 1, fp) == 1 &&
+             fread(&length, sizeof(length), 1, fp) == 1 &&
+             range[0] < range[1] && range[1] <= size;
+        if (!ok) break;
+        name.resize(length);
+        ok = length == 0 || fread(&name[0], length, 1, fp) == 1;
+        if (!ok) break;
+        Net *net = netsParasitics_->findNet(name.c_str());
+        if (net) offsets_.push_back(SpefNetOffset{net->getId(), range[0], range[1]});
+    }
+    fclose(fp);
+    if (!ok) offsets_.clear();
+    return ok;
+}
+
+bool SpefLazyLoader::__writeIndex(const std::string &indexFile) const {
+    uint64_t fileSize = 0;
+    int64_t fileMtime = 0;
+    if (!__getFileStamp(&fileSize, &fileMtime)) return false;
+    FILE *fp = fopen(indexFile.c_str(), "wb");
+    if (fp == nullptr) return false;
+
+    uint64_t numNets = offsets_.size();
+    bool ok = fwrite(kIndexMagic, sizeof(kIndexMagic), 1, fp) == 1 &&
+              fwrite(&fileSize, sizeof(fileSize), 1, fp) == 1 &&
+              fwrite(&fileMtime, sizeof(fileMtime), 1, fp) == 1 &&
+              fwrite(&numNets, sizeof(numNets), 1, fp) == 1;
+    for (uint64_t i = 0; ok && i < numNets; ++i) {
+        uint64_t range[2] = {offsets_[i].begin, offsets_[i].end};
+        std::string name = reader_->getNetName(offsets_[i].begin);
+        uint32_t length = name.size();
+        ok = fwrite(range, sizeof(range), 1, fp) == 1 &&
+             fwrite(&length, sizeof(length), 1, fp) == 1 &&
+             (length == 0 || fwrite(name.data(), length, 1, fp) == 1);
+    }
+    if (fclose(fp) != 0) ok = false;
+    return ok;
+}
+
+}  // namespace SpefReader
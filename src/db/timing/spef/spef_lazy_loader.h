@@ -0,0 +1,99 @@
+/**
+ * @file spef_lazy_loader.h
+ * @date 2020-11-02
+ * @brief On demand loading of the nets of a SPEF file.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef EDI_DB_TIMING_SPEF_SPEF_LAZY_LOADER_H_
+#define EDI_DB_TIMING_SPEF_SPEF_LAZY_LOADER_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "db/core/object.h"
+#include "db/timing/spef/spef_reader_parallel.h"
+
+namespace open_edi {
+namespace db {
+  class DesignParasitics;
+  class NetParasitics;
+  class NetsParasitics;
+}
+}
+using namespace open_edi::db;
+
+namespace SpefReader {
+
+class SpefReader;
+
+/// @brief On demand loading of the nets of a SPEF file.
+///
+/// open() maps the file, reads its header and name map, and records the
+/// line range of each *D_NET/*R_NET instead of parsing the nets. A net is
+/// parsed the first time NetsParasitics::getNetParasitics asks for it.
+///
+/// At most cacheSize nets are kept loaded (0 keeps all of them); the least
+/// recently used one is removed from NetsParasitics when another is loaded,
+/// so a returned NetParasitics stays valid until cacheSize other nets have
+/// been loaded.
+///
+/// The index can be saved to a sidecar file, which later runs read instead
+/// of scanning the SPEF file again. It keeps the net names as written in
+/// the SPEF file, and is only used if the size and the modification time of
+/// the SPEF file still match.
+///
+/// Once open() succeeds, the loader is owned by the NetsParasitics of the
+/// file.
+class SpefLazyLoader {
+  public:
+    SpefLazyLoader(const std::string &fileName, DesignParasitics *designParasitics,
+                   uint64_t cacheSize);
+    ~SpefLazyLoader();
+
+    bool open(const std::string &indexFile);
+    NetParasitics* load(ObjectId netId);
+    bool isIndexed(ObjectId netId) const;
+    std::vector<ObjectId> getNetIds() const;
+    uint64_t getNumNets() const { return offsets_.size(); }
+    uint64_t getNumLoaded() const { return lru_.size(); }
+
+  private:
+    struct Entry {
+        uint32_t offsetIdx;
+        /// position in lru_ when loaded
+        std::list<ObjectId>::iterator lruPos;
+        bool loaded;
+    };
+
+    bool __readIndex(const std::string &indexFile);
+    bool __writeIndex(const std::string &indexFile) const;
+    bool __getFileStamp(uint64_t *size, int64_t *mtime) const;
+    void __evict();
+
+    std::string fileName_;
+    uint64_t cacheSize_;
+    std::unique_ptr<SpefReader> spefReader_;
+    std::unique_ptr<SpefParallelReader> reader_;
+    NetsParasitics *netsParasitics_;
+    std::vector<SpefNetOffset> offsets_;
+    std::unordered_map<ObjectId, Entry> entries_;
+    /// loaded nets, most recently used first
+    std::list<ObjectId> lru_;
+    std::mutex mutex_;
+};
+
+}  // namespace SpefReader
+
+#endif  // EDI_DB_TIMING_SPEF_SPEF_LAZY_LOADER_H_
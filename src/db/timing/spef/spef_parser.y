@@ -438,7 +438,7 @@ entity:
 
 /****************************************************************/
 internal_def:
-	nets
+	/* empty */
 |	internal_def nets
 ;
 
@@ -620,12 +620,12 @@ driver_reduc:
 ;
 
 driver_pair:
-	DRVCELL pin_name
+	DRVPIN pin_name
 	{ $$ = $2; }
 ;
 
 driver_cell:
-	CELL cell_type
+	DRVCELL cell_type
 	{ $$ = $2; }
 ;
 
@@ -767,7 +767,7 @@ pdriver_reduc:
 ;
 
 pdriver_pair:
-	DRVCELL internal_connection
+	DRVPIN internal_connection
 ;
 
 /****************************************************************/
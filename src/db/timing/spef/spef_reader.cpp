@@ -21,6 +21,7 @@
 #include <time.h>
 
 #include "db/timing/spef/spef_reader.h"
+#include "db/timing/spef/spef_reader_parallel.h"
 
 namespace SpefReader {
 
@@ -36,6 +37,7 @@ SpefReader::SpefReader(std::string fileName, DesignParasitics *designParasitics)
       rnetParasitics_(nullptr),
       lineNo_(1),
       netNodeMap_(),
+      rcBuilder_(),
       scanner_(nullptr) {
     spefField_ = designParasitics->getSpefField();
     //addDesignNetsParasitics();
@@ -230,27 +232,31 @@ void SpefReader::addDNetBegin(Net *net) {
 }
 
 void SpefReader::addDNetEnd() { 
+    if (dnetParasitics_)
+        dnetParasitics_->createRcNetwork(rcBuilder_);
     net_ = nullptr; 
     dnetParasitics_ = nullptr;
     netNodeMap_.clear(); 
+    rcBuilder_.clear();
 }
 
 void SpefReader::addPinNode(const char *pinName) {
     if (pinName) {
         if (dnetParasitics_) {
             std::string pinStr = pinName;
-            ObjectId pinNodeId = getParasiticNode(pinStr);
-            dnetParasitics_->addPinNode(pinNodeId);
+            uint32_t pinNode = getParasiticNode(pinStr);
+            if (pinNode != RcNetwork::kInvalidNode)
+                rcBuilder_.addConnNode(pinNode);
         }
         stringDelete(pinName);
     }
 }
 
-ObjectId SpefReader::getParasiticNode(std::string nodeName) {
-    ObjectId paraNodeId = UNINIT_OBJECT_ID;
+uint32_t SpefReader::getParasiticNode(std::string nodeName) {
+    uint32_t paraNodeId = RcNetwork::kInvalidNode;
     if (netsParasitics_ && dnetParasitics_) {
 	if (netNodeMap_.find(nodeName) == netNodeMap_.end()) {
-            paraNodeId = netsParasitics_->createParaNode(dnetParasitics_, nodeName.c_str());
+            paraNodeId = netsParasitics_->createParaNode(dnetParasitics_, &rcBuilder_, nodeName.c_str());
             netNodeMap_[nodeName] = paraNodeId;
         } else {
             paraNodeId = netNodeMap_[nodeName];
@@ -264,9 +270,9 @@ void SpefReader::addGroundCap(const char *nodeName) {
     if (nodeName) {
         if (dnetParasitics_) {
             std::string nodeStr = nodeName;
-	    ObjectId paraNodeId = getParasiticNode(nodeStr);
-            if (paraNodeId != UNINIT_OBJECT_ID)
-                dnetParasitics_->addGroundCap(paraNodeId, parValue_);
+	    uint32_t paraNodeId = getParasiticNode(nodeStr);
+            if (paraNodeId != RcNetwork::kInvalidNode)
+                rcBuilder_.addGroundCap(paraNodeId, parValue_);
         }
         stringDelete(nodeName);
     }
@@ -277,10 +283,10 @@ void SpefReader::addCouplingCap(const char *nodeName1, const char *nodeName2) {
         if (dnetParasitics_) {
             std::string node1Str = nodeName1;
             std::string node2Str = nodeName2;
-	    ObjectId paraNode1Id = getParasiticNode(node1Str);
-            ObjectId paraNode2Id = getParasiticNode(node2Str);
-	    if (paraNode1Id != UNINIT_OBJECT_ID && paraNode2Id != UNINIT_OBJECT_ID)
-	        dnetParasitics_->addCouplingCap(paraNode1Id, paraNode2Id, parValue_);
+	    uint32_t paraNode1Id = getParasiticNode(node1Str);
+            uint32_t paraNode2Id = getParasiticNode(node2Str);
+	    if (paraNode1Id != RcNetwork::kInvalidNode && paraNode2Id != RcNetwork::kInvalidNode)
+	        rcBuilder_.addCouplingCap(paraNode1Id, paraNode2Id, parValue_);
 	}
         stringDelete(nodeName1);
         stringDelete(nodeName2);
@@ -292,10 +298,10 @@ void SpefReader::addResistor(const char *nodeName1, const char *nodeName2) {
         if (dnetParasitics_) {
             std::string node1Str = nodeName1;
 	    std::string node2Str = nodeName2;
-	    ObjectId paraNode1Id = getParasiticNode(node1Str);
-            ObjectId paraNode2Id = getParasiticNode(node2Str);
-            if (paraNode1Id != UNINIT_OBJECT_ID && paraNode2Id != UNINIT_OBJECT_ID)
-                dnetParasitics_->addResistor(paraNode1Id, paraNode2Id, parValue_);
+	    uint32_t paraNode1Id = getParasiticNode(node1Str);
+            uint32_t paraNode2Id = getParasiticNode(node2Str);
+            if (paraNode1Id != RcNetwork::kInvalidNode && paraNode2Id != RcNetwork::kInvalidNode)
+                rcBuilder_.addResistor(paraNode1Id, paraNode2Id, parValue_);
 	}
 	stringDelete(nodeName1);
 	stringDelete(nodeName2);
@@ -303,7 +309,7 @@ void SpefReader::addResistor(const char *nodeName1, const char *nodeName2) {
 }
 
 void SpefReader::addRNetBegin(Net *net) {
-    if (netsParasitics_) {
+    if (netsParasitics_ && net) {
 	net_ = net;
         rnetParasitics_ = netsParasitics_->addRNetParasitics(net->getId(), parValue_);
     } 
@@ -328,7 +334,16 @@ void SpefReader::addPiModel(float c2, float r1, float c1) {
     }
 }
 
-bool SpefReader::parseSpefFile() {
+bool SpefReader::parseSpefFile(int numThreads) {
+
+    if (numThreads > 1) {
+        SpefParallelReader reader(this, numThreads);
+        if (!reader.parse())
+            return false;
+        open_edi::util::message->info("Read %lu nets on %d threads.\n",
+                                      reader.getNumNets(), numThreads);
+        return true;
+    }
 
     std::string errMsg = "Failed to open SPEF file: " + spefFileName_;
 
@@ -339,18 +354,23 @@ bool SpefReader::parseSpefFile() {
         return false;
     }
 
-    __spef_parse_begin(fspef);
+    bool ok = parseSpefStream(fspef);
+    fclose(fspef);
+    return ok;
+}
+
+/// @brief parseSpefStream parse SPEF text from an opened stream
+bool SpefReader::parseSpefStream(FILE *fp) {
+    __spef_parse_begin(fp);
     if (__spef_parse() != 0) {
-        errMsg = "Failed to parse SPEF file: " + spefFileName_;
+        std::string errMsg = "Failed to parse SPEF file: " + spefFileName_;
 	open_edi::util::message->issueMsg(
                         open_edi::util::kError, errMsg.c_str());
 
-        __spef_parse_end(fspef);
-        fclose(fspef);
+        __spef_parse_end(fp);
         return false;
     }
-    __spef_parse_end(fspef); 
-    fclose(fspef);
+    __spef_parse_end(fp); 
     
     return true;
 }
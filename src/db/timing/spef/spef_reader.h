@@ -75,7 +75,7 @@ class SpefReader {
     void addDNetBegin(Net *net);
     void addDNetEnd();
     void addPinNode(const char *pinName);
-    ObjectId getParasiticNode(std::string nodeName);
+    uint32_t getParasiticNode(std::string nodeName);
     void addGroundCap(const char *nodeName);
     void addCouplingCap(const char *nodeName1, const char *nodeName2);
     void addResistor(const char *nodeName1, const char *nodeName2);
@@ -88,7 +88,9 @@ class SpefReader {
     void incrLineNo() { lineNo_++; }
     uint32_t getLineNo() const { return lineNo_; }
     std::string getSpefFile() const { return spefFileName_; }
-    bool parseSpefFile();
+    NetsParasitics* getNetsParasitics() const { return netsParasitics_; }
+    bool parseSpefFile(int numThreads = 1);
+    bool parseSpefStream(FILE *fp);
 
   private:
     void __spef_parse_begin(FILE *fp);
@@ -106,7 +108,8 @@ class SpefReader {
     RNetParasitics *rnetParasitics_;
     uint8_t spefField_;
     uint32_t lineNo_;
-    std::map<std::string, ObjectId> netNodeMap_; //use to check if node created for net
+    std::map<std::string, uint32_t> netNodeMap_; //use to check if node created for net
+    RcNetworkBuilder rcBuilder_; //nodes and elements of the current D_NET
     void *scanner_;
 };
 
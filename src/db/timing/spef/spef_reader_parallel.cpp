@@ -0,0 +1,574 @@
+/**
+ * @file spef_reader_parallel.cpp
+ * @date 2020-11-02
+ * @brief Parallel import of the nets of a SPEF file.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "db/timing/spef/spef_reader_parallel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "db/core/db.h"
+#include "db/timing/spef/spef_reader.h"
+#include "util/thread_pool.h"
+
+namespace SpefReader {
+
+/// @brief most bytes of the body parsed by one task
+static const uint64_t kMaxChunkSize = 64 << 20;
+
+/// @brief whitespace separated tokens of the SPEF body, comments skipped
+class SpefParallelReader::Tokenizer {
+  public:
+    Tokenizer(const char *begin, const char *end)
+        : begin_(begin), pos_(begin), end_(end), token_(nullptr), length_(0) {}
+
+    bool next() {
+        for (;;) {
+            while (pos_ < end_ && __isSpace(*pos_)) ++pos_;
+            if (pos_ + 1 < end_ && pos_[0] == '/' && pos_[1] == '/') {
+                while (pos_ < end_ && *pos_ != '\n') ++pos_;
+                continue;
+            }
+            if (pos_ + 1 < end_ && pos_[0] == '/' && pos_[1] == '*') {
+                pos_ += 2;
+                while (pos_ + 1 < end_ && !(pos_[0] == '*' && pos_[1] == '/'))
+                    ++pos_;
+                pos_ = std::min(pos_ + 2, end_);
+                continue;
+            }
+            break;
+        }
+        if (pos_ == end_) {
+            token_ = nullptr;
+            length_ = 0;
+            return false;
+        }
+        token_ = pos_;
+        while (pos_ < end_ && !__isSpace(*pos_)) ++pos_;
+        length_ = pos_ - token_;
+        return true;
+    }
+
+    const char *token() const { return token_; }
+    size_t length() const { return length_; }
+    NameRef name() const { return NameRef{token_, static_cast<uint32_t>(length_)}; }
+    /// @brief offset of the token from the start of the tokenized bytes
+    uint64_t offset() const { return (token_ ? token_ : pos_) - begin_; }
+
+    template <size_t N>
+    bool is(const char (&keyword)[N]) const {
+        return token_ != nullptr && length_ == N - 1 &&
+               memcmp(token_, keyword, N - 1) == 0;
+    }
+
+  private:
+    static bool __isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    const char *begin_;
+    const char *pos_;
+    const char *end_;
+    const char *token_;
+    size_t length_;
+};
+
+bool SpefParallelReader::NameRef::operator==(const NameRef &rhs) const {
+    return size == rhs.size && memcmp(data, rhs.data, size) == 0;
+}
+
+size_t SpefParallelReader::NameRefHash::operator()(const NameRef &name) const {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t i = 0; i < name.size; ++i) {
+        hash ^= static_cast<unsigned char>(name.data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+SpefParallelReader::SpefParallelReader(SpefReader *spefReader, int numThreads)
+    : spefReader_(spefReader),
+      netsParasitics_(nullptr),
+      numThreads_(numThreads > 0 ? numThreads : 1),
+      spefField_(spefReader->getSpefField()),
+      delimiter_(':'),
+      data_(nullptr),
+      size_(0),
+      bodyBegin_(0),
+      numNets_(0) {
+}
+
+SpefParallelReader::~SpefParallelReader() {
+    // nets of chunks not committed after an error
+    for (auto &chunk : chunks_) {
+        for (auto &net : chunk->nets)
+            RcNetwork::destroy(net.rcNetwork);
+    }
+}
+
+/// @brief __nextNetLine first line at or after pos starting a net
+uint64_t SpefParallelReader::__nextNetLine(uint64_t pos) const {
+    static const char *kKeywords[] = {"*D_NET", "*R_NET", "*D_PNET", "*R_PNET"};
+    while (pos < size_) {
+        if (pos == 0 || data_[pos - 1] == '\n') {
+            for (const char *keyword : kKeywords) {
+                size_t length = strlen(keyword);
+                if (pos + length < size_ &&
+                    memcmp(data_ + pos, keyword, length) == 0 &&
+                    (data_[pos + length] == ' ' || data_[pos + length] == '\t'))
+                    return pos;
+            }
+        }
+        const void *newline = memchr(data_ + pos, '\n', size_ - pos);
+        if (newline == nullptr) break;
+        pos = static_cast<const char *>(newline) - data_ + 1;
+    }
+    return size_;
+}
+
+/// @brief __parseHeader with the serial parser, up to the first net
+bool SpefParallelReader::__parseHeader() {
+    FILE *fp = fmemopen(const_cast<char *>(data_), bodyBegin_, "r");
+    if (fp == nullptr) return false;
+    bool ok = spefReader_->parseSpefStream(fp);
+    fclose(fp);
+    return ok;
+}
+
+/// @brief open map the file and read its header, up to the first net
+bool SpefParallelReader::open() {
+    std::string fileName = spefReader_->getSpefFile();
+    if (!file_.map(fileName.c_str())) {
+        std::string errMsg = "Failed to open SPEF file: " + fileName;
+        open_edi::util::message->issueMsg(open_edi::util::kError, errMsg.c_str());
+        return false;
+    }
+    data_ = file_.getAddr();
+    size_ = file_.getSize();
+    bodyBegin_ = __nextNetLine(0);
+    if (!__parseHeader()) return false;
+    netsParasitics_ = spefReader_->getNetsParasitics();
+    if (netsParasitics_ == nullptr) return bodyBegin_ == size_;
+    delimiter_ = netsParasitics_->getDelimiter();
+    return true;
+}
+
+bool SpefParallelReader::parse() {
+    if (!open()) return false;
+    if (netsParasitics_ == nullptr) return true;
+    std::string fileName = spefReader_->getSpefFile();
+
+    // cut the body at net lines.
+    uint64_t bodySize = size_ - bodyBegin_;
+    uint64_t numChunks = std::max<uint64_t>(numThreads_ * 4,
+                                            bodySize / kMaxChunkSize + 1);
+    uint64_t chunkSize = std::max<uint64_t>(1, bodySize / numChunks);
+    uint64_t begin = bodyBegin_;
+    while (begin < size_) {
+        uint64_t end = __nextNetLine(std::min(size_, begin + chunkSize));
+        chunks_.emplace_back(new Chunk);
+        Chunk *chunk = chunks_.back().get();
+        chunk->begin = begin;
+        chunk->end = end;
+        chunk->errorOffset = 0;
+        chunk->failed = false;
+        chunk->done = false;
+        begin = end;
+    }
+
+    // workers look up nets, instances and IO pins by name: build the name
+    // indexes of the cell up front, rather than on a first lookup that
+    // every worker would wait for.
+    Cell *cell = Object::addr<Cell>(netsParasitics_->getCellId());
+    if (cell) cell->buildNameIndexes();
+
+    open_edi::util::ThreadPool &pool = open_edi::util::ThreadPool::getInstance();
+    open_edi::util::TaskGroup tasks(pool);
+    for (auto &chunk : chunks_) {
+        Chunk *task = chunk.get();
+        tasks.run([this, task]() {
+            __parseChunk(task);
+            std::lock_guard<std::mutex> lock(mutex_);
+            task->done.store(true, std::memory_order_release);
+            chunkDone_.notify_all();
+        });
+    }
+
+    // commit in file order, parsing while the next chunk isn't done.
+    bool ok = true;
+    for (auto &chunk : chunks_) {
+        while (!chunk->done.load(std::memory_order_acquire)) {
+            if (pool.runPendingTask()) continue;
+            std::unique_lock<std::mutex> lock(mutex_);
+            chunkDone_.wait(lock, [&chunk]() {
+                return chunk->done.load(std::memory_order_acquire);
+            });
+        }
+        if (chunk->failed) {
+            char errMsg[4096];
+            snprintf(errMsg, sizeof(errMsg),
+                     "Error found in line %lu in SPEF file %s\n",
+                     __lineNo(chunk->errorOffset), fileName.c_str());
+            open_edi::util::message->issueMsg(open_edi::util::kError, errMsg);
+            ok = false;
+            break;
+        }
+        __commit(chunk.get());
+    }
+    tasks.wait();
+    return ok;
+}
+
+void SpefParallelReader::__parseChunk(Chunk *chunk) {
+    Worker worker;
+    Tokenizer tokens(data_ + chunk->begin, data_ + chunk->end);
+    while (tokens.next()) {
+        SpefStagedNet net = {UNINIT_OBJECT_ID, 0.0, false, nullptr,
+                             UNINIT_OBJECT_ID, 0.0, 0.0, 0.0};
+        bool ok = true;
+        if (tokens.is("*D_NET")) {
+            ok = __parseDNet(worker, tokens, net);
+        } else if (tokens.is("*R_NET")) {
+            net.reduced = true;
+            ok = __parseRNet(worker, tokens, net);
+        } else if (tokens.is("*D_PNET") || tokens.is("*R_PNET")) {
+            // physical nets are not kept, as in the serial parser
+            while (tokens.next() && !tokens.is("*END")) {}
+            ok = tokens.token() != nullptr;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            RcNetwork::destroy(net.rcNetwork);
+            chunk->failed = true;
+            chunk->errorOffset = chunk->begin + tokens.offset();
+            return;
+        }
+        if (net.netId != UNINIT_OBJECT_ID) chunk->nets.push_back(net);
+    }
+}
+
+/// @brief __parValue number or triplet, picked as the serial parser does
+bool SpefParallelReader::__parValue(const char *token, size_t length,
+                                    float *value) const {
+    char buffer[128];
+    if (token == nullptr || length == 0 || length >= sizeof(buffer))
+        return false;
+    char first = *token;
+    if (!isdigit(static_cast<unsigned char>(first)) && first != '.' &&
+        first != '-' && first != '+')
+        return false;
+    memcpy(buffer, token, length);
+    buffer[length] = '\0';
+    float values[3];
+    int num = 0;
+    char *pos = buffer;
+    while (num < 3) {
+        char *end = nullptr;
+        values[num++] = strtof(pos, &end);
+        if (end == pos) return false;
+        if (*end == '\0') break;
+        if (*end != ':') return false;
+        pos = end + 1;
+    }
+    if (num == 2) return false;
+    if (num == 3 && spefField_ >= 1 && spefField_ <= 3)
+        *value = values[spefField_ - 1];
+    else
+        *value = values[0];
+    return true;
+}
+
+bool SpefParallelReader::__parseDNet(Worker &worker, Tokenizer &tokens,
+                                     SpefStagedNet &net) {
+    if (!tokens.next()) return false;
+    NameRef netName = tokens.name();
+    net.netId = __findNet(worker, netName);
+    if (!tokens.next() ||
+        !__parValue(tokens.token(), tokens.length(), &net.totalCap))
+        return false;
+
+    RcNetworkBuilder &builder = worker.builder;
+    builder.clear();
+    worker.nodes.clear();
+    enum { kNone, kConn, kCap, kRes, kInduc } section = kNone;
+    float value = 0.0;
+    while (tokens.next()) {
+        if (tokens.is("*END")) {
+            if (net.netId != UNINIT_OBJECT_ID)
+                net.rcNetwork = RcNetwork::create(builder);
+            return true;
+        } else if (tokens.is("*CONN")) {
+            section = kConn;
+        } else if (tokens.is("*CAP")) {
+            section = kCap;
+        } else if (tokens.is("*RES")) {
+            section = kRes;
+        } else if (tokens.is("*INDUC")) {
+            section = kInduc;
+        } else if (section == kConn) {
+            if (tokens.is("*P") || tokens.is("*I")) {
+                if (!tokens.next()) return false;
+                NameRef pinName = tokens.name();
+                if (!tokens.next()) return false;  // direction
+                if (net.netId == UNINIT_OBJECT_ID) continue;
+                uint32_t node = __getNode(worker, netName, net.netId, pinName);
+                if (node != RcNetwork::kInvalidNode) builder.addConnNode(node);
+            } else if (tokens.is("*N") || tokens.is("*D")) {
+                if (!tokens.next()) return false;  // node or driving cell
+            }
+            // coordinates, loads and slews are not kept.
+        } else if (section == kCap) {
+            // id node value, or id node node value.
+            if (!tokens.next()) return false;
+            NameRef node1Name = tokens.name();
+            if (!tokens.next()) return false;
+            if (__parValue(tokens.token(), tokens.length(), &value)) {
+                if (net.netId == UNINIT_OBJECT_ID) continue;
+                uint32_t node1 = __getNode(worker, netName, net.netId, node1Name);
+                if (node1 != RcNetwork::kInvalidNode)
+                    builder.addGroundCap(node1, value);
+                continue;
+            }
+            NameRef node2Name = tokens.name();
+            if (!tokens.next() ||
+                !__parValue(tokens.token(), tokens.length(), &value))
+                return false;
+            if (net.netId == UNINIT_OBJECT_ID) continue;
+            uint32_t node1 = __getNode(worker, netName, net.netId, node1Name);
+            uint32_t node2 = __getNode(worker, netName, net.netId, node2Name);
+            if (node1 != RcNetwork::kInvalidNode && node2 != RcNetwork::kInvalidNode)
+                builder.addCouplingCap(node1, node2, value);
+        } else if (section == kRes || section == kInduc) {
+            // id node node value
+            if (!tokens.next()) return false;
+            NameRef node1Name = tokens.name();
+            if (!tokens.next()) return false;
+            NameRef node2Name = tokens.name();
+            if (!tokens.next() ||
+                !__parValue(tokens.token(), tokens.length(), &value))
+                return false;
+            if (section == kInduc || net.netId == UNINIT_OBJECT_ID) continue;
+            uint32_t node1 = __getNode(worker, netName, net.netId, node1Name);
+            uint32_t node2 = __getNode(worker, netName, net.netId, node2Name);
+            if (node1 != RcNetwork::kInvalidNode && node2 != RcNetwork::kInvalidNode)
+                builder.addResistor(node1, node2, value);
+        } else if (tokens.is("*V")) {
+            if (!tokens.next()) return false;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool SpefParallelReader::__parseRNet(Worker &worker, Tokenizer &tokens,
+                                     SpefStagedNet &net) {
+    if (!tokens.next()) return false;
+    net.netId = __findNet(worker, tokens.name());
+    if (!tokens.next() ||
+        !__parValue(tokens.token(), tokens.length(), &net.totalCap))
+        return false;
+    while (tokens.next()) {
+        if (tokens.is("*END")) {
+            return true;
+        } else if (tokens.is("*DRIVER")) {
+            if (!tokens.next()) return false;
+            if (net.netId != UNINIT_OBJECT_ID)
+                net.drvrPinId = __findPin(worker, tokens.name());
+        } else if (tokens.is("*C2_R1_C1")) {
+            if (!tokens.next() ||
+                !__parValue(tokens.token(), tokens.length(), &net.c2))
+                return false;
+            if (!tokens.next() ||
+                !__parValue(tokens.token(), tokens.length(), &net.r1))
+                return false;
+            if (!tokens.next() ||
+                !__parValue(tokens.token(), tokens.length(), &net.c1))
+                return false;
+        }
+        // the cell, *V, and the loads are not kept.
+    }
+    return false;
+}
+
+/// @brief __getNode index of a node in the builder, created on first use
+///
+/// Same rules as NetsParasitics::createParaNode: net:number is an internal
+/// node of the net or a node of another net, other names are pins.
+uint32_t SpefParallelReader::__getNode(Worker &worker, NameRef netName,
+                                       ObjectId netId, NameRef nodeName) {
+    auto found = worker.nodes.find(nodeName);
+    if (found != worker.nodes.end()) return found->second;
+
+    uint32_t node = RcNetwork::kInvalidNode;
+    const char *delimiter = nullptr;
+    for (uint32_t i = nodeName.size; i > 0; --i) {
+        if (nodeName.data[i - 1] == delimiter_) {
+            delimiter = nodeName.data + i - 1;
+            break;
+        }
+    }
+    bool isDigits = delimiter != nullptr;
+    for (const char *c = delimiter ? delimiter + 1 : nullptr;
+         isDigits && c < nodeName.data + nodeName.size; ++c) {
+        isDigits = isdigit(static_cast<unsigned char>(*c));
+    }
+    if (isDigits) {
+        NameRef prefix = {nodeName.data,
+                          static_cast<uint32_t>(delimiter - nodeName.data)};
+        uint32_t number = strtoul(std::string(delimiter + 1,
+                                              nodeName.data + nodeName.size).c_str(),
+                                  NULL, 0);
+        ObjectId nodeNetId = prefix == netName ? netId : __findNet(worker, prefix);
+        if (nodeNetId == netId)
+            node = worker.builder.addIntNode(number);
+        else if (nodeNetId != UNINIT_OBJECT_ID)
+            node = worker.builder.addExtNode(nodeNetId, number);
+    } else {
+        ObjectId pinId = __findPin(worker, nodeName);
+        if (pinId != UNINIT_OBJECT_ID) node = worker.builder.addPinNode(pinId);
+    }
+    worker.nodes.emplace(nodeName, node);
+    return node;
+}
+
+ObjectId SpefParallelReader::__findNet(Worker &worker, NameRef name) {
+    auto found = worker.nets.find(name);
+    if (found != worker.nets.end()) return found->second;
+    Net *net = netsParasitics_->findNet(std::string(name.data, name.size).c_str());
+    ObjectId netId = net ? net->getId() : UNINIT_OBJECT_ID;
+    worker.nets.emplace(name, netId);
+    return netId;
+}
+
+ObjectId SpefParallelReader::__findPin(Worker &worker, NameRef name) {
+    std::string pinName(name.data, name.size);
+    std::size_t found = pinName.find_last_of(delimiter_);
+    if (found == std::string::npos) {  // IO pin
+        Pin *pin = netsParasitics_->findPin(pinName.c_str());
+        return pin ? pin->getId() : UNINIT_OBJECT_ID;
+    }
+    NameRef instName = {name.data, static_cast<uint32_t>(found)};
+    ObjectId instId = UNINIT_OBJECT_ID;
+    auto cached = worker.insts.find(instName);
+    if (cached != worker.insts.end()) {
+        instId = cached->second;
+    } else {
+        Inst *inst = netsParasitics_->findInst(pinName.substr(0, found));
+        instId = inst ? inst->getId() : UNINIT_OBJECT_ID;
+        worker.insts.emplace(instName, instId);
+    }
+    if (instId == UNINIT_OBJECT_ID) return UNINIT_OBJECT_ID;
+    Inst *inst = Object::addr<Inst>(instId);
+    std::lock_guard<std::mutex> lock(instLocks_[(instId >> 3) % instLocks_.size()]);
+    Pin *pin = inst->getPin(pinName.substr(found + 1));
+    return pin ? pin->getId() : UNINIT_OBJECT_ID;
+}
+
+/// @brief __commit the nets of a chunk, in file order
+void SpefParallelReader::__commit(Chunk *chunk) {
+    for (auto &staged : chunk->nets) {
+        commitNet(&staged);
+        ++numNets_;
+    }
+    std::vector<SpefStagedNet>().swap(chunk->nets);
+}
+
+/// @brief commitNet create the parasitics of a staged net
+///
+/// The RC network moves to the DNetParasitics, or is destroyed if it
+/// could not be created.
+NetParasitics* SpefParallelReader::commitNet(SpefStagedNet *staged) {
+    if (staged->reduced) {
+        RNetParasitics *rnet =
+            netsParasitics_->addRNetParasitics(staged->netId, staged->totalCap);
+        if (rnet) {
+            if (staged->drvrPinId != UNINIT_OBJECT_ID)
+                rnet->setDriverPinId(staged->drvrPinId);
+            rnet->setC2(staged->c2);
+            rnet->setR1(staged->r1);
+            rnet->setC1(staged->c1);
+        }
+        return rnet;
+    }
+    DNetParasitics *dnet =
+        netsParasitics_->addDNetParasitics(staged->netId, staged->totalCap);
+    if (dnet && staged->rcNetwork) {
+        dnet->copyRcNetwork(staged->rcNetwork,
+                            staged->rcNetwork->getMemorySize());
+    }
+    RcNetwork::destroy(staged->rcNetwork);
+    staged->rcNetwork = nullptr;
+    return dnet;
+}
+
+/// @brief indexNets line range and net of each *D_NET and *R_NET
+///
+/// Nets not found in the design are left out.
+bool SpefParallelReader::indexNets(std::vector<SpefNetOffset> *offsets) {
+    if (netsParasitics_ == nullptr) return false;
+    uint64_t begin = bodyBegin_;
+    while (begin < size_) {
+        uint64_t end = __nextNetLine(begin + 1);
+        Tokenizer tokens(data_ + begin, data_ + end);
+        if (tokens.next() && (tokens.is("*D_NET") || tokens.is("*R_NET"))) {
+            if (!tokens.next()) return false;
+            Net *net = netsParasitics_->findNet(
+                std::string(tokens.token(), tokens.length()).c_str());
+            if (net) offsets->push_back(SpefNetOffset{net->getId(), begin, end});
+        }
+        begin = end;
+    }
+    return true;
+}
+
+/// @brief getNetName net name as written on the *D_NET or *R_NET line
+std::string SpefParallelReader::getNetName(uint64_t begin) const {
+    Tokenizer tokens(data_ + begin, data_ + std::min(size_, __nextNetLine(begin + 1)));
+    if (!tokens.next() || !tokens.next()) return std::string();
+    return std::string(tokens.token(), tokens.length());
+}
+
+/// @brief parseNet parse one net of the index, not committed
+bool SpefParallelReader::parseNet(const SpefNetOffset &offset, SpefStagedNet *net) {
+    *net = {UNINIT_OBJECT_ID, 0.0, false, nullptr, UNINIT_OBJECT_ID, 0.0, 0.0, 0.0};
+    if (offset.begin >= offset.end || offset.end > size_) return false;
+    Worker worker;
+    Tokenizer tokens(data_ + offset.begin, data_ + offset.end);
+    bool ok = false;
+    if (tokens.next()) {
+        if (tokens.is("*D_NET")) {
+            ok = __parseDNet(worker, tokens, *net);
+        } else if (tokens.is("*R_NET")) {
+            net->reduced = true;
+            ok = __parseRNet(worker, tokens, *net);
+        }
+    }
+    if (!ok || net->netId != offset.netId) {
+        RcNetwork::destroy(net->rcNetwork);
+        net->rcNetwork = nullptr;
+        return false;
+    }
+    return true;
+}
+
+uint64_t SpefParallelReader::__lineNo(uint64_t offset) const {
+    return std::count(data_, data_ + offset, '\n') + 1;
+}
+
+}  // namespace SpefReader
@@ -0,0 +1,161 @@
+/**
+ * @file spef_reader_parallel.h
+ * @date 2020-11-02
+ * @brief Parallel import of the nets of a SPEF file.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef EDI_DB_TIMING_SPEF_SPEF_READER_PARALLEL_H_
+#define EDI_DB_TIMING_SPEF_SPEF_READER_PARALLEL_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "db/core/object.h"
+#include "db/timing/spef/rc_network.h"
+#include "util/util_mem.h"
+
+namespace open_edi {
+namespace db {
+  class Inst;
+  class NetParasitics;
+  class NetsParasitics;
+}
+}
+using namespace open_edi::db;
+
+namespace SpefReader {
+
+class SpefReader;
+
+/// @brief D_NET or R_NET parsed by a worker thread
+struct SpefStagedNet {
+    ObjectId netId;
+    float totalCap;
+    bool reduced;
+    /// D_NET network, owned by the staged net until it is committed
+    RcNetwork *rcNetwork;
+    /// R_NET driver and pi model
+    ObjectId drvrPinId;
+    float c2;
+    float r1;
+    float c1;
+};
+
+/// @brief *D_NET or *R_NET line range of a net in the SPEF file
+struct SpefNetOffset {
+    ObjectId netId;
+    uint64_t begin;
+    uint64_t end;
+};
+
+/// @brief Parallel import of the nets of a SPEF file.
+///
+/// The file is mapped, and everything before the first *D_NET or *R_NET
+/// line (header, name map, ports...) is read by the serial parser, so the
+/// name map is complete before any net is resolved. The rest is cut at
+/// *D_NET/*R_NET lines into chunks parsed by tasks of the shared thread
+/// pool. Each task keeps its own node table keyed by the bytes of the
+/// node names in the mapped file, and caches the nets and instances it
+/// resolved, so node references cost one hash lookup.
+///
+/// Staged nets are committed to NetsParasitics one chunk at a time in file
+/// order, by the calling thread, while later chunks are still parsed.
+class SpefParallelReader {
+  public:
+    SpefParallelReader(SpefReader *spefReader, int numThreads);
+    ~SpefParallelReader();
+
+    bool open();
+    bool parse();
+    uint64_t getNumNets() const { return numNets_; }
+    uint64_t getFileSize() const { return size_; }
+
+    /// @brief functions for lazy loading, see SpefLazyLoader
+    bool indexNets(std::vector<SpefNetOffset> *offsets);
+    std::string getNetName(uint64_t begin) const;
+    bool parseNet(const SpefNetOffset &offset, SpefStagedNet *net);
+    NetParasitics* commitNet(SpefStagedNet *net);
+
+  private:
+    struct Chunk {
+        uint64_t begin;
+        uint64_t end;
+        std::vector<SpefStagedNet> nets;
+        uint64_t errorOffset;
+        bool failed;
+        std::atomic<bool> done;
+    };
+
+    /// @brief bytes of a name in the mapped file
+    struct NameRef {
+        const char *data;
+        uint32_t size;
+
+        bool operator==(const NameRef &rhs) const;
+    };
+    struct NameRefHash {
+        size_t operator()(const NameRef &name) const;
+    };
+    typedef std::unordered_map<NameRef, uint32_t, NameRefHash> NodeMap;
+    typedef std::unordered_map<NameRef, ObjectId, NameRefHash> IdMap;
+
+    /// @brief state of a task, reused from net to net
+    struct Worker {
+        RcNetworkBuilder builder;
+        NodeMap nodes;
+        IdMap nets;
+        IdMap insts;
+    };
+
+    class Tokenizer;
+
+    uint64_t __nextNetLine(uint64_t pos) const;
+    bool __parseHeader();
+    void __parseChunk(Chunk *chunk);
+    bool __parseDNet(Worker &worker, Tokenizer &tokens, SpefStagedNet &net);
+    bool __parseRNet(Worker &worker, Tokenizer &tokens, SpefStagedNet &net);
+    bool __parValue(const char *token, size_t length, float *value) const;
+    uint32_t __getNode(Worker &worker, NameRef netName, ObjectId netId,
+                       NameRef nodeName);
+    ObjectId __findNet(Worker &worker, NameRef name);
+    ObjectId __findPin(Worker &worker, NameRef name);
+    void __commit(Chunk *chunk);
+    uint64_t __lineNo(uint64_t offset) const;
+
+    SpefReader *spefReader_;
+    NetsParasitics *netsParasitics_;
+    int numThreads_;
+    uint8_t spefField_;
+    char delimiter_;
+
+    open_edi::util::MemMappedFile file_;
+    const char *data_;
+    uint64_t size_;
+    uint64_t bodyBegin_;
+
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    std::mutex mutex_;
+    std::condition_variable chunkDone_;
+    /// ArrayObject reads move its segment cursor: pins of an instance are
+    /// looked up under the lock of the instance
+    std::array<std::mutex, 64> instLocks_;
+    uint64_t numNets_;
+};
+
+}  // namespace SpefReader
+
+#endif  // EDI_DB_TIMING_SPEF_SPEF_READER_PARALLEL_H_
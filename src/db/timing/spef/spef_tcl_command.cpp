@@ -20,6 +20,8 @@
 #include "db/timing/timinglib/analysis_mode.h"
 #include "db/timing/timinglib/analysis_view.h"
 #include "db/timing/spef/spef_reader.h"
+#include "db/timing/spef/spef_lazy_loader.h"
+#include "db/timing/spef/parasitics_cache.h"
 
 #include <utility>
 #include <fstream>
@@ -34,18 +36,115 @@ namespace db {
 void printReadSpefCommandHelp() {
     open_edi::util::message->info("read_spef:\n");
     open_edi::util::message->info("         -corner xxx\n");
+    open_edi::util::message->info("         -threads <num>\n");
+    open_edi::util::message->info("         -lazy\n");
+    open_edi::util::message->info("         -index_file xxx\n");
+    open_edi::util::message->info("         -cache_size <num nets>\n");
     open_edi::util::message->info("         <filename list>\n");
     open_edi::util::message->info("         -help\n");
 }
 
-int parseSpefFile(const std::string &file, DesignParasitics *designParasitics) {
+int parseSpefFile(const std::string &file, DesignParasitics *designParasitics,
+                  int numThreads) {
     
     SpefReader::SpefReader spefReader(file, designParasitics);
-    if (!spefReader.parseSpefFile()) 
+    if (!spefReader.parseSpefFile(numThreads)) 
         return TCL_ERROR;
     return TCL_OK;
 }
 
+int loadSpefFileLazily(const std::string &file, DesignParasitics *designParasitics,
+                       const std::string &indexFile, uint64_t cacheSize) {
+
+    SpefReader::SpefLazyLoader *loader =
+        new SpefReader::SpefLazyLoader(file, designParasitics, cacheSize);
+    if (!loader->open(indexFile)) {
+        delete loader;
+        return TCL_ERROR;
+    }
+    //The loader is owned by the NetsParasitics of the file now
+    open_edi::util::message->info("Indexed %lu nets, loaded on demand.\n",
+                                  loader->getNumNets());
+    return TCL_OK;
+}
+
+/// @brief parasitics of a corner to read into, created if needed
+///
+/// Without corner name, the default view, mode and corner are created
+/// first if they don't exist.
+static DesignParasitics* getCornerParasitics(const std::string &cornerName) {
+    Timing *timingdb = getTimingLib();
+    if (timingdb == nullptr) {
+        open_edi::util::message->issueMsg(
+            open_edi::util::kError,
+            "Cannot find top cell when reading parasitics.");
+        return nullptr;
+    }
+    AnalysisCorner *corner = nullptr;
+    if (cornerName == "") {
+        std::string default_name = "default";
+        auto view = timingdb->getAnalysisView(default_name);
+        if (view == nullptr) {
+            auto mode = timingdb->createAnalysisMode(default_name);
+            if (mode == nullptr) {
+                open_edi::util::message->issueMsg(
+                    open_edi::util::kError, "Create default mode failed.");
+                return nullptr;
+            }
+            corner = timingdb->createAnalysisCorner(default_name);
+            if (corner == nullptr) {
+                open_edi::util::message->issueMsg(
+                    open_edi::util::kError, "Create default corner failed.");
+                return nullptr;
+            }
+            view = timingdb->createAnalysisView(default_name);
+            if (view == nullptr) {
+                open_edi::util::message->issueMsg(
+                    open_edi::util::kError, "Create default view failed.");
+                return nullptr;
+            }
+
+            view->setAnalysisMode(mode->getId());
+            view->setAnalysisCorner(corner->getId());
+            view->setActive(true);
+            view->setSetup(true);
+            view->setHold(true);
+            timingdb->addActiveSetupView(view->getId());
+            timingdb->addActiveHoldView(view->getId());
+        } else {
+            corner = view->getAnalysisCorner();
+            if (corner == nullptr) {
+                corner = timingdb->createAnalysisCorner(default_name);
+                if (corner == nullptr) {
+                    open_edi::util::message->issueMsg(
+                        open_edi::util::kError, "Create default view failed.");
+                    return nullptr;
+                }
+            }
+        }
+    } else {
+        corner = timingdb->getAnalysisCorner(cornerName);
+        if (corner == nullptr) {
+            open_edi::util::message->issueMsg(
+                open_edi::util::kError,
+                "The corner specified doesn't exist.");
+            return nullptr;
+        }
+    }
+    DesignParasitics *dsnParasitics = corner->getDesignParasitics();
+    if (dsnParasitics == nullptr) {
+        dsnParasitics = timingdb->createObject<DesignParasitics>(kObjectTypeDesignParasitics, timingdb->getId());
+        if (dsnParasitics == nullptr) {
+            open_edi::util::message->issueMsg(
+                open_edi::util::kError,
+                "Create spef database failed.");
+            return nullptr;
+        }
+        corner->setDesignParasitics(dsnParasitics->getId());
+    }
+    return dsnParasitics;
+}
+
 int readSpefCommand(ClientData cld, Tcl_Interp *itp, int argc,
                          const char *argv[]) {
 
@@ -57,11 +156,29 @@ int readSpefCommand(ClientData cld, Tcl_Interp *itp, int argc,
     if (argc > 1) {
         std::vector<std::string> spefFiles;
         std::string cornerName = "";
+        int numThreads = 1;
+        bool lazy = false;
+        std::string indexFile = "";
+        uint64_t cacheSize = 100000;
         for (int i = 1; i < argc; ++i) {
             if (!strcmp(argv[i], "-corner")) {
                 if ((i + 1) < argc) {
                     cornerName = argv[++i];
                 }
+            } else if (!strcmp(argv[i], "-threads")) {
+                if ((i + 1) < argc) {
+                    numThreads = atoi(argv[++i]);
+                }
+            } else if (!strcmp(argv[i], "-lazy")) {
+                lazy = true;
+            } else if (!strcmp(argv[i], "-index_file")) {
+                if ((i + 1) < argc) {
+                    indexFile = argv[++i];
+                }
+            } else if (!strcmp(argv[i], "-cache_size")) {
+                if ((i + 1) < argc) {
+                    cacheSize = strtoull(argv[++i], NULL, 0);
+                }
             } else if (!strcmp(argv[i], "-help")) {
                 continue;
             } else {
@@ -73,78 +190,21 @@ int readSpefCommand(ClientData cld, Tcl_Interp *itp, int argc,
                 open_edi::util::kError, "Please specify at least one SPEF file.");
             return TCL_ERROR;
         }
-        Timing *timingdb = getTimingLib();
-        if (timingdb == nullptr) {
+        if (lazy && indexFile != "" && spefFiles.size() > 1) {
+            // an index is the one of a single SPEF file.
             open_edi::util::message->issueMsg(
                 open_edi::util::kError,
-                "Cannot find top cell when reading SPEF file.");
+                "-index_file takes one SPEF file, read the files one by one.");
             return TCL_ERROR;
         }
-        AnalysisCorner *corner = nullptr;
-        if (cornerName == "") {
-            std::string default_name = "default";
-            auto view = timingdb->getAnalysisView(default_name);
-            if (view == nullptr) {
-                auto mode = timingdb->createAnalysisMode(default_name);
-                if (mode == nullptr) {
-                    open_edi::util::message->issueMsg(
-                        open_edi::util::kError, "Create default mode failed.");
-                    return TCL_ERROR;
-                }
-                corner = timingdb->createAnalysisCorner(default_name);
-                if (corner == nullptr) {
-                    open_edi::util::message->issueMsg(
-                        open_edi::util::kError, "Create default corner failed.");
-                    return TCL_ERROR;
-                }
-                view = timingdb->createAnalysisView(default_name);
-                if (view == nullptr) {
-                    open_edi::util::message->issueMsg(
-                        open_edi::util::kError, "Create default view failed.");
-                    return TCL_ERROR;
-                }
-
-                view->setAnalysisMode(mode->getId());
-                view->setAnalysisCorner(corner->getId());
-                view->setActive(true);
-                view->setSetup(true);
-                view->setHold(true);
-                timingdb->addActiveSetupView(view->getId());
-                timingdb->addActiveHoldView(view->getId());
-            } else {
-                corner = view->getAnalysisCorner();
-                if (corner == nullptr) {
-                    corner = timingdb->createAnalysisCorner(default_name);
-                    if (corner == nullptr) {
-                        open_edi::util::message->issueMsg(
-                            open_edi::util::kError, "Create default view failed.");
-                        return TCL_ERROR;
-                    }
-                }
-            }
-        } else {
-            corner = timingdb->getAnalysisCorner(cornerName);
-            if (corner == nullptr) {
-                open_edi::util::message->issueMsg(
-                    open_edi::util::kError,
-                    "The corner specified doesn't exist.");
-                return TCL_ERROR;
-            }
-        }
-        DesignParasitics *dsnParasitics = corner->getDesignParasitics();
-        if (dsnParasitics == nullptr) {
-	    dsnParasitics = timingdb->createObject<DesignParasitics>(kObjectTypeDesignParasitics, timingdb->getId());
-            if (dsnParasitics == nullptr) {
-                open_edi::util::message->issueMsg(
-                    open_edi::util::kError,
-                    "Create spef database failed.");
-                return TCL_ERROR;
-	    }
-            corner->setDesignParasitics(dsnParasitics->getId());
-        }
+        DesignParasitics *dsnParasitics = getCornerParasitics(cornerName);
+        if (dsnParasitics == nullptr)
+            return TCL_ERROR;
         open_edi::util::message->info("\nReading SPEF file\n");
         for (auto spefFile : spefFiles) {
-            if ( parseSpefFile(spefFile, dsnParasitics) == TCL_ERROR ) {
+            int result = lazy ? loadSpefFileLazily(spefFile, dsnParasitics, indexFile, cacheSize)
+                              : parseSpefFile(spefFile, dsnParasitics, numThreads);
+            if (result == TCL_ERROR) {
                 std::string errMsg = "Failed to parse SPEF file: " + spefFile;       
                 open_edi::util::message->issueMsg(
                     open_edi::util::kError,
@@ -170,6 +230,35 @@ void printWriteSpefCommandHelp() {
     open_edi::util::message->info("         -help\n");
 }
 
+/// @brief corner to write the parasitics of, the default one without name
+static AnalysisCorner* findCorner(const std::string &cornerName) {
+    Timing *timingdb = getTimingLib();
+    if (timingdb == nullptr) {
+        open_edi::util::message->issueMsg(
+            open_edi::util::kError,
+            "Cannot find top cell when writing parasitics.");
+        return nullptr;
+    }
+    AnalysisCorner *corner = nullptr;
+    if (cornerName == "") {
+        std::string default_name = "default";
+        corner = timingdb->getAnalysisCorner(default_name);
+        if (corner == nullptr) {
+            open_edi::util::message->issueMsg(
+                    open_edi::util::kError, "Create default corner failed.");
+            return nullptr;
+        }
+    } else {
+        corner = timingdb->getAnalysisCorner(cornerName);
+        if (corner == nullptr) {
+            open_edi::util::message->issueMsg(
+                    open_edi::util::kError, "Can't find specified corner in design.");
+            return nullptr;
+        }
+    }
+    return corner;
+}
+
 int writeSpefCommand(ClientData cld, Tcl_Interp *itp, int argc,
                          const char *argv[]) {
 
@@ -201,30 +290,9 @@ int writeSpefCommand(ClientData cld, Tcl_Interp *itp, int argc,
                 open_edi::util::kError, "Only one file is allowed.");
 	    return TCL_ERROR;
         }
-        Timing *timingdb = getTimingLib();
-        if (timingdb == nullptr) {
-            open_edi::util::message->issueMsg(
-                open_edi::util::kError,
-                "Cannot find top cell when writing SPEF file.");
+        AnalysisCorner *corner = findCorner(cornerName);
+        if (corner == nullptr)
             return TCL_ERROR;
-        }
-        AnalysisCorner *corner = nullptr;
-        if (cornerName == "") {
-            std::string default_name = "default";
-            corner = timingdb->getAnalysisCorner(default_name);
-	    if (corner == nullptr) {
-                open_edi::util::message->issueMsg(
-                        open_edi::util::kError, "Create default corner failed.");
-                return TCL_ERROR;
-            }
-	} else {
-            corner = timingdb->getAnalysisCorner(cornerName);
-	    if (corner == nullptr) {
-                open_edi::util::message->issueMsg(
-                        open_edi::util::kError, "Can't find specified corner in design.");
-                return TCL_ERROR;
-	    }
-	}
         DesignParasitics *dsgPara = corner->getDesignParasitics();
         if (dsgPara) {
 	    open_edi::util::message->info("Write spef file %s...\n", outFiles[0].c_str()); 
@@ -241,6 +309,106 @@ int writeSpefCommand(ClientData cld, Tcl_Interp *itp, int argc,
     return TCL_OK;
 }
 
+void printWriteParasiticsCacheCommandHelp() {
+    open_edi::util::message->info("write_parasitics_cache:\n");
+    open_edi::util::message->info("         -corner xxx\n");
+    open_edi::util::message->info("         <filename>\n");
+    open_edi::util::message->info("         -help\n");
+}
+
+/// @brief parse -corner and one file name, for the parasitics cache commands
+static bool parseCacheCommandArgs(int argc, const char *argv[],
+                                  std::string *cornerName, std::string *fileName) {
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-corner")) {
+            if ((i + 1) < argc) {
+                *cornerName = argv[++i];
+            }
+        } else if (!strcmp(argv[i], "-help")) {
+            continue;
+        } else {
+            files.emplace_back(argv[i]);
+        }
+    }
+    if (files.size() != 1) {
+        open_edi::util::message->issueMsg(
+            open_edi::util::kError, "Please specify one parasitics cache file.");
+        return false;
+    }
+    *fileName = files[0];
+    return true;
+}
+
+int writeParasiticsCacheCommand(ClientData cld, Tcl_Interp *itp, int argc,
+                                const char *argv[]) {
+
+    if (argc == 2 && !strcasecmp(argv[1], "-help")) {
+        printWriteParasiticsCacheCommandHelp();
+        return TCL_OK;
+    }
+
+    std::string cornerName = "";
+    std::string fileName = "";
+    if (!parseCacheCommandArgs(argc, argv, &cornerName, &fileName))
+        return TCL_ERROR;
+    AnalysisCorner *corner = findCorner(cornerName);
+    if (corner == nullptr)
+        return TCL_ERROR;
+    DesignParasitics *dsgPara = corner->getDesignParasitics();
+    if (dsgPara == nullptr) {
+        open_edi::util::message->issueMsg(
+            open_edi::util::kError, "No parasitics in the corner.");
+        return TCL_ERROR;
+    }
+    open_edi::util::message->info("Write parasitics cache %s...\n", fileName.c_str());
+    ParasiticsCacheWriter writer;
+    if (!writer.write(dsgPara, fileName)) {
+        std::string errMsg = "Failed to write parasitics cache: " + fileName;
+        open_edi::util::message->issueMsg(open_edi::util::kError, errMsg.c_str());
+        return TCL_ERROR;
+    }
+    open_edi::util::message->info("Write parasitics cache %s finished\n", fileName.c_str());
+    return TCL_OK;
+}
+
+void printReadParasiticsCacheCommandHelp() {
+    open_edi::util::message->info("read_parasitics_cache:\n");
+    open_edi::util::message->info("         -corner xxx\n");
+    open_edi::util::message->info("         <filename>\n");
+    open_edi::util::message->info("         -help\n");
+}
+
+int readParasiticsCacheCommand(ClientData cld, Tcl_Interp *itp, int argc,
+                               const char *argv[]) {
+
+    if (argc == 2 && !strcasecmp(argv[1], "-help")) {
+        printReadParasiticsCacheCommandHelp();
+        return TCL_OK;
+    }
+
+    std::string cornerName = "";
+    std::string fileName = "";
+    if (!parseCacheCommandArgs(argc, argv, &cornerName, &fileName))
+        return TCL_ERROR;
+    DesignParasitics *dsnParasitics = getCornerParasitics(cornerName);
+    if (dsnParasitics == nullptr)
+        return TCL_ERROR;
+    ParasiticsCacheReader reader;
+    if (!reader.read(dsnParasitics, fileName)) {
+        std::string errMsg = "Failed to read parasitics cache: " + fileName;
+        open_edi::util::message->issueMsg(open_edi::util::kError, errMsg.c_str());
+        return TCL_ERROR;
+    }
+    if (reader.getNumUnresolved() > 0) {
+        open_edi::util::message->issueMsg(open_edi::util::kWarn,
+            "%lu nets or pins of the parasitics cache are not in the design.\n",
+            reader.getNumUnresolved());
+    }
+    open_edi::util::message->info("Read parasitics of %lu nets.\n", reader.getNumNets());
+    return TCL_OK;
+}
+
 } // namespace db
 } // namespace open_edi
 
@@ -21,6 +21,8 @@ namespace db {
 
 int readSpefCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]);
 int writeSpefCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]);
+int readParasiticsCacheCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]);
+int writeParasiticsCacheCommand(ClientData cld, Tcl_Interp *itp, int argc, const char *argv[]);
 
 }  // namespace db
 }  // namespace open_edi
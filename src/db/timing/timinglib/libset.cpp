@@ -12,14 +12,25 @@
 #include "db/timing/timinglib/libset.h"
 
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "db/core/db.h"
+#include "db/timing/timinglib/timinglib_cell.h"
 #include "db/timing/timinglib/timinglib_lib.h"
+#include "db/timing/timinglib/timinglib_tablestorage.h"
 #include "util/stream.h"
 
 namespace open_edi {
 namespace db {
 
+/// Table storages by LibSet id. They hold hash maps on the heap, so they
+/// are kept out of the pool the libsets are written and read back with.
+static std::mutex kTableStoragesMutex;
+static std::unordered_map<ObjectId, std::unique_ptr<TableStorage>>
+    kTableStorages;
+
 LibSet::LibSet()
     : LibSet::BaseType(),
       name_(0),
@@ -28,7 +39,16 @@ LibSet::LibSet()
     setObjectType(ObjectType::kObjectTypeLibSet);
 }
 
-LibSet::~LibSet() { timing_libs_map_.clear(); }
+LibSet::~LibSet() {
+    timing_libs_map_.clear();
+    std::unique_ptr<TableStorage> old;
+    std::lock_guard<std::mutex> lock(kTableStoragesMutex);
+    auto found = kTableStorages.find(getId());
+    if (found != kTableStorages.end()) {
+        old = std::move(found->second);
+        kTableStorages.erase(found);
+    }
+}
 
 LibSet::LibSet(Object* owner, LibSet::IndexType id)
     : LibSet::BaseType(owner, id),
@@ -124,6 +144,46 @@ std::vector<TLib*> LibSet::getTimingLibs(void) {
     return libs;
 }
 
+TLib* LibSet::getTLib(const std::string& filename) const {
+    Timing* timing_lib = getTimingLib();
+    if (timing_lib == nullptr) return nullptr;
+    SymbolIndex idx = timing_lib->isSymbolInTable(filename);
+    if (idx == kInvalidSymbolIndex) return nullptr;
+    auto iter = timing_libs_map_.find(idx);
+    if (iter == timing_libs_map_.end()) return nullptr;
+    return Object::addr<TLib>(iter->second);
+}
+
+/// @brief the name is resolved once, then probed in each tlib.
+TCell* LibSet::getTimingCell(const std::string& name) const {
+    if (timing_libs_ == UNINIT_OBJECT_ID) return nullptr;
+    Timing* timing_lib = getTimingLib();
+    if (timing_lib == nullptr) return nullptr;
+    SymbolIndex idx = timing_lib->isSymbolInTable(name);
+    if (idx == kInvalidSymbolIndex) return nullptr;
+    auto p = Object::addr<ArrayObject<ObjectId>>(timing_libs_);
+    if (p == nullptr) return nullptr;
+    for (auto iter = p->begin(); iter != p->end(); ++iter) {
+        TLib* lib = Object::addr<TLib>(*iter);
+        TCell* cell = lib ? lib->getTimingCell(idx) : nullptr;
+        if (cell) return cell;
+    }
+    return nullptr;
+}
+
+TableStorage* LibSet::getTableStorage(void) {
+    std::lock_guard<std::mutex> lock(kTableStoragesMutex);
+    std::unique_ptr<TableStorage>& storage = kTableStorages[getId()];
+    if (storage == nullptr) storage.reset(new TableStorage);
+    return storage.get();
+}
+
+void LibSet::resetTableStorages() {
+    std::unordered_map<ObjectId, std::unique_ptr<TableStorage>> old;
+    std::lock_guard<std::mutex> lock(kTableStoragesMutex);
+    old.swap(kTableStorages);
+}
+
 void LibSet::print(std::ostream& stream) {
     for (auto v : timing_libs_map_) {
         TLib* lib = Object::addr<TLib>(v.second);
@@ -24,6 +24,8 @@
 namespace open_edi {
 namespace db {
 
+class TableStorage;
+class TCell;
 class TLib;
 class LibSet : public Object {
   public:
@@ -66,6 +68,17 @@ class LibSet : public Object {
     SymbolIndex getNameIndex(void);
     std::string getName(void) const;
     std::vector<TLib *> getTimingLibs(void);
+    /// @brief tlib read from filename, nullptr if none
+    TLib *getTLib(const std::string &filename) const;
+    /// @brief cell of the first tlib, in reading order, that has it
+    TCell *getTimingCell(const std::string &name) const;
+    /// @brief shared axes and values of the timing tables of the libset,
+    /// created on first use. Runtime only: libsets restored by read_design
+    /// start with an empty one.
+    TableStorage *getTableStorage(void);
+    /// @brief delete the table storages of all libsets, e.g. on a new
+    /// timing lib
+    static void resetTableStorages();
 
     /// @brief output the information
     void print(std::ostream &stream);
@@ -147,14 +147,14 @@ TTerm *TCell::getOrCreateTerm(const std::string &name) {
     if (timing_lib) {
         SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
         if (idx != kInvalidSymbolIndex) {
-            auto t = term_map_.find(idx);
-            if (t != term_map_.end()) {
-                return Object::addr<TTerm>(t->second);
+            ObjectId id = term_map_.find(idx);
+            if (id != 0) {
+                return Object::addr<TTerm>(id);
             } else {
                 auto term = __addTermImpl();
                 if (term) {
-                    setName(name);
-                    term_map_[getNameIndex()] = term->getId();
+                    term->setName(name);
+                    term_map_.insert(term->getNameIndex(), term->getId());
                 }
                 return term;
             }
@@ -165,20 +165,19 @@ TTerm *TCell::getOrCreateTerm(const std::string &name) {
 TTerm *TCell::getTerm(const std::string &name) {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
-        if (idx != kInvalidSymbolIndex) {
-            auto t = term_map_.find(idx);
-            if (t != term_map_.end()) {
-                return Object::addr<TTerm>(t->second);
-            }
-        }
+        ObjectId id = term_map_.find(timing_lib->isSymbolInTable(name));
+        if (id != 0) return Object::addr<TTerm>(id);
     }
     return nullptr;
 }
 std::vector<TTerm *> TCell::getTerms(void) {
     std::vector<TTerm *> terms;
-    for (auto p : term_map_) {
-        auto term = Object::addr<TTerm>(p.second);
+    if (tterms_ == UNINIT_OBJECT_ID) return terms;
+    auto p = Object::addr<ArrayObject<ObjectId>>(tterms_);
+    if (p == nullptr) return terms;
+    terms.reserve(p->getSize());
+    for (auto iter = p->begin(); iter != p->end(); ++iter) {
+        auto term = Object::addr<TTerm>(*iter);
         if (term != nullptr) terms.emplace_back(term);
     }
     return terms;
@@ -211,7 +210,8 @@ void TCell::resetTerms(const std::vector<TTerm *> &terms) {
                     auto &term = (*p)[i];
                     if (terms[i]) {
                         term = terms[i]->getId();
-                        term_map_[terms[i]->getNameIndex()] = terms[i]->getId();
+                        term_map_.insert(terms[i]->getNameIndex(),
+                                         terms[i]->getId());
                     }
                 }
 
@@ -220,7 +220,8 @@ void TCell::resetTerms(const std::vector<TTerm *> &terms) {
                     auto &term = (*p)[i];
                     if (terms[i]) {
                         term = terms[i]->getId();
-                        term_map_[terms[i]->getNameIndex()] = terms[i]->getId();
+                        term_map_.insert(terms[i]->getNameIndex(),
+                                         terms[i]->getId());
                     }
                 }
                 for (IndexType i = orig_size; i < cur_size; ++i) {
@@ -228,7 +229,7 @@ void TCell::resetTerms(const std::vector<TTerm *> &terms) {
                     if (term) {
                         ObjectId id = term->getId();
                         p->pushBack(id);
-                        term_map_[term->getNameIndex()] = id;
+                        term_map_.insert(term->getNameIndex(), id);
                     }
                 }
             }
@@ -240,14 +241,14 @@ TPgTerm *TCell::getOrCreatePgTerm(const std::string &name) {
     if (timing_lib) {
         SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
         if (idx != kInvalidSymbolIndex) {
-            auto t = pg_term_map_.find(idx);
-            if (t != pg_term_map_.end()) {
-                return Object::addr<TPgTerm>(t->second);
+            ObjectId id = pg_term_map_.find(idx);
+            if (id != 0) {
+                return Object::addr<TPgTerm>(id);
             } else {
                 auto term = __addPgTermImpl();
                 if (term) {
                     term->setName(name);
-                    pg_term_map_[term->getNameIndex()] = term->getId();
+                    pg_term_map_.insert(term->getNameIndex(), term->getId());
                 }
                 return term;
             }
@@ -258,20 +259,19 @@ TPgTerm *TCell::getOrCreatePgTerm(const std::string &name) {
 TPgTerm *TCell::getPgTerm(const std::string &name) {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
-        if (idx != kInvalidSymbolIndex) {
-            auto t = pg_term_map_.find(idx);
-            if (t != pg_term_map_.end()) {
-                return Object::addr<TPgTerm>(t->second);
-            }
-        }
+        ObjectId id = pg_term_map_.find(timing_lib->isSymbolInTable(name));
+        if (id != 0) return Object::addr<TPgTerm>(id);
     }
     return nullptr;
 }
 std::vector<TPgTerm *> TCell::getPgTerms(void) {
     std::vector<TPgTerm *> pg_terms;
-    for (auto p : pg_term_map_) {
-        auto term = Object::addr<TPgTerm>(p.second);
+    if (tpg_terms_ == UNINIT_OBJECT_ID) return pg_terms;
+    auto p = Object::addr<ArrayObject<ObjectId>>(tpg_terms_);
+    if (p == nullptr) return pg_terms;
+    pg_terms.reserve(p->getSize());
+    for (auto iter = p->begin(); iter != p->end(); ++iter) {
+        auto term = Object::addr<TPgTerm>(*iter);
         if (term != nullptr) pg_terms.emplace_back(term);
     }
     return pg_terms;
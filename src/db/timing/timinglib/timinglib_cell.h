@@ -22,6 +22,7 @@
 
 #include "db/core/object.h"
 #include "db/timing/timinglib/timinglib_commondef.h"
+#include "db/util/name_index.h"
 
 namespace open_edi {
 namespace db {
@@ -188,8 +189,9 @@ class TCell : public Object {
     float cell_leakage_power_;
     ObjectId tterms_;
     ObjectId tpg_terms_;
-    std::unordered_map<SymbolIndex, ObjectId> term_map_;
-    std::unordered_map<SymbolIndex, ObjectId> pg_term_map_;
+    /// terms by name
+    NameIndex term_map_;
+    NameIndex pg_term_map_;
 };
 
 }  // namespace db
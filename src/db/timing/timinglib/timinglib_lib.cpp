@@ -271,7 +271,9 @@ TCell *TLib::addTimingCell(const std::string &name) {
     if (timing_lib) {
         SymbolIndex index = timing_lib->getOrCreateSymbol(name.c_str());
         if (index != kInvalidSymbolIndex) {
-            timing_cells_map_[index] = cell->getId();
+            // a later cell of the same name replaces the earlier one.
+            timing_cells_map_.erase(index);
+            timing_cells_map_.insert(index, cell->getId());
             timing_lib->addSymbolReference(index, cell->getId());
         }
     }
@@ -510,7 +512,7 @@ float TLib::getDefaultCellLeakagePower(void) {
 float TLib::getSupplyVoltage(const std::string &name) {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex index = timing_lib->getOrCreateSymbol(name.c_str());
+        SymbolIndex index = timing_lib->isSymbolInTable(name);
         if (index != kInvalidSymbolIndex) {
             auto it = supply_voltage_map_.find(index);
             if (it != supply_voltage_map_.end()) return it->second;
@@ -553,7 +555,7 @@ OperatingConditions *TLib::getOperatingConditions(
     const std::string &name) const {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
+        SymbolIndex idx = timing_lib->isSymbolInTable(name);
         if (idx != kInvalidSymbolIndex) {
             auto it = operating_conditions_map_.find(idx);
             if (it != operating_conditions_map_.end())
@@ -565,7 +567,7 @@ OperatingConditions *TLib::getOperatingConditions(
 WireLoad *TLib::getWireLoad(const std::string &name) const {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
+        SymbolIndex idx = timing_lib->isSymbolInTable(name);
         if (idx != kInvalidSymbolIndex) {
             auto it = wire_loads_map_.find(idx);
             if (it != wire_loads_map_.end()) return addr<WireLoad>(it->second);
@@ -576,7 +578,7 @@ WireLoad *TLib::getWireLoad(const std::string &name) const {
 WireLoadTable *TLib::getWireLoadTable(const std::string &name) {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
+        SymbolIndex idx = timing_lib->isSymbolInTable(name);
         if (idx != kInvalidSymbolIndex) {
             auto it = wire_load_tables_map_.find(idx);
             if (it != wire_load_tables_map_.end())
@@ -588,7 +590,7 @@ WireLoadTable *TLib::getWireLoadTable(const std::string &name) {
 WireLoadSelection *TLib::getWireLoadSelection(const std::string &name) const {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
+        SymbolIndex idx = timing_lib->isSymbolInTable(name);
         if (idx != kInvalidSymbolIndex) {
             auto it = wire_load_selections_map_.find(idx);
             if (it != wire_load_selections_map_.end())
@@ -600,7 +602,7 @@ WireLoadSelection *TLib::getWireLoadSelection(const std::string &name) const {
 TableTemplate *TLib::getTableTemplate(const std::string &name) {
     Timing *timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
+        SymbolIndex idx = timing_lib->isSymbolInTable(name);
         if (idx != kInvalidSymbolIndex) {
             auto it = table_templates_map_.find(idx);
             if (it != table_templates_map_.end())
@@ -611,19 +613,22 @@ TableTemplate *TLib::getTableTemplate(const std::string &name) {
 }
 TCell *TLib::getTimingCell(const std::string &name) {
     Timing *timing_lib = getTimingLib();
-    if (timing_lib) {
-        SymbolIndex idx = timing_lib->getOrCreateSymbol(name.c_str());
-        if (idx != kInvalidSymbolIndex) {
-            auto it = timing_cells_map_.find(idx);
-            if (it != timing_cells_map_.end()) return addr<TCell>(it->second);
-        }
-    }
+    if (timing_lib) return getTimingCell(timing_lib->isSymbolInTable(name));
+    return nullptr;
+}
+TCell *TLib::getTimingCell(SymbolIndex name) const {
+    ObjectId id = timing_cells_map_.find(name);
+    if (id != 0) return addr<TCell>(id);
     return nullptr;
 }
 std::vector<TCell *> TLib::getTimingCells(void) {
     std::vector<TCell *> cells;
-    for (auto p : timing_cells_map_) {
-        auto cell = addr<TCell>(p.second);
+    if (timing_cells_ == UNINIT_OBJECT_ID) return cells;
+    auto p = addr<ArrayObject<ObjectId>>(timing_cells_);
+    if (p == nullptr) return cells;
+    cells.reserve(p->getSize());
+    for (auto iter = p->begin(); iter != p->end(); ++iter) {
+        auto cell = addr<TCell>(*iter);
         if (cell != nullptr) cells.emplace_back(cell);
     }
     return cells;
@@ -20,6 +20,7 @@
 #include "db/core/object.h"
 #include "db/timing/timinglib/timinglib_commondef.h"
 #include "db/util/array.h"
+#include "db/util/name_index.h"
 
 namespace open_edi {
 namespace db {
@@ -151,6 +152,9 @@ class TLib : public Object {
     WireLoadSelection *getWireLoadSelection(const std::string &name) const;
     TableTemplate *getTableTemplate(const std::string &name);
     TCell *getTimingCell(const std::string &name);
+    /// @brief cell by the symbol index of its name, for callers looking
+    /// up the same name in several libraries.
+    TCell *getTimingCell(SymbolIndex name) const;
     std::vector<TCell *> getTimingCells(void);
 
     /// @brief summarize memory usage of the object in bytes
@@ -220,7 +224,8 @@ class TLib : public Object {
     std::unordered_map<SymbolIndex, ObjectId> wire_load_tables_map_;
     std::unordered_map<SymbolIndex, ObjectId> wire_load_selections_map_;
     std::unordered_map<SymbolIndex, ObjectId> table_templates_map_;
-    std::unordered_map<SymbolIndex, ObjectId> timing_cells_map_;
+    /// cells by name, probed without hashing the name again
+    NameIndex timing_cells_map_;
 };
 
 }  // namespace db
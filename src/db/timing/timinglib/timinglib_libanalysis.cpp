@@ -26,6 +26,7 @@
 #include "db/timing/timinglib/attr_enum.h"
 #include "db/timing/timinglib/group_enum.h"
 #include "db/timing/timinglib/timinglib_libbuilder.h"
+#include "db/timing/timinglib/timinglib_libstaging.h"
 #include "db/timing/timinglib/timinglib_libhash.h"
 #include "db/timing/timinglib/timinglib_si2dr.h"
 #include "timinglib_libparser.tab.hh"
@@ -57,6 +58,7 @@ LibAnalysis::LibAnalysis(LibBuilder *libbuilder) {
 LibAnalysis::~LibAnalysis() {
     si2drErrorT err;
     si2drPIQuit(&err);
+    __destroyTokenStrings();
     delete (sd_);
     sd_ = nullptr;
     delete strtab_;
@@ -306,9 +308,54 @@ int LibAnalysis::injectedToken(void *val) {
 void LibAnalysis::setTok(void) {
     if (sd_->token_comment_buf[0]) sd_->tok_encountered++;
 }
+/// token strings go to the master string table, which lives as long as
+/// the parse tree. In stream mode nothing keeps them after the builder
+/// callbacks, so they go to a table dropped after the next top level group.
+char *LibAnalysis::enterTokenString(char *str) {
+    if (!stream_mode_)
+        return strtab_->timinglibStrtableEnterString(sd_->master_string_table,
+                                                     str);
+    if (token_strings_[0] == nullptr)
+        token_strings_[0] =
+            strtab_->timinglibStrtableCreateStrtable(4099, 1024 * 1024, 0);
+    return strtab_->timinglibStrtableEnterString(token_strings_[0], str);
+}
+/// the parser reads at most one token ahead, so strings of the previous
+/// generation are no longer referenced when a top level group ends.
+void LibAnalysis::__recycleTokenStrings(void) {
+    if (token_strings_[1] != nullptr)
+        strtab_->timinglibStrtableDestroyStrtable(token_strings_[1]);
+    token_strings_[1] = token_strings_[0];
+    token_strings_[0] = nullptr;
+}
+void LibAnalysis::__destroyTokenStrings(void) {
+    for (auto &table : token_strings_) {
+        if (table != nullptr && strtab_ != nullptr)
+            strtab_->timinglibStrtableDestroyStrtable(table);
+        table = nullptr;
+    }
+}
+void LibAnalysis::clearComments(void) {
+    sd_->token_comment_buf[0] = 0;
+    sd_->token_comment_buf2[0] = 0;
+    sd_->tok_encountered = 0;
+}
 void LibAnalysis::pushGroup(Timinglib::timinglib_head *h) {
     Timinglib::timinglib_attribute_value *v, *vn;
     si2drErrorT err;
+    if (stream_mode_) {
+        clearComments();
+        sd_->gs[sd_->gsindex++] = nulloid_;
+        if (staging_)
+            staging_->beginGroup(h);
+        else if (libbuilder_)
+            libbuilder_->beginGroup(h);
+        for (v = h->list; v; v = vn) {
+            vn = v->next;
+            free(v);
+        }
+        return;
+    }
     si2drMessageHandlerT MsgPrinter;
     Timinglib::group_enum ge;
     size_t pb_size = 8000;
@@ -419,10 +466,27 @@ void LibAnalysis::pushGroup(Timinglib::timinglib_head *h) {
 void LibAnalysis::popGroup(timinglib_head *h) {
     sd_->gsindex--;
     free(h);
-    if (libbuilder_) libbuilder_->endGroup();
+    if (staging_)
+        staging_->endGroup();
+    else if (libbuilder_)
+        libbuilder_->endGroup();
+    if (stream_mode_ && sd_->gsindex == 1) __recycleTokenStrings();
 }
 void LibAnalysis::makeComplex(timinglib_head *h) {
     Timinglib::timinglib_attribute_value *v, *vn;
+    if (stream_mode_) {
+        clearComments();
+        if (staging_)
+            staging_->buildAttribute(h->name, h->list);
+        else if (libbuilder_)
+            libbuilder_->buildAttribute(h->name, h->list);
+        for (v = h->list; v; v = vn) {
+            vn = v->next;
+            free(v);
+        }
+        free(h);
+        return;
+    }
     sd_->curr_attr = __si2drGroupCreateAttr(sd_->gs[sd_->gsindex - 1], h->name,
                                             kSI2DR_COMPLEX, &sd_->err);
     if (sd_->token_comment_buf[0]) {
@@ -455,6 +519,19 @@ void LibAnalysis::makeComplex(timinglib_head *h) {
     free(h);
 }
 void LibAnalysis::makeSimple(char *name, timinglib_attribute_value *v) {
+    if (stream_mode_) {
+        clearComments();
+        sd_->curr_attr = nulloid_;
+        if (staging_)
+            staging_->buildAttribute(name, v);
+        else if (libbuilder_)
+            libbuilder_->buildAttribute(name, v);
+        if (v->type == kTIMINGLIB__VAL_EXPR)
+            si2drExprDestroy(static_cast<si2drExprT *>(v->u.expr_val),
+                             &sd_->err);
+        free(v);
+        return;
+    }
     sd_->curr_attr = __si2drGroupCreateAttr(sd_->gs[sd_->gsindex - 1], name,
                                             kSI2DR_SIMPLE, &sd_->err);
     if (sd_->token_comment_buf[0]) {
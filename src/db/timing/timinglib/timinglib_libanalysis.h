@@ -39,6 +39,7 @@
 namespace Timinglib {
 
 class LibBuilder;
+class LibStaging;
 class LibAnalysis;
 typedef si2drVoidT (LibAnalysis::*si2drMessageHandlerT)(si2drSeverityT sev,
                                                         si2drErrorT errToPrint,
@@ -170,6 +171,14 @@ class LibAnalysis {
                                              void *constraint_ptr);
     bool isLibertySyntaxValid();
     bool dumpLibFile(const char *const filename, bool clearFileContent = true);
+    /// @brief stream mode: groups and attributes go to the LibBuilder only,
+    /// no si2dr tree is built
+    void setStreamMode(bool streamMode) { stream_mode_ = streamMode; }
+    bool isStreamMode() const { return stream_mode_; }
+    /// @brief stream mode only: record into staging instead of the LibBuilder
+    void setStaging(LibStaging *staging) { staging_ = staging; }
+    char *enterTokenString(char *str);
+    void clearComments(void);
 
     void cleanFileName(char *dirty, char *clean);
     si2drValueTypeT convertVt(char *type);
@@ -497,7 +506,15 @@ class LibAnalysis {
     scandata *sd_ = nullptr;
     LibStrtab *strtab_ = nullptr;
     LibBuilder *libbuilder_ = nullptr;
+    LibStaging *staging_ = nullptr;
     std::string *parseLogStr_ = nullptr;
+
+    /* stream mode: token strings of the current and previous top level
+       groups, the older one is dropped when a top level group ends */
+    void __recycleTokenStrings(void);
+    void __destroyTokenStrings(void);
+    bool stream_mode_ = false;
+    timinglib_strtable *token_strings_[2] = {nullptr, nullptr};
 };
 }  // namespace Timinglib
 
@@ -24,6 +24,7 @@
 #include "db/timing/timinglib/timinglib_opcond.h"
 #include "db/timing/timinglib/timinglib_pgterm.h"
 #include "db/timing/timinglib/timinglib_scalefactors.h"
+#include "db/timing/timinglib/timinglib_tablestorage.h"
 #include "db/timing/timinglib/timinglib_tabletemplate.h"
 #include "db/timing/timinglib/timinglib_term.h"
 #include "db/timing/timinglib/timinglib_timingarc.h"
@@ -825,7 +826,6 @@ void LibBuilder::__buildTiming(timinglib_head *h) {
     }
 }
 void LibBuilder::__buildCellRise(timinglib_head *h) {
-    tb_namespace::Timing *timing_lib = tb_namespace::getTimingLib();
     auto v = h->list;
     if (v && __isStringType(v)) {
         std::vector<tb_namespace::TimingArc *> timingarcs;
@@ -840,30 +840,11 @@ void LibBuilder::__buildCellRise(timinglib_head *h) {
         tb_namespace::TableTemplate *tt =
             lib->getTableTemplate(v->u.string_val);
         if (tt == nullptr) return;
-        auto axis1 = tt->getAxis1();
-        if (axis1) {
-            axis_[0] =
-                tb_namespace::Object::createObject<tb_namespace::TableAxis>(
-                    tb_namespace::ObjectType::kObjectTypeTableAxis,
-                    timing_lib->getId());
-            if (axis_[0]) *(axis_[0]) = *axis1;
-        }
-        auto axis2 = tt->getAxis2();
-        if (axis2) {
-            axis_[1] =
-                tb_namespace::Object::createObject<tb_namespace::TableAxis>(
-                    tb_namespace::ObjectType::kObjectTypeTableAxis,
-                    timing_lib->getId());
-            if (axis_[1]) *(axis_[1]) = *axis2;
-        }
-        auto axis3 = tt->getAxis3();
-        if (axis3) {
-            axis_[2] =
-                tb_namespace::Object::createObject<tb_namespace::TableAxis>(
-                    tb_namespace::ObjectType::kObjectTypeTableAxis,
-                    timing_lib->getId());
-            if (axis_[2]) *(axis_[2]) = *axis3;
-        }
+        // tables refer to the shared axes, they are never changed.
+        tb_namespace::TableStorage *storage = libset_->getTableStorage();
+        axis_[0] = storage->getAxis(tt->getAxis1());
+        axis_[1] = storage->getAxis(tt->getAxis2());
+        axis_[2] = storage->getAxis(tt->getAxis3());
     }
 }
 void LibBuilder::__buildCellFall(timinglib_head *h) { __buildCellRise(h); }
@@ -2865,6 +2846,8 @@ void LibBuilder::__buildValues(buildParam) {
         }
     }
     if (values.empty()) return;
+    tb_namespace::TableStorage *storage = libset_->getTableStorage();
+    std::vector<float> floats(values.begin(), values.end());
 
     GOBJECTS
     for (auto &p : objects) {
@@ -2879,13 +2862,11 @@ void LibBuilder::__buildValues(buildParam) {
                     tb_namespace::ObjectType::kObjectTypeTimingTable3,
                     timing_lib->getId());
                 if (p) {
-                    axis_[0]->setOwner(p);
                     p->setAxis1(axis_[0]->getId());
-                    axis_[1]->setOwner(p);
                     p->setAxis2(axis_[1]->getId());
-                    axis_[2]->setOwner(p);
                     p->setAxis3(axis_[2]->getId());
-                    for (auto &v : values) p->addValue(v);
+                    p->setSharedValues(storage->getValues(floats));
+                    p->pack(storage);
                     tt = p;
                 }
             } else if (axis_[0] && axis_[1]) {
@@ -2894,11 +2875,10 @@ void LibBuilder::__buildValues(buildParam) {
                     tb_namespace::ObjectType::kObjectTypeTimingTable2,
                     timing_lib->getId());
                 if (p) {
-                    axis_[0]->setOwner(p);
                     p->setAxis1(axis_[0]->getId());
-                    axis_[1]->setOwner(p);
                     p->setAxis2(axis_[1]->getId());
-                    for (auto &v : values) p->addValue(v);
+                    p->setSharedValues(storage->getValues(floats));
+                    p->pack(storage);
                     tt = p;
                 }
             } else if (axis_[0]) {
@@ -2907,9 +2887,9 @@ void LibBuilder::__buildValues(buildParam) {
                     tb_namespace::ObjectType::kObjectTypeTimingTable1,
                     timing_lib->getId());
                 if (p) {
-                    axis_[0]->setOwner(p);
                     p->setAxis1(axis_[0]->getId());
-                    for (auto &v : values) p->addValue(v);
+                    p->setSharedValues(storage->getValues(floats));
+                    p->pack(storage);
                     tt = p;
                 }
             } else {
@@ -2917,7 +2897,10 @@ void LibBuilder::__buildValues(buildParam) {
                     tb_namespace::TimingTable0>(
                     tb_namespace::ObjectType::kObjectTypeTimingTable0,
                     timing_lib->getId());
-                if (p) p->setValue(values[0]);
+                if (p) {
+                    p->setValue(values[0]);
+                    p->pack(storage);
+                }
                 tt = p;
             }
             if (tt) {
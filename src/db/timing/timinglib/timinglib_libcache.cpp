@@ -0,0 +1,161 @@
+/**
+ * @file timinglib_libcache.cpp
+ * @date 2020-09-01
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#include "db/timing/timinglib/timinglib_libcache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "db/timing/timinglib/timinglib_libstaging.h"
+#include "util/util_mem.h"
+#include "util/version.h"
+
+namespace Timinglib {
+
+static const char kLibCacheMagic[8] = {'E', 'D', 'I', 'T', 'L', 'I', 'B', 'C'};
+static const uint32_t kLibCacheFormat = 2;
+
+/// header of a cache file, followed by the tool version string and the
+/// LibStaging data.
+struct LibCacheHeader {
+    char magic[8];
+    uint32_t format;
+    uint32_t version_size;
+    uint64_t hash;
+    uint64_t lib_size;
+    uint64_t data_size;
+    uint64_t data_hash;
+};
+
+/// @brief hashBytes 64 bit FNV-1a of size bytes at data
+static uint64_t hashBytes(const char *data, uint64_t size) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    uint64_t h = 14695981039346656037ULL;
+    for (uint64_t i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static std::string getToolVersion() {
+    open_edi::util::Version version;
+    version.init();
+    return version.getVersionString();
+}
+
+LibCache::LibCache(const std::string &dir) : dir_(dir) {
+    while (dir_.size() > 1 && dir_.back() == '/') dir_.pop_back();
+}
+
+/// @brief getKey hash and size of the content of libFile
+bool LibCache::getKey(const std::string &libFile, Key *key) const {
+    open_edi::util::MemMappedFile file;
+    if (!file.map(libFile.c_str())) return false;
+    key->hash = hashBytes(file.getAddr(), file.getSize());
+    key->size = file.getSize();
+    return true;
+}
+
+std::string LibCache::__getCacheFile(const std::string &libFile,
+                                     uint64_t hash) const {
+    std::string base = libFile;
+    size_t slash = base.find_last_of('/');
+    if (slash != std::string::npos) base = base.substr(slash + 1);
+    char key[32];
+    snprintf(key, sizeof(key), ".%016llx.tlibc",
+             static_cast<unsigned long long>(hash));
+    return dir_ + "/" + base + key;
+}
+
+/// @brief load the staged content of libFile, false if not cached or if
+/// the cache file is damaged
+bool LibCache::load(const std::string &libFile, const Key &key,
+                    LibStaging *staging) const {
+    if (staging == nullptr) return false;
+    std::string cacheFile = __getCacheFile(libFile, key.hash);
+    if (access(cacheFile.c_str(), R_OK) != 0) return false;
+
+    open_edi::util::MemMappedFile file;
+    if (!file.map(cacheFile.c_str())) return false;
+    const char *data = file.getAddr();
+    uint64_t size = file.getSize();
+    std::string toolVersion = getToolVersion();
+    LibCacheHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, kLibCacheMagic, sizeof(kLibCacheMagic)) != 0 ||
+        header.format != kLibCacheFormat || header.hash != key.hash ||
+        header.lib_size != key.size ||
+        header.version_size != toolVersion.size() ||
+        sizeof(header) + header.version_size + header.data_size != size ||
+        memcmp(data + sizeof(header), toolVersion.data(),
+               toolVersion.size()) != 0)
+        return false;
+    const char *stagingData = data + sizeof(header) + header.version_size;
+    if (hashBytes(stagingData, header.data_size) != header.data_hash)
+        return false;
+
+    if (!staging->read(stagingData, header.data_size, libFile)) {
+        staging->clear();
+        return false;
+    }
+    return true;
+}
+
+/// @brief save staging as the cache of libFile
+///
+/// The file is written under a temporary name then renamed, so that
+/// concurrent runs only ever see complete cache files.
+bool LibCache::save(const std::string &libFile, const Key &key,
+                    const LibStaging &staging) const {
+    if (!staging.isSingleFile()) return false;
+    // staged in memory first, the header holds its size and hash.
+    char *data = nullptr;
+    size_t dataSize = 0;
+    FILE *mem = open_memstream(&data, &dataSize);
+    if (mem == nullptr) return false;
+    bool ok = staging.write(mem);
+    if (fclose(mem) != 0) ok = false;
+    std::unique_ptr<char, decltype(&free)> dataOwner(data, &free);
+    if (!ok) return false;
+
+    std::string cacheFile = __getCacheFile(libFile, key.hash);
+    std::string tmpFile = cacheFile + "." + std::to_string(getpid()) + ".tmp";
+    FILE *fp = fopen(tmpFile.c_str(), "wb");
+    if (fp == nullptr) return false;
+
+    std::string toolVersion = getToolVersion();
+    LibCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kLibCacheMagic, sizeof(kLibCacheMagic));
+    header.format = kLibCacheFormat;
+    header.version_size = toolVersion.size();
+    header.hash = key.hash;
+    header.lib_size = key.size;
+    header.data_size = dataSize;
+    header.data_hash = hashBytes(data, dataSize);
+    ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+         fwrite(toolVersion.data(), toolVersion.size(), 1, fp) == 1 &&
+         (dataSize == 0 || fwrite(data, dataSize, 1, fp) == 1);
+    if (fclose(fp) != 0) ok = false;
+    if (ok) ok = rename(tmpFile.c_str(), cacheFile.c_str()) == 0;
+    if (!ok) unlink(tmpFile.c_str());
+    return ok;
+}
+
+}  // namespace Timinglib
@@ -0,0 +1,63 @@
+/**
+ * @file timinglib_libcache.h
+ * @date 2020-09-01
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#ifndef SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_LIBCACHE_H_
+#define SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_LIBCACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace Timinglib {
+
+class LibStaging;
+
+/// @brief Directory of precompiled liberty files.
+///
+/// A liberty file is precompiled into the LibStaging it parses to, so
+/// reading it again only replays the staged groups and attributes into a
+/// LibBuilder. Cache files are named after the liberty file and a hash of
+/// its content, and are used only if the content, the tool version and the
+/// cache format all match and the cached data still has the hash it was
+/// saved with; a liberty file that is modified, moved or copied keeps
+/// using its cache as long as its content is the same.
+/// Files with include_file are not cached.
+///
+/// A liberty file is hashed once by getKey(), the key is then given to
+/// load() and, on a miss, to save().
+class LibCache {
+  public:
+    /// @brief content of a liberty file, as its hash and size
+    struct Key {
+        uint64_t hash;
+        uint64_t size;
+    };
+
+    explicit LibCache(const std::string &dir);
+
+    bool getKey(const std::string &libFile, Key *key) const;
+    bool load(const std::string &libFile, const Key &key,
+              LibStaging *staging) const;
+    bool save(const std::string &libFile, const Key &key,
+              const LibStaging &staging) const;
+
+  private:
+    std::string __getCacheFile(const std::string &libFile,
+                               uint64_t hash) const;
+
+    std::string dir_;
+};
+
+}  // namespace Timinglib
+
+#endif  // SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_LIBCACHE_H_
@@ -111,7 +111,7 @@ statement 	: simple_attr {}
 
 simple_attr	: IDENT COLON attr_val_expr { libAnalysis.makeSimple($1,$3);} SEMI
 			| IDENT COLON attr_val_expr { libAnalysis.makeSimple($1,$3);}
-            | IDENT EQ    attr_val_expr { libAnalysis.makeSimple($1,$3);libAnalysis.si2drSimpleAttrSetIsVar(SD->curr_attr,&SD->err); } SEMI
+            | IDENT EQ    attr_val_expr { libAnalysis.makeSimple($1,$3);if (!libAnalysis.isStreamMode()) libAnalysis.si2drSimpleAttrSetIsVar(SD->curr_attr,&SD->err); } SEMI
 			;
 
 complex_attr 	: head  SEMI  {libAnalysis.makeComplex($1);}
@@ -153,20 +153,20 @@ param_list  : attr_val {$$=$1;}
 			;
 
 define 	: KW_DEFINE LPAR s_or_i COMMA s_or_i COMMA s_or_i RPAR SEMI  
-		{SD->curr_def = libAnalysis.si2drGroupCreateDefine(SD->gs[SD->gsindex-1],$3,$5,libAnalysis.convertVt($7),&SD->err);libAnalysis.si2drObjectSetLineNo(SD->curr_def,SD->lineno,&SD->err);libAnalysis.si2drObjectSetFileName(SD->curr_def,SD->curr_file,&SD->err);
+		{if (libAnalysis.isStreamMode()) { libAnalysis.clearComments(); } else {SD->curr_def = libAnalysis.si2drGroupCreateDefine(SD->gs[SD->gsindex-1],$3,$5,libAnalysis.convertVt($7),&SD->err);libAnalysis.si2drObjectSetLineNo(SD->curr_def,SD->lineno,&SD->err);libAnalysis.si2drObjectSetFileName(SD->curr_def,SD->curr_file,&SD->err);
 		if( SD->token_comment_buf[0] ) { libAnalysis.si2drDefineSetComment(SD->curr_def, SD->token_comment_buf,&SD->err); SD->token_comment_buf[0]=0;} 
 		if( SD->token_comment_buf2[0] )	{strcpy(SD->token_comment_buf, SD->token_comment_buf2);SD->token_comment_buf2[0] = 0;}
 		SD->tok_encountered = 0;
-		}
+		}}
 		;
 
 
 define_group : KW_DEFINE_GROUP LPAR s_or_i COMMA s_or_i RPAR SEMI
-            {SD->curr_def = libAnalysis.si2drGroupCreateDefine(SD->gs[SD->gsindex-1],$3,$5,Timinglib::kSI2DR_UNDEFINED_VALUETYPE,&SD->err);libAnalysis.si2drObjectSetLineNo(SD->curr_def,SD->lineno,&SD->err);libAnalysis.si2drObjectSetFileName(SD->curr_def,SD->curr_file,&SD->err);
+            {if (libAnalysis.isStreamMode()) { libAnalysis.clearComments(); } else {SD->curr_def = libAnalysis.si2drGroupCreateDefine(SD->gs[SD->gsindex-1],$3,$5,Timinglib::kSI2DR_UNDEFINED_VALUETYPE,&SD->err);libAnalysis.si2drObjectSetLineNo(SD->curr_def,SD->lineno,&SD->err);libAnalysis.si2drObjectSetFileName(SD->curr_def,SD->curr_file,&SD->err);
 			if( SD->token_comment_buf[0] ) { libAnalysis.si2drDefineSetComment(SD->curr_def, SD->token_comment_buf,&SD->err); SD->token_comment_buf[0]=0;} 
 			if( SD->token_comment_buf2[0] )	{strcpy(SD->token_comment_buf, SD->token_comment_buf2);SD->token_comment_buf2[0] = 0;}
 			SD->tok_encountered = 0;
-			}
+			}}
 		;
 
 s_or_i  : STRING {$$ = $1;}
@@ -200,7 +200,7 @@ attr_val : NUM { $$= (Timinglib::timinglib_attribute_value*)calloc(sizeof(Timing
 				   $$->type = Timinglib::kTIMINGLIB__VAL_STRING;
 				   x = (char*)alloca(strlen($1) + strlen($3) + 2); /* get a scratchpad */
 				   sprintf(x, "%s:%s", $1,$3);
-				   $$->u.string_val = STRTAB->timinglibStrtableEnterString(SD->master_string_table, x); /* scratchpad goes away after this */
+				   $$->u.string_val = libAnalysis.enterTokenString(x); /* scratchpad goes away after this */
 			   }
          | KW_TRUE
                {
@@ -0,0 +1,302 @@
+/**
+ * @file timinglib_libstaging.cpp
+ * @date 2020-09-01
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#include "db/timing/timinglib/timinglib_libstaging.h"
+
+#include <string.h>
+
+#include "db/timing/timinglib/timinglib_libbuilder.h"
+
+namespace Timinglib {
+
+static const size_t kStagingBlockSize = 256 * 1024;
+
+LibStaging::LibStaging()
+    : events_(),
+      values_(),
+      blocks_(),
+      block_(nullptr),
+      block_used_(0),
+      last_filename_(nullptr),
+      last_filename_copy_(nullptr),
+      num_filenames_(0) {}
+
+LibStaging::~LibStaging() { clear(); }
+
+void LibStaging::beginGroup(timinglib_head *h) {
+    Event event;
+    event.type = kBeginGroup;
+    event.lineno = h->lineno;
+    event.name = __copyString(h->name);
+    if (h->filename != last_filename_ || last_filename_copy_ == nullptr) {
+        if (last_filename_copy_ == nullptr ||
+            strcmp(last_filename_copy_, h->filename) != 0)
+            ++num_filenames_;
+        last_filename_ = h->filename;
+        last_filename_copy_ = __copyString(h->filename);
+    }
+    event.filename = last_filename_copy_;
+    __addValues(&event, h->list);
+    events_.push_back(event);
+}
+
+void LibStaging::endGroup() {
+    Event event;
+    event.type = kEndGroup;
+    event.lineno = 0;
+    event.name = nullptr;
+    event.filename = nullptr;
+    event.first_value = 0;
+    event.num_values = 0;
+    events_.push_back(event);
+}
+
+void LibStaging::buildAttribute(const std::string &name,
+                                timinglib_attribute_value *v) {
+    Event event;
+    event.type = kAttribute;
+    event.lineno = 0;
+    event.name = __copyString(name.c_str());
+    event.filename = nullptr;
+    __addValues(&event, v);
+    events_.push_back(event);
+}
+
+/// @brief replay the recorded calls to builder, in the order they came
+void LibStaging::replay(LibBuilder *builder) {
+    if (builder == nullptr) return;
+    // values are only linked now, the vector may have moved while recording.
+    for (auto &event : events_) {
+        timinglib_attribute_value *list = nullptr;
+        if (event.num_values > 0) {
+            list = &values_[event.first_value];
+            for (uint32_t i = 0; i + 1 < event.num_values; ++i)
+                list[i].next = &list[i + 1];
+            list[event.num_values - 1].next = nullptr;
+        }
+        if (event.type == kBeginGroup) {
+            timinglib_head h;
+            h.name = event.name;
+            h.lineno = event.lineno;
+            h.filename = event.filename;
+            h.list = list;
+            builder->beginGroup(&h);
+        } else if (event.type == kEndGroup) {
+            builder->endGroup();
+        } else {
+            builder->buildAttribute(event.name, list);
+        }
+    }
+}
+
+void LibStaging::clear() {
+    events_.clear();
+    events_.shrink_to_fit();
+    values_.clear();
+    values_.shrink_to_fit();
+    blocks_.clear();
+    block_ = nullptr;
+    block_used_ = 0;
+    last_filename_ = nullptr;
+    last_filename_copy_ = nullptr;
+    num_filenames_ = 0;
+}
+
+/// on disk: numbers of events and values and size of the strings, then
+/// the events, the values and the strings. Strings are referred to by
+/// their offset plus one, 0 being no string.
+struct StagingFileEvent {
+    uint32_t type;
+    int32_t lineno;
+    uint32_t name;
+    uint32_t first_value;
+    uint32_t num_values;
+};
+
+struct StagingFileValue {
+    uint32_t type;
+    uint32_t string;
+    union {
+        int64_t int_val;
+        double double_val;
+    } u;
+};
+
+bool LibStaging::write(FILE *fp) const {
+    std::vector<char> strings;
+    auto addString = [&strings](const char *str) -> uint32_t {
+        if (str == nullptr) return 0;
+        uint32_t offset = strings.size() + 1;
+        strings.insert(strings.end(), str, str + strlen(str) + 1);
+        return offset;
+    };
+
+    std::vector<StagingFileEvent> events(events_.size());
+    for (size_t i = 0; i < events_.size(); ++i) {
+        events[i].type = events_[i].type;
+        events[i].lineno = events_[i].lineno;
+        events[i].name = addString(events_[i].name);
+        events[i].first_value = events_[i].first_value;
+        events[i].num_values = events_[i].num_values;
+    }
+    std::vector<StagingFileValue> values(values_.size());
+    for (size_t i = 0; i < values_.size(); ++i) {
+        const timinglib_attribute_value &v = values_[i];
+        values[i].type = v.type;
+        values[i].string = 0;
+        values[i].u.int_val = 0;
+        if (v.type == kTIMINGLIB__VAL_STRING)
+            values[i].string = addString(v.u.string_val);
+        else if (v.type == kTIMINGLIB__VAL_DOUBLE)
+            values[i].u.double_val = v.u.double_val;
+        else if (v.type == kTIMINGLIB__VAL_BOOLEAN)
+            values[i].u.int_val = v.u.bool_val;
+        else if (v.type == kTIMINGLIB__VAL_INT)
+            values[i].u.int_val = v.u.int_val;
+    }
+    if (strings.size() >= UINT32_MAX) return false;
+
+    uint64_t counts[3] = {events.size(), values.size(), strings.size()};
+    if (fwrite(counts, sizeof(counts), 1, fp) != 1) return false;
+    if (!events.empty() &&
+        fwrite(events.data(), sizeof(StagingFileEvent), events.size(), fp) !=
+            events.size())
+        return false;
+    if (!values.empty() &&
+        fwrite(values.data(), sizeof(StagingFileValue), values.size(), fp) !=
+            values.size())
+        return false;
+    if (!strings.empty() &&
+        fwrite(strings.data(), 1, strings.size(), fp) != strings.size())
+        return false;
+    return true;
+}
+
+bool LibStaging::read(const char *data, uint64_t size,
+                      const std::string &filename) {
+    clear();
+    uint64_t counts[3];
+    if (size < sizeof(counts)) return false;
+    memcpy(counts, data, sizeof(counts));
+    uint64_t numEvents = counts[0], numValues = counts[1];
+    uint64_t stringsSize = counts[2];
+    if (numEvents > size / sizeof(StagingFileEvent) ||
+        numValues > size / sizeof(StagingFileValue) ||
+        stringsSize > size ||
+        sizeof(counts) + numEvents * sizeof(StagingFileEvent) +
+                numValues * sizeof(StagingFileValue) + stringsSize !=
+            size)
+        return false;
+    const char *eventData = data + sizeof(counts);
+    const char *valueData = eventData + numEvents * sizeof(StagingFileEvent);
+    const char *stringData = valueData + numValues * sizeof(StagingFileValue);
+    if (stringsSize > 0 && stringData[stringsSize - 1] != 0) return false;
+
+    // all strings in one block, they are all terminated.
+    char *strings = nullptr;
+    if (stringsSize > 0) {
+        blocks_.emplace_back(new char[stringsSize]);
+        strings = blocks_.back().get();
+        memcpy(strings, stringData, stringsSize);
+    }
+    auto getString = [strings, stringsSize](uint32_t offset,
+                                            char **str) -> bool {
+        *str = nullptr;
+        if (offset == 0) return true;
+        if (offset > stringsSize) return false;
+        *str = strings + offset - 1;
+        return true;
+    };
+
+    char *filenameCopy = __copyString(filename.c_str());
+    num_filenames_ = 1;
+    events_.resize(numEvents);
+    for (uint64_t i = 0; i < numEvents; ++i) {
+        StagingFileEvent e;
+        memcpy(&e, eventData + i * sizeof(e), sizeof(e));
+        Event &event = events_[i];
+        if (e.type > kAttribute ||
+            static_cast<uint64_t>(e.first_value) + e.num_values > numValues ||
+            !getString(e.name, &event.name))
+            return false;
+        event.type = static_cast<EventType>(e.type);
+        event.lineno = e.lineno;
+        event.filename = event.type == kBeginGroup ? filenameCopy : nullptr;
+        event.first_value = e.first_value;
+        event.num_values = e.num_values;
+        if (event.type != kEndGroup && event.name == nullptr) return false;
+    }
+    values_.resize(numValues);
+    for (uint64_t i = 0; i < numValues; ++i) {
+        StagingFileValue v;
+        memcpy(&v, valueData + i * sizeof(v), sizeof(v));
+        timinglib_attribute_value &value = values_[i];
+        value.type = static_cast<timinglib_attribute_value_type>(v.type);
+        value.next = nullptr;
+        if (v.type == kTIMINGLIB__VAL_STRING) {
+            if (!getString(v.string, &value.u.string_val) ||
+                value.u.string_val == nullptr)
+                return false;
+        } else if (v.type == kTIMINGLIB__VAL_DOUBLE) {
+            value.u.double_val = v.u.double_val;
+        } else if (v.type == kTIMINGLIB__VAL_BOOLEAN) {
+            value.u.bool_val = v.u.int_val;
+        } else if (v.type == kTIMINGLIB__VAL_INT) {
+            value.u.int_val = v.u.int_val;
+        } else if (v.type == kTIMINGLIB__VAL_EXPR ||
+                   v.type == kTIMINGLIB__VAL_UNDEFINED) {
+            value.u.expr_val = nullptr;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+char *LibStaging::__copyString(const char *str) {
+    if (str == nullptr) return nullptr;
+    size_t size = strlen(str) + 1;
+    char *copy = nullptr;
+    if (size > kStagingBlockSize / 4) {
+        // big strings (values tables) get a block of their own.
+        blocks_.emplace_back(new char[size]);
+        copy = blocks_.back().get();
+    } else {
+        if (block_ == nullptr || block_used_ + size > kStagingBlockSize) {
+            blocks_.emplace_back(new char[kStagingBlockSize]);
+            block_ = blocks_.back().get();
+            block_used_ = 0;
+        }
+        copy = block_ + block_used_;
+        block_used_ += size;
+    }
+    memcpy(copy, str, size);
+    return copy;
+}
+
+void LibStaging::__addValues(Event *event, timinglib_attribute_value *v) {
+    event->first_value = values_.size();
+    event->num_values = 0;
+    for (; v; v = v->next) {
+        timinglib_attribute_value value = *v;
+        if (value.type == kTIMINGLIB__VAL_STRING)
+            value.u.string_val = __copyString(v->u.string_val);
+        else if (value.type == kTIMINGLIB__VAL_EXPR)
+            value.u.expr_val = nullptr;
+        value.next = nullptr;
+        values_.push_back(value);
+        ++event->num_values;
+    }
+}
+
+}  // namespace Timinglib
@@ -0,0 +1,88 @@
+/**
+ * @file timinglib_libstaging.h
+ * @date 2020-09-01
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#ifndef SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_LIBSTAGING_H_
+#define SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_LIBSTAGING_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/timing/timinglib/timinglib_structs.h"
+
+namespace Timinglib {
+
+class LibBuilder;
+
+/// @brief Groups and attributes of one liberty file, as the LibBuilder
+/// would get them.
+///
+/// A LibAnalysis in stream mode records into it instead of calling the
+/// LibBuilder, so a file can be parsed without touching the timing
+/// database, e.g. on another thread. replay() then feeds the recorded
+/// calls to a LibBuilder in the same order. Strings are copied, values
+/// of expressions are not kept as the LibBuilder does not use them.
+class LibStaging {
+  public:
+    LibStaging();
+    ~LibStaging();
+
+    void beginGroup(timinglib_head *h);
+    void endGroup();
+    void buildAttribute(const std::string &name, timinglib_attribute_value *v);
+
+    void replay(LibBuilder *builder);
+    void clear();
+    size_t getNumEvents() const { return events_.size(); }
+    /// @brief false if groups came from more than one file (include_file)
+    bool isSingleFile() const { return num_filenames_ <= 1; }
+
+    /// @brief write the recorded calls at the current position of fp,
+    /// filenames are left out.
+    bool write(FILE *fp) const;
+    /// @brief read calls written by write() from data, groups get filename.
+    bool read(const char *data, uint64_t size, const std::string &filename);
+
+  private:
+    enum EventType : uint8_t { kBeginGroup, kEndGroup, kAttribute };
+
+    struct Event {
+        EventType type;
+        int lineno;
+        char *name;
+        char *filename;
+        uint32_t first_value;
+        uint32_t num_values;
+    };
+
+    char *__copyString(const char *str);
+    void __addValues(Event *event, timinglib_attribute_value *v);
+
+    std::vector<Event> events_;
+    std::vector<timinglib_attribute_value> values_;
+    /// string storage, in blocks so that copies never move
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char *block_;
+    size_t block_used_;
+    /// filename of the last group, groups of a file share its copy
+    const char *last_filename_;
+    char *last_filename_copy_;
+    uint32_t num_filenames_;
+};
+
+}  // namespace Timinglib
+
+#endif  // SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_LIBSTAGING_H_
@@ -45,6 +45,8 @@ bool LibSyn::parseLibertyFile(const char *const filename,
 
     analysis_->setLibertyFileName(filename);
     analysis_->setLibertyParseLogStr(parseLogStr);
+    analysis_->setStreamMode(stream_mode_);
+    analysis_->setStaging(staging_);
 
     si2drErrorT err;
     analysis_->si2drPIInit(&err);
@@ -87,7 +89,13 @@ bool LibSyn::parseLibertyFile(const char *const filename,
     return true;
 }
 
+void LibSyn::setStaging(LibStaging *staging) {
+    staging_ = staging;
+    if (staging_ != nullptr) stream_mode_ = true;
+}
+
 bool LibSyn::isLibertySyntaxValid(void) {
+    if (stream_mode_) return true;
     if (analysis_ != nullptr) return analysis_->isLibertySyntaxValid();
 
     return true;
@@ -95,7 +103,7 @@ bool LibSyn::isLibertySyntaxValid(void) {
 
 bool LibSyn::dumpLibFile(const char *const filename,
                          bool clearFileContent /*=true*/) {
-    if (analysis_ == nullptr) return false;
+    if (analysis_ == nullptr || stream_mode_) return false;
     return analysis_->dumpLibFile(filename, clearFileContent);
 }
 
@@ -25,6 +25,7 @@
 namespace Timinglib {
 class LibBuilder;
 class LibAnalysis;
+class LibStaging;
 
 class LibSyn {
   public:
@@ -37,6 +38,14 @@ class LibSyn {
 
     bool isLibertySyntaxValid(void);
 
+    /// @brief build while parsing, without the si2dr tree. Syntax checks
+    /// and dumpLibFile need the tree, they are not available then.
+    void setStreamMode(bool streamMode) { stream_mode_ = streamMode; }
+    bool isStreamMode(void) const { return stream_mode_; }
+    /// @brief record the file into staging rather than build it, implies
+    /// stream mode.
+    void setStaging(LibStaging *staging);
+
     bool dumpLibFile(const char *const filename, bool clearFileContent = true);
 
     LibAnalysis *getAnalysis(void);
@@ -61,6 +70,8 @@ class LibSyn {
     LibBuilder *libbuilder_ = nullptr;
 
     void *scanner_ = nullptr;
+    bool stream_mode_ = false;
+    LibStaging *staging_ = nullptr;
 };
 
 } /* end namespace Timinglib */
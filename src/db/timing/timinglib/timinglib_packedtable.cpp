@@ -0,0 +1,260 @@
+/**
+ * @file timinglib_packedtable.cpp
+ * @date 2020-10-09
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#include "db/timing/timinglib/timinglib_packedtable.h"
+
+#include <string.h>
+
+#include <new>
+
+#include "db/timing/timinglib/timinglib_tabletemplate.h"
+#include "db/util/array.h"
+#include "util/message.h"
+
+namespace open_edi {
+namespace db {
+
+static_assert(sizeof(PackedTable) <= PackedTable::kAlignment,
+              "PackedTable header must fit in its first cache line");
+
+/// floats per aligned chunk
+static const uint32_t kAlignedFloats = PackedTable::kAlignment / sizeof(float);
+
+static uint32_t alignFloats(uint64_t n) {
+    return (n + kAlignedFloats - 1) / kAlignedFloats * kAlignedFloats;
+}
+
+static bool isSlewVariable(TableAxisVariable v) {
+    return v == TableAxisVariable::kInput_Net_Transition ||
+           v == TableAxisVariable::kInput_Transition_Time ||
+           v == TableAxisVariable::kRelated_Pin_Transition ||
+           v == TableAxisVariable::kConstrained_Pin_Transition ||
+           v == TableAxisVariable::kOutput_Pin_Transition;
+}
+
+static bool isLoadVariable(TableAxisVariable v) {
+    return v == TableAxisVariable::kTotal_Output_Net_Capacitance ||
+           v == TableAxisVariable::kEqual_Or_Opposite_Output_Net_Capacitance ||
+           v == TableAxisVariable::kRelated_Out_Total_Output_Net_Capacitance;
+}
+
+/// @brief sizes of the axes and the number of values, false if the values
+/// don't fill the axes.
+static bool getShape(const std::vector<TableAxis *> &axes,
+                     const std::vector<float> &values, uint32_t *sizes,
+                     uint64_t *num_values) {
+    uint32_t dimension = axes.size();
+    if (dimension > PackedTable::kMaxDimension || values.empty())
+        return false;
+    *num_values = 1;
+    for (uint32_t i = 0; i < PackedTable::kMaxDimension; ++i) sizes[i] = 1;
+    for (uint32_t i = 0; i < dimension; ++i) {
+        if (axes[i] == nullptr || axes[i]->getSize() <= 0) return false;
+        sizes[i] = axes[i]->getSize();
+        *num_values *= sizes[i];
+    }
+    return *num_values == values.size();
+}
+
+uint64_t PackedTable::getPackedSize(const std::vector<TableAxis *> &axes,
+                                    const std::vector<float> &values) {
+    uint32_t sizes[kMaxDimension];
+    uint64_t num_values = 0;
+    if (!getShape(axes, values, sizes, &num_values)) return 0;
+    uint64_t floats = kAlignedFloats + alignFloats(num_values);
+    for (uint32_t i = 0; i < axes.size(); ++i) floats += alignFloats(sizes[i]);
+    if (floats > UINT32_MAX) return 0;
+    return floats * sizeof(float);
+}
+
+PackedTable *PackedTable::pack(const std::vector<TableAxis *> &axes,
+                               const std::vector<float> &values,
+                               void *block) {
+    uint32_t sizes[kMaxDimension];
+    uint64_t num_values = 0;
+    uint64_t size = getPackedSize(axes, values);
+    if (block == nullptr || size == 0) return nullptr;
+    getShape(axes, values, sizes, &num_values);
+    uint32_t dimension = axes.size();
+
+    uint64_t offset = kAlignedFloats;
+    uint32_t axis_offsets[kMaxDimension] = {0, 0, 0};
+    for (uint32_t i = 0; i < dimension; ++i) {
+        axis_offsets[i] = offset;
+        offset += alignFloats(sizes[i]);
+    }
+    uint64_t values_offset = offset;
+
+    memset(block, 0, size);
+    PackedTable *table = new (block) PackedTable;
+    table->size_ = size;
+    table->dimension_ = dimension;
+    table->num_values_ = num_values;
+    table->values_offset_ = values_offset;
+    table->slew_axis_ = kMaxDimension;
+    table->load_axis_ = kMaxDimension;
+    float *data = static_cast<float *>(block);
+    for (uint32_t i = 0; i < kMaxDimension; ++i) {
+        table->sizes_[i] = sizes[i];
+        table->axis_offsets_[i] = axis_offsets[i];
+        table->variables_[i] = TableAxisVariable::kUnknown;
+        if (i >= dimension) continue;
+        table->variables_[i] = axes[i]->getVariable();
+        ArrayObject<float> *axis_values = axes[i]->getValues();
+        for (uint32_t j = 0; j < sizes[i]; ++j)
+            data[axis_offsets[i] + j] = (*axis_values)[j];
+        if (table->slew_axis_ == kMaxDimension &&
+            isSlewVariable(table->variables_[i]))
+            table->slew_axis_ = i;
+        else if (table->load_axis_ == kMaxDimension &&
+                 isLoadVariable(table->variables_[i]))
+            table->load_axis_ = i;
+    }
+    memcpy(data + values_offset, values.data(), sizeof(float) * num_values);
+    return table;
+}
+
+/// @brief copy
+///
+/// Pool blocks are 8 byte aligned, the copy starts at the next 64 byte
+/// boundary of a block larger by the difference, and its id is moved along
+/// with it. Blocks of the pool are not freed one by one.
+PackedTable *PackedTable::copy(const PackedTable &table, MemPagePool *pool,
+                               ObjectId *id) {
+    *id = UNINIT_OBJECT_ID;
+    if (pool == nullptr) return nullptr;
+    uint64_t size = table.size_ + kAlignment - 8;
+    if (size + 8 > pool->getPageSize()) {
+        open_edi::util::message->issueMsg(
+            open_edi::util::kError,
+            "timing table has %lu bytes, more than a memory page.\n",
+            table.size_);
+        return nullptr;
+    }
+    ObjectId block_id = UNINIT_OBJECT_ID;
+    char *block = pool->allocateArray<char>(size, block_id);
+    if (block == nullptr) return nullptr;
+    uint64_t skip = (kAlignment - reinterpret_cast<uintptr_t>(block) %
+                                      kAlignment) % kAlignment;
+    memcpy(block + skip, &table, table.size_);
+    *id = block_id + skip;
+    return reinterpret_cast<PackedTable *>(block + skip);
+}
+
+/// @brief FNV-1a over the shape, variables and the data after the header
+uint64_t PackedTable::getHash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void *data, size_t size) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    add(&dimension_, sizeof(dimension_));
+    add(sizes_, sizeof(sizes_));
+    add(variables_, sizeof(variables_));
+    add(reinterpret_cast<const char *>(this) + kAlignment, size_ - kAlignment);
+    return hash;
+}
+
+bool PackedTable::isSame(const PackedTable &rhs) const {
+    return size_ == rhs.size_ && dimension_ == rhs.dimension_ &&
+           memcmp(sizes_, rhs.sizes_, sizeof(sizes_)) == 0 &&
+           memcmp(variables_, rhs.variables_, sizeof(variables_)) == 0 &&
+           memcmp(reinterpret_cast<const char *>(this) + kAlignment,
+                  reinterpret_cast<const char *>(&rhs) + kAlignment,
+                  size_ - kAlignment) == 0;
+}
+
+float PackedTable::getValue(uint32_t index1, uint32_t index2,
+                            uint32_t index3) const {
+    uint64_t index = (static_cast<uint64_t>(index1) * sizes_[1] + index2) *
+                         sizes_[2] +
+                     index3;
+    if (index >= num_values_) return 0.0f;
+    return getValues()[index];
+}
+
+/// @brief segment of axis around x and the position of x in it
+///
+/// The segment is found by counting inner points not above x, a fixed
+/// loop over a few floats without branches. The fraction is kept within
+/// [-1, 2], one segment length beyond either end.
+static inline uint32_t findSegment(const float *axis, uint32_t size, float x,
+                                   float *fraction) {
+    if (size < 2) {
+        *fraction = 0.0f;
+        return 0;
+    }
+    uint32_t segment = 0;
+    for (uint32_t i = 1; i + 1 < size; ++i) segment += axis[i] <= x;
+    float x0 = axis[segment];
+    float width = axis[segment + 1] - x0;
+    float t = width != 0.0f ? (x - x0) / width : 0.0f;
+    t = t < -1.0f ? -1.0f : t;
+    t = t > 2.0f ? 2.0f : t;
+    *fraction = t;
+    return segment;
+}
+
+float PackedTable::lookup(float x1, float x2, float x3) const {
+    const float x[kMaxDimension] = {x1, x2, x3};
+    uint32_t segment[kMaxDimension] = {0, 0, 0};
+    float t[kMaxDimension] = {0.0f, 0.0f, 0.0f};
+    // corners of the segment along axes of size 1 are the same point.
+    uint32_t step[kMaxDimension] = {0, 0, 0};
+    for (uint32_t i = 0; i < dimension_; ++i) {
+        segment[i] = findSegment(getAxis(i), sizes_[i], x[i], &t[i]);
+        step[i] = sizes_[i] > 1 ? 1 : 0;
+    }
+
+    const float *values = getValues();
+    uint32_t stride1 = sizes_[1] * sizes_[2];
+    uint32_t stride2 = sizes_[2];
+    const float *base =
+        values + segment[0] * stride1 + segment[1] * stride2 + segment[2];
+    float result = 0.0f;
+    for (uint32_t corner = 0; corner < (1u << dimension_); ++corner) {
+        uint32_t c0 = corner & 1, c1 = (corner >> 1) & 1, c2 = (corner >> 2) & 1;
+        float weight = (c0 ? t[0] : 1.0f - t[0]);
+        if (dimension_ > 1) weight *= (c1 ? t[1] : 1.0f - t[1]);
+        if (dimension_ > 2) weight *= (c2 ? t[2] : 1.0f - t[2]);
+        result += weight * base[c0 * step[0] * stride1 + c1 * step[1] * stride2 +
+                                c2 * step[2]];
+    }
+    return result;
+}
+
+float PackedTable::lookupSlewLoad(float slew, float load) const {
+    float x[kMaxDimension] = {0.0f, 0.0f, 0.0f};
+    if (slew_axis_ < kMaxDimension) x[slew_axis_] = slew;
+    if (load_axis_ < kMaxDimension) x[load_axis_] = load;
+    return lookup(x[0], x[1], x[2]);
+}
+
+void PackedTable::lookupSlewLoad(const PackedTable *const *tables,
+                                 const float *slews, const float *loads,
+                                 float *results, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        // the next table is most likely in another cache line.
+        if (i + 1 < count && tables[i + 1] != nullptr)
+            __builtin_prefetch(tables[i + 1]);
+        results[i] = tables[i] != nullptr
+                         ? tables[i]->lookupSlewLoad(slews[i], loads[i])
+                         : 0.0f;
+    }
+}
+
+}  // namespace db
+}  // namespace open_edi
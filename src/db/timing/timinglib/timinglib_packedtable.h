@@ -0,0 +1,116 @@
+/**
+ * @file timinglib_packedtable.h
+ * @date 2020-10-09
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#ifndef SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_PACKEDTABLE_H_
+#define SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_PACKEDTABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "db/core/object.h"
+#include "db/timing/timinglib/timinglib_commondef.h"
+
+namespace open_edi {
+namespace db {
+
+class TableAxis;
+
+/// @brief Axes and values of a timing table in one block.
+///
+/// The block is a 64 byte header, then each axis and the values, each
+/// starting on a 64 byte boundary of the block. Values are row major, the
+/// last axis varying fastest, as in the liberty values attribute.
+///
+/// Tables keep their blocks in the memory pool and refer to them by id, so
+/// they are written and read back with the pool. Blocks never change once
+/// copied there, equal tables can refer to the same one.
+///
+/// lookup() interpolates linearly along each axis. Outside of an axis the
+/// end segment is extended by at most its own length, beyond that the
+/// result is that of the bound, so a bad slew or load cannot run away.
+class PackedTable {
+  public:
+    static const uint32_t kMaxDimension = 3;
+    static const size_t kAlignment = 64;
+
+    /// @brief bytes of the block of axes and values, 0 if the number of
+    /// values doesn't match the axes.
+    static uint64_t getPackedSize(const std::vector<TableAxis *> &axes,
+                                  const std::vector<float> &values);
+    /// @brief pack axes and values into block of getPackedSize() bytes, 8
+    /// byte aligned at least.
+    static PackedTable *pack(const std::vector<TableAxis *> &axes,
+                             const std::vector<float> &values, void *block);
+    /// @brief copy of table in a block of pool, its id in *id.
+    static PackedTable *copy(const PackedTable &table, MemPagePool *pool,
+                             ObjectId *id);
+
+    /// @brief hash of axes and values, equal tables have equal hashes
+    uint64_t getHash() const;
+    bool isSame(const PackedTable &rhs) const;
+
+    uint64_t getMemorySize() const { return size_; }
+    uint32_t getDimension() const { return dimension_; }
+    uint32_t getSize(uint32_t axis) const { return sizes_[axis]; }
+    TableAxisVariable getVariable(uint32_t axis) const {
+        return variables_[axis];
+    }
+    const float *getAxis(uint32_t axis) const {
+        return __getData() + axis_offsets_[axis];
+    }
+    const float *getValues() const { return __getData() + values_offset_; }
+    uint32_t getNumValues() const { return num_values_; }
+
+    float getValue(uint32_t index1, uint32_t index2 = 0,
+                   uint32_t index3 = 0) const;
+
+    /// @brief value at x1, x2, x3 along axis 1, 2, 3
+    float lookup(float x1, float x2 = 0.0f, float x3 = 0.0f) const;
+    /// @brief value at slew and load, each given to the axis of its
+    /// variable; transition axes take slew, capacitance axes take load.
+    float lookupSlewLoad(float slew, float load) const;
+    /// @brief lookupSlewLoad of count tables at once, results[i] being
+    /// tables[i] at slews[i] and loads[i]; null tables give 0.
+    static void lookupSlewLoad(const PackedTable *const *tables,
+                               const float *slews, const float *loads,
+                               float *results, size_t count);
+
+  private:
+    PackedTable() {}
+    ~PackedTable() {}
+    PackedTable(PackedTable const &) = delete;
+    PackedTable &operator=(PackedTable const &) = delete;
+
+    const float *__getData() const {
+        return reinterpret_cast<const float *>(this);
+    }
+
+    uint64_t size_;
+    uint32_t dimension_;
+    uint32_t num_values_;
+    uint32_t sizes_[kMaxDimension];
+    /// offsets in floats from the start of the block
+    uint32_t axis_offsets_[kMaxDimension];
+    uint32_t values_offset_;
+    TableAxisVariable variables_[kMaxDimension];
+    /// axis taking slew and load in lookupSlewLoad, kMaxDimension if none
+    uint8_t slew_axis_;
+    uint8_t load_axis_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_PACKEDTABLE_H_
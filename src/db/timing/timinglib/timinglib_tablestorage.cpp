@@ -0,0 +1,123 @@
+/**
+ * @file timinglib_tablestorage.cpp
+ * @date 2020-10-09
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#include "db/timing/timinglib/timinglib_tablestorage.h"
+
+#include <string.h>
+
+#include "db/core/db.h"
+#include "db/timing/timinglib/timinglib_packedtable.h"
+#include "db/timing/timinglib/timinglib_tabletemplate.h"
+
+namespace open_edi {
+namespace db {
+
+static uint64_t hashFloats(const std::vector<float> &values, uint64_t seed) {
+    uint64_t hash = 14695981039346656037ULL ^ seed;
+    const unsigned char *bytes =
+        reinterpret_cast<const unsigned char *>(values.data());
+    for (size_t i = 0; i < values.size() * sizeof(float); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void getFloats(ArrayObject<float> *array, std::vector<float> *values) {
+    values->clear();
+    if (array == nullptr) return;
+    values->reserve(array->getSize());
+    for (int64_t i = 0; i < array->getSize(); ++i)
+        values->push_back((*array)[i]);
+}
+
+/// values are compared bit by bit, like they are hashed.
+static bool isSameFloats(ArrayObject<float> *array,
+                         const std::vector<float> &values) {
+    if (array == nullptr ||
+        array->getSize() != static_cast<int64_t>(values.size()))
+        return false;
+    for (size_t i = 0; i < values.size(); ++i) {
+        float f = (*array)[i];
+        if (memcmp(&f, &values[i], sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+TableStorage::TableStorage()
+    : axes_(), values_(), packed_tables_(), num_shared_(0) {}
+
+TableAxis *TableStorage::getAxis(TableAxis *axis) {
+    if (axis == nullptr) return nullptr;
+    std::vector<float> values;
+    getFloats(axis->getValues(), &values);
+    uint64_t hash =
+        hashFloats(values, static_cast<uint64_t>(axis->getVariable()));
+    auto range = axes_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        TableAxis *shared = Object::addr<TableAxis>(it->second);
+        if (shared && shared->getVariable() == axis->getVariable() &&
+            isSameFloats(shared->getValues(), values)) {
+            ++num_shared_;
+            return shared;
+        }
+    }
+    axes_.emplace(hash, axis->getId());
+    return axis;
+}
+
+ObjectId TableStorage::getValues(const std::vector<float> &values) {
+    uint64_t hash = hashFloats(values, 0);
+    auto range = values_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (isSameFloats(Object::addr<ArrayObject<float>>(it->second),
+                         values)) {
+            ++num_shared_;
+            return it->second;
+        }
+    }
+
+    Timing *timing_lib = getTimingLib();
+    if (timing_lib == nullptr) return UNINIT_OBJECT_ID;
+    ArrayObject<float> *p = Object::createObject<ArrayObject<float>>(
+        kObjectTypeArray, timing_lib->getId());
+    if (p == nullptr) return UNINIT_OBJECT_ID;
+    p->setPool(timing_lib->getPool());
+    p->reserve(values.size());
+    for (auto f : values) p->pushBack(f);
+    values_.emplace(hash, p->getId());
+    return p->getId();
+}
+
+ObjectId TableStorage::getPackedTable(const PackedTable &table) {
+    uint64_t hash = table.getHash();
+    auto range = packed_tables_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        PackedTable *shared = Object::addr<PackedTable>(it->second);
+        if (shared && shared->isSame(table)) {
+            ++num_shared_;
+            return it->second;
+        }
+    }
+
+    Timing *timing_lib = getTimingLib();
+    if (timing_lib == nullptr) return UNINIT_OBJECT_ID;
+    ObjectId id = UNINIT_OBJECT_ID;
+    if (PackedTable::copy(table, timing_lib->getPool(), &id) == nullptr)
+        return UNINIT_OBJECT_ID;
+    packed_tables_.emplace(hash, id);
+    return id;
+}
+
+}  // namespace db
+}  // namespace open_edi
@@ -0,0 +1,72 @@
+/**
+ * @file timinglib_tablestorage.h
+ * @date 2020-10-09
+ * @brief
+ *
+ * Copyright (C) 2020 NIIC EDA
+ *
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ *
+ * of the BSD license.  See the LICENSE file for details.
+ */
+#ifndef SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_TABLESTORAGE_H_
+#define SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_TABLESTORAGE_H_
+
+#include <stdint.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "db/core/object.h"
+
+namespace open_edi {
+namespace db {
+
+class PackedTable;
+class TableAxis;
+
+/// @brief Shared axes and values of the timing tables of a LibSet.
+///
+/// Libraries repeat the same index_1/index_2 axes and often the same
+/// values in many tables, across cells and across the libraries of a
+/// corner. Axes, value arrays and packed tables are looked up here by
+/// content, and tables with equal content refer to the same one.
+///
+/// Shared objects are not edited in place: TimingTable::addValue copies
+/// shared values before changing them, and packed tables are never
+/// changed once copied to the pool.
+class TableStorage {
+  public:
+    TableStorage();
+
+    /// @brief axis equal to axis (same variable and values), axis itself
+    /// if it is the first one.
+    TableAxis *getAxis(TableAxis *axis);
+    /// @brief id of an ArrayObject<float> holding values
+    ObjectId getValues(const std::vector<float> &values);
+    /// @brief id of a packed table equal to table, a copy of table in the
+    /// pool of the timing library if it is the first one.
+    ObjectId getPackedTable(const PackedTable &table);
+
+    uint64_t getNumAxes() const { return axes_.size(); }
+    uint64_t getNumValues() const { return values_.size(); }
+    uint64_t getNumPackedTables() const { return packed_tables_.size(); }
+    /// @brief lookups answered by an existing axis, array or table
+    uint64_t getNumShared() const { return num_shared_; }
+
+  private:
+    TableStorage(TableStorage const &) = delete;
+    TableStorage &operator=(TableStorage const &) = delete;
+
+    std::unordered_multimap<uint64_t, ObjectId> axes_;
+    std::unordered_multimap<uint64_t, ObjectId> values_;
+    std::unordered_multimap<uint64_t, ObjectId> packed_tables_;
+    uint64_t num_shared_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // SRC_DB_TIMING_TIMINGLIB_TIMINGLIB_TABLESTORAGE_H_
@@ -16,9 +16,14 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -35,10 +40,13 @@
 #include "db/timing/timinglib/timinglib_cell.h"
 #include "db/timing/timinglib/timinglib_lib.h"
 #include "db/timing/timinglib/timinglib_libbuilder.h"
+#include "db/timing/timinglib/timinglib_libcache.h"
+#include "db/timing/timinglib/timinglib_libstaging.h"
 #include "db/timing/timinglib/timinglib_libsyn.h"
 #include "db/timing/timinglib/timinglib_pgterm.h"
 #include "db/timing/timinglib/timinglib_term.h"
 #include "util/stream.h"
+#include "util/thread_pool.h"
 #include "util/util.h"
 
 namespace open_edi {
@@ -208,13 +216,53 @@ void buildTermMapping() {
     }
 }
 
+static bool dumpLibLog(const std::string &dump_log_file,
+                       const std::string &parseLogStr, bool clearFileContent) {
+    uint8_t endl_c = '\n';
+    std::ios_base::openmode mode = std::ios::out;
+    if (clearFileContent)
+        mode = mode | std::ios::trunc;
+    else
+        mode = mode | std::ios::app;
+    std::ofstream os_log(dump_log_file.c_str(), mode);
+    if (os_log.fail()) {
+        open_edi::util::message->issueMsg("TIMINGLIB", 3, kError,
+                                          dump_log_file.c_str());
+        return false;
+    }
+    os_log << parseLogStr << endl_c;
+    os_log.close();
+    return true;
+}
+
+static bool dumpLibDb(LibSet *libset, const std::string &dump_db_file,
+                      bool clearFileContent) {
+    uint8_t endl_c = '\n';
+    std::ios_base::openmode mode = std::ios::out;
+    if (clearFileContent)
+        mode = mode | std::ios::trunc;
+    else
+        mode = mode | std::ios::app;
+    OStream<std::ofstream> os(dump_db_file.c_str(), mode);
+    if (!os.isOpen()) {
+        open_edi::util::message->issueMsg("TIMINGLIB", 3, kError,
+                                          dump_db_file.c_str());
+        return false;
+    }
+    os << *libset << endl_c;
+    os.close();
+    return true;
+}
+
 bool parseLib(LibSet *libset, const std::string &file,
               const std::string &dump_lib_file, const std::string &dump_db_file,
-              const std::string &dump_log_file, bool clearFileContent) {
+              const std::string &dump_log_file, bool clearFileContent,
+              bool stream) {
     if (libset == nullptr) return false;
 
     Timinglib::LibBuilder builder(libset);
     Timinglib::LibSyn libSyn(&builder);
+    libSyn.setStreamMode(stream);
 
     std::string parseLogStr = "";
     bool ret = libSyn.parseLibertyFile(file.c_str(), &parseLogStr);
@@ -224,50 +272,16 @@ bool parseLib(LibSet *libset, const std::string &file,
         return false;
     }
 
-    if (dump_lib_file != "") {
+    if (dump_lib_file != "" && !stream) {
         if (false ==
             libSyn.dumpLibFile(dump_lib_file.c_str(), clearFileContent))
             return false;
     }
-    uint8_t endl_c = '\n';
-    if (dump_log_file != "") {
-        // open_edi::util::message->info("Write file %s...\n",
-        //                              dump_log_file.c_str());
-        std::ios_base::openmode mode = std::ios::out;
-        if (clearFileContent)
-            mode = mode | std::ios::trunc;
-        else
-            mode = mode | std::ios::app;
-        std::ofstream os_log(dump_log_file.c_str(), mode);
-        if (os_log.fail()) {
-            open_edi::util::message->issueMsg("TIMINGLIB", 3, kError,
-                                              dump_log_file.c_str());
-            return false;
-        }
-        os_log << parseLogStr << endl_c;
-        os_log.close();
-        // open_edi::util::message->info("Write file %s finished.\n",
-        //                              dump_log_file.c_str());
-    }
-    if (dump_db_file != "") {
-        // open_edi::util::message->info("Write file %s...\n",
-        //                              dump_db_file.c_str());
-        std::ios_base::openmode mode = std::ios::out;
-        if (clearFileContent)
-            mode = mode | std::ios::trunc;
-        else
-            mode = mode | std::ios::app;
-        OStream<std::ofstream> os(dump_db_file.c_str(), mode);
-        if (!os.isOpen()) {
-            open_edi::util::message->issueMsg("TIMINGLIB", 3, kError,
-                                              dump_db_file.c_str());
-            return false;
-        }
-        os << *libset << endl_c;
-        os.close();
-        // open_edi::util::message->info("Write file %s...\n",
-        //                              dump_db_file.c_str());
-    }
+    if (dump_log_file != "" &&
+        !dumpLibLog(dump_log_file, parseLogStr, clearFileContent))
+        return false;
+    if (dump_db_file != "" && !dumpLibDb(libset, dump_db_file, clearFileContent))
+        return false;
 
     // open_edi::util::message->info("Building term mapping...\n");
     buildTermMapping();
@@ -276,6 +290,118 @@ bool parseLib(LibSet *libset, const std::string &file,
     return true;
 }
 
+/// @brief parseLibs read files into libset on the thread pool
+///
+/// Each file is parsed on a worker into its own LibStaging, without
+/// touching the timing database. Staged files are then built into libset
+/// on this thread, one after the other and in the order of files, while
+/// the next ones are still being parsed; so libraries, cells and symbols
+/// are created as a sequential read would create them.
+///
+/// At most num_threads files are parsed or waiting to be built at a time,
+/// so that no more than num_threads staged files are held in memory.
+///
+/// With a cache_dir, files precompiled there are loaded instead of parsed,
+/// and the others are precompiled there once parsed.
+static bool parseLibs(LibSet *libset, const std::vector<std::string> &files,
+                      const std::string &dump_db_file,
+                      const std::string &dump_log_file,
+                      const std::string &cache_dir, int num_threads) {
+    if (libset == nullptr) return false;
+
+    struct StagedLib {
+        Timinglib::LibStaging staging;
+        std::string parseLogStr;
+        bool ok = false;
+        bool cached = false;
+        std::atomic<bool> done{false};
+    };
+    std::unique_ptr<Timinglib::LibCache> cache;
+    if (cache_dir != "") cache.reset(new Timinglib::LibCache(cache_dir));
+    Timinglib::LibCache *libCache = cache.get();
+    std::vector<std::unique_ptr<StagedLib>> staged;
+    for (size_t i = 0; i < files.size(); ++i)
+        staged.emplace_back(new StagedLib);
+
+    open_edi::util::ThreadPool &pool = open_edi::util::ThreadPool::getInstance();
+    open_edi::util::TaskGroup tasks(pool);
+    std::mutex mutex;
+    std::condition_variable libDone;
+    auto post = [&](size_t i) {
+        StagedLib *lib = staged[i].get();
+        const std::string *file = &files[i];
+        tasks.run([lib, file, libCache, &mutex, &libDone]() {
+            try {
+                // hashed once, for the lookup and the save of a miss.
+                Timinglib::LibCache::Key key;
+                bool keyed = libCache && libCache->getKey(*file, &key);
+                if (keyed && libCache->load(*file, key, &lib->staging)) {
+                    lib->ok = lib->cached = true;
+                } else {
+                    Timinglib::LibSyn libSyn(nullptr);
+                    libSyn.setStaging(&lib->staging);
+                    lib->ok = libSyn.parseLibertyFile(file->c_str(),
+                                                      &lib->parseLogStr);
+                    if (lib->ok && keyed)
+                        libCache->save(*file, key, lib->staging);
+                }
+            } catch (...) {
+                lib->ok = false;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            lib->done.store(true, std::memory_order_release);
+            libDone.notify_all();
+        });
+    };
+    size_t window = std::max(1, num_threads);
+    size_t next = 0;
+    for (; next < files.size() && next < window; ++next) post(next);
+
+    bool ok = true;
+    size_t num_cached = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        StagedLib *lib = staged[i].get();
+        while (!lib->done.load(std::memory_order_acquire)) {
+            if (pool.runPendingTask()) continue;
+            std::unique_lock<std::mutex> lock(mutex);
+            libDone.wait(lock, [lib]() {
+                return lib->done.load(std::memory_order_acquire);
+            });
+        }
+        if (!lib->ok) {
+            ok = false;
+            break;
+        }
+        if (lib->cached) {
+            open_edi::util::message->info("Reading %s from cache...\n",
+                                          files[i].c_str());
+            ++num_cached;
+        }
+        Timinglib::LibBuilder builder(libset);
+        lib->staging.replay(&builder);
+        lib->staging.clear();
+        // this file is built, the next one can be parsed.
+        if (next < files.size()) post(next++);
+        if (dump_log_file != "" &&
+            !dumpLibLog(dump_log_file, lib->parseLogStr, i == 0)) {
+            ok = false;
+            break;
+        }
+    }
+    tasks.wait();
+    if (!ok) return false;
+    if (cache) {
+        open_edi::util::message->info(
+            "Read %lu of %lu liberty files from cache %s.\n", num_cached,
+            files.size(), cache_dir.c_str());
+    }
+
+    if (dump_db_file != "" && !dumpLibDb(libset, dump_db_file, true))
+        return false;
+    buildTermMapping();
+    return true;
+}
+
 int readTimingLibCommand(ClientData cld, Tcl_Interp *itp, int argc,
                          const char *argv[]) {
     if (argc > 1) {
@@ -283,8 +409,34 @@ int readTimingLibCommand(ClientData cld, Tcl_Interp *itp, int argc,
         std::string dump_lib_file = "";
         std::string dump_db_file = "";
         std::string dump_log_file = "";
+        bool stream = false;
+        int numThreads = 1;
+        std::string cache_dir = "";
         for (int i = 1; i < argc; ++i) {
-            if (!strcmp(argv[i], "-dump_lib")) {
+            if (!strcmp(argv[i], "-stream")) {
+                stream = true;
+            } else if (!strcmp(argv[i], "-cache_dir")) {
+                if ((i + 1) < argc) {
+                    cache_dir = argv[++i];
+                } else {
+                    open_edi::util::message->issueMsg("TIMINGLIB", 7, kError,
+                                                      argv[i]);
+                    return TCL_ERROR;
+                }
+            } else if (!strcmp(argv[i], "-threads")) {
+                if ((i + 1) < argc) {
+                    numThreads = atoi(argv[++i]);
+                    if (numThreads <= 0) {
+                        open_edi::util::message->issueMsg(
+                            "TIMINGLIB", 12, kError, argv[i], "-threads");
+                        return TCL_ERROR;
+                    }
+                } else {
+                    open_edi::util::message->issueMsg("TIMINGLIB", 7, kError,
+                                                      argv[i]);
+                    return TCL_ERROR;
+                }
+            } else if (!strcmp(argv[i], "-dump_lib")) {
                 if ((i + 1) < argc) {
                     dump_lib_file = argv[++i];
                 } else {
@@ -312,6 +464,19 @@ int readTimingLibCommand(ClientData cld, Tcl_Interp *itp, int argc,
                 files.emplace_back(argv[i]);
             }
         }
+        bool staged = cache_dir != "" || (numThreads > 1 && files.size() > 1);
+        if (staged) stream = true;
+        if (stream && dump_lib_file != "") {
+            open_edi::util::message->issueMsg(
+                open_edi::util::kWarn,
+                "-dump_lib needs the liberty parse tree, ignored with -stream, "
+                "-threads or -cache_dir.\n");
+        }
+        if (cache_dir != "" && access(cache_dir.c_str(), W_OK) == -1) {
+            open_edi::util::message->issueMsg(
+                "TIMINGLIB", 5, open_edi::util::kError, cache_dir.c_str());
+            return TCL_ERROR;
+        }
         size_t lib_file_count = files.size();
         if (lib_file_count == 0) {
             open_edi::util::message->issueMsg("TIMINGLIB", 4, kError,
@@ -385,11 +550,16 @@ int readTimingLibCommand(ClientData cld, Tcl_Interp *itp, int argc,
             open_edi::util::message->info("\nReading Timing Library\n");
         bool clearFileContent = true;
         bool bSuccess = true;
+        if (staged) {
+            bSuccess = parseLibs(libset, files, dump_db_file, dump_log_file,
+                                 cache_dir, numThreads);
+            lib_file_count = 0;
+        }
         for (int i = 0; i < lib_file_count; ++i) {
             if (i != 0) clearFileContent = false;
 
             if (false == parseLib(libset, files[i], dump_lib_file, dump_db_file,
-                                  dump_log_file, clearFileContent)) {
+                                  dump_log_file, clearFileContent, stream)) {
                 bSuccess = false;
                 break;
             }
@@ -743,7 +913,7 @@ int createAnalysisCornerCommand(ClientData cld, Tcl_Interp *itp, int argc,
 
         open_edi::util::message->info("\nReading Timing Library\n");
         if (false == parseLib(libset, args.lib_set, dump_lib_file, dump_db_file,
-                              dump_log_file, true)) {
+                              dump_log_file, true, false)) {
             // open_edi::util::message->issueMsg("TIMINGLIB", 9,
             //    open_edi::util::kError, "read Timing Library");
             open_edi::util::message->issueMsg("TIMINGLIB", 1,
@@ -270,6 +270,18 @@ TimingArc *TTerm::getTimingarc(ObjectId id) {
     }
     return nullptr;
 }
+std::vector<TimingArc *> TTerm::getTimingarcs(void) {
+    std::vector<TimingArc *> arcs;
+    if (timing_arcs_ == UNINIT_OBJECT_ID) return arcs;
+    auto p = Object::addr<ArrayObject<ObjectId>>(timing_arcs_);
+    if (p == nullptr) return arcs;
+    arcs.reserve(p->getSize());
+    for (auto iter = p->begin(); iter != p->end(); ++iter) {
+        auto arc = Object::addr<TimingArc>(*iter);
+        if (arc != nullptr) arcs.emplace_back(arc);
+    }
+    return arcs;
+}
 TPgTerm *TTerm::getRelatedPowerPin(void) const {
     if (related_power_pin_ != UNINIT_OBJECT_ID) {
         return Object::addr<TPgTerm>(related_power_pin_);
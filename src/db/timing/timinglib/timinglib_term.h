@@ -15,6 +15,7 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "db/core/object.h"
 #include "db/timing/timinglib/timinglib_commondef.h"
@@ -108,6 +109,7 @@ class TTerm : public Object {
     SymbolIndex getNameIndex(void);
     TFunction *getFunction(void);
     TimingArc *getTimingarc(ObjectId id);
+    std::vector<TimingArc *> getTimingarcs(void);
     TPgTerm *getRelatedPowerPin(void) const;
     TPgTerm *getRelatedGroundPin(void) const;
 
@@ -249,7 +249,7 @@ TimingTable* TimingArc::getFallConstraint(void) {
 TTerm* TimingArc::getRelatedPin(const std::string& name) {
     Timing* timing_lib = getTimingLib();
     if (timing_lib) {
-        SymbolIndex id = timing_lib->getOrCreateSymbol(name.c_str());
+        SymbolIndex id = timing_lib->isSymbolInTable(name);
         if (id != kInvalidSymbolIndex) {
             auto p = related_pins_map_.find(id);
             if (p != related_pins_map_.end()) return getRelatedPin(p->second);
@@ -14,25 +14,34 @@
 #include "db/timing/timinglib/timinglib_timingtable.h"
 
 #include "db/core/db.h"
+#include "db/timing/timinglib/timinglib_packedtable.h"
+#include "db/timing/timinglib/timinglib_tablestorage.h"
 #include "db/timing/timinglib/timinglib_tabletemplate.h"
 
 namespace open_edi {
 namespace db {
 
-TimingTable::TimingTable() : TimingTable::BaseType() {
+TimingTable::TimingTable()
+    : TimingTable::BaseType(), packed_(UNINIT_OBJECT_ID) {
     setObjectType(ObjectType::kObjectTypeTimingTable);
 }
 
 TimingTable::~TimingTable() {}
 
 TimingTable::TimingTable(Object* owner, TimingTable::IndexType id)
-    : TimingTable::BaseType(owner, id) {
+    : TimingTable::BaseType(owner, id), packed_(UNINIT_OBJECT_ID) {
     setObjectType(ObjectType::kObjectTypeTimingTable);
 }
 
-TimingTable::TimingTable(TimingTable const& rhs) { copy(rhs); }
+TimingTable::TimingTable(TimingTable const& rhs)
+    : packed_(UNINIT_OBJECT_ID) {
+    copy(rhs);
+}
 
-TimingTable::TimingTable(TimingTable&& rhs) noexcept { move(std::move(rhs)); }
+TimingTable::TimingTable(TimingTable&& rhs) noexcept
+    : packed_(UNINIT_OBJECT_ID) {
+    move(std::move(rhs));
+}
 
 TimingTable& TimingTable::operator=(TimingTable const& rhs) {
     if (this != &rhs) {
@@ -48,18 +57,84 @@ TimingTable& TimingTable::operator=(TimingTable&& rhs) noexcept {
     return *this;
 }
 
-void TimingTable::copy(TimingTable const& rhs) { this->BaseType::copy(rhs); }
+void TimingTable::copy(TimingTable const& rhs) {
+    this->BaseType::copy(rhs);
+    // packed blocks never change, the copy refers to the same one.
+    packed_ = rhs.packed_;
+}
 
 void TimingTable::move(TimingTable&& rhs) {
     this->BaseType::move(std::move(rhs));
+    packed_ = rhs.packed_;
+    rhs.packed_ = UNINIT_OBJECT_ID;
 }
 
 TimingTable::IndexType TimingTable::memory() const {
     IndexType ret = this->BaseType::memory();
 
+    ret += sizeof(packed_);
+    const PackedTable* packed = getPackedTable();
+    if (packed) ret += packed->getMemorySize();
+
     return ret;
 }
 
+const PackedTable* TimingTable::getPackedTable(void) const {
+    if (packed_ == UNINIT_OBJECT_ID) return nullptr;
+    return addr<PackedTable>(packed_);
+}
+
+/// @brief __pack
+///
+/// The block is built on the heap first, so that a table equal to one of
+/// storage takes no room in the pool.
+void TimingTable::__pack(const std::vector<TableAxis*>& axes,
+                         const std::vector<float>& values,
+                         TableStorage* storage) {
+    packed_ = UNINIT_OBJECT_ID;
+    uint64_t size = PackedTable::getPackedSize(axes, values);
+    if (size == 0) return;
+    std::vector<uint64_t> block((size + sizeof(uint64_t) - 1) /
+                                sizeof(uint64_t));
+    PackedTable* packed = PackedTable::pack(axes, values, block.data());
+    if (packed == nullptr) return;
+    if (storage) {
+        packed_ = storage->getPackedTable(*packed);
+    } else {
+        PackedTable::copy(*packed, MemPool::getPagePoolByObjectId(getId()),
+                          &packed_);
+    }
+}
+
+/// @brief values array of a table to add values to, a copy of the shared
+/// one if shared, so that the other tables keep theirs.
+static ArrayObject<float>* getValuesToEdit(ObjectId* values, bool* shared) {
+    ArrayObject<float>* p = nullptr;
+    if (*values != UNINIT_OBJECT_ID)
+        p = Object::addr<ArrayObject<float>>(*values);
+    if (p != nullptr && !*shared) return p;
+
+    Timing* timing_lib = getTimingLib();
+    if (timing_lib == nullptr) return nullptr;
+    ArrayObject<float>* q = Object::createObject<ArrayObject<float>>(
+        kObjectTypeArray, timing_lib->getId());
+    if (q == nullptr) return nullptr;
+    q->setPool(timing_lib->getPool());
+    q->reserve(p != nullptr ? p->getSize() + 32 : 32);
+    if (p != nullptr) {
+        for (int64_t i = 0; i < p->getSize(); ++i) q->pushBack((*p)[i]);
+    }
+    *values = q->getId();
+    *shared = false;
+    return q;
+}
+
+float TimingTable::lookup(float slew, float load) const {
+    const PackedTable* packed = getPackedTable();
+    if (packed) return packed->lookupSlewLoad(slew, load);
+    return 0.0f;
+}
+
 TableAxis* TimingTable::getAxis1(void) { return nullptr; }
 TableAxis* TimingTable::getAxis2(void) { return nullptr; }
 TableAxis* TimingTable::getAxis3(void) { return nullptr; }
@@ -123,6 +198,9 @@ TimingTable0::IndexType TimingTable0::memory() const {
     return ret;
 }
 void TimingTable0::setValue(float f) { value_ = f; }
+void TimingTable0::pack(TableStorage* storage) {
+    __pack({}, {value_}, storage);
+}
 float TimingTable0::getValue(void) { return value_; }
 
 OStreamBase& operator<<(OStreamBase& os, TimingTable0 const& rhs) {
@@ -140,7 +218,8 @@ OStreamBase& operator<<(OStreamBase& os, TimingTable0 const& rhs) {
 TimingTable1::TimingTable1()
     : TimingTable1::BaseType(),
       values_(UNINIT_OBJECT_ID),
-      axis1_(UNINIT_OBJECT_ID) {
+      axis1_(UNINIT_OBJECT_ID),
+      shared_values_(false) {
     setObjectType(ObjectType::kObjectTypeTimingTable1);
 }
 
@@ -157,7 +236,8 @@ TimingTable1::~TimingTable1() {
 TimingTable1::TimingTable1(Object* owner, TimingTable1::IndexType id)
     : TimingTable1::BaseType(owner, id),
       values_(UNINIT_OBJECT_ID),
-      axis1_(UNINIT_OBJECT_ID) {
+      axis1_(UNINIT_OBJECT_ID),
+      shared_values_(false) {
     setObjectType(ObjectType::kObjectTypeTimingTable1);
 }
 
@@ -185,12 +265,15 @@ void TimingTable1::copy(TimingTable1 const& rhs) {
     this->BaseType::copy(rhs);
     values_ = rhs.values_;
     axis1_ = rhs.axis1_;
+    // the copy refers to the same array, neither may change it in place.
+    shared_values_ = rhs.values_ != UNINIT_OBJECT_ID;
 }
 
 void TimingTable1::move(TimingTable1&& rhs) {
     this->BaseType::move(std::move(rhs));
     values_ = std::move(rhs.values_);
     axis1_ = std::move(rhs.axis1_);
+    shared_values_ = rhs.shared_values_;
 }
 
 TimingTable1::IndexType TimingTable1::memory() const {
@@ -198,30 +281,28 @@ TimingTable1::IndexType TimingTable1::memory() const {
 
     ret += sizeof(values_);
     ret += sizeof(axis1_);
+    ret += sizeof(shared_values_);
 
     return ret;
 }
 
 void TimingTable1::addValue(float f) {
-    ArrayObject<float>* p = nullptr;
-    if (values_ == UNINIT_OBJECT_ID) {
-        Timing* timing_lib = getTimingLib();
-        if (timing_lib != nullptr) {
-            p = Object::createObject<ArrayObject<float>>(kObjectTypeArray,
-                                                         timing_lib->getId());
-            if (p != nullptr) {
-                values_ = p->getId();
-                p->setPool(timing_lib->getPool());
-                p->reserve(32);
-            }
-        }
-    } else {
-        p = addr<ArrayObject<float>>(values_);
-    }
+    ArrayObject<float>* p = getValuesToEdit(&values_, &shared_values_);
     if (p != nullptr) p->pushBack(f);
+    // the packed table doesn't have it.
+    packed_ = UNINIT_OBJECT_ID;
+}
+
+void TimingTable1::setSharedValues(ObjectId id) {
+    values_ = id;
+    shared_values_ = true;
+    packed_ = UNINIT_OBJECT_ID;
 }
 
 void TimingTable1::setAxis1(ObjectId id) { axis1_ = id; }
+void TimingTable1::pack(TableStorage* storage) {
+    __pack({getAxis1()}, getValues(), storage);
+}
 
 std::vector<float> TimingTable1::getValues(void) {
     std::vector<float> values;
@@ -283,7 +364,8 @@ TimingTable2::TimingTable2()
     : TimingTable2::BaseType(),
       values_(UNINIT_OBJECT_ID),
       axis1_(UNINIT_OBJECT_ID),
-      axis2_(UNINIT_OBJECT_ID) {
+      axis2_(UNINIT_OBJECT_ID),
+      shared_values_(false) {
     setObjectType(ObjectType::kObjectTypeTimingTable2);
 }
 
@@ -305,7 +387,8 @@ TimingTable2::TimingTable2(Object* owner, TimingTable2::IndexType id)
     : TimingTable2::BaseType(owner, id),
       values_(UNINIT_OBJECT_ID),
       axis1_(UNINIT_OBJECT_ID),
-      axis2_(UNINIT_OBJECT_ID) {
+      axis2_(UNINIT_OBJECT_ID),
+      shared_values_(false) {
     setObjectType(ObjectType::kObjectTypeTimingTable2);
 }
 
@@ -334,6 +417,8 @@ void TimingTable2::copy(TimingTable2 const& rhs) {
     values_ = rhs.values_;
     axis1_ = rhs.axis1_;
     axis2_ = rhs.axis2_;
+    // the copy refers to the same array, neither may change it in place.
+    shared_values_ = rhs.values_ != UNINIT_OBJECT_ID;
 }
 
 void TimingTable2::move(TimingTable2&& rhs) {
@@ -341,6 +426,7 @@ void TimingTable2::move(TimingTable2&& rhs) {
     values_ = std::move(rhs.values_);
     axis1_ = std::move(rhs.axis1_);
     axis2_ = std::move(rhs.axis2_);
+    shared_values_ = rhs.shared_values_;
 }
 
 TimingTable2::IndexType TimingTable2::memory() const {
@@ -349,33 +435,44 @@ TimingTable2::IndexType TimingTable2::memory() const {
     ret += sizeof(values_);
     ret += sizeof(axis1_);
     ret += sizeof(axis2_);
+    ret += sizeof(shared_values_);
 
     return ret;
 }
 
 void TimingTable2::addValue(float f) {
-    ArrayObject<float>* p = nullptr;
-    if (values_ == UNINIT_OBJECT_ID) {
-        Timing* timing_lib = getTimingLib();
-        if (timing_lib != nullptr) {
-            p = Object::createObject<ArrayObject<float>>(kObjectTypeArray,
-                                                         timing_lib->getId());
-            if (p != nullptr) {
-                values_ = p->getId();
-                p->setPool(timing_lib->getPool());
-                p->reserve(32);
-            }
-        }
-    } else {
-        p = addr<ArrayObject<float>>(values_);
-    }
+    ArrayObject<float>* p = getValuesToEdit(&values_, &shared_values_);
     if (p != nullptr) p->pushBack(f);
+    // the packed table doesn't have it.
+    packed_ = UNINIT_OBJECT_ID;
+}
+
+void TimingTable2::setSharedValues(ObjectId id) {
+    values_ = id;
+    shared_values_ = true;
+    packed_ = UNINIT_OBJECT_ID;
 }
 void TimingTable2::setAxis1(ObjectId id) { axis1_ = id; }
 void TimingTable2::setAxis2(ObjectId id) { axis2_ = id; }
 
+/// @brief pack, also for TimingTable3 which has its third axis
+void TimingTable2::pack(TableStorage* storage) {
+    std::vector<TableAxis*> axes = {getAxis1(), getAxis2()};
+    if (getAxis3()) axes.push_back(getAxis3());
+    std::vector<float> values;
+    ArrayObject<float>* p = nullptr;
+    if (values_ != UNINIT_OBJECT_ID) p = addr<ArrayObject<float>>(values_);
+    if (p != nullptr) {
+        values.reserve(p->getSize());
+        for (int64_t i = 0; i < p->getSize(); ++i) values.push_back((*p)[i]);
+    }
+    __pack(axes, values, storage);
+}
+
 float TimingTable2::getValue(IndexType index1, IndexType index2) {
-    TableAxis* t = getAxis1();
+    const PackedTable* packed = getPackedTable();
+    if (packed) return packed->getValue(index1, index2);
+    TableAxis* t = getAxis2();
     if (t) {
         ArrayObject<float>* p = nullptr;
         if (values_ != UNINIT_OBJECT_ID) p = addr<ArrayObject<float>>(values_);
@@ -505,14 +602,16 @@ TimingTable3::IndexType TimingTable3::memory() const {
 void TimingTable3::setAxis3(ObjectId id) { axis3_ = id; }
 float TimingTable3::getValue(IndexType index1, IndexType index2,
                              IndexType index3) {
-    TableAxis* t1 = getAxis1();
+    const PackedTable* packed = getPackedTable();
+    if (packed) return packed->getValue(index1, index2, index3);
     TableAxis* t2 = getAxis2();
-    if (t1 && t2) {
+    TableAxis* t3 = getAxis3();
+    if (t2 && t3) {
         ArrayObject<float>* p = nullptr;
         if (values_ != UNINIT_OBJECT_ID) p = addr<ArrayObject<float>>(values_);
         if (p != nullptr)
             return (
-                *p)[(index1 * t1->getSize() + index2) * t2->getSize() + index3];
+                *p)[(index1 * t2->getSize() + index2) * t3->getSize() + index3];
     }
 
     return 0.0f;
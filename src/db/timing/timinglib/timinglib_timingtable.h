@@ -24,7 +24,9 @@
 namespace open_edi {
 namespace db {
 
+class PackedTable;
 class TableAxis;
+class TableStorage;
 
 class TimingTable : public Object {
   public:
@@ -58,6 +60,11 @@ class TimingTable : public Object {
     virtual TableAxis *getAxis1(void);
     virtual TableAxis *getAxis2(void);
     virtual TableAxis *getAxis3(void);
+    /// @brief axes and values in one block, nullptr until the table of
+    /// the derived type is packed.
+    const PackedTable *getPackedTable(void) const;
+    /// @brief interpolated value at slew and load, 0 if not packed
+    float lookup(float slew, float load) const;
 
   protected:
     /// @brief copy object
@@ -66,6 +73,13 @@ class TimingTable : public Object {
     void move(TimingTable &&rhs);
     /// @brief overload output stream
     friend OStreamBase &operator<<(OStreamBase &os, TimingTable const &rhs);
+
+    /// @brief pack axes and values, shared with equal tables of storage if
+    /// given; the table has no packed block if they don't match.
+    void __pack(const std::vector<TableAxis *> &axes,
+                const std::vector<float> &values, TableStorage *storage);
+
+    ObjectId packed_;
 };
 
 class TimingTable0 : public TimingTable {
@@ -98,6 +112,8 @@ class TimingTable0 : public TimingTable {
 
     /// set
     void setValue(float f);
+    /// @brief pack the value once the table is built
+    void pack(TableStorage *storage = nullptr);
 
     /// get
     float getValue(void);
@@ -144,7 +160,11 @@ class TimingTable1 : public TimingTable {
 
     /// set
     void addValue(float f);
+    /// @brief use the values of a shared array, copied on the next addValue
+    void setSharedValues(ObjectId id);
     void setAxis1(ObjectId id);
+    /// @brief pack axis and values once the table is built
+    void pack(TableStorage *storage = nullptr);
 
     /// get
     std::vector<float> getValues(void);
@@ -161,6 +181,7 @@ class TimingTable1 : public TimingTable {
   private:
     ObjectId values_;
     ObjectId axis1_;
+    bool shared_values_;
 };
 
 class TimingTable2 : public TimingTable {
@@ -193,8 +214,12 @@ class TimingTable2 : public TimingTable {
 
     /// set
     virtual void addValue(float f);
+    /// @brief use the values of a shared array, copied on the next addValue
+    void setSharedValues(ObjectId id);
     virtual void setAxis1(ObjectId id);
     virtual void setAxis2(ObjectId id);
+    /// @brief pack axes and values once the table is built
+    void pack(TableStorage *storage = nullptr);
 
     /// get
     float getValue(IndexType index1, IndexType index2);
@@ -212,6 +237,7 @@ class TimingTable2 : public TimingTable {
     ObjectId values_;
     ObjectId axis1_;
     ObjectId axis2_;
+    bool shared_values_;
 };
 
 class TimingTable3 : public TimingTable2 {
@@ -84,8 +84,14 @@ class ArrayObject : public Object {
         pool_ = nullptr;
         is_initialized_ = false;
         current_avail_ = 0;
-        current_seg_ = nullptr;
         size_ = 0;
+        segment_size_ = 0;
+        segment_num_ = 0;
+        segments_ = 0;
+        last_segment_ = 0;
+        directory_ = 0;
+        directory_capacity_ = 0;
+        directory_levels_ = 1;
     }
     /// @brief ArrayObject
     ///
@@ -99,13 +105,13 @@ class ArrayObject : public Object {
     /// @param pool
     void setPool(MemPagePool *pool) { pool_ = pool; }
 
-    /// @brief getPool
+    /// @brief getPool, always the pool of the id of the array. A pool
+    /// pointer kept in the array would dangle once the page is saved and
+    /// read back by read_design, pool_ is only what setPool was given.
     ///
     /// @return
-    MemPagePool* getPool() {
-        if (nullptr != pool_) return pool_;
-        pool_ = MemPool::getPagePoolByObjectId(getId());
-        return pool_;
+    MemPagePool* getPool() const {
+        return MemPool::getPagePoolByObjectId(getId());
     }
 
     /// @brief reserve
@@ -116,96 +122,79 @@ class ArrayObject : public Object {
     bool reserve(int64_t size) {
         if (nullptr == getPool()) return false;
 
-        if (size >= kSegmentSize) {
+        if (size >= kSegmentSize || size <= 0) {
             segment_size_ = kSegmentSize;
         } else {
             segment_size_ = size;
         }
 
-        uint64_t seg_no = 1;
-        ObjectId seg_id = 0;
-        ArraySegment *seg_ptr = createSegment(segment_size_, seg_id);
-        if (nullptr == seg_ptr) {
-            return false;
-        }
-        seg_ptr->setNo(seg_no);
-        this->setFirstSegmentId(seg_id);
-        segment_num_ = 1;
+        freeDirectory();
+        segment_num_ = 0;
+        segments_ = 0;
+        last_segment_ = 0;
         current_avail_ = 0;
-        current_seg_ = seg_ptr;
-        size_ = segment_size_;
+        size_ = 0;
 
         // This is actual array size, not index
         // Since getSegmentNumber() assumes the parameter as index
         // Decrease by 1 before passing into
-        int32_t seg_num = getSegmentNumber(size - 1);  // total segments needed
-
-        ArraySegment *new_ptr = nullptr;
-        while (--seg_num) {  // ignore the first one
-            ObjectId id;
-            new_ptr = createSegment(segment_size_, id);
-            if (nullptr == new_ptr) {
-                return false;
-            }
-            seg_no++;
-            new_ptr->setNo(seg_no);
-            seg_ptr->setNext(id);
-            seg_ptr = new_ptr;
-            segment_num_++;
-            size_ += segment_size_;
+        int32_t seg_num = size > 0 ? getSegmentNumber(size - 1) : 1;
+        while (seg_num--) {
+            if (nullptr == appendSegment()) return false;
         }
         is_initialized_ = true;
         return true;
     }
 
-    /// @brief operator[]
+    /// @brief operator[], grows the array up to index if needed.
     ///
     /// @param index
     ///
     /// @return
     T &operator[](uint64_t index) {
-        int32_t seg_idx = getSegmentIndex(index);
-
-        ArraySegment *seg_ptr = nullptr;
-        seg_ptr = getSegmentByIndex(index);
-
-        ediAssert(nullptr != seg_ptr);
-        MemPagePool* pool = getPool();
-        T *array = pool->getObjectPtr<T>(seg_ptr->getArrayId());
-        return array[seg_idx];
+        if (static_cast<int64_t>(index) >= size_) increaseArraySize(index);
+        return *getElement(index);
     }
 
+    /// @brief operator[], O(1) and doesn't change the array, so that
+    /// several threads may read at the same time as long as none writes.
+    /// index must be below getArraySize().
+    ///
+    /// @param index
+    ///
+    /// @return
+    const T &operator[](uint64_t index) const { return *getElement(index); }
+
     /// @brief pushBack
     ///
     /// @param ele
     ///
     /// @return
     bool pushBack(const T &ele) {
-        int32_t index = getSegmentIndex(current_avail_);
-
-        ArraySegment *seg_ptr = nullptr;
-        seg_ptr = getSegmentByIndex(current_avail_);
-
-        if (nullptr != seg_ptr) {
-            MemPagePool* pool = getPool();
-            T *array = pool->getObjectPtr<T>(seg_ptr->getArrayId());
-            array[index] = ele;
-            current_avail_++;
-            return true;
+        if (current_avail_ >= size_ &&
+            nullptr == increaseArraySize(current_avail_)) {
+            return false;
         }
-
-        return false;
+        *getElement(current_avail_) = ele;
+        current_avail_++;
+        return true;
     }
 
     /// @brief getArraySize returns total allocated array size.
     ///
     /// @return
-    int64_t getArraySize() { return size_; }
+    int64_t getArraySize() const { return size_; }
 
     /// @brief getSize returns used size. less than or equal to total size.
     ///
     /// @return 
-    int64_t getSize() { return current_avail_; }
+    int64_t getSize() const { return current_avail_; }
+
+    /// @brief getSegmentSize returns the number of elements per segment,
+    /// elements of one segment are contiguous.
+    ///
+    /// @return
+    int32_t getSegmentSize() const { return segment_size_; }
 
     /// @brief adjustSize adjusts used size.
     ///
@@ -327,7 +316,7 @@ class ArrayObject : public Object {
     /// @param index
     ///
     /// @return
-    int32_t getSegmentNumber(int64_t index) {
+    int32_t getSegmentNumber(int64_t index) const {
         // if you call this fucntion with total size, you need to convert to
         // index number say, if you want to know how many segments needed for
         // totol N elements, call: getSegmentNumber(N-1);
@@ -339,7 +328,9 @@ class ArrayObject : public Object {
     /// @param index
     ///
     /// @return
-    int32_t getSegmentIndex(int64_t index) { return index % segment_size_; }
+    int32_t getSegmentIndex(int64_t index) const {
+        return index % segment_size_;
+    }
 
     ArraySegment *increaseArraySize(int64_t to_size);
 
@@ -369,48 +360,149 @@ class ArrayObject : public Object {
         return seg_ptr;
     }
 
-    /// @brief getSegmentByIndex
+    /// @brief resizeRoot moves the root of the directory to a block of
+    /// capacity ids and frees the old one.
     ///
-    /// @param index
-    ///
-    /// @return
-    ArraySegment *getSegmentByIndex(int32_t index) {
-        int32_t seg_num = getSegmentNumber(index);  // get needed segment number
+    /// @return false upon failure, the directory is left as is
+    bool resizeRoot(MemPagePool *pool, int64_t capacity) {
+        ObjectId root_id = 0;
+        ObjectId *root = pool->allocateArray<ObjectId>(capacity, root_id);
+        if (nullptr == root) return false;
+        const ObjectId *old_root =
+            directory_ ? pool->getObjectPtr<ObjectId>(directory_) : nullptr;
+        for (int64_t i = 0; i < capacity; ++i) {
+            root[i] = i < directory_capacity_ ? old_root[i] : 0;
+        }
+        if (directory_) {
+            pool->freeArray<ObjectId>(directory_, directory_capacity_);
+        }
+        directory_ = root_id;
+        directory_capacity_ = capacity;
+        return true;
+    }
 
-        if (seg_num > segment_num_) {
-            current_seg_ = increaseArraySize(index);
-            return current_seg_;
+    /// @brief growDirectory makes room for the entry of segment
+    /// segment_num_.
+    ///
+    /// @return the entry, nullptr upon failure
+    ObjectId *growDirectory(MemPagePool *pool) {
+        int64_t seg_no = segment_num_;
+        if (1 == directory_levels_ && seg_no < kDirectoryLeafSize) {
+            // one level, the root lists the segments.
+            if (seg_no >= directory_capacity_ &&
+                !resizeRoot(pool, directory_capacity_
+                                      ? directory_capacity_ * 2
+                                      : kDirectoryRootSize)) {
+                return nullptr;
+            }
+            return pool->getObjectPtr<ObjectId>(directory_) + seg_no;
+        }
+        if (1 == directory_levels_) {
+            // the root is a full leaf, it becomes the first leaf of a
+            // root of leaves.
+            ObjectId leaf_id = directory_;
+            ObjectId root_id = 0;
+            ObjectId *root =
+                pool->allocateArray<ObjectId>(kDirectoryRootSize, root_id);
+            if (nullptr == root) return nullptr;
+            root[0] = leaf_id;
+            for (int64_t i = 1; i < kDirectoryRootSize; ++i) root[i] = 0;
+            directory_ = root_id;
+            directory_capacity_ = kDirectoryRootSize;
+            directory_levels_ = 2;
+        }
+        int64_t leaf_no = seg_no >> kDirectoryLeafBits;
+        int64_t slot = seg_no & (kDirectoryLeafSize - 1);
+        if (leaf_no >= directory_capacity_ &&
+            !resizeRoot(pool, directory_capacity_ * 2)) {
+            return nullptr;
         }
+        ObjectId *root = pool->getObjectPtr<ObjectId>(directory_);
+        if (0 == root[leaf_no]) {
+            ObjectId leaf_id = 0;
+            if (nullptr ==
+                pool->allocateArray<ObjectId>(kDirectoryLeafSize, leaf_id)) {
+                return nullptr;
+            }
+            root[leaf_no] = leaf_id;
+        }
+        return pool->getObjectPtr<ObjectId>(root[leaf_no]) + slot;
+    }
 
-        int start_i = 0;
-        
-        if (index >= ((current_seg_->getNo()-1) * segment_size_)) {
-            if (index < (current_seg_->getNo() * segment_size_)) {
-                return current_seg_;
-            } else {
-                start_i = current_seg_->getNo();
+    /// @brief freeDirectory gives the root and the leaves back to the pool.
+    void freeDirectory() {
+        MemPagePool* pool = getPool();
+        if (nullptr != pool && directory_) {
+            if (2 == directory_levels_) {
+                const ObjectId *root = pool->getObjectPtr<ObjectId>(directory_);
+                for (int64_t i = 0; i < directory_capacity_; ++i) {
+                    if (root[i]) {
+                        pool->freeArray<ObjectId>(root[i], kDirectoryLeafSize);
+                    }
+                }
             }
+            pool->freeArray<ObjectId>(directory_, directory_capacity_);
         }
+        directory_ = 0;
+        directory_capacity_ = 0;
+        directory_levels_ = 1;
+    }
 
-        ObjectId seg_id;
-        ArraySegment *seg_ptr = nullptr;
+    /// @brief appendSegment creates a segment after the last one and adds
+    /// it to the directory.
+    ///
+    /// @return
+    ArraySegment *appendSegment() {
         MemPagePool* pool = getPool();
+        if (!pool) return nullptr;
 
-        if (start_i == 0) {
-            seg_id = getFirstSegmentId();
+        ObjectId *entry = growDirectory(pool);
+        if (nullptr == entry) return nullptr;
+        ObjectId seg_id = 0;
+        ArraySegment *seg_ptr = createSegment(segment_size_, seg_id);
+        if (nullptr == seg_ptr) return nullptr;
+        *entry = seg_ptr->getArrayId();
+        seg_ptr->setNo(segment_num_ + 1);
+        if (0 == segment_num_) {
+            setFirstSegmentId(seg_id);
         } else {
-            seg_id = current_seg_->getNext();
-        }
-        for (; start_i < seg_num; start_i++) {
-            seg_ptr = pool->getObjectPtr<ArraySegment>(seg_id);
-            seg_id = seg_ptr->getNext();
+            pool->getObjectPtr<ArraySegment>(last_segment_)->setNext(seg_id);
         }
-        current_seg_ = seg_ptr;
+        last_segment_ = seg_id;
+        segment_num_++;
+        size_ += segment_size_;
         return seg_ptr;
     }
 
+    /// @brief getElement finds the segment through the directory.
+    ///
+    /// @param index
+    ///
+    /// @return
+    T *getElement(int64_t index) const {
+        ediAssert(index >= 0 && index < size_);
+        MemPagePool* pool = getPool();
+        int64_t seg_no = index / segment_size_;
+        const ObjectId *root = pool->getObjectPtr<ObjectId>(directory_);
+        ObjectId array_id = 0;
+        if (1 == directory_levels_) {
+            array_id = root[seg_no];
+        } else {
+            const ObjectId *leaf = pool->getObjectPtr<ObjectId>(
+                root[seg_no >> kDirectoryLeafBits]);
+            array_id = leaf[seg_no & (kDirectoryLeafSize - 1)];
+        }
+        return pool->getObjectPtr<T>(array_id) +
+               (index - seg_no * segment_size_);
+    }
+
   private:
     const static int kSegmentSize = 32;
+    /// ids of a new root
+    const static int kDirectoryRootSize = 4;
+    /// segments of one directory leaf, a leaf is 32KB of ids
+    const static int kDirectoryLeafBits = 12;
+    const static int kDirectoryLeafSize = 1 << kDirectoryLeafBits;
 
     MemPagePool *pool_;
     int64_t size_;           // array size
@@ -418,7 +510,13 @@ class ArrayObject : public Object {
     int32_t segment_num_;    // number of segments
     ObjectId segments_;      // id for first ArraySegment object
     int64_t current_avail_;  // index for next available element
-    ArraySegment* current_seg_;  // index for next available element
+    ObjectId last_segment_;  // id for last ArraySegment object
+    // ids of the data of the segments, so an element is found in O(1). Up
+    // to 4096 segments the root lists them and doubles as they come; then
+    // it lists leaves, entry i % 4096 of leaf i / 4096 is segment i.
+    ObjectId directory_;
+    int64_t directory_capacity_;  // ids the root has room for
+    int32_t directory_levels_;    // 1 or 2
     bool is_initialized_;
 };
 
@@ -427,28 +525,22 @@ class ArrayObject : public Object {
 /// @tparam T
 /// @param index
 ///
-/// @return
+/// @return the last segment, nullptr upon failure
 template <class T>
 ArraySegment *ArrayObject<T>::increaseArraySize(int64_t index) {
+    if (!is_initialized_ && !reserve(kSegmentSize)) return nullptr;
     int32_t seg_num = getSegmentNumber(index);  // get needed segment number
 
     ArraySegment *seg_ptr = nullptr;
-    seg_ptr = getSegmentByIndex(segment_size_ * segment_num_ - 1);  // last one
-
-    seg_num -= segment_num_;
-    // now seg_ptr points to the last segment
-    while (seg_num--) {
-        ObjectId id;
-        ArraySegment *new_ptr = nullptr;
-        new_ptr = createSegment(segment_size_, id);
-        if (nullptr == new_ptr) {
+    if (seg_num <= segment_num_) {
+        MemPagePool* pool = getPool();
+        seg_ptr = pool->getObjectPtr<ArraySegment>(last_segment_);
+    }
+    while (segment_num_ < seg_num) {
+        seg_ptr = appendSegment();
+        if (nullptr == seg_ptr) {
             return nullptr;
         }
-        new_ptr->setNo(seg_ptr->getNo()+1);
-        seg_ptr->setNext(id);
-        segment_num_++;
-        size_ += segment_size_;
-        seg_ptr = new_ptr;
     }
 
     return seg_ptr;
@@ -467,9 +559,11 @@ ArrayObject<T>::~ArrayObject() {
     ArraySegment *pre_ptr = seg_ptr;
     while (segment_num_--) {
         seg_ptr = pool->getObjectPtr<ArraySegment>(seg_ptr->getNext());
+        pool->freeArray<T>(pre_ptr->getArrayId(), segment_size_);
         pool->free(kObjectTypeArraySegment, pre_ptr);
         pre_ptr = seg_ptr;
     }
+    freeDirectory();
     initArrayObject();
 }
 
@@ -46,19 +46,6 @@ void Box::setBox(const Box *box) {
     ury_ = box->getURY();
 }
 
-Box &Box::operator=(const Box &box) {
-    llx_ = box.getLLX();
-    lly_ = box.getLLY();
-    urx_ = box.getURX();
-    ury_ = box.getURY();
-    return *this;
-}
-
-bool Box::operator==(const Box &box) {
-    return (llx_ == box.getLLX() && lly_ == box.getLLY() &&
-            urx_ == box.getURX() && ury_ == box.getURY());
-}
-
 void Box::maxBox(const Box &box) {
     if (llx_ == 0 && lly_ == 0 && urx_ == 0 && ury_ == 0) {
         llx_ = box.getLLX();
@@ -81,27 +68,4 @@ void Box::maxBox(const Box &box) {
     }
 }
 
-bool Box::isIntersect(const Box &box) const {
-    return (llx_ <= box.getURX() && lly_ <= box.getURY() &&
-            urx_ >= box.getLLX() && ury_ >= box.getLLY());
-}
-
-int Box::getWidth() {
-    int width = (getURX() - getLLX());
-    if (width >= 0) {
-        return width;
-    } else {
-        return -width;
-    }
-}
-
-int Box::getHeight() {
-    int height = (getURY() - getLLY());
-    if (height >= 0) {
-        return height;
-    } else {
-        return -height;
-    }
-}
-
 EDI_END_NAMESPACE
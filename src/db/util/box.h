@@ -10,17 +10,23 @@
  */
 #ifndef EDI_UTIL_BOX_H_
 #define EDI_UTIL_BOX_H_
+#include <type_traits>
+
 #include "db/core/object.h"
 #include "util/util.h"
 
 namespace open_edi {
 namespace db {
 
-class Box : public Object {
+/// @brief Rectangle by its lower left and upper right corners.
+///
+/// Box is a plain value of four ints, 16 bytes with no Object header, so
+/// it can be embedded in other objects, kept in vectors and copied with
+/// memcpy. A box that needs its own id is a BoxObject.
+class Box {
   public:
     Box();
     Box(int llx, int lly, int urx, int ury);
-    ~Box(){};
     bool isInvalid() const {return (llx_ >= lly_ || urx_ >= ury_); }
     int getLLX() const { return llx_; }
     int getLLY() const { return lly_; }
@@ -33,14 +39,31 @@ class Box : public Object {
     void setBox(int llx, int lly, int urx, int ury);
     void setBox(const Box &box);
     void setBox(const Box *box);
-    Box &operator=(const Box &box);
-    bool operator==(const Box &box);
+    bool operator==(const Box &box) const {
+        return (llx_ == box.llx_ && lly_ == box.lly_ && urx_ == box.urx_ &&
+                ury_ == box.ury_);
+    }
+    bool operator!=(const Box &box) const { return !(*this == box); }
 
-    bool isIntersect(const Box &box) const;
-    int getWidth();
-    int getHeight();
+    bool isIntersect(const Box &box) const {
+        return (llx_ <= box.urx_ && lly_ <= box.ury_ && urx_ >= box.llx_ &&
+                ury_ >= box.lly_);
+    }
+    int getWidth() const { return urx_ >= llx_ ? urx_ - llx_ : llx_ - urx_; }
+    int getHeight() const { return ury_ >= lly_ ? ury_ - lly_ : lly_ - ury_; }
     void maxBox(const Box &box);
 
+    /// @brief conversion to and from the boxes of src/geo, or any box
+    /// type built from (xl, yl, xh, yh) with xl()/yl()/xh()/yh() getters.
+    template <class GeoBox>
+    GeoBox toGeo() const {
+        return GeoBox(llx_, lly_, urx_, ury_);
+    }
+    template <class GeoBox>
+    static Box fromGeo(const GeoBox &box) {
+        return Box(box.xl(), box.yl(), box.xh(), box.yh());
+    }
+
   private:
     int llx_;
     int lly_;
@@ -48,6 +71,24 @@ class Box : public Object {
     int ury_;
 };
 
+static_assert(sizeof(Box) == 4 * sizeof(int), "Box must stay 16 bytes");
+static_assert(std::is_trivially_copyable<Box>::value,
+              "Box must stay trivially copyable");
+
+/// @brief Box with an id, for the boxes persisted on their own, e.g.
+/// the boxes of a Constraint.
+class BoxObject : public Object, public Box {
+  public:
+    BoxObject() : Object(), Box() {}
+    BoxObject(int llx, int lly, int urx, int ury)
+        : Object(), Box(llx, lly, urx, ury) {}
+    ~BoxObject() {}
+    BoxObject &operator=(const Box &box) {
+        setBox(box);
+        return *this;
+    }
+};
+
 }  // namespace db
 }  // namespace open_edi
 
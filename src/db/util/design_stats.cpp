@@ -0,0 +1,115 @@
+/**
+ * @file  design_stats.cpp
+ * @date  Oct 2020
+ * @brief Whole design statistics gathered by a parallel traversal.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "db/util/design_stats.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "db/core/db.h"
+#include "util/thread_pool.h"
+
+namespace open_edi {
+namespace db {
+
+/// objects summed by one task, chunks are the same for any thread count.
+static const int64_t kObjectsPerChunk = 4096;
+
+void DesignStats::merge(const DesignStats &rhs) {
+    num_insts += rhs.num_insts;
+    num_placed_insts += rhs.num_placed_insts;
+    inst_area += rhs.inst_area;
+    num_nets += rhs.num_nets;
+    num_net_pins += rhs.num_net_pins;
+    max_fanout = std::max(max_fanout, rhs.max_fanout);
+    hpwl += rhs.hpwl;
+    num_special_nets += rhs.num_special_nets;
+}
+
+bool DesignStats::operator==(const DesignStats &rhs) const {
+    return num_insts == rhs.num_insts &&
+           num_placed_insts == rhs.num_placed_insts &&
+           inst_area == rhs.inst_area && num_nets == rhs.num_nets &&
+           num_net_pins == rhs.num_net_pins && max_fanout == rhs.max_fanout &&
+           hpwl == rhs.hpwl && num_special_nets == rhs.num_special_nets;
+}
+
+static bool isPlaced(PlaceStatus status) {
+    return status == PlaceStatus::kPlaced || status == PlaceStatus::kFixed ||
+           status == PlaceStatus::kLocked || status == PlaceStatus::kCover;
+}
+
+static void addInst(Inst *inst, DesignStats *stats) {
+    if (inst == nullptr) return;
+    ++stats->num_insts;
+    if (isPlaced(inst->getStatus())) ++stats->num_placed_insts;
+    Box box = inst->getBox();
+    stats->inst_area += static_cast<int64_t>(box.getWidth()) * box.getHeight();
+}
+
+static void addNet(Net *net, DesignStats *stats) {
+    if (net == nullptr) return;
+    ++stats->num_nets;
+    int64_t num_pins = 0;
+    int64_t llx = std::numeric_limits<int64_t>::max();
+    int64_t lly = llx;
+    int64_t urx = std::numeric_limits<int64_t>::min();
+    int64_t ury = urx;
+    for (Pin *pin : net->pins()) {
+        if (pin == nullptr) continue;
+        ++num_pins;
+        Inst *inst = pin->getInst();
+        if (inst == nullptr) continue;
+        Box box = inst->getBox();
+        int64_t x = (static_cast<int64_t>(box.getLLX()) + box.getURX()) / 2;
+        int64_t y = (static_cast<int64_t>(box.getLLY()) + box.getURY()) / 2;
+        llx = std::min(llx, x);
+        lly = std::min(lly, y);
+        urx = std::max(urx, x);
+        ury = std::max(ury, y);
+    }
+    stats->num_net_pins += num_pins;
+    stats->max_fanout = std::max(stats->max_fanout, num_pins);
+    if (urx >= llx) stats->hpwl += (urx - llx) + (ury - lly);
+}
+
+/// @brief sum add over range in fixed chunks, one partial per chunk
+template <class T>
+static void sumChunks(const ObjectRange<T> &range,
+                      void (*add)(T *, DesignStats *), DesignStats *stats) {
+    int64_t num = range.size();
+    int64_t num_chunks = (num + kObjectsPerChunk - 1) / kObjectsPerChunk;
+    std::vector<DesignStats> partials(num_chunks);
+    util::parallelFor(0, num_chunks, [&](int64_t begin, int64_t end) {
+        for (int64_t chunk = begin; chunk < end; ++chunk) {
+            int64_t first = chunk * kObjectsPerChunk;
+            int64_t last = std::min(num, first + kObjectsPerChunk);
+            for (int64_t i = first; i < last; ++i)
+                add(range[i], &partials[chunk]);
+        }
+    }, 1);
+    for (const DesignStats &partial : partials) stats->merge(partial);
+}
+
+bool getDesignStats(Cell *cell, DesignStats *stats) {
+    if (cell == nullptr || stats == nullptr) return false;
+    *stats = DesignStats();
+    FrozenDBScope frozen;
+    sumChunks(cell->insts(), addInst, stats);
+    sumChunks(cell->nets(), addNet, stats);
+    stats->num_special_nets = cell->specialNets().size();
+    return true;
+}
+
+}  // namespace db
+}  // namespace open_edi
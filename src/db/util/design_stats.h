@@ -0,0 +1,53 @@
+/**
+ * @file  design_stats.h
+ * @date  Oct 2020
+ * @brief Whole design statistics gathered by a parallel traversal.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef SRC_DB_UTIL_DESIGN_STATS_H_
+#define SRC_DB_UTIL_DESIGN_STATS_H_
+
+#include <stdint.h>
+
+namespace open_edi {
+namespace db {
+
+class Cell;
+
+/// @brief Counts and sums over the instances and nets of a cell.
+///
+/// Areas and wire lengths are in database units. The half perimeter wire
+/// length of a net spans the centers of the instances its pins are on.
+struct DesignStats {
+    int64_t num_insts = 0;
+    int64_t num_placed_insts = 0;  ///< placed, fixed, locked or covered
+    int64_t inst_area = 0;
+    int64_t num_nets = 0;
+    int64_t num_net_pins = 0;
+    int64_t max_fanout = 0;  ///< most pins on one net
+    int64_t hpwl = 0;
+    int64_t num_special_nets = 0;
+
+    void merge(const DesignStats &rhs);
+    bool operator==(const DesignStats &rhs) const;
+};
+
+/// @brief gather the statistics of cell on the shared thread pool
+///
+/// The database is frozen while it runs, see freezeDB(). Each chunk of
+/// objects is summed on its own, so the result doesn't depend on the
+/// number of threads.
+///
+/// @return false if cell is null
+bool getDesignStats(Cell *cell, DesignStats *stats);
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // SRC_DB_UTIL_DESIGN_STATS_H_
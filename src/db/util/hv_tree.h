@@ -73,6 +73,10 @@ Box getObjBox(T *obj) {
   return Box(0, 0, 0, 0);
 }
 
+// Box has no Object header, it is its own box.
+inline Box getObjBox(Box *box) { return *box; }
+inline Box getObjBox(BoxObject *box) { return *box; }
+
 template <typename T>
 class HVCutNode {
  public:
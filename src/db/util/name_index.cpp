@@ -0,0 +1,110 @@
+/**
+ * @file  name_index.cpp
+ * @date  Oct 2020
+ * @brief Open addressing map from symbol index to object id.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "db/util/name_index.h"
+
+namespace open_edi {
+namespace db {
+
+static const uint64_t kNameIndexInitCapacity = 64;
+
+NameIndex::NameIndex() : size_(0), mask_(0), shift_(64), built_(false) {}
+
+NameIndex::NameIndex(const NameIndex &rhs)
+    : entries_(rhs.entries_), size_(rhs.size_), mask_(rhs.mask_),
+      shift_(rhs.shift_), built_(rhs.isBuilt()) {}
+
+NameIndex &NameIndex::operator=(const NameIndex &rhs) {
+    if (this != &rhs) {
+        entries_ = rhs.entries_;
+        size_ = rhs.size_;
+        mask_ = rhs.mask_;
+        shift_ = rhs.shift_;
+        setBuilt(rhs.isBuilt());
+    }
+    return *this;
+}
+
+/// @brief insert
+///
+/// @param key
+/// @param value
+void NameIndex::insert(SymbolIndex key, ObjectId value) {
+    if (key == 0) return;
+    // keep the load factor under 1/2
+    if ((size_ + 1) * 2 > entries_.size()) {
+        __rehash(entries_.empty() ? kNameIndexInitCapacity
+                                  : entries_.size() * 2);
+    }
+    for (uint64_t slot = __hash(key);; slot = (slot + 1) & mask_) {
+        Entry &entry = entries_[slot];
+        if (entry.key == key) return;
+        if (entry.key == 0) {
+            entry.key = key;
+            entry.value = value;
+            ++size_;
+            return;
+        }
+    }
+}
+
+/// @brief erase
+///
+/// @param key
+void NameIndex::erase(SymbolIndex key) {
+    if (size_ == 0 || key == 0) return;
+    uint64_t slot = __hash(key);
+    while (entries_[slot].key != key) {
+        if (entries_[slot].key == 0) return;
+        slot = (slot + 1) & mask_;
+    }
+    // move back entries whose probe sequence passes the hole
+    uint64_t hole = slot;
+    for (slot = (hole + 1) & mask_; entries_[slot].key != 0;
+         slot = (slot + 1) & mask_) {
+        uint64_t home = __hash(entries_[slot].key);
+        if (((slot - home) & mask_) >= ((slot - hole) & mask_)) {
+            entries_[hole] = entries_[slot];
+            hole = slot;
+        }
+    }
+    entries_[hole] = Entry{0, 0};
+    --size_;
+}
+
+/// @brief clear
+void NameIndex::clear() {
+    entries_.clear();
+    size_ = 0;
+    mask_ = 0;
+    shift_ = 64;
+    built_ = false;
+}
+
+/// @brief __rehash
+///
+/// @param capacity power of two
+void NameIndex::__rehash(uint64_t capacity) {
+    std::vector<Entry> old;
+    old.swap(entries_);
+    entries_.assign(capacity, Entry{0, 0});
+    mask_ = capacity - 1;
+    shift_ = 64;
+    for (uint64_t c = capacity; c > 1; c >>= 1) --shift_;
+    size_ = 0;
+    for (auto &entry : old) {
+        if (entry.key != 0) insert(entry.key, entry.value);
+    }
+}
+
+}  // namespace db
+}  // namespace open_edi
@@ -0,0 +1,78 @@
+/**
+ * @file  name_index.h
+ * @date  Oct 2020
+ * @brief Open addressing map from symbol index to object id.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef SRC_DB_UTIL_NAME_INDEX_H_
+#define SRC_DB_UTIL_NAME_INDEX_H_
+
+#include <atomic>
+#include <vector>
+
+#include "util/util.h"
+
+namespace open_edi {
+namespace db {
+
+using ObjectId = open_edi::util::ObjectId;
+using SymbolIndex = open_edi::util::SymbolIndex;
+
+/// @brief Name lookup of one object type in a cell.
+///
+/// Linear probing over a power-of-two table, symbol index 0 marks an empty
+/// slot. Erase shifts the following entries back, so there are no
+/// tombstones and find never allocates.
+class NameIndex {
+  public:
+    NameIndex();
+    NameIndex(const NameIndex &rhs);
+    NameIndex &operator=(const NameIndex &rhs);
+
+    /// @brief built is published last, readers seeing it see the entries
+    bool     isBuilt() const { return built_.load(std::memory_order_acquire); }
+    void     setBuilt(bool v) { built_.store(v, std::memory_order_release); }
+    uint64_t getSize() const { return size_; }
+
+    /// @brief keep the existing object if the name is taken
+    void     insert(SymbolIndex key, ObjectId value);
+    void     erase(SymbolIndex key);
+    /// @brief return 0 if not found
+    ObjectId find(SymbolIndex key) const {
+        if (size_ == 0) return 0;
+        for (uint64_t slot = __hash(key);; slot = (slot + 1) & mask_) {
+            const Entry &entry = entries_[slot];
+            if (entry.key == key) return entry.value;
+            if (entry.key == 0) return 0;
+        }
+    }
+    void     clear();
+
+  private:
+    struct Entry {
+        SymbolIndex key;
+        ObjectId value;
+    };
+
+    uint64_t __hash(SymbolIndex key) const {
+        return (key * 0x9e3779b97f4a7c15ULL) >> shift_;
+    }
+    void     __rehash(uint64_t capacity);
+
+    std::vector<Entry> entries_;
+    uint64_t size_;
+    uint64_t mask_;
+    uint32_t shift_;
+    std::atomic<bool> built_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // SRC_DB_UTIL_NAME_INDEX_H_
@@ -0,0 +1,123 @@
+/**
+ * @file  object_range.h
+ * @date  10/17/2020
+ * @brief Typed ranges over the object ids listed by an ArrayObject.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef SRC_DB_UTIL_OBJECT_RANGE_H_
+#define SRC_DB_UTIL_OBJECT_RANGE_H_
+
+#include "db/util/array.h"
+
+namespace open_edi {
+namespace db {
+
+/// @brief Objects of type T listed by an ArrayObject<ObjectId>, e.g.
+/// Cell::insts() or Net::pins():
+///
+///     for (Inst *inst : cell->insts()) { ... }
+///
+/// Iterators walk the id segments of the array directly and prefetch the
+/// objects a few ids ahead; they are plain values, so loops don't
+/// allocate. Ids that don't resolve yield nullptr. The array must not
+/// change while it is being walked.
+template <class T>
+class ObjectRange {
+  public:
+    class iterator {
+      public:
+        iterator() : array_(nullptr), index_(0), size_(0), id_(nullptr),
+                     segment_end_(nullptr) {}
+        iterator(const ArrayObject<ObjectId> *array, int64_t index,
+                 int64_t size)
+            : array_(array), index_(index), size_(size), id_(nullptr),
+              segment_end_(nullptr) {
+            __loadSegment();
+        }
+
+        T *operator*() const { return Object::addr<T>(*id_); }
+        /// @brief id of the current object
+        ObjectId getId() const { return *id_; }
+
+        iterator &operator++() {
+            ++index_;
+            if (++id_ == segment_end_) {
+                __loadSegment();
+            } else {
+                __prefetch();
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator tmp_iter = *this;
+            ++(*this);
+            return tmp_iter;
+        }
+
+        bool operator==(const iterator &iter) const {
+            return index_ == iter.index_;
+        }
+        bool operator!=(const iterator &iter) const {
+            return index_ != iter.index_;
+        }
+
+      private:
+        static const int kPrefetchDistance = 4;
+
+        /// @brief point to the segment holding index_, up to size_.
+        void __loadSegment() {
+            if (index_ >= size_) return;
+            int64_t segment_size = array_->getSegmentSize();
+            int64_t end = (index_ / segment_size + 1) * segment_size;
+            if (end > size_) end = size_;
+            id_ = &(*array_)[index_];
+            segment_end_ = id_ + (end - index_);
+            for (int i = 1; i <= kPrefetchDistance; ++i) {
+                if (id_ + i >= segment_end_) break;
+                __builtin_prefetch(Object::addr<T>(id_[i]));
+            }
+        }
+        /// @brief prefetch the object kPrefetchDistance ids ahead, within
+        /// the current segment.
+        void __prefetch() const {
+            if (id_ + kPrefetchDistance < segment_end_) {
+                __builtin_prefetch(Object::addr<T>(id_[kPrefetchDistance]));
+            }
+        }
+
+        const ArrayObject<ObjectId> *array_;
+        int64_t index_;
+        int64_t size_;
+        const ObjectId *id_;           // current id
+        const ObjectId *segment_end_;  // end of the current segment
+    };
+
+    ObjectRange() : array_(nullptr), size_(0) {}
+    /// @brief range over array, empty if array is nullptr.
+    explicit ObjectRange(const ArrayObject<ObjectId> *array)
+        : array_(array), size_(array ? array->getSize() : 0) {}
+
+    iterator begin() const { return iterator(array_, 0, size_); }
+    iterator end() const { return iterator(array_, size_, size_); }
+    int64_t size() const { return size_; }
+    bool empty() const { return 0 == size_; }
+    /// @brief object at index, index must be below size().
+    T *operator[](int64_t index) const {
+        return Object::addr<T>((*array_)[index]);
+    }
+
+  private:
+    const ArrayObject<ObjectId> *array_;
+    int64_t size_;
+};
+
+}  // namespace db
+}  // namespace open_edi
+
+#endif  // SRC_DB_UTIL_OBJECT_RANGE_H_
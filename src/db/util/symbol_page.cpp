@@ -191,7 +191,8 @@ void SymbolPage::writeToFile(std::ofstream &outfile, bool debug)
 {
     // symbols count + (symbol_index + symbol_name_length + symbol_name + reference count + reference id array)
     int32_t real_size = 0;
-    int32_t size = this->size();
+    // slots are not necessarily filled in order, scan all of them.
+    int32_t size = SYMTBL_ARRAY_SIZE;
     for (int32_t i = 0; i < size; ++i) {
         if (getReferenceCount(i) == 0) {
             continue;
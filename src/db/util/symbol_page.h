@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <unordered_map>
 #include <array>
+#include <atomic>
 
 #include "util/util.h"
 
@@ -56,7 +57,7 @@ public:
   private:
     std::array<std::string, SYMTBL_ARRAY_SIZE> symbols_;
     std::array<std::vector<ObjectId>,SYMTBL_ARRAY_SIZE> references_;
-    uint32_t symbols_size_;
+    std::atomic<uint32_t> symbols_size_;  ///< slots may be filled concurrently
 };
 
 }  // namespace db 
@@ -21,10 +21,12 @@ using namespace open_edi::util;
 
 /// @brief SymbolTable 
 SymbolTable::SymbolTable(/* args */)
+    : page_count_(0), symbol_count_(0)
 {
-    symbol_count_ = 0;
-    symbol_pages_.push_back(new(SymbolPage));
-    page_count_ = 1;
+    for (auto &block : symbol_pages_) {
+        block.store(nullptr, std::memory_order_relaxed);
+    }
+    __getOrCreatePage(0);
 
     // Because the symbol index 0 cannot be used by any applications,
     // so a dummy symbol is created to occupy index 0.
@@ -34,64 +36,207 @@ SymbolTable::SymbolTable(/* args */)
 /// @brief ~SymbolTable 
 SymbolTable::~SymbolTable()
 {
-    for (auto &sp : symbol_pages_) {
-        delete sp;
-    }
-    symbol_pages_.clear();
+    __clear();
     non_reference_symbols_.clear();
-    hash_.clear();
+}
+
+/// @brief __clear release pages and hash slots
+void SymbolTable::__clear()
+{
+    for (auto &block : symbol_pages_) {
+        PageBlock *pages = block.exchange(nullptr);
+        if (pages == nullptr) continue;
+        for (auto &page : *pages) {
+            delete page.load();
+        }
+        delete pages;
+    }
+    for (auto &shard : shards_) {
+        delete shard.slots.exchange(nullptr);
+        shard.retired.clear();
+        shard.size = 0;
+    }
     symbol_count_ = 0;
     page_count_ = 0;
 }
 
-/// @brief isSymbolInTable 
+/// @brief __hash FNV-1a of the name
 ///
-/// @param name
+/// The top kNumShardBits bits select the shard, the low bits the slot.
+uint64_t SymbolTable::__hash(SymbolName name)
+{
+    uint64_t hash = 0xcbf29ce484222325UL;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3UL;
+    }
+    return hash;
+}
+
+/// @brief __getPage 
+///
+/// @return page or nullptr if it doesn't exist.
+SymbolPage *SymbolTable::__getPage(uint64_t page_num) const
+{
+    if (page_num >= kMaxSymbolPages) return nullptr;
+    PageBlock *pages = symbol_pages_[page_num >> kPageBlockBits].load(
+        std::memory_order_acquire);
+    if (pages == nullptr) return nullptr;
+    return (*pages)[page_num & (kPageBlockSize - 1)].load(
+        std::memory_order_acquire);
+}
+
+/// @brief __getOrCreatePage, pages may be created by several threads.
+SymbolPage *SymbolTable::__getOrCreatePage(uint64_t page_num)
+{
+    if (page_num >= kMaxSymbolPages) return nullptr;
+    std::atomic<PageBlock *> &block = symbol_pages_[page_num >> kPageBlockBits];
+    PageBlock *pages = block.load(std::memory_order_acquire);
+    if (pages == nullptr) {
+        PageBlock *new_pages = new PageBlock;
+        for (auto &page : *new_pages) {
+            page.store(nullptr, std::memory_order_relaxed);
+        }
+        if (block.compare_exchange_strong(pages, new_pages,
+                                          std::memory_order_acq_rel)) {
+            pages = new_pages;
+        } else {
+            delete new_pages;
+        }
+    }
+    std::atomic<SymbolPage *> &slot = (*pages)[page_num & (kPageBlockSize - 1)];
+    SymbolPage *page = slot.load(std::memory_order_acquire);
+    if (page != nullptr) return page;
+
+    SymbolPage *new_page = new SymbolPage;
+    if (slot.compare_exchange_strong(page, new_page,
+                                     std::memory_order_acq_rel)) {
+        uint64_t count = page_count_.load();
+        while (count < page_num + 1 &&
+               !page_count_.compare_exchange_weak(count, page_num + 1)) {
+        }
+        return new_page;
+    }
+    // another thread won.
+    delete new_page;
+    return page;
+}
+
+/// @brief __isSymbol whether symbol index has the given name
+bool SymbolTable::__isSymbol(SymbolIndex index, SymbolName name) const
+{
+    SymbolPage *page = __getPage(index / SYMTBL_ARRAY_SIZE);
+    if (page == nullptr) return false;
+    const std::string &symbol = page->getSymbol(index % SYMTBL_ARRAY_SIZE);
+    return symbol.size() == name.size() &&
+           symbol.compare(0, symbol.size(), name.data(), name.size()) == 0;
+}
+
+/// @brief __find probe slots for name
 ///
 /// @return symbol index upon success, otherwise 0.
-SymbolIndex SymbolTable::isSymbolInTable(std::string name)
+SymbolIndex SymbolTable::__find(const Slots *slots, uint64_t hash,
+                                SymbolName name) const
 {
-    std::unordered_map<std::string, SymbolIndex>::const_iterator
-        got = hash_.find(name);
-    return ((got != hash_.end()) ? got->second : kInvalidSymbolIndex);
+    if (slots == nullptr) return kInvalidSymbolIndex;
+    for (uint64_t pos = hash & slots->mask; ; pos = (pos + 1) & slots->mask) {
+        SymbolIndex index =
+            slots->indexes[pos].load(std::memory_order_acquire);
+        if (index == kInvalidSymbolIndex) return kInvalidSymbolIndex;
+        if (__isSymbol(index, name)) return index;
+    }
 }
 
-/// @brief getOrCreateSymbol 
+/// @brief __insert add index to a shard, the shard must be locked.
+void SymbolTable::__insert(Shard &shard, uint64_t hash, SymbolIndex index)
+{
+    Slots *slots = shard.slots.load(std::memory_order_relaxed);
+    // keep load factor under 1/2, readers may still probe the old slots.
+    if (slots == nullptr || (shard.size + 1) * 2 > slots->mask + 1) {
+        uint64_t capacity =
+            slots == nullptr ? kInitShardCapacity : (slots->mask + 1) * 2;
+        Slots *new_slots = new Slots(capacity);
+        if (slots != nullptr) {
+            for (auto &slot : slots->indexes) {
+                SymbolIndex old_index =
+                    slot.load(std::memory_order_relaxed);
+                if (old_index == kInvalidSymbolIndex) continue;
+                std::string &symbol = getSymbolByIndex(old_index);
+                uint64_t pos = __hash(symbol) & new_slots->mask;
+                while (new_slots->indexes[pos].load(
+                           std::memory_order_relaxed) != kInvalidSymbolIndex) {
+                    pos = (pos + 1) & new_slots->mask;
+                }
+                new_slots->indexes[pos].store(old_index,
+                                              std::memory_order_relaxed);
+            }
+            shard.retired.emplace_back(slots);
+        }
+        shard.slots.store(new_slots, std::memory_order_release);
+        slots = new_slots;
+    }
+    uint64_t pos = hash & slots->mask;
+    while (slots->indexes[pos].load(std::memory_order_relaxed) !=
+           kInvalidSymbolIndex) {
+        pos = (pos + 1) & slots->mask;
+    }
+    slots->indexes[pos].store(index, std::memory_order_release);
+    ++shard.size;
+}
+
+/// @brief isSymbolInTable, lock free.
 ///
 /// @param name
-/// @param no_check
+///
+/// @return symbol index upon success, otherwise 0. Never inserts.
+SymbolIndex SymbolTable::isSymbolInTable(SymbolName name) const
+{
+    uint64_t hash = __hash(name);
+    const Shard &shard = shards_[hash >> (64 - kNumShardBits)];
+    return __find(shard.slots.load(std::memory_order_acquire), hash, name);
+}
+
+/// @brief getOrCreateSymbol, may be called by several threads.
+///
+/// @param name
+/// @param check, when false a new symbol is always created.
 ///
 /// @return SymbolIndex, 0 upon failure.
-SymbolIndex SymbolTable::getOrCreateSymbol(const char *name, bool check)
+SymbolIndex SymbolTable::getOrCreateSymbol(SymbolName name, bool check)
 {
-    int32_t array_index = 0;
     SymbolIndex symbol_index = kInvalidSymbolIndex;
+    uint64_t hash = __hash(name);
+    Shard &shard = shards_[hash >> (64 - kNumShardBits)];
 
     if (check) {
-        symbol_index = isSymbolInTable(name);
+        symbol_index = __find(shard.slots.load(std::memory_order_acquire),
+                              hash, name);
         if (symbol_index != kInvalidSymbolIndex) {
             return symbol_index;
         }
     }
 
-    int current_page = symbol_pages_.size()-1;
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    SymbolIndex found = __find(shard.slots.load(std::memory_order_relaxed),
+                               hash, name);
+    if (check && found != kInvalidSymbolIndex) {
+        // created by another thread meanwhile.
+        return found;
+    }
 
-    if (current_page < 0) {
+    symbol_index = symbol_count_.fetch_add(1);
+    SymbolPage *page = __getOrCreatePage(symbol_index / SYMTBL_ARRAY_SIZE);
+    if (page == nullptr) {
         message->issueMsg(kError, "There are not symbol pages.\n");
-        return symbol_index;
+        return kInvalidSymbolIndex;
     }
-
-    if (symbol_pages_[current_page]->size() == SYMTBL_ARRAY_SIZE) {
-        symbol_pages_.push_back(new(SymbolPage));
-        page_count_++;
-        current_page++;
+    std::string symbol(name.data(), name.size());
+    page->addSymbol(symbol_index % SYMTBL_ARRAY_SIZE, symbol);
+    // like a map insert, the first symbol of a name stays in the hash.
+    if (found == kInvalidSymbolIndex) {
+        __insert(shard, hash, symbol_index);
     }
 
-    array_index = symbol_pages_[current_page]->addSymbol(name);
-    symbol_index = current_page*SYMTBL_ARRAY_SIZE + array_index;
-    hash_.insert({name,symbol_index});
-    symbol_count_++;
-
     return symbol_index;
 }
 
@@ -104,7 +249,7 @@ std::string &SymbolTable::getSymbolByIndex(SymbolIndex index)
 {
     static std::string kSymtblDft = std::string("");
 
-    if ((index<0) || (index>symbol_count_))
+    if ((index<0) || (index>=symbol_count_))
     {
         return kSymtblDft;
     }
@@ -112,7 +257,9 @@ std::string &SymbolTable::getSymbolByIndex(SymbolIndex index)
     int64_t page_num = index/SYMTBL_ARRAY_SIZE;
     int32_t array_num = index%SYMTBL_ARRAY_SIZE;
 
-    return symbol_pages_[page_num]->getSymbol(array_num);
+    SymbolPage *page = __getPage(page_num);
+    if (page == nullptr) return kSymtblDft;
+    return page->getSymbol(array_num);
 }
 
 /// @brief getSymbolCount 
@@ -132,13 +279,7 @@ uint64_t SymbolTable::getSymbolCount()
 bool SymbolTable::insertReference(const char *name, ObjectId owner)
 {
     SymbolIndex index = getOrCreateSymbol(name);
-    if (index == kInvalidSymbolIndex) return false;
-
-    int page_num = index/SYMTBL_ARRAY_SIZE;
-    int array_num = index%SYMTBL_ARRAY_SIZE;
-    symbol_pages_[page_num]->addSymbolReference(array_num, owner);
-
-    return 1;
+    return addReference(index, owner);
 }
 
 bool SymbolTable::addReference(SymbolIndex index, ObjectId owner)
@@ -147,8 +288,12 @@ bool SymbolTable::addReference(SymbolIndex index, ObjectId owner)
 
     int page_num = index/SYMTBL_ARRAY_SIZE;
     int array_num = index%SYMTBL_ARRAY_SIZE;
-    
-    symbol_pages_[page_num]->addSymbolReference(array_num, owner);
+    SymbolPage *page = __getPage(page_num);
+    if (page == nullptr) return false;
+
+    std::lock_guard<std::mutex> guard(
+        reference_locks_[index % kNumReferenceLocks]);
+    page->addSymbolReference(array_num, owner);
 
     return 1;
 }
@@ -161,17 +306,22 @@ bool SymbolTable::addReference(SymbolIndex index, ObjectId owner)
 /// @return 
 bool SymbolTable::removeReference(SymbolIndex symbol_index, ObjectId owner)
 {
-    if ((symbol_index == kInvalidSymbolIndex) || (symbol_index > symbol_count_))
+    if ((symbol_index == kInvalidSymbolIndex) ||
+        (symbol_index >= symbol_count_))
     {
         return false;
     }
 
     int64_t page_num = symbol_index/SYMTBL_ARRAY_SIZE;
     int32_t array_num = symbol_index%SYMTBL_ARRAY_SIZE;
+    SymbolPage *page = __getPage(page_num);
+    if (page == nullptr) return false;
 
-    bool removed = symbol_pages_[page_num]->removeSymbolReference(array_num, owner);
+    std::lock_guard<std::mutex> guard(
+        reference_locks_[symbol_index % kNumReferenceLocks]);
+    bool removed = page->removeSymbolReference(array_num, owner);
 
-    if (removed && symbol_pages_[page_num]->getReferenceCount(array_num) == 0) {
+    if (removed && page->getReferenceCount(array_num) == 0) {
         non_reference_symbols_.push_back(symbol_index);
     }
     
@@ -191,7 +341,7 @@ bool SymbolTable::eliminateReferences()
         page_num = i/SYMTBL_ARRAY_SIZE;
         array_num = i%SYMTBL_ARRAY_SIZE;
 
-        if (symbol_pages_[page_num]->getReferenceCount(array_num) == 0)
+        if (__getPage(page_num)->getReferenceCount(array_num) == 0)
             non_reference_symbols_.push_back(i);
     }
     return non_reference_symbols_.size();
@@ -202,7 +352,7 @@ std::vector<ObjectId> &SymbolTable::getReferences(SymbolIndex index)
     ediAssert(index != kInvalidSymbolIndex); 
     int page_num = index/SYMTBL_ARRAY_SIZE;
     int array_num = index%SYMTBL_ARRAY_SIZE;
-    return symbol_pages_[page_num]->getReferences(array_num);
+    return __getPage(page_num)->getReferences(array_num);
 }
 /// @brief  
 ///
@@ -213,12 +363,14 @@ void SymbolTable::writeToFile(std::ofstream & outfile, bool debug)
         return;
     }
     //1. symbol pages count + symbols count
-    outfile.write((char *) &(page_count_), sizeof(uint64_t));
-    outfile.write((char *) &(symbol_count_), sizeof(uint64_t));
+    uint64_t page_count = page_count_;
+    uint64_t symbol_count = symbol_count_;
+    outfile.write((char *) &(page_count), sizeof(uint64_t));
+    outfile.write((char *) &(symbol_count), sizeof(uint64_t));
 
     //2. write page one by one:
-    for (auto &sp : symbol_pages_) {
-      sp->writeToFile(outfile, debug);
+    for (uint64_t i = 0; i < page_count; ++i) {
+      __getPage(i)->writeToFile(outfile, debug);
     }
 }
 
@@ -231,27 +383,39 @@ void SymbolTable::readFromFile(std::ifstream & infile, bool debug)
         return;
     }
     //1. symbol pages count + symbols count
-    infile.read((char *) &(page_count_), sizeof(uint64_t));
-    infile.read((char *) &(symbol_count_), sizeof(uint64_t));
+    uint64_t page_count = 0;
+    uint64_t symbol_count = 0;
+    infile.read((char *) &(page_count), sizeof(uint64_t));
+    infile.read((char *) &(symbol_count), sizeof(uint64_t));
+    if (page_count > kMaxSymbolPages) {
+        message->issueMsg(kError, "Too many symbol pages %lu.\n", page_count);
+        return;
+    }
     //2. fill page info:
-    for (int32_t i = 0; i < page_count_; ++i) {
-        if (i != 0) {
-            SymbolPage * symbol_page = new SymbolPage;
-            symbol_page->readFromFile(infile, debug);
-            symbol_pages_.push_back(symbol_page);
-        } else {
-            //during initialization, one page has been allocated.
-            SymbolPage * symbol_page = symbol_pages_[0]; 
-            symbol_page->readFromFile(infile, debug);
-        }
+    //during initialization, one page has been allocated.
+    for (uint64_t i = 0; i < page_count; ++i) {
+        __getOrCreatePage(i)->readFromFile(infile, debug);
     }
-    //3. fill hash info:
-    for (int32_t i = 0; i < page_count_; ++i) { //i is page idx
-        SymbolPage * symbol_page = symbol_pages_[i];
-        for (int32_t j = 0; j < symbol_page->size(); ++j) { //j is array idx
-            std::string &symbol_name = symbol_page->getSymbol(j);
+    symbol_count_ = symbol_count;
+    //3. fill hash info, only referenced symbols are saved:
+    for (auto &shard : shards_) {
+        delete shard.slots.exchange(nullptr);
+        shard.retired.clear();
+        shard.size = 0;
+    }
+    for (uint64_t i = 0; i < page_count; ++i) { //i is page idx
+        SymbolPage * symbol_page = __getPage(i);
+        for (int32_t j = 0; j < SYMTBL_ARRAY_SIZE; ++j) { //j is array idx
             uint64_t symbol_index = i*SYMTBL_ARRAY_SIZE + j;
-            hash_.insert({symbol_name.c_str(),symbol_index});
+            if (symbol_index >= symbol_count) break;
+            std::string &symbol_name = symbol_page->getSymbol(j);
+            if (symbol_name.empty()) continue;
+            uint64_t hash = __hash(symbol_name);
+            Shard &shard = shards_[hash >> (64 - kNumShardBits)];
+            if (__find(shard.slots.load(), hash, symbol_name) ==
+                kInvalidSymbolIndex) {
+                __insert(shard, hash, symbol_index);
+            }
         }
     }    
 }
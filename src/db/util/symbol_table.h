@@ -15,11 +15,15 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include <boost/utility/string_ref.hpp>
+
 #include "db/util/symbol_page.h"
 #include "util/util.h"
 #include "db/core/object.h"
@@ -32,12 +36,27 @@ using MemPool = open_edi::util::MemPool;
 
 const uint64_t kInvalidSymbolIndex = 0;
 
+/// @brief non-owning name used for lookups, e.g. straight from a parser
+/// buffer, so that no std::string temporary is needed.
+using SymbolName = boost::string_ref;
+
+/// @brief Symbol table shared by the objects of a hierarchical cell.
+///
+/// Symbols are looked up through a hash split into kNumShards shards.
+/// Lookups (isSymbolInTable, getSymbolByIndex) never take a lock; inserts
+/// lock only the shard the name falls in, so several threads may create
+/// symbols at the same time. Adding references to one symbol from several
+/// threads is serialized as well, reading the references of a symbol
+/// while they are being added is not.
 class SymbolTable {
   public:
     template <class T>
     T *getObjectByTypeAndName(ObjectType type, std::string &name);
-    SymbolIndex isSymbolInTable(std::string name);
-    SymbolIndex getOrCreateSymbol(const char *name, bool check = true);
+    SymbolIndex isSymbolInTable(SymbolName name) const;
+    SymbolIndex getOrCreateSymbol(SymbolName name, bool check = true);
+    SymbolIndex getOrCreateSymbol(const char *name, bool check = true) {
+        return getOrCreateSymbol(SymbolName(name), check);
+    }
 
     std::string &getSymbolByIndex(SymbolIndex index);
     uint64_t getSymbolCount();
@@ -54,10 +73,12 @@ class SymbolTable {
     void writeToFile(std::ofstream &outfile, bool debug = false);
     void readFromFile(std::ifstream &infile, bool debug = false);
 
+    /// @brief walks the references of a symbol in place, without
+    /// copying them; references must not change during the walk.
     template <typename T>
     class referenceIterator {
       public:
-        referenceIterator() {};
+        referenceIterator() : iter_(nullptr), end_(nullptr) {};
 
         referenceIterator& operator++() {
             ++iter_;
@@ -70,42 +91,84 @@ class SymbolTable {
             return tmp;
         };
 
+        /// @brief current object, skipping invalid ones.
         T* operator*() {
-            T* o = MemPool::getObjectPtr<T>(*iter_);
-            if (o && o->getIsValid()) return o;
-
-            while (iter_ != vec_.end()) {
-                iter_++;
-                o = MemPool::getObjectPtr<T>(*iter_);
+            while (iter_ < end_) {
+                T* o = Object::addr<T>(*iter_);
                 if (o && o->getIsValid()) return o;
+                ++iter_;
             }
             return nullptr;
         };
 
         referenceIterator& begin(SymbolTable *table, SymbolIndex &index) {
-            vec_ = table->getReferences(index);
-            iter_ = vec_.begin();
+            iter_ = end_ = nullptr;
+            if (index != kInvalidSymbolIndex) {
+                const std::vector<ObjectId> &references =
+                    table->getReferences(index);
+                iter_ = references.data();
+                end_ = iter_ + references.size();
+            }
             return *this;
         }
 
         referenceIterator& begin(SymbolTable *table, std::string &symbol) {
-            SymbolIndex index = table->getOrCreateSymbol(symbol.c_str());
+            SymbolIndex index = table->isSymbolInTable(symbol);
             return begin(table, index);
         }
 
-        bool end() {return (vec_.empty() || iter_ == vec_.end());}
+        bool end() {return iter_ >= end_;}
 
       private:
-        std::vector<ObjectId> vec_;
-        std::vector<ObjectId>::iterator iter_;
+        const ObjectId *iter_;
+        const ObjectId *end_;
     };
 
   private:
-    std::vector<SymbolPage *> symbol_pages_;
+    /// @brief open addressing slots holding symbol indexes, 0 means empty.
+    ///
+    /// A full array is replaced by a larger one instead of being resized in
+    /// place, so that readers holding the old one can finish their probe.
+    struct Slots {
+        explicit Slots(uint64_t capacity) : mask(capacity - 1),
+                                            indexes(capacity) {}
+        uint64_t mask;
+        std::vector<std::atomic<SymbolIndex>> indexes;
+    };
+    struct Shard {
+        Shard() : slots(nullptr), size(0) {}
+        std::mutex mutex;  ///< taken by writers only
+        std::atomic<Slots *> slots;
+        uint64_t size;
+        /// replaced arrays, kept until the table goes away.
+        std::vector<std::unique_ptr<Slots>> retired;
+    };
+
+    static const uint64_t kNumShardBits = 6;
+    static const uint64_t kNumShards = 1UL << kNumShardBits;
+    static const uint64_t kInitShardCapacity = 64;
+    static const uint64_t kPageBlockBits = 8;
+    static const uint64_t kPageBlockSize = 1UL << kPageBlockBits;
+    static const uint64_t kMaxSymbolPages = kPageBlockSize * kPageBlockSize;
+    static const uint64_t kNumReferenceLocks = 64;
+
+    static uint64_t __hash(SymbolName name);
+    SymbolPage *__getPage(uint64_t page_num) const;
+    SymbolPage *__getOrCreatePage(uint64_t page_num);
+    bool __isSymbol(SymbolIndex index, SymbolName name) const;
+    SymbolIndex __find(const Slots *slots, uint64_t hash,
+                       SymbolName name) const;
+    void __insert(Shard &shard, uint64_t hash, SymbolIndex index);
+    void __clear();
+
+    using PageBlock = std::array<std::atomic<SymbolPage *>, kPageBlockSize>;
+    /// two level page directory, pages are never moved once created.
+    std::array<std::atomic<PageBlock *>, kPageBlockSize> symbol_pages_;
+    std::array<Shard, kNumShards> shards_;
+    std::array<std::mutex, kNumReferenceLocks> reference_locks_;
     std::vector<long> non_reference_symbols_;
-    std::unordered_map<std::string, SymbolIndex> hash_;
-    uint64_t page_count_;
-    uint64_t symbol_count_;
+    std::atomic<uint64_t> page_count_;
+    std::atomic<uint64_t> symbol_count_;
 };
 
 
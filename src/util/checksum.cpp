@@ -11,9 +11,33 @@
  */
 #include "util/checksum.h"
 
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
 namespace open_edi {
 namespace util {
 
+#ifndef __SSE4_2__
+static const uint32_t kCrc32cPoly = 0x82f63b78;  // reflected Castagnoli
+
+static const uint32_t *__crc32cTable() {
+    static uint32_t table[256];
+    static bool initialized = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (c >> 1) ^ kCrc32cPoly : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)initialized;
+    return table;
+}
+#endif
+
 // Class CheckSum
 uint16_t CheckSum::__from32to16(uint32_t x) {
     /* add up 16-bit and 16-bit for 16+c bit */
@@ -114,5 +138,30 @@ uint32_t CheckSum::summary(const unsigned char *buff, int len, bool debug) {
     return result;
 }
 
+uint32_t CheckSum::crc32c(const unsigned char *buff, uint64_t len,
+                          uint32_t crc) {
+    crc = ~crc;
+#ifdef __SSE4_2__
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        crc64 = _mm_crc32_u64(crc64, *(const uint64_t *)buff);
+        buff += 8;
+        len -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (len > 0) {
+        crc = _mm_crc32_u8(crc, *buff++);
+        --len;
+    }
+#else
+    const uint32_t *table = __crc32cTable();
+    while (len > 0) {
+        crc = table[(crc ^ *buff++) & 0xff] ^ (crc >> 8);
+        --len;
+    }
+#endif
+    return ~crc;
+}
+
 }  // namespace util
 }  // namespace open_edi
@@ -27,6 +27,9 @@ class CheckSum {
     uint32_t summary(const std::string & filename, int len, bool debug = false);
     uint32_t summary(const unsigned char *buff, int len, bool debug = false);
     bool check(uint32_t sum_value, uint32_t ref_value, bool debug = false);
+    /// @brief CRC32C (Castagnoli), crc of a previous block can be chained in.
+    static uint32_t crc32c(const unsigned char *buff, uint64_t len,
+                           uint32_t crc = 0);
 
   private:
     uint16_t __from32to16(uint32_t x);
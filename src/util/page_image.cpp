@@ -0,0 +1,295 @@
+/**
+ * @file  page_image.cpp
+ * @date  Oct 2020
+ * @brief Paged, per-page checksummed image of a MemPagePool on disk.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "util/page_image.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <functional>
+
+#include "util/checksum.h"
+#include "util/message.h"
+#include "util/thread_pool.h"
+
+namespace open_edi {
+namespace util {
+
+using namespace std;
+
+/// @brief run func(i) for i in [0, num) on the shared thread pool, a few
+/// tasks per thread
+static void __parallelFor(int num_threads, uint64_t num,
+                          const std::function<void(uint64_t)> &func) {
+    if (num_threads <= 1 || num <= 1) {
+        for (uint64_t i = 0; i < num; ++i) func(i);
+        return;
+    }
+    parallelFor(0, num, [&func](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) func(i);
+    }, (num + 4 * num_threads - 1) / (4 * num_threads));
+}
+
+/// @brief pread until len bytes are read
+static bool __preadAll(int fd, char *buff, uint64_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t n = pread(fd, buff, len, offset);
+        if (n <= 0) return false;
+        buff += n;
+        offset += n;
+        len -= n;
+    }
+    return true;
+}
+
+const uint32_t PageImage::kMagic;
+const uint32_t PageImage::kFormatVersion;
+const uint64_t PageImage::kPagesPerBatch;
+
+PageImage::PageImage(MemPagePool *pool)
+    : pool_(pool), compression_(kCompressionNone), num_threads_(1),
+      page_size_(pool->getPageSize()), index_pos_(0) {}
+
+/// @brief magic, version, compression, reserved, num_pages, page_size
+uint64_t PageImage::__indexSize() const {
+    return 4 * sizeof(uint32_t) + 2 * sizeof(uint64_t) +
+           entries_.size() * sizeof(PageEntry);
+}
+
+/// @brief compress a page into buffer
+///
+/// @return false if the page should be stored raw
+bool PageImage::__compressPage(uint64_t page_no, std::vector<char> &buffer) {
+    const char *frame = pool_->getPage(page_no)->getFrame();
+    uLongf len = compressBound(page_size_);
+    buffer.resize(len);
+    int ret = compress2((Bytef *)buffer.data(), &len, (const Bytef *)frame,
+                        page_size_, Z_BEST_SPEED);
+    if (ret != Z_OK || len >= page_size_) {
+        buffer.clear();
+        return false;
+    }
+    buffer.resize(len);
+    return true;
+}
+
+void PageImage::writeIndexToFile(std::ofstream &outfile, bool debug) {
+    entries_.assign(pool_->getNumPages(), PageEntry{0, 0, 0});
+    index_pos_ = outfile.tellp();
+
+    uint32_t magic = kMagic;
+    uint32_t version = kFormatVersion;
+    uint32_t compression = compression_;
+    uint32_t reserved = 0;
+    uint64_t num_pages = entries_.size();
+    outfile.write((char *)&magic, sizeof(uint32_t));
+    outfile.write((char *)&version, sizeof(uint32_t));
+    outfile.write((char *)&compression, sizeof(uint32_t));
+    outfile.write((char *)&reserved, sizeof(uint32_t));
+    outfile.write((char *)&num_pages, sizeof(uint64_t));
+    outfile.write((char *)&page_size_, sizeof(uint64_t));
+    outfile.write((char *)entries_.data(), entries_.size() * sizeof(PageEntry));
+    if (debug)
+        cout << "RWDBGINFO: write page index num_pages " << num_pages
+             << " compression " << compression << endl;
+}
+
+bool PageImage::writePagesToFile(std::ofstream &outfile, bool debug) {
+    uint64_t content_start = outfile.tellp();
+    uint64_t offset = 0;
+    uint64_t num_pages = entries_.size();
+    std::vector<std::vector<char>> buffers(kPagesPerBatch);
+
+    for (uint64_t first = 0; first < num_pages; first += kPagesPerBatch) {
+        uint64_t num = std::min(kPagesPerBatch, num_pages - first);
+        // compress & checksum the batch in parallel
+        __parallelFor(num_threads_, num, [&](uint64_t i) {
+            uint64_t page_no = first + i;
+            PageEntry &entry = entries_[page_no];
+            if (compression_ != kCompressionNone &&
+                __compressPage(page_no, buffers[i])) {
+                entry.stored_size = buffers[i].size();
+                entry.crc = CheckSum::crc32c(
+                    (const unsigned char *)buffers[i].data(),
+                    buffers[i].size());
+            } else {
+                buffers[i].clear();
+                entry.stored_size = page_size_;
+                entry.crc = CheckSum::crc32c(
+                    (const unsigned char *)pool_->getPage(page_no)->getFrame(),
+                    page_size_);
+            }
+        });
+        // then write it in order
+        for (uint64_t i = 0; i < num; ++i) {
+            uint64_t page_no = first + i;
+            PageEntry &entry = entries_[page_no];
+            entry.offset = offset;
+            if (buffers[i].empty()) {
+                outfile.write(pool_->getPage(page_no)->getFrame(), page_size_);
+            } else {
+                outfile.write(buffers[i].data(), buffers[i].size());
+            }
+            offset += entry.stored_size;
+        }
+    }
+    if (debug)
+        cout << "RWDBGINFO: write pages " << num_pages << " with size "
+             << offset << " starting from " << content_start << endl;
+
+    // fill in the index
+    std::streampos end_pos = outfile.tellp();
+    outfile.seekp(index_pos_ + std::streamoff(__indexSize() -
+                  entries_.size() * sizeof(PageEntry)));
+    outfile.write((char *)entries_.data(), entries_.size() * sizeof(PageEntry));
+    outfile.seekp(end_pos);
+    return outfile.good();
+}
+
+bool PageImage::hasIndex(std::ifstream &infile, uint64_t header_end) {
+    std::streampos pos = infile.tellg();
+    if (static_cast<uint64_t>(pos) + sizeof(uint32_t) > header_end) {
+        return false;
+    }
+    uint32_t magic = 0;
+    infile.read((char *)&magic, sizeof(uint32_t));
+    infile.seekg(pos);
+    return magic == kMagic;
+}
+
+bool PageImage::readIndexFromFile(std::ifstream &infile, bool debug) {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t compression = 0;
+    uint32_t reserved = 0;
+    uint64_t num_pages = 0;
+    uint64_t page_size = 0;
+    infile.read((char *)&magic, sizeof(uint32_t));
+    infile.read((char *)&version, sizeof(uint32_t));
+    infile.read((char *)&compression, sizeof(uint32_t));
+    infile.read((char *)&reserved, sizeof(uint32_t));
+    infile.read((char *)&num_pages, sizeof(uint64_t));
+    infile.read((char *)&page_size, sizeof(uint64_t));
+    if (debug)
+        cout << "RWDBGINFO: read page index num_pages " << num_pages
+             << " compression " << compression << endl;
+
+    if (magic != kMagic || version != kFormatVersion) {
+        message->issueMsg(kError, "Unknown page index version %u.\n",
+                          version);
+        return false;
+    }
+    compression_ = static_cast<Compression>(compression);
+    page_size_ = page_size;
+    entries_.resize(num_pages);
+    infile.read((char *)entries_.data(), num_pages * sizeof(PageEntry));
+    return infile.good();
+}
+
+bool PageImage::readPagesFromFile(const std::string &filename,
+                                  uint64_t content_offset, bool debug) {
+    // the index is read before the pool header, check they agree.
+    if (entries_.size() != pool_->getNumPages() ||
+        page_size_ != pool_->getPageSize()) {
+        message->issueMsg(kError, "Page index of %s does not match the pool "
+                                  "(%lu pages of %lu bytes).\n",
+                          filename.c_str(), entries_.size(), page_size_);
+        return false;
+    }
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        message->issueMsg(kError, "Failed to open file %s.\n",
+                          filename.c_str());
+        return false;
+    }
+
+    uint64_t num_pages = entries_.size();
+    std::vector<char> failed(num_pages, 0);
+    __parallelFor(num_threads_, num_pages, [&](uint64_t page_no) {
+        thread_local std::vector<char> buffer;
+        const PageEntry &entry = entries_[page_no];
+        char *frame = pool_->getPage(page_no)->getFrame();
+        uint64_t pos = content_offset + entry.offset;
+
+        if (entry.stored_size == page_size_) {
+            if (!__preadAll(fd, frame, page_size_, pos) ||
+                CheckSum::crc32c((const unsigned char *)frame, page_size_) !=
+                    entry.crc) {
+                failed[page_no] = 1;
+            }
+            return;
+        }
+        buffer.resize(entry.stored_size);
+        uLongf len = page_size_;
+        if (!__preadAll(fd, buffer.data(), entry.stored_size, pos) ||
+            CheckSum::crc32c((const unsigned char *)buffer.data(),
+                             entry.stored_size) != entry.crc ||
+            uncompress((Bytef *)frame, &len, (const Bytef *)buffer.data(),
+                       entry.stored_size) != Z_OK ||
+            len != page_size_) {
+            failed[page_no] = 1;
+        }
+    });
+    close(fd);
+
+    bool ok = true;
+    for (uint64_t page_no = 0; page_no < num_pages; ++page_no) {
+        if (failed[page_no]) {
+            message->issueMsg(kError, "Page %lu of %s is corrupted.\n",
+                              page_no, filename.c_str());
+            ok = false;
+        }
+    }
+    if (debug)
+        cout << "RWDBGINFO: read pages " << num_pages << " from "
+             << filename << endl;
+    return ok;
+}
+
+bool PageImage::verifyMappedPages(const char *content, uint64_t size,
+                                  const std::string &filename, bool check_crc,
+                                  bool debug) {
+    uint64_t num_pages = entries_.size();
+    std::vector<char> failed(num_pages, 0);
+    // bounds alone don't touch the mapping, a page past its end would
+    // fault on first access instead of being reported.
+    __parallelFor(check_crc ? num_threads_ : 1, num_pages,
+                  [&](uint64_t page_no) {
+        const PageEntry &entry = entries_[page_no];
+        if (entry.stored_size != page_size_ ||
+            entry.offset != page_no * page_size_ || entry.offset > size ||
+            page_size_ > size - entry.offset ||
+            (check_crc &&
+             CheckSum::crc32c((const unsigned char *)content + entry.offset,
+                              page_size_) != entry.crc)) {
+            failed[page_no] = 1;
+        }
+    });
+
+    bool ok = true;
+    for (uint64_t page_no = 0; page_no < num_pages; ++page_no) {
+        if (failed[page_no]) {
+            message->issueMsg(kError, "Page %lu of %s is corrupted.\n",
+                              page_no, filename.c_str());
+            ok = false;
+        }
+    }
+    if (debug)
+        cout << "RWDBGINFO: verify mapped pages " << num_pages << " of "
+             << filename << (check_crc ? " with" : " without")
+             << " checksums" << endl;
+    return ok;
+}
+
+}  // namespace util
+}  // namespace open_edi
@@ -0,0 +1,101 @@
+/**
+ * @file  page_image.h
+ * @date  Oct 2020
+ * @brief Paged, per-page checksummed image of a MemPagePool on disk.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef EDI_UTIL_PAGE_IMAGE_H_
+#define EDI_UTIL_PAGE_IMAGE_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "util/util_mem.h"
+
+namespace open_edi {
+namespace util {
+
+/// @brief Pool content stored as one chunk per MemPage.
+///
+/// The index is written ahead of the pool header and holds, for every
+/// page, the offset of its chunk relative to the start of content, the
+/// stored size and a CRC32C of the stored bytes. A chunk whose stored size
+/// equals the page size is raw, otherwise it is zlib compressed.
+/// Without compression chunks are laid out exactly like the raw pool
+/// content, so such files can still be mapped in place.
+///
+/// Chunks are compressed, checksummed and read back on several threads;
+/// a corrupted chunk is reported by page number.
+class PageImage {
+  public:
+    enum Compression {
+        kCompressionNone = 0,
+        kCompressionZlib = 1
+    };
+
+    explicit PageImage(MemPagePool *pool);
+
+    void        setCompression(Compression v) { compression_ = v; }
+    Compression getCompression() const { return compression_; }
+    void        setNumThreads(int v) { num_threads_ = v > 0 ? v : 1; }
+    int         getNumThreads() const { return num_threads_; }
+    /// @brief pages listed by the index read last
+    uint64_t    getNumPages() const { return entries_.size(); }
+
+    /// @brief write a placeholder index, filled in by writePagesToFile
+    void writeIndexToFile(std::ofstream &outfile, bool debug = false);
+    /// @brief write chunks starting at the current position
+    bool writePagesToFile(std::ofstream &outfile, bool debug = false);
+
+    /// @brief whether an index follows at the current position
+    static bool hasIndex(std::ifstream &infile, uint64_t header_end);
+    bool readIndexFromFile(std::ifstream &infile, bool debug = false);
+    /// @brief read chunks of a file whose content starts at content_offset
+    bool readPagesFromFile(const std::string &filename,
+                           uint64_t content_offset, bool debug = false);
+    /// @brief check the chunks of an uncompressed file mapped in place
+    ///
+    /// Each chunk must be raw, at the offset of its page in raw content
+    /// and within the mapping. Checksums are
+    /// only compared if check_crc is set: that reads every page at once,
+    /// which is what mapping the file avoids.
+    ///
+    /// @param content first byte of content in the mapping
+    /// @param size bytes of the mapping from content on
+    bool verifyMappedPages(const char *content, uint64_t size,
+                           const std::string &filename, bool check_crc,
+                           bool debug = false);
+
+  private:
+    struct PageEntry {
+        uint64_t offset;
+        uint32_t stored_size;
+        uint32_t crc;
+    };
+
+    static const uint32_t kMagic = 0x47504445;  // "EDPG"
+    static const uint32_t kFormatVersion = 1;
+    static const uint64_t kPagesPerBatch = 256;
+
+    uint64_t __indexSize() const;
+    bool     __compressPage(uint64_t page_no, std::vector<char> &buffer);
+
+    MemPagePool *pool_;
+    Compression compression_;
+    int num_threads_;
+    uint64_t page_size_;
+    std::streampos index_pos_;
+    std::vector<PageEntry> entries_;
+};
+
+}  // namespace util
+}  // namespace open_edi
+
+#endif
@@ -61,18 +61,6 @@ void Point::set(int x, int y) {
     y_ = y;
 }
 
-/**
- * @brief Point operator '='
- *
- * @param point
- * @return Point&
- */
-Point &Point::operator=(const Point &point) {
-    x_ = point.getX();
-    y_ = point.getY();
-    return *this;
-}
-
 /**
  * @brief Point operator '=='
  *
@@ -80,7 +68,7 @@ Point &Point::operator=(const Point &point) {
  * @return true
  * @return false
  */
-bool Point::operator==(const Point &point) { return (x_ == point.getX() && y_ == point.getY()); }
+bool Point::operator==(const Point &point) const { return (x_ == point.getX() && y_ == point.getY()); }
 
 }  // namespace util
 }  // namespace open_edi
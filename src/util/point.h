@@ -10,6 +10,8 @@
  */
 #ifndef EDI_UTIL_POINT_H_
 #define EDI_UTIL_POINT_H_
+#include <type_traits>
+
 #include "util/namespace.h"
 
 namespace open_edi {
@@ -28,14 +30,28 @@ class Point {
 
     void set(int x, int y);
 
-    Point &operator=(const Point &point);
-    bool operator==(const Point &point);
+    bool operator==(const Point &point) const;
+
+    /// @brief conversion to and from the points of src/geo, or any point
+    /// type built from (x, y) and indexed by dimension.
+    template <class GeoPoint>
+    GeoPoint toGeo() const {
+        return GeoPoint(x_, y_);
+    }
+    template <class GeoPoint>
+    static Point fromGeo(const GeoPoint &point) {
+        return Point(point[0], point[1]);
+    }
 
   private:
     int x_;
     int y_;
 };
 
+static_assert(sizeof(Point) == 2 * sizeof(int), "Point must stay 8 bytes");
+static_assert(std::is_trivially_copyable<Point>::value,
+              "Point must stay trivially copyable");
+
 }  // namespace util
 }  // namespace open_edi
 
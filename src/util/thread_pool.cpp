@@ -0,0 +1,250 @@
+/**
+ * @file  thread_pool.cpp
+ * @date  Oct 2020
+ * @brief Work stealing thread pool shared by parallel features.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "util/thread_pool.h"
+
+#include <algorithm>
+
+namespace open_edi {
+namespace util {
+
+thread_local ThreadPool *ThreadPool::current_pool_ = nullptr;
+thread_local int ThreadPool::current_index_ = -1;
+
+ThreadPool &ThreadPool::getInstance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool()
+    : started_(false), num_threads_(0), num_queued_(0), stop_(false) {}
+
+ThreadPool::~ThreadPool() { __stop(); }
+
+int ThreadPool::getNumThreads() {
+    __start();
+    return num_threads_;
+}
+
+bool ThreadPool::setNumThreads(int num_threads) {
+    if (current_pool_ == this) return false;
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    __stop();
+    num_threads_ = num_threads;
+    started_.store(false);
+    return true;
+}
+
+/// @brief __start the workers on first use
+void ThreadPool::__start() {
+    if (started_.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (started_.load(std::memory_order_relaxed)) return;
+    std::unique_lock<std::shared_timed_mutex> workers_lock(workers_mutex_);
+    if (num_threads_ <= 0) {
+        num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    stop_ = false;
+    for (int i = 0; i < num_threads_ - 1; ++i) {
+        workers_.emplace_back(new Worker);
+    }
+    for (int i = 0; i < num_threads_ - 1; ++i) {
+        workers_[i]->thread = std::thread(&ThreadPool::__work, this, i);
+    }
+    started_.store(true, std::memory_order_release);
+}
+
+/// @brief __stop the workers once the pending tasks are done
+void ThreadPool::__stop() {
+    // no thread outside the pool uses the workers while they go.
+    std::unique_lock<std::shared_timed_mutex> workers_lock(workers_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    workers_.clear();
+}
+
+/// Workers are only stopped once they are joined, so tasks use the
+/// workers without a lock. Other threads hold workers_mutex_ shared.
+void ThreadPool::post(std::function<void()> task) {
+    __start();
+    if (current_pool_ == this) {
+        Worker *worker = workers_[current_index_].get();
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->tasks.push_back(std::move(task));
+        }
+        ++num_queued_;
+        // take the lock, so a worker can't miss the wake up between
+        // checking the queued count and going to sleep.
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        wake_.notify_one();
+        return;
+    }
+    {
+        std::shared_lock<std::shared_timed_mutex> workers_lock(workers_mutex_);
+        if (!workers_.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(std::move(task));
+                ++num_queued_;
+            }
+            wake_.notify_one();
+            return;
+        }
+    }
+    task();
+}
+
+bool ThreadPool::runPendingTask() {
+    std::function<void()> task;
+    if (current_pool_ == this) {
+        if (!__popTask(current_index_, task)) return false;
+    } else {
+        std::shared_lock<std::shared_timed_mutex> workers_lock(workers_mutex_);
+        if (!__popTask(-1, task)) return false;
+    }
+    task();
+    return true;
+}
+
+/// @brief __popTask from the back of the own deque, the shared queue, or
+/// the front of another deque
+bool ThreadPool::__popTask(int index, std::function<void()> &task) {
+    if (num_queued_.load(std::memory_order_relaxed) <= 0) return false;
+    int num_workers = workers_.size();
+    if (index >= 0) {
+        Worker *worker = workers_[index].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (!worker->tasks.empty()) {
+            task = std::move(worker->tasks.back());
+            worker->tasks.pop_back();
+            --num_queued_;
+            return true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!queue_.empty()) {
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            --num_queued_;
+            return true;
+        }
+    }
+    for (int i = 1; i <= num_workers; ++i) {
+        int victim = (std::max(index, 0) + i) % num_workers;
+        if (victim == index) continue;
+        Worker *worker = workers_[victim].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (!worker->tasks.empty()) {
+            task = std::move(worker->tasks.front());
+            worker->tasks.pop_front();
+            --num_queued_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::__work(int index) {
+    current_pool_ = this;
+    current_index_ = index;
+    std::function<void()> task;
+    while (true) {
+        if (__popTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this]() { return stop_ || num_queued_ > 0; });
+        if (stop_ && num_queued_ <= 0) break;
+    }
+    current_pool_ = nullptr;
+    current_index_ = -1;
+}
+
+// TaskGroup
+TaskGroup::TaskGroup(ThreadPool &pool) : pool_(pool), num_pending_(0) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // already reported to the one calling wait(), if any.
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    ++num_pending_;
+    pool_.post([this, task]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        // the group may be gone as soon as the count drops and the lock
+        // is released.
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--num_pending_ == 0) done_.notify_all();
+    });
+}
+
+void TaskGroup::wait() {
+    while (num_pending_ > 0) {
+        if (pool_.runPendingTask()) continue;
+        // nothing is queued, so the pending tasks run elsewhere: the last
+        // one to finish wakes us up. Tasks they post are run by the
+        // threads posting them or by idle workers.
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return num_pending_ == 0; });
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void parallelFor(int64_t begin, int64_t end,
+                 const std::function<void(int64_t, int64_t)> &body,
+                 int64_t grain) {
+    if (begin >= end) return;
+    int64_t num = end - begin;
+    if (grain <= 0) {
+        int64_t num_threads = ThreadPool::getInstance().getNumThreads();
+        grain = std::max<int64_t>(1, (num + 4 * num_threads - 1) /
+                                         (4 * num_threads));
+    }
+    if (num <= grain) {
+        body(begin, end);
+        return;
+    }
+    TaskGroup group;
+    for (int64_t b = begin + grain; b < end; b += grain) {
+        int64_t e = std::min(end, b + grain);
+        group.run([&body, b, e]() { body(b, e); });
+    }
+    body(begin, std::min(end, begin + grain));
+    group.wait();
+}
+
+}  // namespace util
+}  // namespace open_edi
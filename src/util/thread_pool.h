@@ -0,0 +1,142 @@
+/**
+ * @file  thread_pool.h
+ * @date  Oct 2020
+ * @brief Work stealing thread pool shared by parallel features.
+ *
+ * Copyright (C) 2020 NIIC EDA
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef EDI_UTIL_THREAD_POOL_H_
+#define EDI_UTIL_THREAD_POOL_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace open_edi {
+namespace util {
+
+/// @brief Persistent pool of worker threads.
+///
+/// Each worker has a deque of its own: tasks posted by a worker go to the
+/// back of its deque and are run from the back, so nested work stays hot
+/// in its cache, while idle workers steal from the front of the others.
+/// Tasks posted from outside the pool go to a shared queue.
+///
+/// A pool of n threads runs n - 1 workers: the thread waiting for a
+/// TaskGroup or a parallelFor runs tasks as well. With a single thread,
+/// tasks run in the posting thread.
+class ThreadPool {
+  public:
+    /// @brief the pool shared by the application
+    static ThreadPool &getInstance();
+
+    /// @brief number of threads running tasks, the waiting one included
+    int getNumThreads();
+    /// @brief restart the workers, num_threads <= 0 means one per core
+    ///
+    /// @return false if called from a task of the pool
+    bool setNumThreads(int num_threads);
+
+    /// @brief run a task on the pool
+    void post(std::function<void()> task);
+    /// @brief run a task on the pool and get its result
+    template <class F>
+    std::future<typename std::result_of<F()>::type> submit(F &&func);
+    /// @brief run one pending task in the calling thread
+    ///
+    /// @return false if there was none
+    bool runPendingTask();
+
+  private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    ThreadPool();
+    ~ThreadPool();
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    void __start();
+    void __stop();
+    void __work(int index);
+    bool __popTask(int index, std::function<void()> &task);
+
+    static thread_local ThreadPool *current_pool_;
+    static thread_local int current_index_;
+
+    std::mutex config_mutex_;  // start/stop of the workers
+    std::atomic<bool> started_;
+    int num_threads_;
+
+    std::shared_timed_mutex workers_mutex_;  // workers_ outside the pool
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex mutex_;  // shared queue and sleeping workers
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> queue_;
+    std::atomic<int64_t> num_queued_;
+    bool stop_;
+};
+
+template <class F>
+std::future<typename std::result_of<F()>::type> ThreadPool::submit(
+    F &&func) {
+    using ResultType = typename std::result_of<F()>::type;
+    // std::function needs a copyable target.
+    auto task = std::make_shared<std::packaged_task<ResultType()>>(
+        std::forward<F>(func));
+    std::future<ResultType> result = task->get_future();
+    post([task]() { (*task)(); });
+    return result;
+}
+
+/// @brief Tasks run on a pool and waited for together.
+///
+/// wait() runs pending tasks of the pool in the waiting thread rather than
+/// blocking it, so groups may be nested in tasks. The first exception
+/// thrown by a task is thrown again by wait().
+class TaskGroup {
+  public:
+    explicit TaskGroup(ThreadPool &pool = ThreadPool::getInstance());
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+    void wait();
+
+  private:
+    ThreadPool &pool_;
+    std::atomic<int64_t> num_pending_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+};
+
+/// @brief run body(b, e) on sub-ranges [b, e) covering [begin, end)
+///
+/// @param grain size of the sub-ranges, 0 picks a few per thread
+void parallelFor(int64_t begin, int64_t end,
+                 const std::function<void(int64_t, int64_t)> &body,
+                 int64_t grain = 0);
+
+}  // namespace util
+}  // namespace open_edi
+
+#endif  // EDI_UTIL_THREAD_POOL_H_
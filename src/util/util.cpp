@@ -9,6 +9,7 @@
  * of the BSD license.  See the LICENSE file for details.
  */
 
+#include <pthread.h>
 #include <time.h>
 #include <errno.h>
 #include <limits.h>
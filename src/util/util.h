@@ -23,7 +23,7 @@
 #include "util/enums.h"
 #include "util/message.h"
 #include "util/point.h"
-#include "util/map_reduce.h"
+#include "util/thread_pool.h"
 #include "util/polygon_table.h"
 #include "util/stream.h"
 #include "util/util_mem.h"
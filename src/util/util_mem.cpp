@@ -12,7 +12,11 @@
 
 #include "string.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -76,7 +80,7 @@ MemChunk::MemChunk() { MemChunk(0); }
 /// @brief MemChunk
 ///
 /// @param size
-MemChunk::MemChunk(size_t size) : size_(size) {
+MemChunk::MemChunk(size_t size) : size_(size), owned_(true) {
     if (size > 0) {
         chunk_ = new char[size];
     } else {
@@ -84,13 +88,60 @@ MemChunk::MemChunk(size_t size) : size_(size) {
     }
 }
 
+/// @brief MemChunk, memory is not released by the chunk
+///
+/// @param chunk
+/// @param size
+MemChunk::MemChunk(void *chunk, size_t size)
+    : size_(size), chunk_(chunk), owned_(false) {}
+
 /// @brief destructor of MemChunk
 MemChunk::~MemChunk() {
-    if (size_ > 0) {
+    if (owned_ && size_ > 0) {
         delete[](char *) chunk_;
     }
 }
 
+/// @brief map a file privately, writes are never carried back to the file
+///
+/// @param filename
+///
+/// @return
+bool MemMappedFile::map(const char *filename) {
+    unmap();
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    void *addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE, fd, 0);
+    // the mapping holds its own reference to the file.
+    close(fd);
+    if (addr == MAP_FAILED) return false;
+
+    addr_ = (char *)addr;
+    size_ = st.st_size;
+    return true;
+}
+
+/// @brief unmap, private copies of written pages are dropped as well
+void MemMappedFile::unmap() {
+    if (addr_ != nullptr) {
+        munmap(addr_, size_);
+    }
+    addr_ = nullptr;
+    size_ = 0;
+}
+
+/// @brief serial numbers of arena sets, see MemPagePool::__getArena
+static std::atomic<uint64_t> next_arena_serial(1);
+
 /// @brief init pool
 void MemPagePool::__reset() {
     num_pages_ = MEM_PAGE_NUM_INIT;
@@ -99,27 +150,42 @@ void MemPagePool::__reset() {
     num_chunks_ = 0;
     mem_free_ = 0;
     curr_page_id_ = 0;
+    curr_page_claimed_ = false;
     mem_used_ = 0;
+    page_table_ = nullptr;
+    page_table_size_ = 0;
+    num_published_ = 0;
+    frame_table_ = nullptr;
+    for (auto &head : free_list_) {
+        head = 0;
+    }
+    serial_ = next_arena_serial++;
 }
 
 /// @brief release memory
 void MemPagePool::__release() {
-    pages_.clear();
-
-    for (auto &fl : free_list_) {
-        delete fl.second;
+    if (pool_no_ > 0 && pool_no_ < MEM_POOL_MAX) {
+        frame_tables_[pool_no_].store(nullptr, std::memory_order_release);
     }
-    free_list_.clear();
+    pages_.clear();
+    page_tables_.clear();
+    frame_tables_owned_.clear();
+    arenas_.clear();
 
     for (auto &chunk : chunks_) {
         delete chunk;
     }
     chunks_.clear();
 
+    if (mapped_file_ != nullptr) {
+        delete mapped_file_;
+        mapped_file_ = nullptr;
+    }
+
     __reset();
 }
 
-MemPagePool::MemPagePool() { __reset(); }
+MemPagePool::MemPagePool() : pool_no_(0), mapped_file_(nullptr) { __reset(); }
 
 MemPagePool::~MemPagePool() {
     std::lock_guard<std::mutex> sg(mutex_);
@@ -134,6 +200,123 @@ MemPage *MemPagePool::__nextPage() {
     }
 }
 
+/// @brief current frame table of each pool, see getAddress
+std::array<std::atomic<char **>, MEM_POOL_MAX> MemPagePool::frame_tables_;
+
+/// @brief make pages_ and their frames visible to lock free readers
+void MemPagePool::__publishPages() {
+    MemPage **table = page_table_.load(std::memory_order_relaxed);
+    char **frames = frame_table_.load(std::memory_order_relaxed);
+    if (pages_.size() > page_table_size_) {
+        // readers may still hold the old tables, keep them.
+        uint64_t size = std::max<uint64_t>(page_table_size_ * 2,
+                                           pages_.size());
+        MemPage **new_table = new MemPage *[size]();
+        char **new_frames = new char *[size]();
+        for (uint64_t i = 0; i < num_published_; ++i) {
+            new_table[i] = table[i];
+            new_frames[i] = frames[i];
+        }
+        page_tables_.emplace_back(new_table);
+        frame_tables_owned_.emplace_back(new_frames);
+        page_table_size_ = size;
+        table = new_table;
+        frames = new_frames;
+    }
+    // pages are only appended: entries readers may see are never written
+    // again, only the new ones past them are.
+    for (uint64_t i = num_published_; i < pages_.size(); ++i) {
+        table[i] = pages_[i];
+        frames[i] = pages_[i] ? pages_[i]->getFrame() : nullptr;
+    }
+    num_published_ = pages_.size();
+    page_table_.store(table, std::memory_order_release);
+    frame_table_.store(frames, std::memory_order_release);
+    if (pool_no_ > 0 && pool_no_ < MEM_POOL_MAX) {
+        frame_tables_[pool_no_].store(frames, std::memory_order_release);
+    }
+}
+
+void MemPagePool::resetFrameTables() {
+    for (auto &frames : frame_tables_) {
+        frames.store(nullptr, std::memory_order_release);
+    }
+}
+
+/// @brief pool numbers index frame_tables_, pages allocated before the
+/// number is given are published now.
+void MemPagePool::setPoolNo(size_t n) {
+    pool_no_ = n;
+    if (pool_no_ > 0 && pool_no_ < MEM_POOL_MAX) {
+        frame_tables_[pool_no_].store(
+            frame_table_.load(std::memory_order_relaxed),
+            std::memory_order_release);
+    }
+}
+
+/// @brief get the arena of the calling thread, created on first use
+MemPagePool::MemArena *MemPagePool::__getArena() {
+    struct ArenaCache {
+        uint64_t serial;
+        MemArena *arena;
+    };
+    // one entry per pool number, checked against the serial of the pool.
+    thread_local std::array<ArenaCache, MEM_POOL_MAX> caches{};
+
+    ArenaCache &cache = caches[pool_no_ % MEM_POOL_MAX];
+    if (cache.serial == serial_ && cache.arena != nullptr) {
+        return cache.arena;
+    }
+    std::lock_guard<std::mutex> sg(mutex_);
+    std::unique_ptr<MemArena> &arena = arenas_[std::this_thread::get_id()];
+    if (arena == nullptr) arena.reset(new MemArena);
+    cache.serial = serial_;
+    cache.arena = arena.get();
+    return cache.arena;
+}
+
+/// @brief give free objects held by arenas back to the shared lists.
+///
+/// Arena lists are owned by their threads, no allocation may run
+/// meanwhile, e.g. when the pool is saved.
+void MemPagePool::__flushArenaFreeLists() {
+    std::lock_guard<std::mutex> sg(mutex_);
+    for (auto &arena : arenas_) {
+        for (int type = 0; type < MEM_FREE_LIST_MAX; ++type) {
+            uint64_t &local = arena.second->free_list[type];
+            if (local == 0) continue;
+            // append the shared list to the end of the local one.
+            MemFreeNode *tail = getObjectPtr<MemFreeNode>(__fromFreeId(local));
+            while (tail->next != 0) {
+                tail = getObjectPtr<MemFreeNode>(__fromFreeId(tail->next));
+            }
+            tail->next = free_list_[type];
+            free_list_[type] = local;
+            local = 0;
+        }
+    }
+}
+
+/// @brief hand out a page no arena uses yet
+///
+/// @return nullptr upon failure
+MemPage *MemPagePool::__claimPage() {
+    std::lock_guard<std::mutex> sg(mutex_);
+    try {
+        if (curr_page_claimed_) {
+            if (__pageEnd()) __allocatePages();
+            __nextPage();
+        } else if (pages_.empty()) {
+            // the current page restored from a file is handed out first.
+            __allocatePages();
+        }
+    } catch (MemException &e) {
+        return nullptr;
+    }
+    curr_page_claimed_ = true;
+    return pages_[curr_page_id_];
+}
+
 /// @brief allocate new memory chunk
 bool MemPagePool::__allocatePages() {
     MemChunk *mem_chunk = nullptr;
@@ -170,6 +353,7 @@ bool MemPagePool::__allocatePages() {
     chunks_[num_chunks_ - 1] = mem_chunk;
 
     mem_free_ += chunk_size_;
+    __publishPages();
 
     return true;
 }
@@ -188,6 +372,8 @@ void MemPagePool::printUsage() {
          << "Number of pages- " << num_pages_ << endl;
     cout << "MEMINFO: "
          << "Current (available) page- " << curr_page_id_ << endl;
+    cout << "MEMINFO: "
+         << "Number of arenas- " << arenas_.size() << endl;
     cout << "MEMINFO: "
          << "Total memory allocated- "
          << (float)num_pages_ * page_size_ * sizeof(char) / MEM_MEGA_BYTE
@@ -213,7 +399,8 @@ void MemPagePool::__writeChunkSizeInfo(std::ofstream &outfile, bool debug) {
     }
 }
 
-void MemPagePool::__readChunkSizeInfo(std::ifstream &infile, bool debug) {
+void MemPagePool::__readChunkSizeInfo(std::ifstream &infile, char *content,
+                                      bool debug) {
     uint64_t size = 0;
     infile.read((char *)(&size), sizeof(uint64_t));
     if (debug) cout << "RWDBGINFO: read size " << size << endl;
@@ -226,7 +413,14 @@ void MemPagePool::__readChunkSizeInfo(std::ifstream &infile, bool debug) {
     chunks_.resize(num_chunks_, nullptr);
     for (int i = 0; i < size; ++i) {
         if (debug) cout << "RWDBGINFO: read chunk_size " << buffer[i] << endl;
-        MemChunk *mem_chunk = new MemChunk(buffer[i]);
+        MemChunk *mem_chunk = nullptr;
+        if (content != nullptr) {
+            // chunks are stored back to back in the file.
+            mem_chunk = new MemChunk(content, buffer[i]);
+            content += buffer[i];
+        } else {
+            mem_chunk = new MemChunk(buffer[i]);
+        }
         chunks_[i] = mem_chunk;
     }
     delete[] buffer;
@@ -257,6 +451,9 @@ void MemPagePool::__readPageInfo(std::ifstream &infile, bool debug) {
              << num_pages_ << " current_page_id " << curr_page_id_ << endl;
 
     pages_.resize(num_pages_, nullptr);
+    // restored pages replace all of the published ones, nothing reads the
+    // pool while a design is read.
+    num_published_ = 0;
 
     uint64_t chunk_index = 0;
     size_t offset_in_chunk = 0;
@@ -282,73 +479,57 @@ void MemPagePool::__readPageInfo(std::ifstream &infile, bool debug) {
             mem_page->printPageUsage(true);
         }
     }
+    __publishPages();
 }
 
+/// @brief free lists are linked through free ids stored in the freed
+/// objects, so they are saved with the content; only heads are written.
 void MemPagePool::__writeFreeListInfo(std::ofstream &outfile, bool debug) {
-    outfile.write((char *)&(mem_free_), sizeof(uint64_t));
+    __flushArenaFreeLists();
+    uint64_t mem_free = mem_free_;
+    outfile.write((char *)&(mem_free), sizeof(uint64_t));
 
-    size_t size = free_list_.size();
+    size_t size = 0;
+    for (auto &head : free_list_) {
+        if (head != 0) ++size;
+    }
     outfile.write((char *)&(size), sizeof(size_t));
     if (debug)
         cout << "RWDBGINFO: write freelist size " << size << " and mem_free "
-             << mem_free_ << endl;
+             << mem_free << endl;
 
-    for (auto &fl : free_list_) {
-        int obj_type_id = fl.first;
+    for (int obj_type_id = 0; obj_type_id < MEM_FREE_LIST_MAX;
+         ++obj_type_id) {
+        uint64_t free_id = free_list_[obj_type_id];
+        if (free_id == 0) continue;
         outfile.write((char *)&(obj_type_id), sizeof(int));
-
-        size_t freeobjs_size = 0;
-        for (std::forward_list<void *>::iterator iter = fl.second->begin();
-             iter != fl.second->end(); ++iter) {
-            ++freeobjs_size;
-        }
-        outfile.write((char *)&(freeobjs_size), sizeof(size_t));
-
+        outfile.write((char *)&(free_id), sizeof(uint64_t));
         if (debug)
             cout << "RWDBGINFO: write freelist objtype_id " << obj_type_id
-                 << " freeobjs_size " << freeobjs_size << endl;
-        for (std::forward_list<void *>::iterator iter = fl.second->begin();
-             iter != fl.second->end(); ++iter) {
-            uint64_t freeobj_ptr = (long)(char *)(*iter);
-            outfile.write((char *)(&freeobj_ptr), sizeof(uint64_t));
-            if (debug)
-                cout << "RWDBGINFO: write freelist obj_id " << freeobj_ptr
-                     << endl;
-        }
+                 << " head " << free_id << endl;
     }
 }
 
 void MemPagePool::__readFreeListInfo(std::ifstream &infile, bool debug) {
-    infile.read((char *)&(mem_free_), sizeof(uint64_t));
+    uint64_t mem_free = 0;
+    infile.read((char *)&(mem_free), sizeof(uint64_t));
+    mem_free_ = mem_free;
 
     size_t size = 0;
     infile.read((char *)&(size), sizeof(size_t));
     if (debug)
         cout << "RWDBGINFO: read freelist size " << size << " and mem_free "
-             << mem_free_ << endl;
+             << mem_free << endl;
     for (int i = 0; i < size; ++i) {
         int obj_type_id = 0;
-        size_t freeobjs_size = 0;
+        uint64_t free_id = 0;
         infile.read((char *)&(obj_type_id), sizeof(int));
-        infile.read((char *)&(freeobjs_size), sizeof(size_t));
+        infile.read((char *)&(free_id), sizeof(uint64_t));
         if (debug)
             cout << "RWDBGINFO: read freelist objtype_id " << obj_type_id
-                 << " freeobjs_size " << freeobjs_size << endl;
-        for (int j = 0; j < freeobjs_size; ++j) {
-            uint64_t freeobj_ptr = 0;
-            infile.read((char *)&(freeobj_ptr), sizeof(uint64_t));
-            if (debug)
-                cout << "RWDBGINFO: read freelist obj_id " << freeobj_ptr
-                     << endl;
-
-            if (j == 0) {
-                std::forward_list<void *> *fl = new std::forward_list<void *>;
-                fl->push_front((void *)freeobj_ptr);
-                free_list_[obj_type_id] = fl;
-            } else {
-                free_list_[obj_type_id]->push_front((void *)freeobj_ptr);
-            }
-        }
+                 << " head " << free_id << endl;
+        if (obj_type_id < 0 || obj_type_id >= MEM_FREE_LIST_MAX) continue;
+        free_list_[obj_type_id] = free_id;
     }
 }
 
@@ -365,6 +546,8 @@ void MemPagePool::__writeChunks(std::ofstream &outfile, bool debug) {
 
 void MemPagePool::__readChunks(std::ifstream &infile, bool debug) {
     for (uint64_t i = 0; i < num_chunks_; ++i) {
+        // borrowed chunks already hold the file content.
+        if (!chunks_[i]->isOwned()) continue;
         void *chunk = chunks_[i]->getChunk();
         size_t size = chunks_[i]->getSize();
         if (debug)
@@ -411,19 +594,41 @@ void MemPagePool::readFromFile(std::ifstream &infile, bool debug) {
         return;
     }
 
+    readHeaderFromFile(infile, nullptr, debug);
+    readContentFromFile(infile, debug);
+    // close-file moved to UI callback.
+    // infile.close();
+    if (debug) {
+        printUsage();
+    }
+}
+
+/// @brief read header from a file
+///
+/// @param infile
+/// @param content chunk content already in memory (e.g. a mapped file),
+///        chunks are then pointed into it instead of being allocated.
+/// @param debug
+void MemPagePool::readHeaderFromFile(std::ifstream &infile, char *content,
+                                     bool debug) {
+    if (!infile) {
+        return;
+    }
     // 2. read num_chunk & chunk_size
-    __readChunkSizeInfo(infile, debug);
+    __readChunkSizeInfo(infile, content, debug);
     // 3. read num_pages & page_info
     __readPageInfo(infile, debug);
     // 4. read num_free_list & typeid+free_object_ids
     __readFreeListInfo(infile, debug);
+}
+
+/// @brief read chunk/content from a file
+void MemPagePool::readContentFromFile(std::ifstream &infile, bool debug) {
+    if (!infile) {
+        return;
+    }
     // 5. read chunks
     __readChunks(infile, debug);
-    // close-file moved to UI callback.
-    // infile.close();
-    if (debug) {
-        printUsage();
-    }
 }
 
 /// @brief MemPool
@@ -465,6 +670,7 @@ bool MemPool::destroyMemPool() {
     }
 
     indexed_page_pools_.fill(nullptr);
+    MemPagePool::resetFrameTables();
     page_pools_.clear();
     initialized_ = 0;
     //initMemPool();
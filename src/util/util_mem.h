@@ -11,12 +11,15 @@
  */
 
 #include <assert.h>
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vector>
-#include <forward_list>
 #include <limits.h>
 #include <mutex>
 #include <iostream>
+#include <thread>
 #include "util/namespace.h"
 
 #ifndef EDI_UITIL_MEM_HPP_
@@ -50,6 +53,16 @@ class MemException {
 #define POOL_INDEX_MASK  0x00FC000000000000  // first 6bits of total 56bits
 #define PAGE_INDEX_MASK  0x0003FFFFFFF00000  // following 30bits of total 56bits
 #define PAGE_OFFSET_MASK 0x00000000000FFFFD  // rest 20bits
+// free lists: one per object type, then one per 8B size of vector
+// objects up to 4KB, then one per size of array blocks.
+#define MEM_OBJECT_FREE_LIST_NUM 256  // object types with a free list
+#define MEM_VECTOR_FREE_LIST_NUM (1 << (12 - MEM_ALIGN_BIT))
+#define MEM_VECTOR_FREE_LIST_BASE MEM_OBJECT_FREE_LIST_NUM
+// array blocks of 8B, 16B, ... up to a page
+#define MEM_ARRAY_FREE_LIST_NUM (MEM_PAGE_SIZE_BIT - MEM_ALIGN_BIT + 1)
+#define MEM_ARRAY_FREE_LIST_BASE \
+    (MEM_VECTOR_FREE_LIST_BASE + MEM_VECTOR_FREE_LIST_NUM)
+#define MEM_FREE_LIST_MAX (MEM_ARRAY_FREE_LIST_BASE + MEM_ARRAY_FREE_LIST_NUM)
 
 class MemPage {
   public:
@@ -144,17 +157,52 @@ class MemChunk {
   public:
     MemChunk();
     MemChunk(size_t size);
+    /// @brief borrow memory owned by someone else, e.g. a mapped file.
+    MemChunk(void *chunk, size_t size);
 
     ~MemChunk();
     
     size_t getSize() const { return size_;}
     void *getChunk() const { return chunk_;}
+    bool isOwned() const { return owned_;}
 
   private:
     size_t size_;
     void *chunk_;
+    bool owned_;
 };
 
+/// @brief private (copy-on-write) mapping of a saved pool file.
+/// Pages of the file are faulted in on first access and only copied
+/// into anonymous memory when they are first written.
+class MemMappedFile {
+  public:
+    MemMappedFile() : addr_(nullptr), size_(0) {}
+    ~MemMappedFile() { unmap(); }
+
+    bool    map(const char *filename);
+    void    unmap();
+    char*   getAddr() const { return addr_; }
+    size_t  getSize() const { return size_; }
+
+  private:
+    MemMappedFile(MemMappedFile const &rhs);
+    MemMappedFile &operator=(MemMappedFile const &rhs);
+
+    char *addr_;
+    size_t size_;
+};
+
+/// @brief Pages of objects of one pool.
+///
+/// Objects may be allocated and freed by several threads at the same time.
+/// Each thread bump-allocates from its own arena, i.e. a page claimed from
+/// the pool for that thread only, and takes the pool lock only when it
+/// needs a new page. Freed objects are pushed to per-type lock free stacks;
+/// an allocating thread takes a whole stack at once into its arena, so a
+/// node is never read by one thread while being reused by another.
+/// Object ids keep the pool/page/offset encoding, whichever thread
+/// allocated them.
 class MemPagePool {
   public:
     MemPagePool();
@@ -164,24 +212,80 @@ class MemPagePool {
     template<class T> T *allocate(int type, uint64_t &id); 
     template<typename T> T *allocateArray(int64_t size, uint64_t &id); 
     template<class T> void free(const int type, T *o);
+    /// @brief free an array of num T given by allocateArray. Arrays of a
+    /// power of two bytes are handed out again by allocateArray of the
+    /// same size, others stay in the pool.
+    template<typename T> void freeArray(uint64_t id, int64_t num);
     template<class T> T *getObjectPtr(uint64_t id);
+    /// @brief address of any object id, in two dependent loads: the frame
+    /// table of the pool, then the frame of the page. Ids of pools without
+    /// pages give nullptr.
+    static inline char *getAddress(uint64_t id) {
+        char **frames = frame_tables_[(id & POOL_INDEX_MASK) >>
+                                      MEM_PAGE_MAX_BIT]
+                            .load(std::memory_order_acquire);
+        if (frames == nullptr) return nullptr;
+        return frames[(id & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT] +
+               (id & PAGE_OFFSET_MASK);
+    }
+    /// @brief getAddress for ids known to be valid, no checks at all.
+    static inline char *getAddressUnchecked(uint64_t id) {
+        return frame_tables_[(id & POOL_INDEX_MASK) >> MEM_PAGE_MAX_BIT]
+                   .load(std::memory_order_acquire)
+                   [(id & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT] +
+               (id & PAGE_OFFSET_MASK);
+    }
+
+    /// @brief forget the frame tables of all pools, ids resolve to nullptr
+    static void resetFrameTables();
 
-    MemPage*    getPage(uint64_t pid) {return pages_.empty()?nullptr:pages_[pid];}
-    MemPage*    getCurrentPage() {return getPage(curr_page_id_);}
-    void        setPoolNo(size_t n) {pool_no_ = n;}
+    /// @brief lock free, pages are published before ids pointing into them
+    MemPage*    getPage(uint64_t pid) {
+        MemPage **table = page_table_.load(std::memory_order_acquire);
+        return table == nullptr ? nullptr : table[pid];
+    }
+    uint64_t    getNumPages() {return pages_.size();}
+    size_t      getPageSize() {return page_size_;}
+    /// @brief bytes of claimed pages not in use, freed objects included
+    uint64_t    getFreeMemory() const {return mem_free_;}
+    void        setPoolNo(size_t n);
     size_t      getPoolNo() {return pool_no_;}
     void        printUsage();
     void        writeHeaderToFile(std::ofstream & outfile, bool debug = false);
     void        writeContentToFile(std::ofstream & outfile, bool debug = false);
     void        readFromFile(std::ifstream & infile, bool debug = false);
+    void        readHeaderFromFile(std::ifstream & infile,
+                                   char *content = nullptr,
+                                   bool debug = false);
+    void        readContentFromFile(std::ifstream & infile,
+                                    bool debug = false);
+    void        setMappedFile(MemMappedFile *mapped) {mapped_file_ = mapped;}
+    MemMappedFile* getMappedFile() {return mapped_file_;}
 
   private:
+    /// @brief page a thread allocates from, owned by that thread only.
+    struct MemArena {
+        MemArena() : page(nullptr) { free_list.fill(0); }
+        MemPage *page;
+        std::array<uint64_t, MEM_FREE_LIST_MAX> free_list;  // free ids
+    };
+    /// @brief link stored in a freed object, as a pool local free id.
+    /// Free ids don't depend on where pages are, lists survive save/restore.
+    struct MemFreeNode {
+        uint64_t next;
+    };
+
     void        __reset();
     void        __release();
     bool        __allocatePages(); // allocate page chunks, re-alloc page array;
-    template<class T> T* __allocateFromFreeList(const int type);
-    template<class T> T* __allocateFromPages(uint32_t &offset);
-    template<class T> T* __allocateFromPages(uint64_t num, uint32_t &offset);
+    void        __publishPages();
+    void        __flushArenaFreeLists();
+    MemArena*   __getArena();
+    MemPage*    __claimPage();
+    template<class T> T* __allocateFromFreeList(const int type, uint64_t &id);
+    template<class T> T* __allocateFromArena(uint32_t &offset, MemPage *&p);
+    template<class T> T* __allocateFromArena(uint64_t num, uint32_t &offset,
+                                             MemPage *&p);
     MemPage*    __nextPage();
 
     inline uint64_t __computeObjectId(MemPage *p, size_t of) 
@@ -190,6 +294,15 @@ class MemPagePool {
         return ((getPoolNo() << MEM_PAGE_MAX_BIT) | (p->getPageNo() << MEM_PAGE_SIZE_BIT) | of);
     }
 
+    /// @brief pool local id of an 8 bytes aligned object, 0 means none.
+    static uint64_t __toFreeId(uint64_t id) {
+        return ((id & ((1UL << MEM_PAGE_MAX_BIT) - 1)) >> MEM_ALIGN_BIT) + 1;
+    }
+    uint64_t __fromFreeId(uint64_t free_id) {
+        return (getPoolNo() << MEM_PAGE_MAX_BIT) |
+               ((free_id - 1) << MEM_ALIGN_BIT);
+    }
+
     bool __pageEnd() {
         return (pages_.empty() || curr_page_id_ == (pages_.size()-1));
     }
@@ -197,9 +310,17 @@ class MemPagePool {
     inline void __align(uint64_t &size) {
         size = ((size+(1<<MEM_ALIGN_BIT)-1)>>MEM_ALIGN_BIT)<<MEM_ALIGN_BIT;
     }
+    /// @brief free list of array blocks of size bytes, -1 if none
+    static int __arrayFreeList(uint64_t size) {
+        if (size == 0 || (size & (size - 1)) != 0) return -1;
+        int list = MEM_ARRAY_FREE_LIST_BASE + __builtin_ctzll(size) -
+                   MEM_ALIGN_BIT;
+        return list < MEM_FREE_LIST_MAX ? list : -1;
+    }
     
     void __writeChunkSizeInfo(std::ofstream & outfile, bool debug = false);
-    void __readChunkSizeInfo(std::ifstream & infile, bool debug = false);  
+    void __readChunkSizeInfo(std::ifstream & infile, char *content,
+                             bool debug = false);
     void __writePageInfo(std::ofstream & outfile, bool debug = false);
     void __readPageInfo(std::ifstream & infile, bool debug = false);
     void __writeFreeListInfo(std::ofstream & outfile, bool debug = false);
@@ -207,109 +328,149 @@ class MemPagePool {
     void __writeChunks(std::ofstream & outfile, bool debug = false);
     void __readChunks(std::ifstream & infile, bool debug = false);
   private:
-    std::mutex mutex_;
+    std::mutex mutex_;  // page claiming & arena creation
 
     size_t pool_no_;
     size_t page_size_;
     uint64_t num_pages_;
-    uint64_t curr_page_id_;
+    uint64_t curr_page_id_;  // last page handed out to an arena
+    bool curr_page_claimed_;
     uint64_t mem_used_;  // used pages
-    uint64_t mem_free_;  // free memory
+    std::atomic<uint64_t> mem_free_;  // free memory
     uint64_t chunk_size_;
     uint64_t num_chunks_;
     std::vector<MemPage *> pages_;
-    std::map<int, std::forward_list<void *>*> free_list_;
+    // read side copy of pages_, replaced when it grows. Old tables are
+    // kept in page_tables_ as readers may still use them.
+    std::atomic<MemPage **> page_table_;
+    uint64_t page_table_size_;
+    uint64_t num_published_;  ///< entries of page_table_ already set
+    std::vector<std::unique_ptr<MemPage *[]>> page_tables_;
+    // frames of the pages, published and kept in the same way.
+    std::atomic<char **> frame_table_;
+    std::vector<std::unique_ptr<char *[]>> frame_tables_owned_;
+    // current frame table of each pool, indexed by pool number.
+    static std::array<std::atomic<char **>, MEM_POOL_MAX> frame_tables_;
+    std::array<std::atomic<uint64_t>, MEM_FREE_LIST_MAX> free_list_;
     std::vector<MemChunk *> chunks_;
+    MemMappedFile *mapped_file_;  // chunks may point into it, see readHeaderFromFile
+    // arenas, per thread. serial_ changes whenever they are dropped, so
+    // that threads don't use a stale cached arena.
+    std::map<std::thread::id, std::unique_ptr<MemArena>> arenas_;
+    uint64_t serial_;
 };
 
-/// @brief free an object & put it in free list
+/// @brief free an object & put it in free list, lock free.
 template<class T>
 void MemPagePool::free(int type, T *obj)
 {
-    std::lock_guard<std::mutex> sg(mutex_);
+    static_assert(sizeof(T) >= sizeof(MemFreeNode), "object too small");
+    assert(type >= 0 && type < MEM_FREE_LIST_MAX);
     uint64_t size = sizeof(T);
     __align(size);
 
+    uint64_t free_id = __toFreeId(obj->getId());
     obj->~T(); // de-construct
-    auto it = free_list_.find(type); 
-    if (it == free_list_.end()) {
-        std::forward_list<void*> *fl = new std::forward_list<void*>;
-        fl->push_front((void*)obj);
-        free_list_[type] = fl;
-    } else {
-        it->second->push_front((void*)obj);
-    }
+    MemFreeNode *node = reinterpret_cast<MemFreeNode *>(obj);
+    std::atomic<uint64_t> &head = free_list_[type];
+    uint64_t old_head = head.load(std::memory_order_relaxed);
+    do {
+        node->next = old_head;
+    } while (!head.compare_exchange_weak(old_head, free_id,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+    mem_free_ += size*sizeof(char);
+}
+
+/// @brief free an array & put it in the free list of its size, lock free.
+template<typename T>
+void MemPagePool::freeArray(uint64_t id, int64_t num)
+{
+    uint64_t size = sizeof(T) * num;
+    __align(size);
+    int list = __arrayFreeList(size);
+    if (list < 0) return;
+
+    uint64_t free_id = __toFreeId(id);
+    MemFreeNode *node = getObjectPtr<MemFreeNode>(id);
+    std::atomic<uint64_t> &head = free_list_[list];
+    uint64_t old_head = head.load(std::memory_order_relaxed);
+    do {
+        node->next = old_head;
+    } while (!head.compare_exchange_weak(old_head, free_id,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
     mem_free_ += size*sizeof(char);
 }
 
-/// @brief __allocateFromFreeList 
+/// @brief __allocateFromFreeList, lock free.
+///
+/// Objects are popped from the free list of the calling thread's arena,
+/// which is refilled by taking the whole shared list of the type.
 ///
 /// @tparam T
 /// @param type
+/// @param id id of the object upon success
 ///
 /// @return 
 template<class T>
-T* MemPagePool::__allocateFromFreeList(const int type)
+T* MemPagePool::__allocateFromFreeList(const int type, uint64_t &id)
 {
-    T *ptr = nullptr;
-
-    if (free_list_.empty()) return nullptr;
-
-    auto it = free_list_.find(type); 
-    if (it != free_list_.end() && !it->second->empty()) {
-        ptr = (T*)(it->second->front());
-        it->second->erase_after(it->second->before_begin());
+    assert(type >= 0 && type < MEM_FREE_LIST_MAX);
+    uint64_t &local = __getArena()->free_list[type];
+    if (local == 0) {
+        if (free_list_[type].load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        local = free_list_[type].exchange(0, std::memory_order_acquire);
+        if (local == 0) return nullptr;
     }
-    return ptr;
+    id = __fromFreeId(local);
+    MemFreeNode *node = getObjectPtr<MemFreeNode>(id);
+    local = node->next;
+    return (T*)node;
 }
 
-/// @brief __allocateFromPages 
+/// @brief __allocateFromArena, from the page of the calling thread
 ///
 /// @tparam T
 /// @param offset
+/// @param p page the object is on
 ///
 /// @return 
 template<class T>
-T* MemPagePool::__allocateFromPages(uint32_t &offset)
+T* MemPagePool::__allocateFromArena(uint32_t &offset, MemPage *&p)
 {
+    MemArena *arena = __getArena();
     T *obj = nullptr;
-    MemPage *p = nullptr;
-
-    uint64_t size = sizeof(T);
-    __align(size);
-
-    if (size <= mem_free_) {
-        p = getCurrentPage();
-        while (p) {
-            obj = p->allocate<T>(offset);
-            // success, or no avail pages
-            if (obj != nullptr || __pageEnd()) break;
-            p = __nextPage();
-        }
+    if (arena->page != nullptr) {
+        obj = arena->page->allocate<T>(offset);
     }
-
+    if (obj == nullptr) {
+        // the rest of the page is left unused.
+        arena->page = __claimPage();
+        if (arena->page == nullptr) return nullptr;
+        obj = arena->page->allocate<T>(offset);
+    }
+    p = arena->page;
     return obj;
 }
 
 template<class T>
-T* MemPagePool::__allocateFromPages(uint64_t num, uint32_t &offset)
+T* MemPagePool::__allocateFromArena(uint64_t num, uint32_t &offset,
+                                    MemPage *&p)
 {
+    MemArena *arena = __getArena();
     T *obj = nullptr;
-    MemPage *p = nullptr;
-
-    uint64_t size = sizeof(T) * num;
-    __align(size);
-
-    if (size <= mem_free_) {
-        p = getCurrentPage();
-        while (p) {
-            obj = p->allocate<T>(num, offset);
-            // success, or no avail pages
-            if (obj != nullptr || __pageEnd()) break;
-            p = __nextPage();
-        }
+    if (arena->page != nullptr) {
+        obj = arena->page->allocate<T>(num, offset);
     }
-
+    if (obj == nullptr) {
+        arena->page = __claimPage();
+        if (arena->page == nullptr) return nullptr;
+        obj = arena->page->allocate<T>(num, offset);
+    }
+    p = arena->page;
     return obj;
 }
 
@@ -329,34 +490,18 @@ T *MemPagePool::allocate(const int type, uint64_t &id)
     __align(size);
     assert(size <= page_size_);
 
-    std::lock_guard<std::mutex> sg(mutex_);
-
     // free list first.
-    if (obj = __allocateFromFreeList<T>(type)) {
+    if ((obj = __allocateFromFreeList<T>(type, id))) {
         mem_free_ -= size*sizeof(char);
-        id = obj->getId();
         return new(obj)T;
     }
 
     uint32_t offset = 0;
     MemPage *p = nullptr;
 
-    // second, from current available page
-    obj = __allocateFromPages<T>(offset);
-
-    // third, if free mem on current page is not adequate 
-    // then allocate new pages, and allocate from new pages
-    if (obj == nullptr && __pageEnd()) {
-        try {
-            __allocatePages();
-        } catch (MemException &e) {
-            return (T*)obj;
-        }
-        obj = __allocateFromPages<T>(offset);
-    }
-
+    // second, from the page of this thread, or a new one.
+    obj = __allocateFromArena<T>(offset, p);
     if (obj == nullptr) return (T*)nullptr;
-    p = getCurrentPage();
     
     mem_free_ -= size*sizeof(char);
     id = __computeObjectId(p, offset); // compute id
@@ -371,32 +516,23 @@ T *MemPagePool::allocateArray(int64_t num, uint64_t &id)
     id = ULONG_MAX;
     T *obj = nullptr;
 
-    std::lock_guard<std::mutex> sg(mutex_);
-
     uint64_t size = sizeof(T) * num;
     __align(size);
 
     assert(size<=page_size_);
 
+    // a freed array of the same size first.
+    int list = __arrayFreeList(size);
+    if (list >= 0 && (obj = __allocateFromFreeList<T>(list, id))) {
+        mem_free_ -= size*sizeof(char);
+        return obj;
+    }
+
     uint32_t offset = 0;
     MemPage *p = nullptr;
 
-    // second, from current available page
-    obj = __allocateFromPages<T>(num, offset);
-
-    // third, if free mem on current page is not adequate 
-    // then allocate new pages, and allocate from new pages
-    if (obj == nullptr && __pageEnd()) {
-        try {
-            __allocatePages();
-        } catch (MemException &e) {
-            return (T*)obj;
-        }
-        obj = __allocateFromPages<T>(num, offset);
-    }
-
+    obj = __allocateFromArena<T>(num, offset, p);
     if (obj == nullptr) return (T*)nullptr;
-    p = getCurrentPage();
     
     mem_free_ -= size*sizeof(char);
     id = __computeObjectId(p, offset); // compute id
@@ -412,17 +548,11 @@ T *MemPagePool::allocateArray(int64_t num, uint64_t &id)
 /// @return 
 template <class T>
 T *MemPagePool::getObjectPtr(uint64_t id) {
-    uint32_t idx;
-    char *ptr;
-
-    // get page with page no given by middle 35 bits
-    idx = ((id & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT);
-    ptr = getPage(idx)->getFrame();
-
-    // get real addr with offset given by last 10 bits
-    ptr += (id & PAGE_OFFSET_MASK);
-
-    return (T*)ptr;
+    // frame of the page given by the middle bits, then the offset
+    char **frames = frame_table_.load(std::memory_order_acquire);
+    return reinterpret_cast<T *>(
+        frames[(id & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT] +
+        (id & PAGE_OFFSET_MASK));
 }
 
 class MemPool
@@ -33,9 +33,9 @@ void Version::reset() {
 }
 
 void Version::init() {
-    major_ = 1;
-    minor_ = 0;
-    revision_ = 0;
+    major_ = kDesignFileMajor;
+    minor_ = kDesignFileMinor;
+    revision_ = kDesignFileRevision;
 }
 
 void Version::set(Version & v) {
@@ -44,6 +44,13 @@ void Version::set(Version & v) {
     revision_ = v.revision_;
 }
 
+int Version::compare(const Version & v) const {
+    if (major_ != v.major_) return major_ < v.major_ ? -1 : 1;
+    if (minor_ != v.minor_) return minor_ < v.minor_ ? -1 : 1;
+    if (revision_ != v.revision_) return revision_ < v.revision_ ? -1 : 1;
+    return 0;
+}
+
 const std::string & Version::getVersionString() {
     stringstream sstream;
     sstream << kHeaderChar << major_ << kVersionDelimiter << minor_ << kVersionDelimiter << revision_;
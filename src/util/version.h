@@ -18,14 +18,33 @@
 namespace open_edi {
 namespace util {
 
+/// @brief version of the design files this build writes, the only one
+/// read_design accepts. Pool pages are written as they are in memory, so
+/// the minor number changes with the layout of any object in a pool:
+///   1.0  the original layout
+///   1.1  free list heads of MemPagePool per object type and array block
+///        size, optional Inst attributes in a side table of the cell,
+///        ArrayObject segment directories, Box without an Object header
+///   1.2  free lists of vector objects, between those of object types and
+///        those of array blocks
+///   1.3  RC networks of DNetParasitics in power of two blocks, split
+///        behind a directory of blocks when larger than a quarter page
+const int kDesignFileMajor = 1;
+const int kDesignFileMinor = 3;
+const int kDesignFileRevision = 0;
+
 class Version {
   public:
     Version();
     ~Version();
     
+    /// @brief the version of the design files this build writes
     void init();
     void reset();
     void set(Version & v);
+    /// @brief 0 if v is the same version, < 0 if this one is older, > 0
+    /// if it is newer.
+    int compare(const Version & v) const;
     const std::string &getVersionString();
     void writeToFile(std::ofstream & outfile, bool debug = false);
     void readFromFile(std::ifstream & infile, bool debug = false);
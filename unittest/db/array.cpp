@@ -0,0 +1,142 @@
+/**
+ * @file   array.cpp
+ * @date   Oct 2020
+ * @brief  ArrayObject elements through each shape of its segment
+ *         directory, reuse of freed directories and concurrent readers.
+ *         Timings are in bench/array.cpp.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "db/core/db.h"
+#include "util/thread_pool.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class ArrayTest : public ::testing::Test {
+ public:
+  static const int64_t kSegmentSize = 32;
+  /// segments the root of the directory lists before it lists leaves
+  static const int64_t kLeafSize = 4096;
+
+  void SetUp() override { initTopCell(); }
+  void TearDown() override {
+    util::ThreadPool::getInstance().setNumThreads(0);
+  }
+
+  static ArrayObject<int64_t> *createArray(int64_t size) {
+    Cell *top_cell = getTopCell();
+    if (top_cell == nullptr) return nullptr;
+    auto array =
+        top_cell->createObject<ArrayObject<int64_t>>(kObjectTypeArray);
+    if (array == nullptr) return nullptr;
+    array->setPool(top_cell->getPool());
+    array->reserve(kSegmentSize);
+    for (int64_t i = 0; i < size; ++i) {
+      if (!array->pushBack(3 * i)) return nullptr;
+    }
+    return array;
+  }
+};
+
+// sizes around each change of the directory: the first segment, the
+// doubling root, a full root and the second level.
+TEST_F(ArrayTest, DirectoryShapes) {
+  const int64_t sizes[] = {1,
+                           kSegmentSize,
+                           kSegmentSize + 1,
+                           5 * kSegmentSize,
+                           kLeafSize * kSegmentSize,
+                           kLeafSize * kSegmentSize + 1,
+                           3 * kLeafSize * kSegmentSize + 7};
+  for (int64_t size : sizes) {
+    ArrayObject<int64_t> *array = createArray(size);
+    ASSERT_NE(array, nullptr) << size;
+    ASSERT_EQ(array->getSize(), size);
+    ASSERT_GE(array->getArraySize(), size);
+    const ArrayObject<int64_t> &reader = *array;
+    for (int64_t i = 0; i < size; ++i) ASSERT_EQ(reader[i], 3 * i) << size;
+
+    // writes through operator[] land where reads find them, also beyond
+    // the end of the array.
+    (*array)[size / 2] = -2;
+    (*array)[size - 1] = -1;
+    (*array)[size + kSegmentSize] = -3;
+    ASSERT_EQ(reader[size - 1], -1);
+    ASSERT_EQ(reader[size / 2], size / 2 == size - 1 ? -1 : -2);
+    ASSERT_EQ(reader[size + kSegmentSize], -3);
+    Object::deleteObject<ArrayObject<int64_t>>(array);
+  }
+}
+
+// a reserved array has its segments and directory before the first push.
+TEST_F(ArrayTest, Reserve) {
+  Cell *top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  auto array = top_cell->createObject<ArrayObject<int64_t>>(kObjectTypeArray);
+  ASSERT_NE(array, nullptr);
+  array->setPool(top_cell->getPool());
+  const int64_t size = 2 * kLeafSize * kSegmentSize;
+  ASSERT_TRUE(array->reserve(size));
+  ASSERT_EQ(array->getSize(), 0);
+  ASSERT_EQ(array->getArraySize(), size);
+  for (int64_t i = 0; i < size; ++i) ASSERT_TRUE(array->pushBack(i));
+  ASSERT_EQ(array->getArraySize(), size);
+  const ArrayObject<int64_t> &reader = *array;
+  for (int64_t i = 0; i < size; i += 97) ASSERT_EQ(reader[i], i);
+  Object::deleteObject<ArrayObject<int64_t>>(array);
+}
+
+// deleted arrays give their segments, data and directories back, later
+// arrays take them instead of new memory.
+TEST_F(ArrayTest, DirectoryReuse) {
+  Cell *top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  MemPagePool *pool = top_cell->getPool();
+  ASSERT_NE(pool, nullptr);
+  const int64_t size = 2 * kLeafSize * kSegmentSize;
+  ArrayObject<int64_t> *array = createArray(size);
+  ASSERT_NE(array, nullptr);
+  Object::deleteObject<ArrayObject<int64_t>>(array);
+
+  uint64_t free_memory = pool->getFreeMemory();
+  for (int i = 0; i < 100; ++i) {
+    ArrayObject<int64_t> *small = createArray(10 * kSegmentSize);
+    ASSERT_NE(small, nullptr);
+    ASSERT_EQ((*small)[9], 27);
+    Object::deleteObject<ArrayObject<int64_t>>(small);
+    ASSERT_EQ(pool->getFreeMemory(), free_memory) << i;
+  }
+}
+
+TEST_F(ArrayTest, ConcurrentReaders) {
+  const int64_t size = 2 * kLeafSize * kSegmentSize + 5;
+  const int kNumReaders = 8;
+  ArrayObject<int64_t> *array = createArray(size);
+  ASSERT_NE(array, nullptr);
+  const ArrayObject<int64_t> &reader = *array;
+
+  util::ThreadPool::getInstance().setNumThreads(kNumReaders);
+  std::atomic<int> failures(0);
+  util::parallelFor(0, kNumReaders, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; ++r) {
+      // each reader walks the array in its own random order.
+      int64_t index = r;
+      for (int64_t i = 0; i < size; ++i) {
+        if (reader[index] != 3 * index) ++failures;
+        index = (index * 48271 + 11 + r) % size;
+      }
+    }
+  }, 1);
+  ASSERT_EQ(failures, 0);
+  Object::deleteObject<ArrayObject<int64_t>>(array);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
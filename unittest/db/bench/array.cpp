@@ -0,0 +1,99 @@
+/**
+ * @file   array.cpp
+ * @date   Oct 2020
+ * @brief  Random, strided and concurrent access times of ArrayObject.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "db/core/db.h"
+#include "util/thread_pool.h"
+#include "util/util.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace bench {
+
+static const int64_t kNumElements = 10000000;
+static const int64_t kNumAccesses = 10000000;
+static const int64_t kStride = 4099;
+static const int kNumReaders = 8;
+
+static ArrayObject<int64_t> *createArray() {
+  Cell *top_cell = getTopCell();
+  if (top_cell == nullptr) return nullptr;
+  auto array = top_cell->createObject<ArrayObject<int64_t>>(kObjectTypeArray);
+  if (array == nullptr) return nullptr;
+  array->setPool(top_cell->getPool());
+  array->reserve(32);
+  for (int64_t i = 0; i < kNumElements; ++i) array->pushBack(i);
+  return array;
+}
+
+/// @brief sum of the elements at count indexes of the sequence
+/// index = (index * mul + add) % kNumElements, as a const reader.
+static int64_t sumOf(const ArrayObject<int64_t> &array, int64_t first,
+                     int64_t mul, int64_t add, int64_t count) {
+  int64_t sum = 0;
+  int64_t index = first;
+  for (int64_t i = 0; i < count; ++i) {
+    sum += array[index];
+    index = (index * mul + add) % kNumElements;
+  }
+  return sum;
+}
+
+static double nsPerAccess(std::chrono::steady_clock::time_point start,
+                          int64_t count) {
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() /
+         count;
+}
+
+static int run() {
+  initTopCell();
+  ArrayObject<int64_t> *array = createArray();
+  if (array == nullptr) return 1;
+  const ArrayObject<int64_t> &reader = *array;
+
+  // linear congruential sequence, i.e. random indexes.
+  auto start = std::chrono::steady_clock::now();
+  int64_t sum = sumOf(reader, 1, 48271, 11, kNumAccesses);
+  printf("random access: %.1f ns (%ld)\n", nsPerAccess(start, kNumAccesses),
+         sum);
+
+  start = std::chrono::steady_clock::now();
+  sum = sumOf(reader, 0, 1, kStride, kNumAccesses);
+  printf("strided access (%ld): %.1f ns (%ld)\n", kStride,
+         nsPerAccess(start, kNumAccesses), sum);
+
+  start = std::chrono::steady_clock::now();
+  sum = sumOf(reader, 0, 1, 1, kNumAccesses);
+  printf("sequential access: %.1f ns (%ld)\n",
+         nsPerAccess(start, kNumAccesses), sum);
+
+  const int64_t count = kNumAccesses / kNumReaders;
+  std::atomic<int64_t> total(0);
+  util::ThreadPool::getInstance().setNumThreads(kNumReaders);
+  start = std::chrono::steady_clock::now();
+  util::parallelFor(0, kNumReaders, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; ++r)
+      total += sumOf(reader, r + 1, 48271, 11, count);
+  }, 1);
+  printf("%d concurrent readers: %.1f ns per access (%ld)\n", kNumReaders,
+         nsPerAccess(start, count * kNumReaders), total.load());
+  util::ThreadPool::getInstance().setNumThreads(0);
+  return 0;
+}
+
+}  // namespace bench
+
+EDI_END_NAMESPACE
+
+int main() {
+  open_edi::util::utilInit();
+  return open_edi::db::bench::run();
+}
@@ -0,0 +1,77 @@
+/**
+ * @file   frozen_db.cpp
+ * @date   Oct 2020
+ * @brief  Times of the design statistics of a row of instances on one and
+ *         more threads.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "db/core/db.h"
+#include "db/util/design_stats.h"
+#include "util/thread_pool.h"
+#include "util/util.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace bench {
+
+static const int kNumInsts = 200000;
+static const int kPitch = 10;
+
+/// @brief a row of instances, net i connects instance i and i + 1.
+static bool createChain(Cell *top_cell) {
+  Inst *prev = nullptr;
+  for (int i = 0; i < kNumInsts; ++i) {
+    std::string name = "inst_" + std::to_string(i);
+    Inst *inst = top_cell->createInstance(name);
+    if (inst == nullptr) return false;
+    inst->setLocation(Point(i * kPitch, 0));
+    inst->setStatus(i % 2 ? PlaceStatus::kPlaced : PlaceStatus::kFixed);
+    if (prev != nullptr) {
+      std::string net_name = "net_" + std::to_string(i - 1);
+      Net *net = top_cell->createNet(net_name);
+      if (net == nullptr) return false;
+      std::string pin_name = "A";
+      net->addPin(prev->createInstancePinWithoutMaster(pin_name));
+      pin_name = "Z";
+      net->addPin(inst->createInstancePinWithoutMaster(pin_name));
+    }
+    prev = inst;
+  }
+  return true;
+}
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+static int run() {
+  initTopCell();
+  Cell *top_cell = getTopCell();
+  if (top_cell == nullptr || !createChain(top_cell)) return 1;
+
+  const int thread_counts[] = {1, 2, 4, 8};
+  for (int num_threads : thread_counts) {
+    DesignStats stats;
+    util::ThreadPool::getInstance().setNumThreads(num_threads);
+    auto start = std::chrono::steady_clock::now();
+    if (!getDesignStats(top_cell, &stats)) return 1;
+    printf("design stats, %d threads: %.3f ms (%ld)\n", num_threads,
+           msSince(start), stats.hpwl);
+  }
+  util::ThreadPool::getInstance().setNumThreads(0);
+  return 0;
+}
+
+}  // namespace bench
+
+EDI_END_NAMESPACE
+
+int main() {
+  open_edi::util::utilInit();
+  return open_edi::db::bench::run();
+}
@@ -0,0 +1,86 @@
+/**
+ * @file   object_addr.cpp
+ * @date   Oct 2020
+ * @brief  Traversal times of object id to pointer translation.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "db/core/db.h"
+#include "util/util.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace bench {
+
+static const int kNumInsts = 500000;
+
+/// @brief the pool -> page -> frame chain addr used to take.
+static Inst *chainAddr(ObjectId id) {
+  MemPagePool *pool = MemPool::getPagePoolByObjectId(id);
+  if (pool == nullptr) return nullptr;
+  MemPage *page = pool->getPage((id & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT);
+  return reinterpret_cast<Inst *>(page->getFrame() + (id & PAGE_OFFSET_MASK));
+}
+
+static double nsPerId(std::chrono::steady_clock::time_point start,
+                      int64_t count) {
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() /
+         count;
+}
+
+static int run() {
+  initTopCell();
+  Cell *top_cell = getTopCell();
+  if (top_cell == nullptr) return 1;
+  std::vector<ObjectId> ids;
+  ids.reserve(kNumInsts);
+  for (int i = 0; i < kNumInsts; ++i) {
+    Inst *inst = top_cell->createObject<Inst>(kObjectTypeInst);
+    if (inst == nullptr) return 1;
+    inst->setLocation(Point(i, 0));
+    ids.push_back(inst->getId());
+  }
+
+  // in allocation order, then shuffled like ids reached through nets.
+  const char *orders[] = {"sequential", "shuffled"};
+  for (int i = 0; i < 2; ++i) {
+    const char *order = orders[i];
+    if (i == 1) std::shuffle(ids.begin(), ids.end(), std::mt19937(1));
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t sum = 0;
+    for (ObjectId id : ids) sum += chainAddr(id)->getLocation().getX();
+    printf("%s, before (pool, page, frame): %.2f ns (%ld)\n", order,
+           nsPerId(start, kNumInsts), sum);
+
+    start = std::chrono::steady_clock::now();
+    sum = 0;
+    for (ObjectId id : ids)
+      sum += Object::addr<Inst>(id)->getLocation().getX();
+    printf("%s, addr: %.2f ns (%ld)\n", order, nsPerId(start, kNumInsts),
+           sum);
+
+    start = std::chrono::steady_clock::now();
+    sum = 0;
+    for (ObjectId id : ids)
+      sum += Object::addrUnchecked<Inst>(id)->getLocation().getX();
+    printf("%s, addrUnchecked: %.2f ns (%ld)\n", order,
+           nsPerId(start, kNumInsts), sum);
+  }
+  return 0;
+}
+
+}  // namespace bench
+
+EDI_END_NAMESPACE
+
+int main() {
+  open_edi::util::utilInit();
+  return open_edi::db::bench::run();
+}
@@ -0,0 +1,58 @@
+/**
+ * @file   object_range.cpp
+ * @date   Oct 2020
+ * @brief  Traversal times of the insts of a cell, through the instance
+ *         array and addr against Cell::insts().
+ */
+
+#include <chrono>
+#include <cstdio>
+
+#include "db/core/db.h"
+#include "util/util.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace bench {
+
+static const int kNumInsts = 1000000;
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+static int run() {
+  initTopCell();
+  Cell *top_cell = getTopCell();
+  if (top_cell == nullptr) return 1;
+  for (int i = 0; i < kNumInsts; ++i) {
+    Inst *inst = top_cell->createObject<Inst>(kObjectTypeInst);
+    if (inst == nullptr) return 1;
+    inst->setLocation(Point(i, 0));
+    top_cell->addInstance(inst->getId());
+  }
+  ArrayObject<ObjectId> *inst_array = top_cell->getInstanceArray();
+  if (inst_array == nullptr) return 1;
+
+  auto start = std::chrono::steady_clock::now();
+  int64_t sum = 0;
+  for (int64_t i = 0; i < inst_array->getSize(); ++i)
+    sum += Object::addr<Inst>((*inst_array)[i])->getLocation().getX();
+  printf("array and addr: %.3f ms (%ld)\n", msSince(start), sum);
+
+  start = std::chrono::steady_clock::now();
+  sum = 0;
+  for (Inst *inst : top_cell->insts()) sum += inst->getLocation().getX();
+  printf("insts(): %.3f ms (%ld)\n", msSince(start), sum);
+  return 0;
+}
+
+}  // namespace bench
+
+EDI_END_NAMESPACE
+
+int main() {
+  open_edi::util::utilInit();
+  return open_edi::db::bench::run();
+}
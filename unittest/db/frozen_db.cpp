@@ -0,0 +1,181 @@
+/**
+ * @file   frozen_db.cpp
+ * @date   Oct 2020
+ * @brief  Parallel readers of a frozen database. Timings are in
+ *         bench/frozen_db.cpp.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include "db/core/db.h"
+#include "db/util/design_stats.h"
+#include "util/thread_pool.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class FrozenDBTest : public ::testing::Test {
+ public:
+  static const int kNumInsts = 20000;
+  static const int kPitch = 10;
+
+  // the top cell is shared by the tests, each names its objects apart.
+  void SetUp() override {
+    initTopCell();
+    prefix_ = std::string(
+        ::testing::UnitTest::GetInstance()->current_test_info()->name()) +
+        "_";
+  }
+  void TearDown() override {
+    util::ThreadPool::getInstance().setNumThreads(0);
+  }
+
+  std::string instName(int i) const {
+    return prefix_ + "inst_" + std::to_string(i);
+  }
+  std::string netName(int i) const {
+    return prefix_ + "net_" + std::to_string(i);
+  }
+
+  /// @brief a row of num_insts instances in cell, net i connects instance
+  /// i and i + 1.
+  bool createChain(Cell* cell, int num_insts) const {
+    Inst* prev = nullptr;
+    for (int i = 0; i < num_insts; ++i) {
+      std::string name = instName(i);
+      Inst* inst = cell->createInstance(name);
+      if (inst == nullptr) return false;
+      inst->setOrient(Orient::kN);
+      inst->setLocation(Point(i * kPitch, 0));
+      inst->setStatus(i % 2 ? PlaceStatus::kPlaced : PlaceStatus::kFixed);
+      if (prev != nullptr) {
+        std::string net_name = netName(i - 1);
+        Net* net = cell->createNet(net_name);
+        if (net == nullptr) return false;
+        std::string pin_name = "A";
+        net->addPin(prev->createInstancePinWithoutMaster(pin_name));
+        pin_name = "Z";
+        net->addPin(inst->createInstancePinWithoutMaster(pin_name));
+      }
+      prev = inst;
+    }
+    return true;
+  }
+
+  /// @brief look up the chain of cell by name from kNumReaders threads
+  /// while the database is frozen.
+  /// @return the number of failed lookups
+  int lookUpChain(Cell* cell, int num_insts) const {
+    const int kNumReaders = 8;
+    util::ThreadPool::getInstance().setNumThreads(kNumReaders);
+    std::atomic<int> failures(0);
+    FrozenDBScope frozen;
+    util::parallelFor(0, num_insts, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        Inst* inst = cell->getInstance(instName(i));
+        if (inst == nullptr || inst->getLocation().getX() != i * kPitch)
+          ++failures;
+        if (i + 1 < num_insts && cell->getNet(netName(i)) == nullptr)
+          ++failures;
+        // misses don't add symbols.
+        if (cell->getInstance(prefix_ + "missing_" + std::to_string(i)) ||
+            cell->getTerm("missing") || cell->getBus("missing"))
+          ++failures;
+      }
+    });
+    return failures;
+  }
+
+ private:
+  std::string prefix_;
+};
+
+const int FrozenDBTest::kNumInsts;
+const int FrozenDBTest::kPitch;
+
+TEST_F(FrozenDBTest, DesignStats) {
+  Cell* top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  DesignStats before;
+  ASSERT_TRUE(getDesignStats(top_cell, &before));
+  ASSERT_TRUE(createChain(top_cell, kNumInsts));
+
+  DesignStats serial;
+  util::ThreadPool::getInstance().setNumThreads(1);
+  ASSERT_TRUE(getDesignStats(top_cell, &serial));
+  ASSERT_FALSE(isDBFrozen());
+  ASSERT_EQ(serial.num_insts - before.num_insts, kNumInsts);
+  ASSERT_EQ(serial.num_nets - before.num_nets, kNumInsts - 1);
+  ASSERT_EQ(serial.num_net_pins - before.num_net_pins, 2 * (kNumInsts - 1));
+  ASSERT_EQ(serial.max_fanout, std::max<int64_t>(before.max_fanout, 2));
+  ASSERT_EQ(serial.hpwl - before.hpwl,
+            static_cast<int64_t>(kPitch) * (kNumInsts - 1));
+
+  const int thread_counts[] = {2, 4, 8};
+  for (int num_threads : thread_counts) {
+    DesignStats parallel;
+    util::ThreadPool::getInstance().setNumThreads(num_threads);
+    ASSERT_TRUE(getDesignStats(top_cell, &parallel));
+    ASSERT_TRUE(parallel == serial) << num_threads;
+  }
+  ASSERT_FALSE(getDesignStats(nullptr, &serial));
+}
+
+TEST_F(FrozenDBTest, ConcurrentNameLookups) {
+  Cell* top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  ASSERT_TRUE(createChain(top_cell, kNumInsts));
+  uint64_t num_symbols = top_cell->getSymbolTable()->getSymbolCount();
+
+  ASSERT_EQ(lookUpChain(top_cell, kNumInsts), 0);
+  ASSERT_FALSE(isDBFrozen());
+  ASSERT_EQ(top_cell->getSymbolTable()->getSymbolCount(), num_symbols);
+}
+
+// freezeDB builds the indexes of hierarchical cells too, not only those
+// of the top cell.
+TEST_F(FrozenDBTest, HierCellNameLookups) {
+  Cell* top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  std::string cell_name = instName(0) + "_cell";
+  Cell* cell = top_cell->createCell(cell_name, true);
+  ASSERT_NE(cell, nullptr);
+  ASSERT_TRUE(cell->isHierCell());
+  const int num_insts = 1000;
+  ASSERT_TRUE(createChain(cell, num_insts));
+
+  ASSERT_EQ(lookUpChain(cell, num_insts), 0);
+  ASSERT_FALSE(isDBFrozen());
+  ASSERT_EQ(top_cell->getInstance(instName(0)), nullptr);
+}
+
+TEST_F(FrozenDBTest, NoChangesWhileFrozen) {
+  Cell* top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  Inst* inst = top_cell->createObject<Inst>(kObjectTypeInst);
+  ASSERT_NE(inst, nullptr);
+  {
+    FrozenDBScope frozen;
+    {
+      FrozenDBScope nested;
+      ASSERT_EQ(top_cell->createObject<Inst>(kObjectTypeInst), nullptr);
+    }
+    ASSERT_TRUE(isDBFrozen());
+    ASSERT_EQ(top_cell->createObject<Net>(kObjectTypeNet), nullptr);
+    Object::deleteObject<Inst>(inst);
+    ASSERT_EQ(Object::addr<Inst>(inst->getId()), inst);
+    ASSERT_TRUE(inst->getIsValid());
+  }
+  ASSERT_FALSE(isDBFrozen());
+  Inst* other = top_cell->createObject<Inst>(kObjectTypeInst);
+  ASSERT_NE(other, nullptr);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
@@ -0,0 +1,95 @@
+/**
+ * @file   inst_memory.cpp
+ * @date   Oct 2020
+ * @brief  Footprint of instances with sparse optional attributes.
+ */
+
+#include <gtest/gtest.h>
+
+#include "db/core/db.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class InstMemoryTest : public ::testing::Test {
+ public:
+  static const int kNumInsts = 20000;
+  static const int kHaloEvery = 100;  // 1% of instances have a halo
+
+  void SetUp() override { initTopCell(); }
+
+  /// @brief bytes of the pool between two objects allocated by this thread
+  static uint64_t poolBytes(ObjectId first, ObjectId last) {
+    uint64_t page_size = 1ULL << MEM_PAGE_SIZE_BIT;
+    uint64_t first_page = (first & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT;
+    uint64_t last_page = (last & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT;
+    return (last_page - first_page) * page_size +
+           (last & PAGE_OFFSET_MASK) - (first & PAGE_OFFSET_MASK);
+  }
+
+  void testFootprint() {
+    Cell* top_cell = getTopCell();
+    ASSERT_NE(top_cell, nullptr);
+    ArrayObject<ObjectId>* insts = top_cell->getInstanceArray();
+    uint64_t num_existing = insts ? insts->getSize() : 0;
+
+    Inst* first = top_cell->createObject<Inst>(kObjectTypeInst);
+    for (int i = 0; i < kNumInsts; ++i) {
+      Inst* inst = top_cell->createObject<Inst>(kObjectTypeInst);
+      ASSERT_NE(inst, nullptr);
+      inst->setLocation(Point(i, 2 * i));
+      if (i % kHaloEvery == 0) {
+        inst->setHasHalo(true);
+        inst->setHalo(Box(i, i, i, i));
+      }
+      top_cell->addInstance(inst->getId());
+    }
+    Inst* last = top_cell->createObject<Inst>(kObjectTypeInst);
+    insts = top_cell->getInstanceArray();
+    ASSERT_EQ(insts->getSize(), num_existing + kNumInsts);
+
+    // optional attributes read back from the side table.
+    Inst* halo_inst = Object::addr<Inst>((*insts)[num_existing + kHaloEvery]);
+    ASSERT_EQ(halo_inst->getHalo().getLLX(), kHaloEvery);
+    Inst* plain_inst = Object::addr<Inst>((*insts)[num_existing + 1]);
+    ASSERT_EQ(plain_inst->getLocation().getY(), 2);
+    ASSERT_EQ(plain_inst->getHalo().getLLX(), 0);
+    ASSERT_EQ(plain_inst->getMinLayerId(), -1);
+
+    // the optional attributes used to be inline, about 300 bytes each:
+    // an instance without them is the object and its slot in the array.
+    ASSERT_LT(sizeof(Inst), 128u);
+    uint64_t bytes = poolBytes(first->getId(), last->getId());
+    uint64_t expected = kNumInsts * (sizeof(Inst) + sizeof(ObjectId)) +
+                        kNumInsts / kHaloEvery * sizeof(InstSparseAttr);
+    ASSERT_LT(bytes, expected + expected / 4);
+    ASSERT_LT(bytes / kNumInsts, 160u);
+  }
+};
+
+const int InstMemoryTest::kNumInsts;
+const int InstMemoryTest::kHaloEvery;
+
+TEST_F(InstMemoryTest, Footprint) { testFootprint(); }
+
+TEST_F(InstMemoryTest, MaskShift) {
+  Cell* top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  Inst* inst = top_cell->createObject<Inst>(kObjectTypeInst);
+  ASSERT_NE(inst, nullptr);
+  ASSERT_EQ(inst->getMaskShift(0), 0u);
+  inst->setMaskShift(3, 0);
+  inst->setMaskShift(255, 1);
+  ASSERT_EQ(inst->getMaskShift(0), 3u);
+  ASSERT_EQ(inst->getMaskShift(1), 255u);
+  // out of range values and layers are rejected rather than truncated.
+  inst->setMaskShift(256, 0);
+  inst->setMaskShift(1, -1);
+  ASSERT_EQ(inst->getMaskShift(0), 3u);
+  ASSERT_EQ(inst->getMaskShift(-1), 0u);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
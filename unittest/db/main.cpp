@@ -5,7 +5,11 @@
 
 #include <gtest/gtest.h>
 
+#include "util/util.h"
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
+  // the readers and error paths report through the message handler.
+  open_edi::util::utilInit();
   return RUN_ALL_TESTS();
 }
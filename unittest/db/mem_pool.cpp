@@ -0,0 +1,149 @@
+/**
+ * @file   mem_pool.cpp
+ * @date   Oct 2020
+ * @brief  Concurrent allocations and frees of a MemPagePool, and the free
+ *         lists of vector objects.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/util/vector_object_var.h"
+#include "util/thread_pool.h"
+#include "util/util_mem.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+/// id of a freed object in the lists of live ones
+static const uint64_t kFreed = ~0ULL;
+
+class MemPoolTest : public ::testing::Test {
+ public:
+  static const int kNumThreads = 8;
+  static const int kNumObjects = 100000;  // per thread and round
+  static const int kNumRounds = 3;
+  static const int kType = 1;
+
+  /// @brief pool object, tags tell which thread and round wrote it.
+  struct Node {
+    uint64_t id;
+    uint64_t thread;
+    uint64_t index;
+    uint64_t round;
+    uint64_t getId() const { return id; }
+  };
+
+  void TearDown() override {
+    util::ThreadPool::getInstance().setNumThreads(0);
+  }
+};
+
+// threads allocate, check and free objects at the same time. Frees feed
+// the free lists other threads allocate from, and new pages grow the page
+// table while the ids of earlier pages are resolved.
+TEST_F(MemPoolTest, ConcurrentArenas) {
+  util::MemPagePool pool;
+  std::vector<std::vector<uint64_t>> ids(kNumThreads);
+  std::atomic<int> failures(0);
+
+  util::ThreadPool::getInstance().setNumThreads(kNumThreads);
+  for (int round = 0; round < kNumRounds; ++round) {
+    util::parallelFor(0, kNumThreads, [&](int64_t begin, int64_t end) {
+      for (int64_t t = begin; t < end; ++t) {
+        std::vector<uint64_t> &own = ids[t];
+        for (int i = 0; i < kNumObjects; ++i) {
+          uint64_t id = 0;
+          Node *node = pool.allocate<Node>(kType, id);
+          if (node == nullptr) {
+            ++failures;
+            continue;
+          }
+          *node = Node{id, static_cast<uint64_t>(t), own.size(),
+                       static_cast<uint64_t>(round)};
+          own.push_back(id);
+          // an earlier object of this thread, maybe on an older page.
+          uint64_t old_id = own[(i * 7919) % own.size()];
+          Node *old = pool.getObjectPtr<Node>(old_id);
+          if (old->id != old_id || old->thread != static_cast<uint64_t>(t))
+            ++failures;
+        }
+        // free every other object of this round.
+        for (size_t i = own.size() - kNumObjects; i < own.size(); i += 2) {
+          pool.free<Node>(kType, pool.getObjectPtr<Node>(own[i]));
+          own[i] = kFreed;
+        }
+        own.erase(std::remove(own.begin(), own.end(), kFreed), own.end());
+      }
+    }, 1);
+  }
+  ASSERT_EQ(failures, 0);
+
+  // the objects still alive are intact and have distinct ids.
+  std::vector<uint64_t> all;
+  for (int t = 0; t < kNumThreads; ++t) {
+    for (uint64_t id : ids[t]) {
+      Node *node = pool.getObjectPtr<Node>(id);
+      ASSERT_EQ(node->id, id);
+      ASSERT_EQ(node->thread, static_cast<uint64_t>(t));
+      all.push_back(id);
+    }
+  }
+  ASSERT_EQ(all.size(),
+            static_cast<size_t>(kNumThreads) * kNumRounds * kNumObjects / 2);
+  std::sort(all.begin(), all.end());
+  ASSERT_TRUE(std::adjacent_find(all.begin(), all.end()) == all.end());
+}
+
+// vector objects of each size go back to a free list of their own and
+// are taken from it again, not from new memory.
+TEST_F(MemPoolTest, VectorObjects) {
+  initTopCell();
+  ASSERT_NE(getTopCell(), nullptr);
+  util::MemPagePool *pool = getTopCell()->getPool();
+  ASSERT_NE(pool, nullptr);
+  util::MemPool::setCurrentPagePool(pool);
+
+  const int kNumVectors = 100;
+  std::vector<uint64_t> min_ids, max_ids;
+  for (int i = 0; i < kNumVectors; ++i) {
+    VectorObjectMin *min = Object::createVectorObject<VectorObjectMin>();
+    VectorObjectMax *max = Object::createVectorObject<VectorObjectMax>();
+    ASSERT_NE(min, nullptr);
+    ASSERT_NE(max, nullptr);
+    min_ids.push_back(min->getId());
+    max_ids.push_back(max->getId());
+  }
+  uint64_t free_memory = pool->getFreeMemory();
+  for (int i = 0; i < kNumVectors; ++i) {
+    Object::deleteVectorObject(Object::addr<VectorObjectMin>(min_ids[i]));
+    Object::deleteVectorObject(Object::addr<VectorObjectMax>(max_ids[i]));
+  }
+  ASSERT_GT(pool->getFreeMemory(), free_memory);
+
+  std::vector<uint64_t> new_min_ids, new_max_ids;
+  for (int i = 0; i < kNumVectors; ++i) {
+    VectorObjectMax *max = Object::createVectorObject<VectorObjectMax>();
+    VectorObjectMin *min = Object::createVectorObject<VectorObjectMin>();
+    ASSERT_NE(max, nullptr);
+    ASSERT_NE(min, nullptr);
+    new_min_ids.push_back(min->getId());
+    new_max_ids.push_back(max->getId());
+  }
+  ASSERT_EQ(pool->getFreeMemory(), free_memory);
+  std::sort(min_ids.begin(), min_ids.end());
+  std::sort(max_ids.begin(), max_ids.end());
+  std::sort(new_min_ids.begin(), new_min_ids.end());
+  std::sort(new_max_ids.begin(), new_max_ids.end());
+  ASSERT_EQ(new_min_ids, min_ids);
+  ASSERT_EQ(new_max_ids, max_ids);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
@@ -0,0 +1,70 @@
+/**
+ * @file   name_index.cpp
+ * @date   Oct 2020
+ * @brief  Name lookups of instances and nets through the cell name index.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "db/core/db.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class NameIndexTest : public ::testing::Test {
+ public:
+  void SetUp() override { initTopCell(); }
+};
+
+TEST_F(NameIndexTest, Map) {
+  NameIndex index;
+  ASSERT_EQ(index.find(1), 0);
+  for (SymbolIndex key = 1; key <= 1000; ++key) index.insert(key, key * 10);
+  index.insert(7, 1);  // the existing object is kept
+  ASSERT_EQ(index.getSize(), 1000);
+  for (SymbolIndex key = 1; key <= 1000; ++key)
+    ASSERT_EQ(index.find(key), key * 10);
+  for (SymbolIndex key = 1; key <= 1000; key += 2) index.erase(key);
+  for (SymbolIndex key = 1; key <= 1000; ++key)
+    ASSERT_EQ(index.find(key), key % 2 ? 0 : key * 10);
+
+  index.setBuilt(true);
+  NameIndex copy(index);
+  ASSERT_TRUE(copy.isBuilt());
+  ASSERT_EQ(copy.find(8), 80);
+  index.clear();
+  ASSERT_FALSE(index.isBuilt());
+  ASSERT_EQ(index.find(8), 0);
+}
+
+TEST_F(NameIndexTest, Rename) {
+  Cell* top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  std::string inst_name = "name_index_inst";
+  std::string net_name = "name_index_net";
+  Inst* inst = top_cell->createInstance(inst_name);
+  Net* net = top_cell->createNet(net_name);
+  ASSERT_NE(inst, nullptr);
+  ASSERT_NE(net, nullptr);
+  ASSERT_EQ(top_cell->getInstance(inst_name), inst);
+  ASSERT_EQ(top_cell->getNet(net_name), net);
+
+  inst->setName("name_index_inst_renamed");
+  net->setName("name_index_net_renamed");
+  ASSERT_EQ(top_cell->getInstance(inst_name), nullptr);
+  ASSERT_EQ(top_cell->getInstance("name_index_inst_renamed"), inst);
+  ASSERT_EQ(top_cell->getNet(net_name), nullptr);
+  ASSERT_EQ(top_cell->getNet("name_index_net_renamed"), net);
+
+  // the old name is free again.
+  Inst* other = top_cell->createInstance(inst_name);
+  ASSERT_NE(other, nullptr);
+  ASSERT_EQ(top_cell->getInstance(inst_name), other);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
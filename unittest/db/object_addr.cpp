@@ -0,0 +1,66 @@
+/**
+ * @file   object_addr.cpp
+ * @date   Oct 2020
+ * @brief  Object id to pointer translation through the frame table.
+ *         Timings are in bench/object_addr.cpp.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "db/core/db.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class ObjectAddrTest : public ::testing::Test {
+ public:
+  // enough instances for a few pages.
+  static const int kNumInsts = 20000;
+
+  void SetUp() override { initTopCell(); }
+
+  /// @brief the pool -> page -> frame chain addr used to take.
+  static Inst* chainAddr(ObjectId id) {
+    MemPagePool* pool = MemPool::getPagePoolByObjectId(id);
+    if (pool == nullptr) return nullptr;
+    MemPage* page = pool->getPage((id & PAGE_INDEX_MASK) >> MEM_PAGE_SIZE_BIT);
+    return reinterpret_cast<Inst*>(page->getFrame() + (id & PAGE_OFFSET_MASK));
+  }
+};
+
+// ids of objects on several pages give the object the pool, page and
+// frame chain gives, in allocation order and shuffled.
+TEST_F(ObjectAddrTest, SameAsChain) {
+  Cell* top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  std::vector<ObjectId> ids;
+  std::set<ObjectId> pages;
+  for (int i = 0; i < kNumInsts; ++i) {
+    Inst* inst = top_cell->createObject<Inst>(kObjectTypeInst);
+    ASSERT_NE(inst, nullptr);
+    inst->setLocation(Point(i, 0));
+    ids.push_back(inst->getId());
+    pages.insert(inst->getId() & PAGE_INDEX_MASK);
+  }
+  ASSERT_GT(pages.size(), 1u);
+  ASSERT_EQ(Object::addr<Inst>(0), nullptr);
+
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(1));
+  for (ObjectId id : ids) {
+    Inst* inst = chainAddr(id);
+    ASSERT_NE(inst, nullptr);
+    ASSERT_EQ(inst->getId(), id);
+    ASSERT_EQ(Object::addr<Inst>(id), inst);
+    ASSERT_EQ(Object::addrUnchecked<Inst>(id), inst);
+  }
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
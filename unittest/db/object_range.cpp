@@ -0,0 +1,98 @@
+/**
+ * @file   object_range.cpp
+ * @date   Oct 2020
+ * @brief  Typed ranges over the object ids of an ArrayObject, across its
+ *         segments. Timings are in bench/object_range.cpp.
+ */
+
+#include <gtest/gtest.h>
+
+#include "db/core/db.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class ObjectRangeTest : public ::testing::Test {
+ public:
+  static const int64_t kSegmentSize = 32;
+  // a full segment, several more and a partial one.
+  static const int kNumInsts = 10 * kSegmentSize + 7;
+
+  void SetUp() override { initTopCell(); }
+
+  /// @brief kNumInsts insts of the top cell, listed by an array of their
+  /// own rather than by the cell.
+  static ArrayObject<ObjectId> *createInsts() {
+    Cell *top_cell = getTopCell();
+    if (top_cell == nullptr) return nullptr;
+    auto array = top_cell->createObject<ArrayObject<ObjectId>>(
+        kObjectTypeArray);
+    if (array == nullptr) return nullptr;
+    array->setPool(top_cell->getPool());
+    array->reserve(kSegmentSize);
+    for (int i = 0; i < kNumInsts; ++i) {
+      Inst *inst = top_cell->createObject<Inst>(kObjectTypeInst);
+      if (inst == nullptr) return nullptr;
+      inst->setLocation(Point(i, 0));
+      if (!array->pushBack(inst->getId())) return nullptr;
+    }
+    return array;
+  }
+};
+
+const int64_t ObjectRangeTest::kSegmentSize;
+const int ObjectRangeTest::kNumInsts;
+
+TEST_F(ObjectRangeTest, Empty) {
+  ObjectRange<Inst> range(nullptr);
+  ASSERT_TRUE(range.empty());
+  ASSERT_EQ(range.size(), 0);
+  ASSERT_TRUE(range.begin() == range.end());
+  ASSERT_TRUE(ObjectRange<Inst>().empty());
+}
+
+TEST_F(ObjectRangeTest, Insts) {
+  ArrayObject<ObjectId> *inst_array = createInsts();
+  ASSERT_NE(inst_array, nullptr);
+  ObjectRange<Inst> insts(inst_array);
+  ASSERT_FALSE(insts.empty());
+  ASSERT_EQ(insts.size(), kNumInsts);
+
+  // same objects in the same order as the array, across segments.
+  int64_t index = 0;
+  for (auto iter = insts.begin(); iter != insts.end(); ++iter, ++index) {
+    ASSERT_EQ(iter.getId(), (*inst_array)[index]);
+    ASSERT_EQ(*iter, Object::addr<Inst>((*inst_array)[index]));
+    ASSERT_EQ(*iter, insts[index]);
+  }
+  ASSERT_EQ(index, insts.size());
+
+  index = 0;
+  for (Inst *inst : insts) {
+    ASSERT_NE(inst, nullptr);
+    ASSERT_EQ(inst->getLocation().getX(), index++);
+  }
+  ASSERT_EQ(index, kNumInsts);
+  Object::deleteObject<ArrayObject<ObjectId>>(inst_array);
+}
+
+// Cell::insts() lists what the instance array of the cell lists.
+TEST_F(ObjectRangeTest, CellInsts) {
+  Cell *top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  ArrayObject<ObjectId> *inst_array = top_cell->getInstanceArray();
+  ObjectRange<Inst> insts = top_cell->insts();
+  if (inst_array == nullptr) {
+    ASSERT_TRUE(insts.empty());
+    return;
+  }
+  ASSERT_EQ(insts.size(), inst_array->getSize());
+  int64_t index = 0;
+  for (auto iter = insts.begin(); iter != insts.end(); ++iter, ++index)
+    ASSERT_EQ(iter.getId(), (*inst_array)[index]);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
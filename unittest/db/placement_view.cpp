@@ -0,0 +1,93 @@
+/**
+ * @file   placement_view.cpp
+ * @date   Oct 2020
+ * @brief  The placement view of a cell and its instances stay in sync.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/core/placement_view.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class PlacementViewTest : public ::testing::Test {
+ public:
+  static const int kNumInsts = 100;
+
+  void SetUp() override { initTopCell(); }
+  void TearDown() override { getTopCell()->disablePlacementView(); }
+};
+
+TEST_F(PlacementViewTest, Sync) {
+  Cell *top_cell = getTopCell();
+  ASSERT_NE(top_cell, nullptr);
+  top_cell->disablePlacementView();
+  std::vector<Inst *> insts;
+  for (int i = 0; i < kNumInsts; ++i) {
+    std::string name = "placement_view_inst_" + std::to_string(i);
+    Inst *inst = top_cell->createInstance(name);
+    ASSERT_NE(inst, nullptr);
+    inst->setLocation(Point(i, 2 * i));
+    insts.push_back(inst);
+  }
+  // the getter doesn't create a view.
+  ASSERT_EQ(top_cell->getPlacementView(), nullptr);
+  ASSERT_EQ(top_cell->getPlacementView(), nullptr);
+
+  PlacementView *view = top_cell->enablePlacementView();
+  ASSERT_NE(view, nullptr);
+  ASSERT_EQ(top_cell->getPlacementView(), view);
+  ASSERT_EQ(top_cell->enablePlacementView(), view);
+  std::vector<uint64_t> indexes;
+  for (int i = 0; i < kNumInsts; ++i) {
+    uint64_t index = view->getIndex(insts[i]->getId());
+    ASSERT_NE(index, PlacementView::kInvalidIndex);
+    ASSERT_EQ(view->getInst(index), insts[i]);
+    ASSERT_EQ(view->getX()[index], i);
+    ASSERT_EQ(view->getY()[index], 2 * i);
+    indexes.push_back(index);
+  }
+
+  // setters of the instances update the view, new instances are added.
+  insts[3]->setLocation(Point(-3, -6));
+  insts[3]->setStatus(PlaceStatus::kFixed);
+  ASSERT_EQ(view->getX()[indexes[3]], -3);
+  ASSERT_EQ(view->getY()[indexes[3]], -6);
+  ASSERT_EQ(view->getStatus()[indexes[3]], PlaceStatus::kFixed);
+  std::string name = "placement_view_inst_added";
+  Inst *added = top_cell->createInstance(name);
+  ASSERT_NE(added, nullptr);
+  ASSERT_NE(view->getIndex(added->getId()), PlacementView::kInvalidIndex);
+
+  // bulk setters write the instances and skip slots not in the view.
+  indexes.push_back(PlacementView::kInvalidIndex);
+  std::vector<int> x, y;
+  for (int i = 0; i <= kNumInsts; ++i) {
+    x.push_back(10 * i);
+    y.push_back(20 * i);
+  }
+  view->setLocations(indexes.data(), indexes.size(), x.data(), y.data());
+  view->setStatus(indexes.data(), indexes.size(), PlaceStatus::kPlaced);
+  for (int i = 0; i < kNumInsts; ++i) {
+    ASSERT_EQ(insts[i]->getLocation().getX(), 10 * i);
+    ASSERT_EQ(insts[i]->getLocation().getY(), 20 * i);
+    ASSERT_EQ(insts[i]->getStatus(), PlaceStatus::kPlaced);
+    ASSERT_EQ(view->getX()[indexes[i]], 10 * i);
+  }
+
+  // once disabled, setters leave no view behind.
+  top_cell->disablePlacementView();
+  ASSERT_EQ(top_cell->getPlacementView(), nullptr);
+  insts[0]->setLocation(Point(1, 1));
+  ASSERT_EQ(top_cell->getPlacementView(), nullptr);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
@@ -0,0 +1,393 @@
+/**
+ * @file   rc_network.cpp
+ * @date   Oct 2020
+ * @brief  Packing of random RC networks, on the heap and in the timing pool.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/core/timing.h"
+#include "db/timing/spef/net_parasitics.h"
+#include "db/timing/spef/rc_network.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class RcNetworkTest : public ::testing::Test {
+ public:
+  static const int kNumNets = 300;
+
+  /// @brief what identifies a node, whatever its index
+  struct NodeKey {
+    RcNodeType type;
+    ObjectId id;
+    uint32_t number;
+    bool operator==(const NodeKey &rhs) const {
+      return type == rhs.type && id == rhs.id && number == rhs.number;
+    }
+  };
+
+  /// @brief a random net, node keys are unique
+  struct RandomNet {
+    RcNetworkBuilder builder;
+    std::vector<NodeKey> nodes;
+    std::vector<uint32_t> conn;
+    std::vector<RcGroundCap> ground_caps;
+    std::vector<RcCouplingCap> coupling_caps;
+    std::vector<RcResistor> resistors;
+  };
+
+  void SetUp() override { initTopCell(); }
+
+  /// @brief bytes of the pages of a pool in use
+  static uint64_t getUsedMemory(MemPagePool *pool) {
+    return pool->getNumPages() * pool->getPageSize() - pool->getFreeMemory();
+  }
+
+  /// @brief a chain of internal nodes, pins at both ends, packed larger
+  /// than a page of the pool
+  static void makeLargeNet(RandomNet *net) {
+    const uint32_t num_nodes = 100000;
+    for (uint32_t i = 0; i < num_nodes; ++i) {
+      NodeKey key{kRcIntNode, 0, i};
+      if (i == 0 || i == num_nodes - 1) {
+        key = NodeKey{kRcPinNode, 1000 + i, 0};
+        net->builder.addPinNode(key.id);
+      } else {
+        net->builder.addIntNode(key.number);
+      }
+      net->nodes.push_back(key);
+      float value = static_cast<float>(i) + 0.5f;
+      net->ground_caps.push_back(RcGroundCap{i, value});
+      net->builder.addGroundCap(i, value);
+      if (i == 0) continue;
+      net->resistors.push_back(RcResistor{i - 1, i, value});
+      net->builder.addResistor(i - 1, i, value);
+    }
+  }
+
+  static void makeNet(std::mt19937 &rng, int max_nodes, RandomNet *net) {
+    std::uniform_int_distribution<int> size(0, max_nodes);
+    int num_nodes = size(rng);
+    for (int i = 0; i < num_nodes; ++i) {
+      NodeKey key{static_cast<RcNodeType>(rng() % 3), 0, 0};
+      uint32_t node = 0;
+      if (key.type == kRcPinNode) {
+        key.id = 1000 + i;
+        node = net->builder.addPinNode(key.id);
+        if (rng() % 2) {
+          net->builder.addConnNode(node);
+          net->conn.push_back(node);
+        }
+      } else if (key.type == kRcExtNode) {
+        key.id = 5000 + rng() % 4;
+        key.number = i;
+        node = net->builder.addExtNode(key.id, key.number);
+      } else {
+        key.number = i;
+        node = net->builder.addIntNode(key.number);
+      }
+      ASSERT_EQ(node, static_cast<uint32_t>(i));
+      net->nodes.push_back(key);
+    }
+    if (num_nodes == 0) return;
+    std::uniform_int_distribution<uint32_t> pick(0, num_nodes - 1);
+    int num_elements = size(rng);
+    for (int i = 0; i < num_elements; ++i) {
+      float value = static_cast<float>(i) + 0.5f;
+      switch (rng() % 3) {
+        case 0:
+          net->ground_caps.push_back(RcGroundCap{pick(rng), value});
+          net->builder.addGroundCap(net->ground_caps.back().node, value);
+          break;
+        case 1:
+          net->coupling_caps.push_back(
+              RcCouplingCap{pick(rng), pick(rng), value});
+          net->builder.addCouplingCap(net->coupling_caps.back().node1,
+                                      net->coupling_caps.back().node2, value);
+          break;
+        default:
+          net->resistors.push_back(RcResistor{pick(rng), pick(rng), value});
+          net->builder.addResistor(net->resistors.back().node1,
+                                   net->resistors.back().node2, value);
+          break;
+      }
+    }
+  }
+
+  static NodeKey keyOf(const RcNetwork *network, uint32_t node) {
+    NodeKey key{network->getNodeType(node), 0, 0};
+    if (key.type == kRcPinNode) key.id = network->getPinId(node);
+    if (key.type == kRcExtNode) key.id = network->getExtNetId(node);
+    if (key.type != kRcPinNode) key.number = network->getNodeNumber(node);
+    return key;
+  }
+
+  static void checkNet(const RandomNet &net, const RcNetwork *network) {
+    ASSERT_NE(network, nullptr);
+    ASSERT_EQ(network->getNumNodes(), net.nodes.size());
+    ASSERT_TRUE(RcNetwork::isValid(network, network->getMemorySize()));
+    // pin nodes first, then external, then internal ones.
+    for (uint32_t node = 0; node < network->getNumNodes(); ++node) {
+      RcNodeType type = network->getNodeType(node);
+      if (node > 0) {
+        ASSERT_GE(type, network->getNodeType(node - 1));
+      }
+    }
+    std::vector<int> seen(net.nodes.size(), 0);
+    for (uint32_t node = 0; node < network->getNumNodes(); ++node) {
+      NodeKey key = keyOf(network, node);
+      bool found = false;
+      for (size_t i = 0; i < net.nodes.size() && !found; ++i) {
+        if (net.nodes[i] == key) {
+          ++seen[i];
+          found = true;
+        }
+      }
+      ASSERT_TRUE(found);
+    }
+    for (int count : seen) ASSERT_EQ(count, 1);
+
+    RcRange<uint32_t> conn = network->getConnNodes();
+    ASSERT_EQ(conn.size(), net.conn.size());
+    for (uint32_t i = 0; i < conn.size(); ++i)
+      ASSERT_TRUE(keyOf(network, conn[i]) == net.nodes[net.conn[i]]);
+
+    RcRange<RcGroundCap> ground_caps = network->getGroundCaps();
+    ASSERT_EQ(ground_caps.size(), net.ground_caps.size());
+    for (uint32_t i = 0; i < ground_caps.size(); ++i) {
+      ASSERT_EQ(ground_caps[i].capacitance, net.ground_caps[i].capacitance);
+      ASSERT_TRUE(keyOf(network, ground_caps[i].node) ==
+                  net.nodes[net.ground_caps[i].node]);
+    }
+    RcRange<RcCouplingCap> coupling_caps = network->getCouplingCaps();
+    ASSERT_EQ(coupling_caps.size(), net.coupling_caps.size());
+    for (uint32_t i = 0; i < coupling_caps.size(); ++i) {
+      ASSERT_EQ(coupling_caps[i].capacitance,
+                net.coupling_caps[i].capacitance);
+      ASSERT_TRUE(keyOf(network, coupling_caps[i].node1) ==
+                  net.nodes[net.coupling_caps[i].node1]);
+      ASSERT_TRUE(keyOf(network, coupling_caps[i].node2) ==
+                  net.nodes[net.coupling_caps[i].node2]);
+    }
+    RcRange<RcResistor> resistors = network->getResistors();
+    ASSERT_EQ(resistors.size(), net.resistors.size());
+    for (uint32_t i = 0; i < resistors.size(); ++i) {
+      ASSERT_EQ(resistors[i].resistance, net.resistors[i].resistance);
+      ASSERT_TRUE(keyOf(network, resistors[i].node1) ==
+                  net.nodes[net.resistors[i].node1]);
+      ASSERT_TRUE(keyOf(network, resistors[i].node2) ==
+                  net.nodes[net.resistors[i].node2]);
+    }
+
+    // each resistor is listed at both of its ends.
+    std::vector<int> ends(resistors.size(), 0);
+    for (uint32_t node = 0; node < network->getNumNodes(); ++node) {
+      for (uint32_t resistor : network->getNodeResistors(node)) {
+        ASSERT_LT(resistor, resistors.size());
+        ASSERT_TRUE(resistors[resistor].node1 == node ||
+                    resistors[resistor].node2 == node);
+        uint32_t other = network->getOtherNode(resistor, node);
+        ASSERT_LT(other, network->getNumNodes());
+        ++ends[resistor];
+      }
+    }
+    for (int count : ends) ASSERT_EQ(count, 2);
+  }
+};
+
+TEST_F(RcNetworkTest, RandomNets) {
+  std::mt19937 rng(20201102);
+  for (int i = 0; i < kNumNets; ++i) {
+    RandomNet net;
+    makeNet(rng, i % 10 == 0 ? 2000 : 40, &net);
+    RcNetwork *network = RcNetwork::create(net.builder);
+    ASSERT_EQ(network->getMemorySize(),
+              RcNetwork::getPackedSize(net.builder));
+    checkNet(net, network);
+
+    // copies are the same bytes, truncated blocks are rejected.
+    uint64_t size = network->getMemorySize();
+    RcNetwork *copy = RcNetwork::copy(network, size);
+    ASSERT_NE(copy, nullptr);
+    ASSERT_EQ(memcmp(copy, network, size), 0);
+    ASSERT_EQ(RcNetwork::copy(network, size - 4), nullptr);
+    ASSERT_FALSE(RcNetwork::isValid(network, sizeof(RcNetwork) - 1));
+    RcNetwork::destroy(copy);
+    RcNetwork::destroy(network);
+  }
+}
+
+// blocks read from a file: any header field or node index out of place is
+// rejected.
+TEST_F(RcNetworkTest, CorruptBlocks) {
+  std::mt19937 rng(20201104);
+  int num_checked = 0;
+  for (int i = 0; i < kNumNets; ++i) {
+    RandomNet net;
+    makeNet(rng, 40, &net);
+    RcNetwork *network = RcNetwork::create(net.builder);
+    uint64_t size = network->getMemorySize();
+    const char *base = reinterpret_cast<const char *>(network);
+    std::vector<char> block(base, base + size);
+    ASSERT_TRUE(RcNetwork::isValid(block.data(), size));
+    // unaligned blocks are read as well.
+    std::vector<char> shifted(size + 1);
+    memcpy(shifted.data() + 1, block.data(), size);
+    ASSERT_TRUE(RcNetwork::isValid(shifted.data() + 1, size));
+
+    // counts and offsets, each 4 bytes after the size.
+    for (uint64_t pos = sizeof(uint64_t); pos < sizeof(RcNetwork); pos += 4) {
+      std::vector<char> bad = block;
+      uint32_t value = 0;
+      memcpy(&value, bad.data() + pos, sizeof(value));
+      value += 4;
+      memcpy(bad.data() + pos, &value, sizeof(value));
+      ASSERT_FALSE(RcNetwork::isValid(bad.data(), size));
+    }
+
+    // a node or resistor index at or past the end.
+    uint32_t num_nodes = network->getNumNodes();
+    std::vector<uint64_t> node_fields;
+    auto offsetOf = [base](const void *field) {
+      return static_cast<uint64_t>(static_cast<const char *>(field) - base);
+    };
+    if (!network->getConnNodes().empty())
+      node_fields.push_back(offsetOf(network->getConnNodes().begin()));
+    if (!network->getGroundCaps().empty())
+      node_fields.push_back(offsetOf(&network->getGroundCaps()[0].node));
+    if (!network->getCouplingCaps().empty())
+      node_fields.push_back(offsetOf(&network->getCouplingCaps()[0].node2));
+    if (!network->getResistors().empty())
+      node_fields.push_back(offsetOf(&network->getResistors()[0].node1));
+    for (uint64_t pos : node_fields) {
+      std::vector<char> bad = block;
+      memcpy(bad.data() + pos, &num_nodes, sizeof(num_nodes));
+      ASSERT_FALSE(RcNetwork::isValid(bad.data(), size));
+      ++num_checked;
+    }
+    uint32_t num_resistors = network->getResistors().size();
+    for (uint32_t node = 0; node < num_nodes; ++node) {
+      RcRange<uint32_t> resistors = network->getNodeResistors(node);
+      if (resistors.empty()) continue;
+      std::vector<char> bad = block;
+      memcpy(bad.data() + offsetOf(resistors.begin()), &num_resistors,
+             sizeof(num_resistors));
+      ASSERT_FALSE(RcNetwork::isValid(bad.data(), size));
+      // a resistor that is not at this node.
+      for (uint32_t resistor = 0; resistor < num_resistors; ++resistor) {
+        const RcResistor &res = network->getResistors()[resistor];
+        if (res.node1 == node || res.node2 == node) continue;
+        memcpy(bad.data() + offsetOf(resistors.begin()), &resistor,
+               sizeof(resistor));
+        ASSERT_FALSE(RcNetwork::isValid(bad.data(), size));
+        break;
+      }
+      ++num_checked;
+      break;
+    }
+    RcNetwork::destroy(network);
+  }
+  ASSERT_GT(num_checked, 0);
+}
+
+TEST_F(RcNetworkTest, TimingPool) {
+  Timing *timing = getTimingLib();
+  ASSERT_NE(timing, nullptr);
+  std::mt19937 rng(20201103);
+  std::vector<RandomNet> nets(kNumNets);
+  std::vector<ObjectId> ids;
+  for (int i = 0; i < kNumNets; ++i) {
+    makeNet(rng, 60, &nets[i]);
+    DNetParasitics *dnet = timing->createObject<DNetParasitics>(
+        kObjectTypeDNetParasitics, timing->getId());
+    ASSERT_NE(dnet, nullptr);
+    ASSERT_EQ(dnet->getRcNetwork(), nullptr);
+    RcNetwork *network = dnet->createRcNetwork(nets[i].builder);
+    ASSERT_NE(network, nullptr);
+    ASSERT_EQ(dnet->getRcNetwork(), network);
+    ids.push_back(dnet->getId());
+  }
+  // networks are addressed through the pool, as after a restore.
+  for (int i = 0; i < kNumNets; ++i) {
+    DNetParasitics *dnet = Object::addr<DNetParasitics>(ids[i]);
+    checkNet(nets[i], dnet->getRcNetwork());
+  }
+
+  // a copy replaces the network of a net.
+  DNetParasitics *dnet = Object::addr<DNetParasitics>(ids[0]);
+  RcNetwork *heap = RcNetwork::create(nets[1].builder);
+  RcNetwork *copy = dnet->copyRcNetwork(heap, heap->getMemorySize());
+  ASSERT_NE(copy, nullptr);
+  ASSERT_EQ(dnet->getRcNetwork(), copy);
+  checkNet(nets[1], dnet->getRcNetwork());
+  ASSERT_EQ(dnet->copyRcNetwork(heap, heap->getMemorySize() - 4), nullptr);
+  ASSERT_EQ(dnet->getRcNetwork(), copy);
+  RcNetwork::destroy(heap);
+}
+
+// networks larger than a page are split into blocks, and read back in one
+// piece, also when only the blocks are left as after a restore.
+TEST_F(RcNetworkTest, LargeNet) {
+  Timing *timing = getTimingLib();
+  ASSERT_NE(timing, nullptr);
+  MemPagePool *pool = MemPool::getPagePoolByObjectId(timing->getId());
+  ASSERT_NE(pool, nullptr);
+  RandomNet net;
+  makeLargeNet(&net);
+  RcNetwork *heap = RcNetwork::create(net.builder);
+  uint64_t size = heap->getMemorySize();
+  ASSERT_GT(size, pool->getPageSize());
+
+  uint64_t used = getUsedMemory(pool);
+  DNetParasitics *dnet = timing->createObject<DNetParasitics>(
+      kObjectTypeDNetParasitics, timing->getId());
+  ASSERT_NE(dnet, nullptr);
+  uint64_t used_by_net = getUsedMemory(pool);
+  RcNetwork *network = dnet->createRcNetwork(net.builder);
+  ASSERT_NE(network, nullptr);
+  ASSERT_EQ(dnet->getRcNetwork(), network);
+  ASSERT_EQ(memcmp(network, heap, size), 0);
+  ObjectId id = dnet->getId();
+  DNetParasitics::resetSplitRcNetworks();
+  dnet = Object::addr<DNetParasitics>(id);
+  ASSERT_EQ(memcmp(dnet->getRcNetwork(), heap, size), 0);
+
+  // a copy maps pin ids in the blocks as well.
+  network = dnet->copyRcNetwork(heap, size,
+                                [](ObjectId pin_id) { return pin_id + 1; });
+  ASSERT_NE(network, nullptr);
+  DNetParasitics::resetSplitRcNetworks();
+  const RcNetwork *copy = dnet->getRcNetwork();
+  ASSERT_EQ(copy->getNumNodes(), heap->getNumNodes());
+  for (uint32_t node = 0; node < heap->getNumPinNodes(); ++node)
+    ASSERT_EQ(copy->getPinId(node), heap->getPinId(node) + 1);
+  ASSERT_EQ(memcmp(copy->getResistors().begin(), heap->getResistors().begin(),
+                   heap->getResistors().size() * sizeof(RcResistor)),
+            0);
+
+  // the blocks go back to the pool with the net, and are used again.
+  Object::deleteObject<DNetParasitics>(dnet);
+  ASSERT_EQ(getUsedMemory(pool), used);
+  dnet = timing->createObject<DNetParasitics>(kObjectTypeDNetParasitics,
+                                               timing->getId());
+  ASSERT_NE(dnet, nullptr);
+  ASSERT_NE(dnet->createRcNetwork(net.builder), nullptr);
+  uint64_t used_by_network = getUsedMemory(pool) - used_by_net;
+  Object::deleteObject<DNetParasitics>(dnet);
+  ASSERT_EQ(getUsedMemory(pool), used);
+  ASSERT_GT(used_by_network, size);
+  RcNetwork::destroy(heap);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
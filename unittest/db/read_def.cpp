@@ -0,0 +1,296 @@
+/**
+ * @file   read_def.cpp
+ * @date   Oct 2020
+ * @brief  read_def on worker threads builds the same cell as the serial one,
+ *         write_def on them prints the same file.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/io/read_def.h"
+#include "db/io/read_lef.h"
+#include "db/io/write_def.h"
+#include "util/thread_pool.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class ReadDefTest : public ::testing::Test {
+ public:
+  // padded records, so that each section spans a few 4MB chunks.
+  static const int kNumInsts = 30000;
+  static const int kRecordSize = 320;
+  // every kSerialEvery-th record holds a comment the workers leave alone.
+  static const int kSerialEvery = 97;
+
+  void SetUp() override { initTopCell(); }
+  void TearDown() override {
+    for (const std::string &file : files_) std::remove(file.c_str());
+    util::ThreadPool::getInstance().setNumThreads(0);
+  }
+
+  std::string fileName(const std::string &suffix) {
+    std::string name = "unittest_read_def_" + std::to_string(getpid()) +
+                       "_" + suffix;
+    files_.push_back(name);
+    return name;
+  }
+
+  static void writeLef(const std::string &name) {
+    std::ofstream out(name);
+    out << "VERSION 5.8 ;\nBUSBITCHARS \"[]\" ;\nDIVIDERCHAR \"/\" ;\n"
+        << "UNITS\n  DATABASE MICRONS 1000 ;\nEND UNITS\n"
+        << "SITE read_def_site\n  CLASS CORE ;\n  SIZE 0.2 BY 1.4 ;\n"
+        << "END read_def_site\n"
+        << "LAYER read_def_m1\n  TYPE ROUTING ;\n  DIRECTION HORIZONTAL ;\n"
+        << "  PITCH 0.2 ;\n  WIDTH 0.07 ;\nEND read_def_m1\n"
+        << "MACRO read_def_buf\n  CLASS CORE ;\n  ORIGIN 0 0 ;\n"
+        << "  SIZE 0.8 BY 1.4 ;\n  SITE read_def_site ;\n";
+    const char *pins[] = {"A", "Z"};
+    for (const char *pin : pins) {
+      out << "  PIN " << pin << "\n    DIRECTION "
+          << (pin[0] == 'A' ? "INPUT" : "OUTPUT") << " ;\n    PORT\n"
+          << "      LAYER read_def_m1 ;\n        RECT 0.1 0.1 0.2 0.2 ;\n"
+          << "    END\n  END " << pin << "\n";
+    }
+    out << "END read_def_buf\nEND LIBRARY\n";
+  }
+
+  static void pad(std::string *record) {
+    if (record->size() < kRecordSize - 1) record->resize(kRecordSize - 1, ' ');
+    record->push_back('\n');
+  }
+
+  /// @brief a chain of instances named prefix_i, net i drives i + 1,
+  /// lines end in CR LF when crlf is set.
+  static void writeDef(const std::string &name, const std::string &prefix,
+                       bool crlf = false) {
+    std::ostringstream out;
+    out << "VERSION 5.8 ;\nDIVIDERCHAR \"/\" ;\nBUSBITCHARS \"[]\" ;\n"
+        << "DESIGN read_def_test ;\nUNITS DISTANCE MICRONS 1000 ;\n"
+        << "DIEAREA ( 0 0 ) ( 100000000 100000000 ) ;\n";
+    const char *orients[] = {"N", "S", "FN", "FS"};
+    const char *statuses[] = {"PLACED", "FIXED", "COVER"};
+    out << "COMPONENTS " << kNumInsts << " ;\n";
+    for (int i = 0; i < kNumInsts; ++i) {
+      std::string record = "- " + prefix + "i" + std::to_string(i) +
+                           " read_def_buf";
+      if (i % kSerialEvery == 0) record += " # kept serial\n";
+      if (i % 5 == 0) {
+        record += " + UNPLACED";
+      } else {
+        record += std::string(" + ") + statuses[i % 3] + " ( " +
+                  std::to_string(i * 800) + " " +
+                  std::to_string((i % 100) * 1400) + " ) " + orients[i % 4];
+      }
+      if (i % 7 == 0) record += " + SOURCE USER";
+      if (i % 11 == 0) record += " + WEIGHT " + std::to_string(i % 50);
+      record += " ;";
+      pad(&record);
+      out << record;
+    }
+    out << "END COMPONENTS\n";
+    out << "NETS " << kNumInsts - 1 << " ;\n";
+    for (int i = 0; i + 1 < kNumInsts; ++i) {
+      std::string record = "- " + prefix + "n" + std::to_string(i) + " ( " +
+                           prefix + "i" + std::to_string(i) + " Z ) ( " +
+                           prefix + "i" + std::to_string(i + 1) + " A )";
+      if (i % kSerialEvery == 0) record += " # kept serial\n";
+      if (i % 3 == 0) record += " + USE CLOCK";
+      record += " ;";
+      pad(&record);
+      out << record;
+    }
+    out << "END NETS\nEND DESIGN\n";
+
+    std::ofstream file(name, std::ios::binary);
+    for (char c : out.str()) {
+      if (crlf && c == '\n') file << '\r';
+      file << c;
+    }
+  }
+
+  /// @brief read the LEF of the tests once, the top cell is shared.
+  void readLefOnce() {
+    Cell *top_cell = getTopCell();
+    ASSERT_NE(top_cell, nullptr);
+    if (top_cell->getCell("read_def_buf") != nullptr) return;
+    std::string lef = fileName("test.lef");
+    writeLef(lef);
+    const char *lef_argv[] = {"read_lef", lef.c_str()};
+    ASSERT_EQ(readLef(2, lef_argv), 0);
+  }
+
+  /// @brief read a DEF on 4 threads
+  /// @return the number of records the workers parsed, -1 on errors
+  static int64_t readParallel(const std::string &name) {
+    util::ThreadPool::getInstance().setNumThreads(4);
+    const char *argv[] = {"read_def", "-threads", "4", name.c_str()};
+    ::testing::internal::CaptureStdout();
+    int res = readDef(4, argv);
+    std::string output = ::testing::internal::GetCapturedStdout();
+    if (res != 0) return -1;
+    const std::string kParsed = "Parsed ";
+    size_t pos = output.find(kParsed);
+    if (pos == std::string::npos) return 0;
+    return std::stoll(output.substr(pos + kParsed.size()));
+  }
+
+  /// @brief the chains of serial_prefix and parallel_prefix are the same.
+  static void checkSame(const std::string &serial_prefix,
+                        const std::string &parallel_prefix) {
+    Cell *top_cell = getTopCell();
+    ASSERT_NE(top_cell, nullptr);
+    for (int i = 0; i < kNumInsts; ++i) {
+      std::string name = "i" + std::to_string(i);
+      Inst *serial = top_cell->getInstance(serial_prefix + name);
+      Inst *parallel = top_cell->getInstance(parallel_prefix + name);
+      ASSERT_NE(serial, nullptr);
+      ASSERT_NE(parallel, nullptr);
+      ASSERT_NE(serial->getMaster(), nullptr);
+      ASSERT_EQ(parallel->getMaster(), serial->getMaster());
+      ASSERT_EQ(parallel->getStatus(), serial->getStatus());
+      ASSERT_EQ(parallel->getLocation().getX(), serial->getLocation().getX());
+      ASSERT_EQ(parallel->getLocation().getY(), serial->getLocation().getY());
+      ASSERT_EQ(parallel->getOrient(), serial->getOrient());
+      ASSERT_EQ(parallel->getSource(), serial->getSource());
+      ASSERT_EQ(parallel->getWeight(), serial->getWeight());
+      ASSERT_EQ(parallel->numPins(), serial->numPins());
+    }
+    for (int i = 0; i + 1 < kNumInsts; ++i) {
+      std::string name = "n" + std::to_string(i);
+      Net *serial = top_cell->getNet(serial_prefix + name);
+      Net *parallel = top_cell->getNet(parallel_prefix + name);
+      ASSERT_NE(serial, nullptr);
+      ASSERT_NE(parallel, nullptr);
+      ASSERT_EQ(parallel->getType(), serial->getType());
+      std::vector<std::string> serial_pins, parallel_pins;
+      for (Pin *pin : serial->pins())
+        serial_pins.push_back(pinName(pin, serial_prefix));
+      for (Pin *pin : parallel->pins())
+        parallel_pins.push_back(pinName(pin, parallel_prefix));
+      ASSERT_EQ(serial_pins.size(), 2u);
+      ASSERT_EQ(parallel_pins, serial_pins);
+      for (Pin *pin : parallel->pins()) ASSERT_EQ(pin->getNet(), parallel);
+    }
+  }
+
+  /// @brief lines of a DEF file, plain or gzip, without comments: the
+  /// header holds the time it was written.
+  static std::string defContent(const std::string &name) {
+    gzFile file = gzopen(name.c_str(), "rb");
+    if (file == nullptr) return "";
+    std::string bytes;
+    char buffer[1 << 16];
+    int len = 0;
+    while ((len = gzread(file, buffer, sizeof(buffer))) > 0)
+      bytes.append(buffer, len);
+    gzclose(file);
+    std::istringstream in(bytes);
+    std::string content, line;
+    while (std::getline(in, line)) {
+      if (!line.empty() && line[0] == '#') continue;
+      content += line + "\n";
+    }
+    return content;
+  }
+
+  static bool isGzip(const std::string &name) {
+    std::ifstream in(name, std::ios::binary);
+    unsigned char magic[2] = {0, 0};
+    in.read(reinterpret_cast<char *>(magic), sizeof(magic));
+    return magic[0] == 0x1f && magic[1] == 0x8b;
+  }
+
+  static std::string pinName(Pin *pin, const std::string &prefix) {
+    Inst *inst = pin->getInst();
+    return (inst ? inst->getName().substr(prefix.size()) : std::string("PIN")) +
+           "/" + pin->getName();
+  }
+
+ private:
+  std::vector<std::string> files_;
+};
+
+TEST_F(ReadDefTest, SerialAndParallelMatch) {
+  readLefOnce();
+  std::string serial_def = fileName("serial.def");
+  std::string parallel_def = fileName("parallel.def");
+  writeDef(serial_def, "s_");
+  writeDef(parallel_def, "p_");
+
+  const char *serial_argv[] = {"read_def", serial_def.c_str()};
+  ASSERT_EQ(readDef(2, serial_argv), 0);
+  ASSERT_EQ(readParallel(parallel_def), 2 * kNumInsts - 1);
+  checkSame("s_", "p_");
+}
+
+// the workers take CR as white space, as the serial parser does.
+TEST_F(ReadDefTest, CrlfLineEnds) {
+  readLefOnce();
+  std::string serial_def = fileName("serial_lf.def");
+  std::string parallel_def = fileName("parallel_crlf.def");
+  writeDef(serial_def, "ls_");
+  writeDef(parallel_def, "cp_", true);
+
+  const char *serial_argv[] = {"read_def", serial_def.c_str()};
+  ASSERT_EQ(readDef(2, serial_argv), 0);
+  // the workers parse the records, they don't hand them back.
+  ASSERT_EQ(readParallel(parallel_def), 2 * kNumInsts - 1);
+  checkSame("ls_", "cp_");
+}
+
+// records printed on worker threads, and through gzip, make the file the
+// serial writer does.
+TEST_F(ReadDefTest, WriteDefMatchesSerial) {
+  readLefOnce();
+  std::string def = fileName("write_in.def");
+  writeDef(def, "w_");
+  const char *read_argv[] = {"read_def", def.c_str()};
+  ASSERT_EQ(readDef(2, read_argv), 0);
+
+  std::string serial = fileName("serial_out.def");
+  std::string parallel = fileName("parallel_out.def");
+  std::string gzip = fileName("gzip_out.def");
+  std::string gz = fileName("out.def.gz");
+  util::ThreadPool::getInstance().setNumThreads(4);
+  const char *serial_argv[] = {"write_def", serial.c_str()};
+  const char *parallel_argv[] = {"write_def", "-threads", "4",
+                                 parallel.c_str()};
+  const char *gzip_argv[] = {"write_def", "-threads", "3", "-gzip",
+                             gzip.c_str()};
+  const char *gz_argv[] = {"write_def", gz.c_str()};
+  ASSERT_EQ(db::writeDef(2, serial_argv), 0);
+  ASSERT_EQ(db::writeDef(4, parallel_argv), 0);
+  ASSERT_EQ(db::writeDef(5, gzip_argv), 0);
+  ASSERT_EQ(db::writeDef(2, gz_argv), 0);
+
+  std::string expected = defContent(serial);
+  // chunks of 1024 records, several of them per section.
+  ASSERT_NE(expected.find("- w_i" + std::to_string(kNumInsts - 1) + " "),
+            std::string::npos);
+  ASSERT_NE(expected.find("- w_n" + std::to_string(kNumInsts - 2)),
+            std::string::npos);
+  ASSERT_FALSE(isGzip(serial));
+  ASSERT_FALSE(isGzip(parallel));
+  ASSERT_TRUE(isGzip(gzip));
+  ASSERT_TRUE(isGzip(gz));
+  // not ASSERT_EQ, a mismatch would print all of both files.
+  ASSERT_TRUE(defContent(parallel) == expected);
+  ASSERT_TRUE(defContent(gzip) == expected);
+  ASSERT_TRUE(defContent(gz) == expected);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
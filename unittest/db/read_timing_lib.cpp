@@ -0,0 +1,446 @@
+/**
+ * @file   read_timing_lib.cpp
+ * @date   Nov 2020
+ * @brief  read_timing_library builds the same libraries however a file is
+ *         read: streamed, in threads or from a cache.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/io/read_write_db.h"
+#include "db/timing/timinglib/analysis_corner.h"
+#include "db/timing/timinglib/libset.h"
+#include "db/timing/timinglib/timinglib_cell.h"
+#include "db/timing/timinglib/timinglib_libcache.h"
+#include "db/timing/timinglib/timinglib_libstaging.h"
+#include "db/timing/timinglib/timinglib_lib.h"
+#include "db/timing/timinglib/timinglib_tcl_command.h"
+#include "db/timing/timinglib/timinglib_term.h"
+#include "db/timing/timinglib/timinglib_timingarc.h"
+#include "util/thread_pool.h"
+#include "util/version.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class ReadTimingLibTest : public ::testing::Test {
+ public:
+  static const int kNumCells = 64;
+  static const int kNumFiles = 6;
+  static const int kWindow = 2;
+
+  void SetUp() override {
+    initTopCell();
+    top_name_ = getTopCell()->getName();
+    base_ = "unittest_rtl_" + std::to_string(getpid()) + "_base";
+    WriteDesign write_design(base_);
+    ASSERT_EQ(write_design.run(), OK);
+  }
+  void TearDown() override {
+    restoreBase();
+    removeDesign(base_);
+    for (const std::string &file : files_) std::remove(file.c_str());
+    for (const std::string &dir : dirs_) removeDir(dir);
+  }
+
+  static void removeDesign(const std::string &name) {
+    std::string libs = name + kLibSubDirName + "/";
+    for (const std::string &file :
+         {name + "/" + name, libs + kTechLibName, libs + kTimingLibName}) {
+      for (const char *postfix :
+           {kDBFilePostFix, kSymFilePostFix, kPolyFilePostFix})
+        std::remove((file + postfix).c_str());
+    }
+    rmdir((name + kLibSubDirName).c_str());
+    rmdir(name.c_str());
+  }
+
+  /// @brief the design as the test found it. Libraries read after this get
+  /// the same ids as after any other restore.
+  void restoreBase() {
+    ReadDesign read_design(base_);
+    read_design.setTop();
+    ASSERT_EQ(read_design.run(), OK);
+    // the top cell is saved under the name of the design.
+    getTopCell()->setName(top_name_);
+  }
+
+  std::string fileName(const std::string &suffix) {
+    std::string name = "unittest_rtl_" + std::to_string(getpid()) + "_" +
+                       suffix;
+    files_.push_back(name);
+    return name;
+  }
+
+  /// @brief a library of num_cells cells, each with two inputs and an
+  /// output timed from both. Top level groups end in all the ways the
+  /// next token may follow them: on the same line, after a comment, and
+  /// followed by an attribute or by another kind of group. Statements
+  /// without a semicolon make the parser read the token after them.
+  static std::string libContent(const std::string &lib_name,
+                                int num_cells) {
+    std::ostringstream os;
+    os << "library (" << lib_name << ") {\n"
+       << "  delay_model : table_lookup;\n"
+       << "  time_unit : \"1ns\";\n"
+       << "  capacitive_load_unit (1, pf);\n"
+       << "  nom_voltage : 1.0;\n"
+       << "  lu_table_template (tmpl_2x3) {\n"
+       << "    variable_1 : input_net_transition;\n"
+       << "    variable_2 : total_output_net_capacitance;\n"
+       << "    index_1 (\"0.01, 0.1\");\n"
+       << "    index_2 (\"0.001, 0.01, 0.1\");\n"
+       << "  }";
+    for (int i = 0; i < num_cells; ++i) {
+      switch (i % 4) {
+        case 0: os << "\n  "; break;
+        case 1: break;  // on the line of the closing brace
+        case 2: os << " /* cell " << i << " */\n  "; break;
+        case 3:
+          os << "\n  default_max_transition : " << (0.5 + i)
+             << " lu_table_template (tmpl_" << i << ") {"
+             << " variable_1 : input_net_transition;"
+             << " index_1 (\"0.01, 0.1\") } ";
+          break;
+      }
+      os << "cell (" << lib_name << "_C" << i << ") {\n"
+         << "    area : " << (1.5 + i) << ";\n"
+         << "    pin (A) { direction : input; capacitance : "
+         << (0.001 * (i + 1)) << "; }\n"
+         << "    pin (B) { direction : input; capacitance : "
+         << (0.002 * (i + 1)) << "; }\n"
+         << "    pin (Z) {\n"
+         << "      direction : output;\n"
+         << "      function : \"(A & B)\";\n"
+         << "      max_capacitance : " << (0.1 + i) << ";\n";
+      for (const char *related : {"A", "B"}) {
+        os << "      timing () {\n"
+           << "        related_pin : \"" << related << "\";\n"
+           << "        timing_sense : positive_unate;\n"
+           << "        cell_rise (tmpl_2x3) {\n"
+           << "          values (\"" << i << ".1, " << i << ".2, " << i
+           << ".3\", \"" << i << ".4, " << i << ".5, " << i << ".6\");\n"
+           << "        }\n"
+           << "        rise_transition (tmpl_2x3) {\n"
+           << "          values (\"0.1, 0.2, 0.3\", \"0.4, 0.5, " << i
+           << ".7\");\n"
+           << "        }\n"
+           << "      }\n";
+      }
+      os << "    }\n";
+      // the parser reads the closing brace ahead of a statement without
+      // its semicolon.
+      if (i % 2) os << "    cell_footprint : \"fp_" << i << "\"\n";
+      os << "  }";
+    }
+    os << "\n}\n";
+    return os.str();
+  }
+
+  std::string writeLib(const std::string &lib_name, int num_cells) {
+    std::string file = fileName(lib_name + ".lib");
+    std::ofstream(file) << libContent(lib_name, num_cells);
+    return file;
+  }
+
+  /// @brief the libraries read into the default corner
+  static LibSet *getLibSet() {
+    AnalysisCorner *corner = getTimingLib()->getAnalysisCorner("default");
+    return corner ? corner->getLibset() : nullptr;
+  }
+
+  /// @brief read_timing_library with args into the restored design, and
+  /// a dump of the libraries read
+  std::string readLib(std::vector<std::string> args) {
+    restoreBase();
+    args.insert(args.begin(), "read_timing_library");
+    std::vector<const char *> argv;
+    for (const std::string &arg : args) argv.push_back(arg.c_str());
+    if (readTimingLibCommand(nullptr, nullptr, argv.size(), argv.data()) !=
+        TCL_OK)
+      return "";
+    LibSet *libset = getLibSet();
+    if (libset == nullptr) return "";
+    OStream<std::ostringstream> os;
+    os << *libset;
+    return os.getStream().str();
+  }
+
+  /// @brief an empty directory for liberty caches
+  std::string cacheDir() {
+    std::string dir = "unittest_rtl_" + std::to_string(getpid()) + "_cache";
+    mkdir(dir.c_str(), 0755);
+    dirs_.push_back(dir);
+    return dir;
+  }
+
+  static void removeDir(const std::string &dir) {
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr) return;
+    while (struct dirent *entry = readdir(d)) {
+      std::string name = entry->d_name;
+      if (name != "." && name != "..") std::remove((dir + "/" + name).c_str());
+    }
+    closedir(d);
+    rmdir(dir.c_str());
+  }
+
+  /// @brief the cache file in dir, "" unless there is just one
+  static std::string getCacheFile(const std::string &dir) {
+    std::vector<std::string> caches;
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr) return "";
+    while (struct dirent *entry = readdir(d)) {
+      std::string name = entry->d_name;
+      if (name.size() > 6 && name.substr(name.size() - 6) == ".tlibc")
+        caches.push_back(dir + "/" + name);
+    }
+    closedir(d);
+    return caches.size() == 1 ? caches[0] : "";
+  }
+
+  static std::string readBytes(const std::string &file) {
+    std::ifstream in(file, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+  }
+
+  static void writeBytes(const std::string &file, const std::string &bytes) {
+    std::ofstream(file, std::ios::binary | std::ios::trunc)
+        .write(bytes.data(), bytes.size());
+  }
+
+  /// @brief whether the cache in dir is used for file
+  static bool loadCache(const std::string &dir, const std::string &file) {
+    Timinglib::LibCache cache(dir);
+    Timinglib::LibCache::Key key;
+    Timinglib::LibStaging staging;
+    return cache.getKey(file, &key) && cache.load(file, key, &staging) &&
+           staging.getNumEvents() > 0;
+  }
+
+  /// @brief write contents to the pipes of files as they are opened. Each
+  /// file is fed once opened, except the first one not fed yet: it waits
+  /// until no other file has opened for a while, for files to be opened
+  /// as far ahead as they can be. Returns false if a file was opened
+  /// before the file window places ahead of it was fed.
+  static bool feedPipes(const std::vector<std::string> &files,
+                        const std::vector<std::string> &contents,
+                        size_t window) {
+    using Clock = std::chrono::steady_clock;
+    size_t num_files = files.size();
+    std::vector<int> fds(num_files, -1);
+    std::vector<bool> fed(num_files, false);
+    bool in_window = true;
+    size_t first = 0;
+    Clock::time_point quiet = Clock::now();
+    Clock::time_point deadline = Clock::now() + std::chrono::seconds(60);
+    while (first < num_files && Clock::now() < deadline) {
+      for (size_t i = first; i < num_files; ++i) {
+        if (fed[i] || fds[i] != -1) continue;
+        // fails until the file is opened for reading.
+        fds[i] = open(files[i].c_str(), O_WRONLY | O_NONBLOCK);
+        if (fds[i] == -1) continue;
+        fcntl(fds[i], F_SETFL, 0);
+        if (i >= window && !fed[i - window]) in_window = false;
+        quiet = Clock::now() + std::chrono::milliseconds(100);
+      }
+      for (size_t i = first; i < num_files; ++i) {
+        if (fed[i] || fds[i] == -1) continue;
+        if (i == first && Clock::now() < quiet) continue;
+        const std::string &content = contents[i];
+        for (size_t done = 0; done < content.size();) {
+          ssize_t size = write(fds[i], content.data() + done,
+                               content.size() - done);
+          if (size <= 0) break;
+          done += size;
+        }
+        close(fds[i]);
+        fds[i] = -1;
+        fed[i] = true;
+      }
+      while (first < num_files && fed[first]) ++first;
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return in_window && first == num_files;
+  }
+
+ private:
+  std::string top_name_;
+  std::string base_;
+  std::vector<std::string> files_;
+  std::vector<std::string> dirs_;
+};
+
+const int ReadTimingLibTest::kNumCells;
+const int ReadTimingLibTest::kNumFiles;
+const int ReadTimingLibTest::kWindow;
+
+// a -stream build is the tree build: the same cells, terms, arcs and
+// tables, and the same ids.
+TEST_F(ReadTimingLibTest, StreamMatchesTree) {
+  std::string file = writeLib("rtl_stream", kNumCells);
+  std::string tree = readLib({file});
+  ASSERT_NE(tree, "");
+  std::string stream = readLib({"-stream", file});
+  // not ASSERT_EQ, a mismatch would print all of both dumps.
+  ASSERT_TRUE(stream == tree);
+
+  LibSet *libset = getLibSet();
+  ASSERT_NE(libset, nullptr);
+  for (int i = 0; i < kNumCells; ++i) {
+    std::string name = "rtl_stream_C" + std::to_string(i);
+    TCell *cell = libset->getTimingCell(name);
+    ASSERT_NE(cell, nullptr) << name;
+    ASSERT_EQ(cell->getName(), name);
+    if (i % 2) ASSERT_EQ(cell->getCellFootprint(), "fp_" + std::to_string(i));
+  }
+}
+
+// -threads builds the files as a sequential read does, with the same ids,
+// and parses at most -threads files ahead of the one being built.
+TEST_F(ReadTimingLibTest, ThreadsMatchSequential) {
+  std::vector<std::string> files;
+  std::vector<std::string> contents;
+  for (int i = 0; i < kNumFiles; ++i) {
+    std::string lib_name = "rtl_threads" + std::to_string(i);
+    files.push_back(writeLib(lib_name, 8));
+    contents.push_back(libContent(lib_name, 8));
+  }
+  std::string sequential = readLib(files);
+  ASSERT_NE(sequential, "");
+
+  // the files again as pipes fed by this test, a file is parsed once it
+  // is opened. More workers than the window would parse all of them.
+  for (const std::string &file : files) {
+    std::remove(file.c_str());
+    ASSERT_EQ(mkfifo(file.c_str(), 0600), 0);
+  }
+  util::ThreadPool::getInstance().setNumThreads(kWindow + 2);
+  bool in_window = false;
+  std::thread feeder(
+      [&]() { in_window = feedPipes(files, contents, kWindow); });
+  std::vector<std::string> args = {"-threads", std::to_string(kWindow)};
+  args.insert(args.end(), files.begin(), files.end());
+  std::string threaded = readLib(args);
+  feeder.join();
+  ASSERT_TRUE(in_window);
+  ASSERT_TRUE(threaded == sequential);
+}
+
+// a cached library is the parsed one.
+TEST_F(ReadTimingLibTest, CacheRoundTrip) {
+  std::string file = writeLib("rtl_cache", 16);
+  std::string parsed = readLib({file});
+  ASSERT_NE(parsed, "");
+  std::string dir = cacheDir();
+  ASSERT_TRUE(readLib({"-cache_dir", dir, file}) == parsed);
+  ASSERT_NE(getCacheFile(dir), "");
+  ASSERT_TRUE(loadCache(dir, file));
+  ASSERT_TRUE(readLib({"-cache_dir", dir, file}) == parsed);
+}
+
+// damaged caches, and caches of another version, are parsed again and
+// saved over.
+TEST_F(ReadTimingLibTest, DamagedCache) {
+  std::string file = writeLib("rtl_damaged", 16);
+  std::string parsed = readLib({file});
+  ASSERT_NE(parsed, "");
+  std::string dir = cacheDir();
+  ASSERT_TRUE(readLib({"-cache_dir", dir, file}) == parsed);
+  std::string cache = getCacheFile(dir);
+  ASSERT_NE(cache, "");
+  std::string good = readBytes(cache);
+
+  util::Version version;
+  version.init();
+  std::string version_string = version.getVersionString();
+  std::string cell_name = "rtl_damaged_C7";
+  size_t version_pos = good.find(version_string);
+  size_t cell_pos = good.rfind(cell_name);
+  ASSERT_NE(version_pos, std::string::npos);
+  ASSERT_NE(cell_pos, std::string::npos);
+  std::string other_version = good;
+  other_version[version_pos + version_string.size() - 1] ^= 1;
+  std::string renamed_cell = good;
+  renamed_cell[cell_pos + cell_name.size() - 2] = 'X';
+  std::string truncated = good.substr(0, good.size() - 8);
+  std::string half = good.substr(0, good.size() / 2);
+
+  for (const std::string &bad :
+       {other_version, renamed_cell, truncated, half}) {
+    writeBytes(cache, bad);
+    ASSERT_FALSE(loadCache(dir, file));
+    ASSERT_TRUE(readLib({"-cache_dir", dir, file}) == parsed);
+    ASSERT_TRUE(readBytes(cache) == good);
+  }
+}
+
+// lookups of names not in the libraries create no symbols.
+TEST_F(ReadTimingLibTest, LookupsCreateNoSymbols) {
+  std::string file = writeLib("rtl_lookup", 4);
+  ASSERT_NE(readLib({file}), "");
+  LibSet *libset = getLibSet();
+  ASSERT_NE(libset, nullptr);
+  TLib *lib = libset->getTLib(file);
+  ASSERT_NE(lib, nullptr);
+  TCell *cell = libset->getTimingCell("rtl_lookup_C1");
+  ASSERT_NE(cell, nullptr);
+  ASSERT_EQ(lib->getTimingCell("rtl_lookup_C1"), cell);
+  TTerm *term = cell->getTerm("Z");
+  ASSERT_NE(term, nullptr);
+  std::vector<TimingArc *> arcs = term->getTimingarcs();
+  ASSERT_EQ(arcs.size(), 2);
+  ASSERT_EQ(arcs[0]->getRelatedPin("A"), cell->getTerm("A"));
+  ASSERT_EQ(arcs[1]->getRelatedPin("B"), cell->getTerm("B"));
+
+  SymbolTable *symbols = getTimingLib()->getSymbolTable();
+  uint64_t num_symbols = symbols->getSymbolCount();
+  ASSERT_EQ(libset->getTLib("rtl_lookup_missing.lib"), nullptr);
+  ASSERT_EQ(libset->getTimingCell("rtl_lookup_missing"), nullptr);
+  ASSERT_EQ(lib->getTimingCell("rtl_lookup_missing"), nullptr);
+  ASSERT_EQ(cell->getTerm("missing_pin"), nullptr);
+  ASSERT_EQ(cell->getPgTerm("missing_pg_pin"), nullptr);
+  ASSERT_EQ(arcs[0]->getRelatedPin("missing_pin"), nullptr);
+  ASSERT_EQ(symbols->getSymbolCount(), num_symbols);
+}
+
+// getOrCreateTerm names the term it creates, not its cell.
+TEST_F(ReadTimingLibTest, GetOrCreateTerm) {
+  std::string file = writeLib("rtl_terms", 2);
+  ASSERT_NE(readLib({file}), "");
+  LibSet *libset = getLibSet();
+  ASSERT_NE(libset, nullptr);
+  TCell *cell = libset->getTimingCell("rtl_terms_C0");
+  ASSERT_NE(cell, nullptr);
+  size_t num_terms = cell->getTerms().size();
+
+  TTerm *term = cell->getOrCreateTerm("Y");
+  ASSERT_NE(term, nullptr);
+  ASSERT_EQ(term->getName(), "Y");
+  ASSERT_EQ(cell->getName(), "rtl_terms_C0");
+  ASSERT_EQ(libset->getTimingCell("rtl_terms_C0"), cell);
+  ASSERT_EQ(cell->getTerm("Y"), term);
+  ASSERT_EQ(cell->getOrCreateTerm("Y"), term);
+  ASSERT_EQ(cell->getOrCreateTerm("A"), cell->getTerm("A"));
+  ASSERT_EQ(cell->getTerms().size(), num_terms + 1);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
@@ -0,0 +1,239 @@
+/**
+ * @file   read_write_db.cpp
+ * @date   Oct 2020
+ * @brief  write_design and read_design give back the same design, damaged
+ *         files are rejected.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/io/read_write_db.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class ReadWriteDBTest : public ::testing::Test {
+ public:
+  static const int kNumNets = 3000;
+
+  void SetUp() override {
+    initTopCell();
+    top_name_ = getTopCell()->getName();
+  }
+  void TearDown() override {
+    for (const std::string &name : designs_) removeDesign(name);
+  }
+
+  std::string designName(const std::string &suffix) {
+    std::string name = "unittest_rwdb_" + std::to_string(getpid()) + "_" +
+                       suffix;
+    designs_.push_back(name);
+    return name;
+  }
+
+  static std::string netName(int i) { return "rwdb_n" + std::to_string(i); }
+
+  /// @brief files of a design, without their postfixes
+  static std::vector<std::string> designFiles(const std::string &name) {
+    std::string libs = name + kLibSubDirName + "/";
+    return {name + "/" + name, libs + kTechLibName, libs + kTimingLibName};
+  }
+
+  static void removeDesign(const std::string &name) {
+    for (const std::string &file : designFiles(name)) {
+      for (const char *postfix :
+           {kDBFilePostFix, kSymFilePostFix, kPolyFilePostFix})
+        std::remove((file + postfix).c_str());
+    }
+    rmdir((name + kLibSubDirName).c_str());
+    rmdir(name.c_str());
+  }
+
+  /// @brief nets that tell one design from another, a few pages of them
+  static void createNets() {
+    Cell *top_cell = getTopCell();
+    for (int i = 0; i < kNumNets; ++i) {
+      std::string name = netName(i);
+      if (top_cell->getNet(name) == nullptr) top_cell->createNet(name);
+    }
+  }
+
+  static void checkNets() {
+    Cell *top_cell = getTopCell();
+    ASSERT_NE(top_cell, nullptr);
+    for (int i = 0; i < kNumNets; ++i) {
+      Net *net = top_cell->getNet(netName(i));
+      ASSERT_NE(net, nullptr);
+      ASSERT_EQ(net->getName(), netName(i));
+    }
+  }
+
+  static int writeDesign(const std::string &name, bool compress) {
+    WriteDesign write_design(name);
+    write_design.setCompress(compress);
+    write_design.setNumThreads(2);
+    return write_design.run();
+  }
+
+  int readDesign(const std::string &name, bool use_mmap, bool verify) {
+    ReadDesign read_design(name);
+    read_design.setTop();
+    read_design.setMmap(use_mmap);
+    read_design.setVerify(verify);
+    read_design.setNumThreads(2);
+    int ret = read_design.run();
+    // the top cell is saved under the name of the design.
+    if (ret == OK) getTopCell()->setName(top_name_);
+    return ret;
+  }
+
+  /// @brief a copy of a design under another name
+  static void copyDesign(const std::string &from, const std::string &to) {
+    mkdir(to.c_str(), 0755);
+    mkdir((to + kLibSubDirName).c_str(), 0755);
+    std::vector<std::string> from_files = designFiles(from);
+    std::vector<std::string> to_files = designFiles(to);
+    for (size_t i = 0; i < from_files.size(); ++i) {
+      for (const char *postfix :
+           {kDBFilePostFix, kSymFilePostFix, kPolyFilePostFix}) {
+        std::ifstream in(from_files[i] + postfix, std::ios::binary);
+        std::ofstream out(to_files[i] + postfix, std::ios::binary);
+        out << in.rdbuf();
+      }
+    }
+  }
+
+  /// @brief keep the first size bytes of a file and then its last tail
+  /// bytes
+  static void cutFile(const std::string &file, uint64_t size,
+                      uint64_t tail) {
+    std::ifstream in(file, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+    in.close();
+    std::string cut = bytes.substr(0, size) +
+                      bytes.substr(bytes.size() - tail, tail);
+    std::ofstream(file, std::ios::binary).write(cut.data(), cut.size());
+  }
+
+  static uint64_t fileSize(const std::string &file) {
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    return in.tellg();
+  }
+
+  /// @brief flip a byte of the first page of pool content in a .db file
+  static void corruptFirstPage(const std::string &db_file) {
+    std::fstream file(db_file,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    // the file ends with the size of its header and the checksum of it.
+    file.seekg(-2 * static_cast<int>(sizeof(uint32_t)), std::ios::end);
+    uint32_t file_header_size = 0;
+    file.read(reinterpret_cast<char *>(&file_header_size),
+              sizeof(file_header_size));
+    std::streamoff pos = file_header_size + 64;
+    file.seekg(pos);
+    char byte = 0;
+    file.read(&byte, 1);
+    byte ^= 0x5a;
+    file.seekp(pos);
+    file.write(&byte, 1);
+  }
+
+ private:
+  std::string top_name_;
+  std::vector<std::string> designs_;
+};
+
+const int ReadWriteDBTest::kNumNets;
+
+// compressed pages are read back, mapping such files falls back to reading.
+TEST_F(ReadWriteDBTest, CompressedRoundTrip) {
+  createNets();
+  std::string name = designName("zlib");
+  ASSERT_EQ(writeDesign(name, true), OK);
+  ASSERT_EQ(readDesign(name, false, false), OK);
+  checkNets();
+  ASSERT_EQ(readDesign(name, true, true), OK);
+  checkNets();
+}
+
+// a corrupted page fails read_design, and read_design -mmap -verify. Plain
+// -mmap leaves checksums to the reader of the page.
+TEST_F(ReadWriteDBTest, CorruptedPage) {
+  createNets();
+  std::string name = designName("good");
+  std::string bad = designName("bad");
+  ASSERT_EQ(writeDesign(name, false), OK);
+  copyDesign(name, bad);
+  corruptFirstPage(designFiles(bad)[0] + kDBFilePostFix);
+
+  ASSERT_NE(readDesign(bad, false, false), OK);
+  ASSERT_NE(readDesign(bad, true, true), OK);
+  ASSERT_EQ(readDesign(name, true, true), OK);
+  checkNets();
+  ASSERT_EQ(readDesign(name, false, false), OK);
+  checkNets();
+}
+
+// a mapped design is written while its file is still mapped, and read
+// back mapped again.
+TEST_F(ReadWriteDBTest, MmapRoundTrip) {
+  createNets();
+  std::string name = designName("mmap");
+  std::string again = designName("mmap_again");
+  ASSERT_EQ(writeDesign(name, false), OK);
+  ASSERT_EQ(readDesign(name, true, false), OK);
+  checkNets();
+  // pages written after mapping are copied, the file keeps its content.
+  std::string net_name = "rwdb_mapped";
+  ASSERT_NE(getTopCell()->createNet(net_name), nullptr);
+  ASSERT_EQ(writeDesign(again, false), OK);
+  ASSERT_EQ(writeDesign(name, false), OK);
+  ASSERT_EQ(readDesign(again, true, true), OK);
+  checkNets();
+  ASSERT_NE(getTopCell()->getNet(net_name), nullptr);
+  ASSERT_EQ(readDesign(name, true, false), OK);
+  checkNets();
+  ASSERT_NE(getTopCell()->getNet(net_name), nullptr);
+}
+
+// cut files are rejected before any page is used, mapped or not: the tail
+// of the file is lost, or a page in front of an intact tail.
+TEST_F(ReadWriteDBTest, TruncatedFile) {
+  createNets();
+  std::string name = designName("whole");
+  std::string half = designName("half");
+  std::string short_page = designName("short_page");
+  ASSERT_EQ(writeDesign(name, false), OK);
+  copyDesign(name, half);
+  copyDesign(name, short_page);
+  std::string db_file = designFiles(name)[0] + kDBFilePostFix;
+  uint64_t size = fileSize(db_file);
+  uint64_t page_size = getTopCell()->getPool()->getPageSize();
+  ASSERT_GT(size, page_size);
+  cutFile(designFiles(half)[0] + kDBFilePostFix, size / 2, 0);
+  cutFile(designFiles(short_page)[0] + kDBFilePostFix,
+          size - page_size / 2 - 2 * sizeof(uint32_t),
+          2 * sizeof(uint32_t));
+
+  for (const std::string &cut : {half, short_page}) {
+    ASSERT_NE(readDesign(cut, true, false), OK);
+    ASSERT_NE(readDesign(cut, false, false), OK);
+  }
+  ASSERT_EQ(readDesign(name, true, false), OK);
+  checkNets();
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
@@ -0,0 +1,356 @@
+/**
+ * @file   spef_reader.cpp
+ * @date   Oct 2020
+ * @brief  read_spef on worker threads builds the same parasitics as the
+ *         serial one.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/core/timing.h"
+#include "db/timing/spef/design_parasitics.h"
+#include "db/timing/spef/net_parasitics.h"
+#include "db/timing/spef/nets_parasitics.h"
+#include "db/timing/spef/parasitics_cache.h"
+#include "db/timing/spef/rc_network.h"
+#include "db/timing/spef/spef_lazy_loader.h"
+#include "db/timing/spef/spef_reader.h"
+#include "db/timing/spef/spef_tcl_command.h"
+#include "util/thread_pool.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class SpefReaderTest : public ::testing::Test {
+ public:
+  static const int kNumNets = 2000;
+  static const int kNumThreads = 4;
+  // every kReducedEvery-th net is written as an R_NET.
+  static const int kReducedEvery = 13;
+  static const int kCacheSize = 100;
+
+  void SetUp() override { initTopCell(); }
+  void TearDown() override {
+    for (const std::string &file : files_) std::remove(file.c_str());
+    util::ThreadPool::getInstance().setNumThreads(0);
+  }
+
+  std::string fileName(const std::string &suffix) {
+    std::string name = "unittest_spef_reader_" + std::to_string(getpid()) +
+                       "_" + suffix;
+    files_.push_back(name);
+    return name;
+  }
+
+  static std::string netName(int i) { return "spef_n" + std::to_string(i); }
+  static std::string portName(int i) { return "spef_p" + std::to_string(i); }
+
+  /// @brief nets with a port each, and a few nets missing in the design
+  static void writeSpef(const std::string &name, const std::string &design) {
+    std::ofstream out(name);
+    out << "*SPEF \"IEEE 1481-1998\"\n*DESIGN \"" << design << "\"\n"
+        << "*DATE \"Mon Nov 2 00:00:00 2020\"\n*VENDOR \"unittest\"\n"
+        << "*PROGRAM \"unittest\"\n*VERSION \"1.0\"\n"
+        << "*DESIGN_FLOW \"EXTERNAL_LOADS\"\n*DIVIDER /\n*DELIMITER :\n"
+        << "*BUS_DELIMITER [ ]\n*T_UNIT 1 NS\n*C_UNIT 1 PF\n*R_UNIT 1 OHM\n"
+        << "*L_UNIT 1 HENRY\n\n";
+    for (int i = 0; i < kNumNets + 10; ++i) {
+      std::string net = i < kNumNets ? netName(i) : "spef_missing" +
+                                                        std::to_string(i);
+      std::string port = portName(i % kNumNets);
+      std::string next = netName((i + 1) % kNumNets);
+      if (i % kReducedEvery == 0) {
+        out << "*R_NET " << net << " " << i * 0.01 << "\n*DRIVER " << port
+            << "\n*CELL BUF\n*C2_R1_C1 " << i * 0.001 << " " << i * 0.1
+            << " " << i * 0.002 << "\n*LOADS\n*RC " << port
+            << " 0.1\n*END\n\n";
+        continue;
+      }
+      int num_nodes = 1 + i % 5;
+      out << "*D_NET " << net << " " << i * 0.01 << "\n*CONN\n*P " << port
+          << " I\n*CAP\n1 " << port << " 0.5\n";
+      for (int n = 1; n <= num_nodes; ++n)
+        out << n + 1 << " " << net << ":" << n << " " << n * 0.25 << "\n";
+      out << num_nodes + 2 << " " << net << ":1 " << next << ":1 0.125\n";
+      out << "*RES\n1 " << port << " " << net << ":1 " << i * 0.5 << "\n";
+      for (int n = 1; n < num_nodes; ++n)
+        out << n + 1 << " " << net << ":" << n << " " << net << ":" << n + 1
+            << " " << n * 1.5 << "\n";
+      out << "*END\n\n";
+    }
+  }
+
+  /// @brief a design of its own, its name indexes are not built yet
+  static Cell *createDesign(std::string name, std::vector<Net *> *nets) {
+    Cell *cell = getTopCell()->createCell(name, true);
+    if (cell == nullptr) return nullptr;
+    for (int i = 0; i < kNumNets; ++i) {
+      std::string net_name = netName(i);
+      std::string port_name = portName(i);
+      Net *net = cell->createNet(net_name);
+      Pin *pin = cell->createIOPin(port_name);
+      Term *term = cell->createObject<Term>(kObjectTypeTerm);
+      if (net == nullptr || pin == nullptr || term == nullptr) return nullptr;
+      // as read_def names IO pins, by a term of their own.
+      term->setName(port_name);
+      pin->setTerm(term);
+      nets->push_back(net);
+    }
+    return cell;
+  }
+
+  static DesignParasitics *createParasitics() {
+    Timing *timing = getTimingLib();
+    return timing->createObject<DesignParasitics>(kObjectTypeDesignParasitics,
+                                                  timing->getId());
+  }
+
+  /// @brief parasitics of a SPEF file read into a corner of its own
+  static NetsParasitics *readSpef(const std::string &name, int num_threads) {
+    DesignParasitics *parasitics = createParasitics();
+    if (parasitics == nullptr) return nullptr;
+    SpefReader::SpefReader reader(name, parasitics);
+    if (!reader.parseSpefFile(num_threads)) return nullptr;
+    return reader.getNetsParasitics();
+  }
+
+  static void checkSame(NetParasitics *serial, NetParasitics *parallel,
+                        bool reduced) {
+    ASSERT_NE(serial, nullptr);
+    ASSERT_NE(parallel, nullptr);
+    ASSERT_EQ(parallel->getObjectType(), serial->getObjectType());
+    ASSERT_EQ(parallel->getNetTotalCap(), serial->getNetTotalCap());
+    if (reduced) {
+      RNetParasitics *serial_rnet = static_cast<RNetParasitics *>(serial);
+      RNetParasitics *parallel_rnet = static_cast<RNetParasitics *>(parallel);
+      ASSERT_NE(serial_rnet->getDriverPinId(), UNINIT_OBJECT_ID);
+      ASSERT_EQ(parallel_rnet->getDriverPinId(), serial_rnet->getDriverPinId());
+      ASSERT_EQ(parallel_rnet->getC2(), serial_rnet->getC2());
+      ASSERT_EQ(parallel_rnet->getR1(), serial_rnet->getR1());
+      ASSERT_EQ(parallel_rnet->getC1(), serial_rnet->getC1());
+      return;
+    }
+    checkSame(static_cast<DNetParasitics *>(serial)->getRcNetwork(),
+              static_cast<DNetParasitics *>(parallel)->getRcNetwork());
+  }
+
+  static void checkSame(const RcNetwork *serial, const RcNetwork *parallel) {
+    ASSERT_NE(serial, nullptr);
+    ASSERT_NE(parallel, nullptr);
+    ASSERT_EQ(parallel->getNumNodes(), serial->getNumNodes());
+    for (uint32_t node = 0; node < serial->getNumNodes(); ++node) {
+      RcNodeType type = serial->getNodeType(node);
+      ASSERT_EQ(parallel->getNodeType(node), type);
+      if (type == kRcPinNode) {
+        ASSERT_EQ(parallel->getPinId(node), serial->getPinId(node));
+        continue;
+      }
+      if (type == kRcExtNode) {
+        ASSERT_EQ(parallel->getExtNetId(node), serial->getExtNetId(node));
+      }
+      ASSERT_EQ(parallel->getNodeNumber(node), serial->getNodeNumber(node));
+    }
+    RcRange<uint32_t> serial_conn = serial->getConnNodes();
+    RcRange<uint32_t> parallel_conn = parallel->getConnNodes();
+    ASSERT_EQ(parallel_conn.size(), serial_conn.size());
+    for (uint32_t i = 0; i < serial_conn.size(); ++i)
+      ASSERT_EQ(parallel_conn[i], serial_conn[i]);
+    RcRange<RcGroundCap> serial_caps = serial->getGroundCaps();
+    RcRange<RcGroundCap> parallel_caps = parallel->getGroundCaps();
+    ASSERT_EQ(parallel_caps.size(), serial_caps.size());
+    for (uint32_t i = 0; i < serial_caps.size(); ++i) {
+      ASSERT_EQ(parallel_caps[i].node, serial_caps[i].node);
+      ASSERT_EQ(parallel_caps[i].capacitance, serial_caps[i].capacitance);
+    }
+    RcRange<RcCouplingCap> serial_xcaps = serial->getCouplingCaps();
+    RcRange<RcCouplingCap> parallel_xcaps = parallel->getCouplingCaps();
+    ASSERT_EQ(parallel_xcaps.size(), serial_xcaps.size());
+    for (uint32_t i = 0; i < serial_xcaps.size(); ++i) {
+      ASSERT_EQ(parallel_xcaps[i].node1, serial_xcaps[i].node1);
+      ASSERT_EQ(parallel_xcaps[i].node2, serial_xcaps[i].node2);
+      ASSERT_EQ(parallel_xcaps[i].capacitance, serial_xcaps[i].capacitance);
+    }
+    RcRange<RcResistor> serial_res = serial->getResistors();
+    RcRange<RcResistor> parallel_res = parallel->getResistors();
+    ASSERT_EQ(parallel_res.size(), serial_res.size());
+    for (uint32_t i = 0; i < serial_res.size(); ++i) {
+      ASSERT_EQ(parallel_res[i].node1, serial_res[i].node1);
+      ASSERT_EQ(parallel_res[i].node2, serial_res[i].node2);
+      ASSERT_EQ(parallel_res[i].resistance, serial_res[i].resistance);
+    }
+  }
+
+ private:
+  std::vector<std::string> files_;
+};
+
+TEST_F(SpefReaderTest, SerialAndParallelMatch) {
+  std::vector<Net *> nets;
+  std::string design = "spef_reader_design";
+  ASSERT_NE(createDesign(design, &nets), nullptr);
+  std::string spef = fileName("test.spef");
+  writeSpef(spef, design);
+
+  NetsParasitics *serial = readSpef(spef, 1);
+  util::ThreadPool::getInstance().setNumThreads(kNumThreads);
+  NetsParasitics *parallel = readSpef(spef, kNumThreads);
+  ASSERT_NE(serial, nullptr);
+  ASSERT_NE(parallel, nullptr);
+  ASSERT_NE(parallel, serial);
+
+  for (int i = 0; i < kNumNets; ++i) {
+    ObjectId net_id = nets[i]->getId();
+    checkSame(serial->findNetParasitics(net_id),
+              parallel->findNetParasitics(net_id), i % kReducedEvery == 0);
+  }
+  ASSERT_EQ(parallel->getParasiticNetIds().size(),
+            serial->getParasiticNetIds().size());
+}
+
+TEST_F(SpefReaderTest, LazyLoading) {
+  std::vector<Net *> nets;
+  std::string design = "spef_lazy_design";
+  Cell *cell = createDesign(design, &nets);
+  ASSERT_NE(cell, nullptr);
+  std::string spef = fileName("lazy.spef");
+  std::string index = fileName("lazy.idx");
+  writeSpef(spef, design);
+  NetsParasitics *serial = readSpef(spef, 1);
+  ASSERT_NE(serial, nullptr);
+
+  // the first loader writes the index, the second one reads it.
+  std::vector<NetsParasitics *> lazy_nets;
+  for (int round = 0; round < 2; ++round) {
+    DesignParasitics *parasitics = createParasitics();
+    ASSERT_NE(parasitics, nullptr);
+    SpefReader::SpefLazyLoader *loader =
+        new SpefReader::SpefLazyLoader(spef, parasitics, kCacheSize);
+    ASSERT_TRUE(loader->open(index));
+    ASSERT_EQ(loader->getNumNets(), static_cast<uint64_t>(kNumNets));
+    NetsParasitics *lazy = Object::addr<NetsParasitics>(
+        parasitics->getParasiticsMap().at(cell->getId()));
+    ASSERT_NE(lazy, nullptr);
+    ASSERT_EQ(lazy->getLazyLoader(), loader);
+    ASSERT_EQ(lazy->getParasiticNetIds().size(),
+              static_cast<size_t>(kNumNets));
+    for (int i = 0; i < kNumNets; ++i) {
+      ObjectId net_id = nets[i]->getId();
+      checkSame(serial->findNetParasitics(net_id),
+                lazy->getNetParasitics(net_id), i % kReducedEvery == 0);
+      ASSERT_LE(loader->getNumLoaded(), static_cast<uint64_t>(kCacheSize));
+    }
+    lazy_nets.push_back(lazy);
+  }
+  ASSERT_NE(lazy_nets[0]->getLazyLoader(), lazy_nets[1]->getLazyLoader());
+
+  // loaders are runtime state, dropped with the timing lib.
+  NetsParasitics::resetLazyLoaders();
+  for (NetsParasitics *lazy : lazy_nets) {
+    ASSERT_EQ(lazy->getLazyLoader(), nullptr);
+    ASSERT_LE(lazy->getParasiticNetIds().size(),
+              static_cast<size_t>(kCacheSize));
+  }
+}
+
+// nets evicted from the cache of a lazy loader give their memory back, the
+// pool stops growing once the cache is full.
+TEST_F(SpefReaderTest, LazyEviction) {
+  std::vector<Net *> nets;
+  std::string design = "spef_evict_design";
+  Cell *cell = createDesign(design, &nets);
+  ASSERT_NE(cell, nullptr);
+  std::string spef = fileName("evict.spef");
+  writeSpef(spef, design);
+  DesignParasitics *parasitics = createParasitics();
+  ASSERT_NE(parasitics, nullptr);
+  SpefReader::SpefLazyLoader *loader =
+      new SpefReader::SpefLazyLoader(spef, parasitics, kCacheSize);
+  ASSERT_TRUE(loader->open(fileName("evict.idx")));
+  NetsParasitics *lazy = Object::addr<NetsParasitics>(
+      parasitics->getParasiticsMap().at(cell->getId()));
+  ASSERT_NE(lazy, nullptr);
+
+  MemPagePool *pool = MemPool::getPagePoolByObjectId(parasitics->getId());
+  ASSERT_NE(pool, nullptr);
+  auto getUsedMemory = [pool]() {
+    return pool->getNumPages() * pool->getPageSize() - pool->getFreeMemory();
+  };
+  std::vector<uint64_t> used;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < kNumNets; ++i) {
+      ASSERT_NE(lazy->getNetParasitics(nets[i]->getId()), nullptr);
+    }
+    used.push_back(getUsedMemory());
+  }
+  ASSERT_EQ(used[1], used[0]);
+  ASSERT_EQ(used[2], used[0]);
+}
+
+TEST_F(SpefReaderTest, ParasiticsCache) {
+  std::vector<Net *> nets;
+  std::string design = "spef_cache_design";
+  Cell *cell = createDesign(design, &nets);
+  ASSERT_NE(cell, nullptr);
+  std::string spef = fileName("cache.spef");
+  std::string cache = fileName("cache.bin");
+  std::string truncated = fileName("truncated.bin");
+  writeSpef(spef, design);
+  DesignParasitics *written = createParasitics();
+  ASSERT_NE(written, nullptr);
+  SpefReader::SpefReader spef_reader(spef, written);
+  ASSERT_TRUE(spef_reader.parseSpefFile(1));
+  NetsParasitics *serial = spef_reader.getNetsParasitics();
+  ASSERT_NE(serial, nullptr);
+
+  // written through a temporary file, none left behind.
+  ParasiticsCacheWriter writer;
+  ASSERT_TRUE(writer.write(written, cache));
+  std::string tmp = cache + "." + std::to_string(getpid()) + ".tmp";
+  ASSERT_NE(access(tmp.c_str(), F_OK), 0);
+
+  DesignParasitics *read = createParasitics();
+  ASSERT_NE(read, nullptr);
+  ParasiticsCacheReader reader;
+  ASSERT_TRUE(reader.read(read, cache));
+  ASSERT_EQ(reader.getNumUnresolved(), 0u);
+  NetsParasitics *cached = Object::addr<NetsParasitics>(
+      read->getParasiticsMap().at(cell->getId()));
+  ASSERT_NE(cached, nullptr);
+  for (int i = 0; i < kNumNets; ++i) {
+    ObjectId net_id = nets[i]->getId();
+    checkSame(serial->findNetParasitics(net_id),
+              cached->findNetParasitics(net_id), i % kReducedEvery == 0);
+  }
+
+  // a cut cache is rejected.
+  std::ifstream in(cache, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+  std::ofstream(truncated, std::ios::binary)
+      .write(bytes.data(), bytes.size() / 2);
+  DesignParasitics *cut = createParasitics();
+  ASSERT_NE(cut, nullptr);
+  ParasiticsCacheReader cut_reader;
+  ASSERT_FALSE(cut_reader.read(cut, truncated));
+}
+
+TEST_F(SpefReaderTest, IndexFileOfOneSpef) {
+  std::string index = fileName("shared.idx");
+  const char *argv[] = {"read_spef", "-lazy", "-index_file", index.c_str(),
+                        "a.spef", "b.spef"};
+  ASSERT_EQ(readSpefCommand(nullptr, nullptr, 6, argv), TCL_ERROR);
+  ASSERT_NE(access(index.c_str(), F_OK), 0);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
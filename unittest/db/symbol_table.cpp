@@ -0,0 +1,97 @@
+/**
+ * @file   symbol_table.cpp
+ * @date   Oct 2020
+ * @brief  Concurrent inserts and lookups of the symbol table.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "db/util/symbol_table.h"
+#include "util/thread_pool.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class SymbolTableTest : public ::testing::Test {
+ public:
+  static const int kNumThreads = 8;
+  static const int kNumSymbols = 50000;
+
+  void TearDown() override {
+    util::ThreadPool::getInstance().setNumThreads(0);
+  }
+
+  static std::string symbolName(int i) { return "symbol_" + std::to_string(i); }
+};
+
+// every thread inserts all of the names in its own order while the others
+// look them up, so that each name is raced for by all of the threads.
+TEST_F(SymbolTableTest, ConcurrentInsertAndLookup) {
+  SymbolTable table;
+  uint64_t num_existing = table.getSymbolCount();
+  std::vector<std::vector<SymbolIndex>> indexes(
+      kNumThreads, std::vector<SymbolIndex>(kNumSymbols, kInvalidSymbolIndex));
+  std::atomic<int> failures(0);
+
+  util::ThreadPool::getInstance().setNumThreads(kNumThreads);
+  util::parallelFor(0, kNumThreads, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; ++t) {
+      for (int n = 0; n < kNumSymbols; ++n) {
+        int i = (n * 7919 + t * 4099) % kNumSymbols;
+        std::string name = symbolName(i);
+        SymbolIndex found = table.isSymbolInTable(name);
+        SymbolIndex index = table.getOrCreateSymbol(name.c_str());
+        if (index == kInvalidSymbolIndex ||
+            (found != kInvalidSymbolIndex && found != index))
+          ++failures;
+        indexes[t][i] = index;
+      }
+    }
+  }, 1);
+  ASSERT_EQ(failures, 0);
+
+  // one index per name, whichever thread created it.
+  ASSERT_EQ(table.getSymbolCount(), num_existing + kNumSymbols);
+  for (int i = 0; i < kNumSymbols; ++i) {
+    SymbolIndex index = indexes[0][i];
+    for (int t = 1; t < kNumThreads; ++t) ASSERT_EQ(indexes[t][i], index);
+    ASSERT_EQ(table.isSymbolInTable(symbolName(i)), index);
+    ASSERT_EQ(table.getSymbolByIndex(index), symbolName(i));
+  }
+  ASSERT_EQ(table.isSymbolInTable("symbol_missing"), kInvalidSymbolIndex);
+}
+
+TEST_F(SymbolTableTest, ConcurrentReferences) {
+  SymbolTable table;
+  SymbolIndex index = table.getOrCreateSymbol("shared");
+  ASSERT_NE(index, kInvalidSymbolIndex);
+  const int kNumReferences = 10000;
+
+  util::ThreadPool::getInstance().setNumThreads(kNumThreads);
+  util::parallelFor(0, kNumThreads, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; ++t) {
+      for (int n = 0; n < kNumReferences; ++n)
+        table.addReference(index, t * kNumReferences + n + 1);
+    }
+  }, 1);
+
+  std::vector<ObjectId>& references = table.getReferences(index);
+  ASSERT_EQ(references.size(),
+            static_cast<size_t>(kNumThreads) * kNumReferences);
+  std::vector<char> seen(kNumThreads * kNumReferences + 1, 0);
+  for (ObjectId id : references) {
+    ASSERT_GT(id, 0);
+    ASSERT_LE(id, kNumThreads * kNumReferences);
+    ASSERT_FALSE(seen[id]);
+    seen[id] = 1;
+  }
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
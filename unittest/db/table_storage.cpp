@@ -0,0 +1,130 @@
+/**
+ * @file   table_storage.cpp
+ * @date   Nov 2020
+ * @brief  Timing tables with equal axes, values or packed blocks share one.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/timing/timinglib/libset.h"
+#include "db/timing/timinglib/timinglib_packedtable.h"
+#include "db/timing/timinglib/timinglib_tablestorage.h"
+#include "db/timing/timinglib/timinglib_tabletemplate.h"
+#include "db/timing/timinglib/timinglib_timingtable.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class TableStorageTest : public ::testing::Test {
+ public:
+  void SetUp() override { initTopCell(); }
+
+  static TableAxis *createAxis(TableAxisVariable variable,
+                               const std::vector<float> &values) {
+    Timing *timing = getTimingLib();
+    TableAxis *axis = Object::createObject<TableAxis>(kObjectTypeTableAxis,
+                                                      timing->getId());
+    if (axis == nullptr) return nullptr;
+    axis->setVariable(variable);
+    for (float f : values) axis->addValue(f);
+    return axis;
+  }
+
+  static TimingTable1 *createTable(TableStorage *storage, TableAxis *axis,
+                                   const std::vector<float> &values) {
+    Timing *timing = getTimingLib();
+    TimingTable1 *table = Object::createObject<TimingTable1>(
+        kObjectTypeTimingTable1, timing->getId());
+    if (table == nullptr) return nullptr;
+    table->setAxis1(storage->getAxis(axis)->getId());
+    table->setSharedValues(storage->getValues(values));
+    table->pack(storage);
+    return table;
+  }
+};
+
+TEST_F(TableStorageTest, Sharing) {
+  TableStorage storage;
+  std::vector<float> index = {0.1f, 0.2f, 0.4f};
+  std::vector<float> values = {1.0f, 2.0f, 3.0f};
+  std::vector<float> other_values = {1.0f, 2.0f, 3.5f};
+  TableAxis *axis =
+      createAxis(TableAxisVariable::kInput_Net_Transition, index);
+  TableAxis *same_axis =
+      createAxis(TableAxisVariable::kInput_Net_Transition, index);
+  TableAxis *other_axis =
+      createAxis(TableAxisVariable::kTotal_Output_Net_Capacitance, index);
+  ASSERT_NE(axis, nullptr);
+  ASSERT_NE(same_axis, nullptr);
+  ASSERT_NE(other_axis, nullptr);
+
+  // the first axis is kept, an equal one gives it back, another variable
+  // makes another axis.
+  ASSERT_EQ(storage.getAxis(axis), axis);
+  ASSERT_EQ(storage.getAxis(same_axis), axis);
+  ASSERT_EQ(storage.getAxis(other_axis), other_axis);
+  ASSERT_EQ(storage.getNumAxes(), 2u);
+  ASSERT_EQ(storage.getNumShared(), 1u);
+
+  ObjectId values_id = storage.getValues(values);
+  ASSERT_NE(values_id, UNINIT_OBJECT_ID);
+  ASSERT_EQ(storage.getValues(values), values_id);
+  ASSERT_NE(storage.getValues(other_values), values_id);
+  ASSERT_EQ(storage.getNumValues(), 2u);
+  ASSERT_EQ(storage.getNumShared(), 2u);
+
+  // equal tables refer to one packed block, counted once.
+  uint64_t num_shared = storage.getNumShared();
+  TimingTable1 *table = createTable(&storage, axis, values);
+  TimingTable1 *same = createTable(&storage, same_axis, values);
+  TimingTable1 *other = createTable(&storage, axis, other_values);
+  TimingTable1 *other_variable = createTable(&storage, other_axis, values);
+  ASSERT_NE(table, nullptr);
+  ASSERT_NE(same, nullptr);
+  ASSERT_NE(other, nullptr);
+  ASSERT_NE(other_variable, nullptr);
+  ASSERT_NE(table->getPackedTable(), nullptr);
+  ASSERT_EQ(same->getPackedTable(), table->getPackedTable());
+  ASSERT_NE(other->getPackedTable(), table->getPackedTable());
+  ASSERT_NE(other_variable->getPackedTable(), table->getPackedTable());
+  ASSERT_EQ(storage.getNumPackedTables(), 3u);
+  // each table finds its axis and values, one of them its block.
+  ASSERT_EQ(storage.getNumShared(), num_shared + 4 * 2 + 1);
+  ASSERT_EQ(same->getPackedTable()->getValue(2), 3.0f);
+
+  // a shared table changed by addValue leaves the others alone.
+  same->addValue(4.0f);
+  ASSERT_EQ(same->getPackedTable(), nullptr);
+  ASSERT_EQ(table->getValues(), values);
+  ASSERT_EQ(table->getPackedTable()->getNumValues(), 3u);
+}
+
+TEST_F(TableStorageTest, LibSetStorage) {
+  Timing *timing = getTimingLib();
+  ASSERT_NE(timing, nullptr);
+  LibSet *libset =
+      Object::createObject<LibSet>(kObjectTypeLibSet, timing->getId());
+  LibSet *other =
+      Object::createObject<LibSet>(kObjectTypeLibSet, timing->getId());
+  ASSERT_NE(libset, nullptr);
+  ASSERT_NE(other, nullptr);
+
+  TableStorage *storage = libset->getTableStorage();
+  ASSERT_NE(storage, nullptr);
+  ASSERT_EQ(libset->getTableStorage(), storage);
+  ASSERT_NE(other->getTableStorage(), storage);
+  storage->getValues({1.0f, 2.0f});
+  ASSERT_EQ(libset->getTableStorage()->getNumValues(), 1u);
+
+  // a reset, as on a new timing lib, leaves the libsets empty storages.
+  LibSet::resetTableStorages();
+  ASSERT_EQ(libset->getTableStorage()->getNumValues(), 0u);
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE
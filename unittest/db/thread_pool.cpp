@@ -0,0 +1,100 @@
+/**
+ * @file   thread_pool.cpp
+ * @date   Oct 2020
+ * @brief  Tests of the shared thread pool.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "util/thread_pool.h"
+
+namespace open_edi {
+namespace util {
+
+namespace unitest {
+
+class ThreadPoolTest : public ::testing::TestWithParam<int> {
+ public:
+  void SetUp() override {
+    ThreadPool::getInstance().setNumThreads(GetParam());
+  }
+  void TearDown() override { ThreadPool::getInstance().setNumThreads(0); }
+};
+
+TEST_P(ThreadPoolTest, ParallelFor) {
+  const int64_t kNum = 100000;
+  std::vector<int> hits(kNum, 0);
+  parallelFor(0, kNum, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) ++hits[i];
+  });
+  for (int64_t i = 0; i < kNum; ++i) ASSERT_EQ(hits[i], 1);
+}
+
+TEST_P(ThreadPoolTest, NestedParallelFor) {
+  std::atomic<int64_t> count(0);
+  parallelFor(0, 64, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      parallelFor(0, 100, [&](int64_t b, int64_t e) { count += e - b; }, 7);
+    }
+  }, 1);
+  ASSERT_EQ(count, 6400);
+}
+
+TEST_P(ThreadPoolTest, TaskGroup) {
+  std::atomic<int> count(0);
+  TaskGroup group;
+  for (int i = 0; i < 100; ++i) {
+    group.run([&]() {
+      ++count;
+      // tasks may post more tasks to their group.
+      group.run([&]() { ++count; });
+    });
+  }
+  group.wait();
+  ASSERT_EQ(count, 200);
+}
+
+TEST_P(ThreadPoolTest, Exception) {
+  TaskGroup group;
+  group.run([]() { throw 5; });
+  ASSERT_THROW(group.wait(), int);
+}
+
+TEST_P(ThreadPoolTest, Future) {
+  std::future<int> result = ThreadPool::getInstance().submit([]() {
+    return 42;
+  });
+  ASSERT_EQ(result.get(), 42);
+}
+
+// the pool is resized while another thread posts and waits for tasks.
+TEST_P(ThreadPoolTest, ResizeWhilePosting) {
+  std::atomic<bool> stop(false);
+  std::atomic<int64_t> count(0);
+  std::thread poster([&]() {
+    while (!stop) {
+      parallelFor(0, 64, [&](int64_t b, int64_t e) { count += e - b; }, 1);
+    }
+  });
+  for (int i = 0; i < 20; ++i) {
+    ThreadPool::getInstance().setNumThreads(1 + (GetParam() + i) % 4);
+    // let the poster run a few loops on the new workers.
+    int64_t seen = count;
+    while (count < seen + 4 * 64) std::this_thread::yield();
+  }
+  stop = true;
+  poster.join();
+  ASSERT_EQ(count % 64, 0);
+}
+
+INSTANTIATE_TEST_CASE_P(NumThreads, ThreadPoolTest,
+                        ::testing::Values(1, 2, 4, 8));
+
+}  // namespace unitest
+
+}  // namespace util
+}  // namespace open_edi
@@ -0,0 +1,202 @@
+/**
+ * @file   timing_table.cpp
+ * @date   Nov 2020
+ * @brief  Packed timing tables give the values and interpolations of the
+ *         axes and values they are packed from.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "db/core/db.h"
+#include "db/timing/timinglib/timinglib_packedtable.h"
+#include "db/timing/timinglib/timinglib_tabletemplate.h"
+#include "db/timing/timinglib/timinglib_timingtable.h"
+
+EDI_BEGIN_NAMESPACE
+
+namespace unitest {
+
+class TimingTableTest : public ::testing::Test {
+ public:
+  static const int kSize1 = 7;
+  static const int kSize2 = 5;
+  static const int kSize3 = 3;
+
+  void SetUp() override { initTopCell(); }
+
+  static TableAxis *createAxis(TableAxisVariable variable, int size,
+                               std::mt19937 *rng) {
+    Timing *timing = getTimingLib();
+    TableAxis *axis = Object::createObject<TableAxis>(kObjectTypeTableAxis,
+                                                      timing->getId());
+    if (axis == nullptr) return nullptr;
+    axis->setVariable(variable);
+    std::uniform_real_distribution<float> step(0.01f, 0.5f);
+    float x = step(*rng);
+    for (int i = 0; i < size; ++i, x += step(*rng)) axis->addValue(x);
+    return axis;
+  }
+
+  static std::vector<float> getAxisValues(TableAxis *axis) {
+    std::vector<float> values;
+    for (int64_t i = 0; i < axis->getSize(); ++i)
+      values.push_back((*axis->getValues())[i]);
+    return values;
+  }
+
+  /// @brief segment and fraction as documented by PackedTable::lookup
+  static int findSegment(const std::vector<float> &axis, float x, float *t) {
+    int segment = 0;
+    while (segment + 2 < static_cast<int>(axis.size()) &&
+           axis[segment + 1] <= x)
+      ++segment;
+    *t = (x - axis[segment]) / (axis[segment + 1] - axis[segment]);
+    *t = std::min(std::max(*t, -1.0f), 2.0f);
+    return segment;
+  }
+
+  /// @brief bilinear interpolation of the values of a table, unpacked
+  static float interpolate(TimingTable2 *table, float x1, float x2) {
+    std::vector<float> axis1 = getAxisValues(table->getAxis1());
+    std::vector<float> axis2 = getAxisValues(table->getAxis2());
+    float t1 = 0.0f, t2 = 0.0f;
+    int i = findSegment(axis1, x1, &t1);
+    int j = findSegment(axis2, x2, &t2);
+    return (1 - t1) * (1 - t2) * table->getValue(i, j) +
+           (1 - t1) * t2 * table->getValue(i, j + 1) +
+           t1 * (1 - t2) * table->getValue(i + 1, j) +
+           t1 * t2 * table->getValue(i + 1, j + 1);
+  }
+};
+
+TEST_F(TimingTableTest, PackedValues) {
+  Timing *timing = getTimingLib();
+  ASSERT_NE(timing, nullptr);
+  std::mt19937 rng(20201109);
+  std::uniform_real_distribution<float> value(0.0f, 2.0f);
+  TableAxis *axis1 =
+      createAxis(TableAxisVariable::kInput_Net_Transition, kSize1, &rng);
+  TableAxis *axis2 = createAxis(
+      TableAxisVariable::kTotal_Output_Net_Capacitance, kSize2, &rng);
+  TableAxis *axis3 =
+      createAxis(TableAxisVariable::kRelated_Pin_Transition, kSize3, &rng);
+  ASSERT_NE(axis1, nullptr);
+  ASSERT_NE(axis2, nullptr);
+  ASSERT_NE(axis3, nullptr);
+
+  TimingTable3 *table = Object::createObject<TimingTable3>(
+      kObjectTypeTimingTable3, timing->getId());
+  ASSERT_NE(table, nullptr);
+  table->setAxis1(axis1->getId());
+  table->setAxis2(axis2->getId());
+  table->setAxis3(axis3->getId());
+  for (int i = 0; i < kSize1 * kSize2 * kSize3; ++i)
+    table->addValue(value(rng));
+
+  // values read from the array before the table is packed.
+  std::vector<float> unpacked;
+  ASSERT_EQ(table->getPackedTable(), nullptr);
+  ASSERT_EQ(table->lookup(0.1f, 0.1f), 0.0f);
+  for (int i = 0; i < kSize1; ++i)
+    for (int j = 0; j < kSize2; ++j)
+      for (int k = 0; k < kSize3; ++k)
+        unpacked.push_back(table->getValue(i, j, k));
+
+  table->pack();
+  const PackedTable *packed = table->getPackedTable();
+  ASSERT_NE(packed, nullptr);
+  ASSERT_EQ(packed->getDimension(), 3u);
+  ASSERT_EQ(packed->getNumValues(), unpacked.size());
+  size_t n = 0;
+  for (int i = 0; i < kSize1; ++i)
+    for (int j = 0; j < kSize2; ++j)
+      for (int k = 0; k < kSize3; ++k, ++n)
+        ASSERT_EQ(table->getValue(i, j, k), unpacked[n]);
+
+  // the block is in the pool, a copy of the table refers to it.
+  TimingTable3 copy(*table);
+  ASSERT_EQ(copy.getPackedTable(), packed);
+  // a new value leaves the table unpacked until packed again.
+  table->addValue(value(rng));
+  ASSERT_EQ(table->getPackedTable(), nullptr);
+  ASSERT_EQ(copy.getPackedTable(), packed);
+}
+
+TEST_F(TimingTableTest, Lookup) {
+  Timing *timing = getTimingLib();
+  ASSERT_NE(timing, nullptr);
+  std::mt19937 rng(20201110);
+  std::uniform_real_distribution<float> value(0.0f, 2.0f);
+  // load first, so that lookup has to give slew to the second axis.
+  TableAxis *axis1 = createAxis(
+      TableAxisVariable::kTotal_Output_Net_Capacitance, kSize1, &rng);
+  TableAxis *axis2 =
+      createAxis(TableAxisVariable::kInput_Net_Transition, kSize2, &rng);
+  ASSERT_NE(axis1, nullptr);
+  ASSERT_NE(axis2, nullptr);
+
+  TimingTable2 *table = Object::createObject<TimingTable2>(
+      kObjectTypeTimingTable2, timing->getId());
+  ASSERT_NE(table, nullptr);
+  table->setAxis1(axis1->getId());
+  table->setAxis2(axis2->getId());
+  for (int i = 0; i < kSize1 * kSize2; ++i) table->addValue(value(rng));
+
+  // points on the grid, within and beyond the axes, interpolated from
+  // the unpacked values.
+  std::vector<float> loads = getAxisValues(axis1);
+  std::vector<float> slews = getAxisValues(axis2);
+  std::vector<float> load_points, slew_points;
+  for (size_t i = 0; i + 1 < loads.size(); ++i) {
+    load_points.push_back(loads[i]);
+    load_points.push_back(0.7f * loads[i] + 0.3f * loads[i + 1]);
+  }
+  for (size_t i = 0; i + 1 < slews.size(); ++i) {
+    slew_points.push_back(slews[i]);
+    slew_points.push_back(0.4f * slews[i] + 0.6f * slews[i + 1]);
+  }
+  load_points.push_back(loads.back());
+  slew_points.push_back(slews.back());
+  load_points.push_back(loads.front() - 10.0f);
+  load_points.push_back(loads.back() + 0.1f);
+  slew_points.push_back(slews.front() - 0.01f);
+  slew_points.push_back(slews.back() + 10.0f);
+  std::vector<float> expected;
+  for (float load : load_points)
+    for (float slew : slew_points)
+      expected.push_back(interpolate(table, load, slew));
+
+  table->pack();
+  ASSERT_NE(table->getPackedTable(), nullptr);
+  size_t n = 0;
+  for (float load : load_points) {
+    for (float slew : slew_points) {
+      float result = table->lookup(slew, load);
+      ASSERT_NEAR(result, expected[n], 1e-4f * (1.0f + std::fabs(expected[n])))
+          << "load " << load << " slew " << slew;
+      ++n;
+    }
+  }
+
+  // the batch lookup gives the same results, null tables give 0.
+  const PackedTable *packed = table->getPackedTable();
+  std::vector<const PackedTable *> tables = {packed, nullptr, packed};
+  std::vector<float> batch_slews = {slew_points[1], 0.0f, slew_points[3]};
+  std::vector<float> batch_loads = {load_points[2], 0.0f, load_points[5]};
+  std::vector<float> results(tables.size());
+  PackedTable::lookupSlewLoad(tables.data(), batch_slews.data(),
+                              batch_loads.data(), results.data(),
+                              tables.size());
+  ASSERT_EQ(results[0], table->lookup(batch_slews[0], batch_loads[0]));
+  ASSERT_EQ(results[1], 0.0f);
+  ASSERT_EQ(results[2], table->lookup(batch_slews[2], batch_loads[2]));
+}
+
+}  // namespace unitest
+
+EDI_END_NAMESPACE